@@ -12,6 +12,7 @@
 #include <complex> 
 #include <vector> 
 
+#include "Graniitti/Amplitude/HelicityFilter.h"
 #include "Graniitti/Amplitude/Parameters_sm.h"
 #include "Graniitti/MForm.h"
 #include "Graniitti/MAux.h"
@@ -53,6 +54,10 @@ class AMP_MG5_yy_ll
     void setMomenta(vector < double * > & momenta){p = momenta;}
     void setInitial(int inid1, int inid2){id1 = inid1; id2 = inid2;}
 
+    // Helicity combination filtering, on by default // GRANIITTI
+    void setHelicityFilter(bool on) {helfilter.SetEnabled(on);}
+    const MG5_sm::HelicityFilter & getHelicityFilter() const {return helfilter;}
+
     // Get matrix element vector
     const double * getMatrixElements() const {return matrix_element;}
 
@@ -78,6 +83,9 @@ class AMP_MG5_yy_ll
     // Color flows, used when selecting color
     double * jamp2[nprocesses]; 
 
+    // Vanishing helicity combinations // GRANIITTI
+    MG5_sm::HelicityFilter helfilter; 
+
     // Pointer to the model parameters
     Parameters_sm pars; // GRANIITTI 
 
@@ -0,0 +1,76 @@
+// Helicity combination filter for the MadGraph amplitudes [HEADER ONLY]
+//
+// GRANIITTI replacement of MadGraph 'goodhel' logic: over the first NWARMUP
+// phase space points with a non-zero total, a helicity combination is marked good if its
+// |A_h|^2 is above EPS x \sum_h |A_h|^2 at any point. After the warm-up,
+// only good combinations are evaluated. Skipped amplitudes are left zero
+// in lts.hamp, so the vector keeps the same layout for the screening loop.
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+#ifndef HELICITYFILTER_H
+#define HELICITYFILTER_H
+
+// C++
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace MG5_sm {
+
+class HelicityFilter {
+ public:
+  HelicityFilter() {}
+
+  // Is this helicity combination evaluated
+  bool Evaluate(int ihel) const { return !ENABLED || !learned || good[ihel]; }
+
+  // Learn from the helicity amplitudes of one phase space point
+  void Update(const std::vector<std::complex<double>> &hamp) {
+    if (!ENABLED || learned) { return; }
+    if (good.size() != hamp.size()) { good.assign(hamp.size(), false); }
+
+    // Points with a vanishing (or non-finite) total do not count to the warm-up
+    double sum = 0.0;
+    for (const auto &A : hamp) { sum += std::norm(A); }
+    if (!(sum > 0) || !std::isfinite(sum)) { return; }
+    for (std::size_t i = 0; i < hamp.size(); ++i) {
+      if (std::norm(hamp[i]) > EPS * sum) { good[i] = true; }
+    }
+    if (++ntry >= NWARMUP) {
+      learned = true;
+      // Nothing was marked good, evaluate all
+      if (NGood() == 0) { good.assign(good.size(), true); }
+    }
+  }
+
+  // Number of good helicity combinations (after the warm-up)
+  std::size_t NGood() const {
+    std::size_t n = 0;
+    for (const auto &x : good) { n += x ? 1 : 0; }
+    return n;
+  }
+  bool Learned() const { return learned; }
+
+  // Turn filtering on/off, relearn from scratch
+  void SetEnabled(bool on) {
+    ENABLED = on;
+    learned = false;
+    ntry    = 0;
+    good.clear();
+  }
+
+  static constexpr unsigned int NWARMUP = 20;
+  static constexpr double       EPS     = 1e-20;
+
+ private:
+  bool              ENABLED = true;
+  bool              learned = false;
+  unsigned int      ntry    = 0;
+  std::vector<bool> good;
+};
+
+}  // namespace MG5_sm
+
+#endif
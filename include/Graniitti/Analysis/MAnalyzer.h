@@ -7,7 +7,11 @@
 #define MANALYZER_H
 
 #include <complex>
+#include <exception>
+#include <map>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 // ROOT
@@ -41,6 +45,7 @@
 // Own
 #include "Graniitti/Analysis/MMultiplet.h"
 #include "Graniitti/MAux.h"
+#include "Graniitti/MEventRecord.h"
 
 namespace gra {
 
@@ -51,6 +56,33 @@ const std::vector<std::string> FRAMES = {"CM", "HX", "CS", "PG", "GJ", "LAB"};
 
 }  // namespace analyzer
 
+// Thread-local state of the event loop
+struct MAnalyzerLocal {
+  // Local copy of a histogram (the histogram itself without a copy)
+  template <typename T>
+  T *Get(T *h) const {
+    const auto it = copy.find(h);
+    return (it == copy.end()) ? h : static_cast<T *>(it->second);
+  }
+  template <typename T>
+  T *Get(const std::shared_ptr<T> &h) const {
+    return Get(h.get());
+  }
+
+  std::unordered_map<TH1 *, TH1 *> copy;
+
+  // Ancestry index of the current event
+  std::vector<unsigned int> ancestors;
+  std::vector<unsigned int> parents;
+
+  double             totalW = 0.0;
+  double             selecW = 0.0;
+  double             sqrts  = 0.0;
+  bool               nstar  = false;
+  std::size_t        events = 0;
+  std::exception_ptr error  = nullptr;
+};
+
 class MAnalyzer {
  public:
   // Constructor, destructor
@@ -87,25 +119,25 @@ class MAnalyzer {
   std::shared_ptr<TH2D> h2Phi[NFR][NFR];
   // ----------------------------------------------------------
 
-  // HepMC3 reader
+  // HepMC3 and columnar reader, inputfile may be "name1+name2+..."
   double HepMC3_OracleFill(const std::string inputfile, unsigned int multiplicity, int finalPDG,
                            unsigned int                                            MAXEVENTS,
                            std::map<std::string, std::shared_ptr<h1Multiplet>> &   h1,
                            std::map<std::string, std::shared_ptr<h2Multiplet>> &   h2,
                            std::map<std::string, std::shared_ptr<hProfMultiplet>> &hP,
-                           unsigned int                                            SID);
+                           unsigned int SID, unsigned int THREADS = 1);
 
   // Plot out all local histograms
   void PlotAll(const std::string &titlestr);
 
   double cross_section = 0;
 
-  double CheckEnergyMomentum(HepMC3::GenEvent &evt) const;
-  void   FrameObservables(double W, HepMC3::GenEvent &evt, const M4Vec &p_beam_plus,
-                          const M4Vec &p_beam_minus, const M4Vec &p_final_plus,
-                          const M4Vec &p_final_minus, const std::vector<M4Vec> &pip,
-                          const std::vector<M4Vec> &pim);
-  void   NStarObservables(double W, HepMC3::GenEvent &evt);
+  double CheckEnergyMomentum(const MEventRecord &evt) const;
+  void   FrameObservables(double W, const M4Vec &p_beam_plus, const M4Vec &p_beam_minus,
+                          const M4Vec &p_final_plus, const M4Vec &p_final_minus,
+                          const std::vector<M4Vec> &pip, const std::vector<M4Vec> &pim,
+                          MAnalyzerLocal &L) const;
+  void   NStarObservables(double W, const MEventRecord &evt, MAnalyzerLocal &L) const;
 
  private:
   double sqrts = 0.0;
@@ -14,14 +14,20 @@
 //  p%2 = -py
 //  p%3 = -pz
 //
+// Fixed size value type (no heap), 32-byte aligned for vector loads.
+//
 // (c) 2017-2020 Mikael Mieskolainen
 // Licensed under the MIT License <http://opensource.org/licenses/MIT>.
 
 #ifndef M4VEC_H
 #define M4VEC_H
 
+#include <algorithm>
+#include <cmath>
 #include <complex>
 #include <iostream>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 namespace gra {
@@ -39,14 +45,15 @@ namespace gra {
 // Complex 4-vectors could be implemented this way, TBD.
 // ----------------------------------------------------------------------
 
-class M4Vec {
+class alignas(32) M4Vec {
  public:
   // All default to zero
-  M4Vec() { k = {0.0, 0.0, 0.0, 0.0}; }
+  M4Vec() : k{0.0, 0.0, 0.0, 0.0} {}
   // Initialize
-  M4Vec(double x, double y, double z, double t) { k = {t, x, y, z}; }
-  // Copy constructor
-  M4Vec(const M4Vec &rhs) { k = rhs.k; }
+  M4Vec(double x, double y, double z, double t) : k{t, x, y, z} {}
+  // Trivial copy and assignment
+  M4Vec(const M4Vec &rhs) = default;
+  M4Vec &operator=(const M4Vec &rhs) = default;
 
   // SET methods
   void SetPx(double v) { k[X_] = v; }
@@ -317,10 +324,13 @@ class M4Vec {
 
   // Safe sqrt
   double msqrt(double x) const { return std::sqrt(std::max(0.0, x)); }
-  // 4-vector
-  std::vector<double> k;
+  // 4-vector (t,x,y,z)
+  double k[4];
 };
 
+static_assert(sizeof(M4Vec) == 32, "M4Vec should be 4 doubles");
+static_assert(std::is_trivially_copyable<M4Vec>::value, "M4Vec should be trivially copyable");
+
 }  // namespace gra
 
 #endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+// Binary memory mapped cache for interpolation arrays
+//
+// Arrays are stored as a fixed size versioned header followed by
+// row-major double precision values. Files are mapped read-only and
+// shared, so processes on the same node share the page cache copy.
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+#ifndef MARRAYCACHE_H
+#define MARRAYCACHE_H
+
+// C++
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gra {
+
+// File header (fixed layout, little endian host format)
+struct MArrayHeader {
+  static constexpr char          MAGIC[8] = {'G', 'R', 'A', 'A', 'R', 'R', 'A', 'Y'};
+  static constexpr std::uint32_t VERSION  = 1;
+
+  char          magic[8]   = {0};
+  std::uint32_t version    = 0;
+  std::uint32_t ndim       = 0;     // 1 or 2
+  std::uint64_t hash       = 0;     // Hash of the discretization and physics parameters
+  std::uint32_t N[2]       = {0};   // Number of intervals (N+1 points) per dimension
+  std::uint32_t islog[2]   = {0};   // Logarithmic stepping per dimension
+  std::uint32_t ncol       = 0;     // Values per grid point
+  std::uint32_t reserved   = 0;
+  double        MIN[2]     = {0.0};
+  double        MAX[2]     = {0.0};
+  double        sqrts      = 0.0;
+  std::uint64_t nvalues    = 0;     // Total number of doubles after the header
+
+  // Compare everything but the payload size
+  bool Compatible(const MArrayHeader &other) const;
+};
+
+class MArrayCache {
+ public:
+  MArrayCache() {}
+  ~MArrayCache();
+
+  // Write header + values atomically (temporary file + rename)
+  static void Write(const std::string &filename, MArrayHeader header,
+                    const std::vector<double> &values);
+
+  // Map read-only, returns nullptr if the file does not exist or does not
+  // match the expected header
+  static std::shared_ptr<const MArrayCache> Map(const std::string &  filename,
+                                                const MArrayHeader &expected);
+
+  // Mapped values or the private copy, resolved once in Map
+  const double *      data() const { return values; }
+  std::size_t         size() const { return header.nvalues; }
+  const MArrayHeader &GetHeader() const { return header; }
+  bool                IsMapped() const { return mapped != nullptr; }
+
+ private:
+  // Copy and assignment disabled
+  MArrayCache(const MArrayCache &);
+  MArrayCache &operator=(const MArrayCache &);
+
+  MArrayHeader        header;
+  void *              mapped     = nullptr;
+  std::size_t         mappedsize = 0;
+  const double *      values     = nullptr;
+  std::vector<double> buffer;  // Fallback if mmap is not available
+};
+
+}  // namespace gra
+
+#endif
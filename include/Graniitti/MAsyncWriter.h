@@ -0,0 +1,184 @@
+// Asynchronous batched event writer
+//
+// Generation threads push finished events into a bounded lock-free
+// multi-producer single-consumer queue, and a dedicated writer thread
+// serializes them in batches to the underlying event writer. Events are
+// written in the order of event_number (0,1,2,...), those arriving early
+// wait in a reorder buffer of the writer thread.
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+#ifndef MASYNCWRITER_H
+#define MASYNCWRITER_H
+
+// C++
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Own
+#include "Graniitti/MEventRecord.h"
+#include "Graniitti/MEventWriter.h"
+
+namespace gra {
+
+// Bounded lock-free queue (sequence number ring buffer)
+// [REFERENCE: Vyukov, Bounded MPMC queue, 1024cores.net]
+template <typename T>
+class MPSCQueue {
+ public:
+  explicit MPSCQueue(std::size_t capacity) {
+    // Round up to power of two
+    std::size_t N = 2;
+    while (N < capacity) { N *= 2; }
+    mask   = N - 1;
+    buffer = std::unique_ptr<Cell[]>(new Cell[N]);
+    for (std::size_t i = 0; i < N; ++i) { buffer[i].seq.store(i, std::memory_order_relaxed); }
+    enqueue_pos.store(0, std::memory_order_relaxed);
+    dequeue_pos.store(0, std::memory_order_relaxed);
+  }
+
+  // Returns false if the queue is full
+  bool TryPush(T &&value) {
+    Cell *      cell = nullptr;
+    std::size_t pos  = enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+      cell                   = &buffer[pos & mask];
+      const std::size_t seq  = cell->seq.load(std::memory_order_acquire);
+      const std::ptrdiff_t d = (std::ptrdiff_t)seq - (std::ptrdiff_t)pos;
+      if (d == 0) {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+      } else if (d < 0) {
+        return false;  // Full
+      } else {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+    cell->data = std::move(value);
+    cell->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Returns false if the queue is empty
+  bool TryPop(T &value) {
+    Cell *      cell = nullptr;
+    std::size_t pos  = dequeue_pos.load(std::memory_order_relaxed);
+    while (true) {
+      cell                   = &buffer[pos & mask];
+      const std::size_t seq  = cell->seq.load(std::memory_order_acquire);
+      const std::ptrdiff_t d = (std::ptrdiff_t)seq - (std::ptrdiff_t)(pos + 1);
+      if (d == 0) {
+        if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+      } else if (d < 0) {
+        return false;  // Empty
+      } else {
+        pos = dequeue_pos.load(std::memory_order_relaxed);
+      }
+    }
+    value = std::move(cell->data);
+    cell->seq.store(pos + mask + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Approximate number of queued elements
+  std::size_t Size() const {
+    const std::size_t e = enqueue_pos.load(std::memory_order_relaxed);
+    const std::size_t d = dequeue_pos.load(std::memory_order_relaxed);
+    return (e > d) ? e - d : 0;
+  }
+  std::size_t Capacity() const { return mask + 1; }
+
+ private:
+  struct Cell {
+    std::atomic<std::size_t> seq;
+    T                        data;
+  };
+  std::unique_ptr<Cell[]> buffer;
+  std::size_t             mask = 0;
+
+  alignas(64) std::atomic<std::size_t> enqueue_pos;
+  alignas(64) std::atomic<std::size_t> dequeue_pos;
+};
+
+// Writer back-pressure statistics
+struct AsyncWriterStats {
+  double pushed    = 0;    // Events pushed
+  double written   = 0;    // Events written
+  double batches   = 0;    // Batches written
+  double stalls    = 0;    // Pushes which found the queue full
+  double stalltime = 0.0;  // Seconds producers waited on a full queue
+  double maxdepth  = 0;    // Maximum observed queue occupancy
+};
+
+class MAsyncWriter {
+ public:
+  // depth = 0 gives synchronous (locked) direct writes
+  MAsyncWriter(std::shared_ptr<MEventWriter> writer, std::size_t depth, std::size_t batch = 64);
+  ~MAsyncWriter();
+
+  // Called by generation threads, does not wait for the preceding event numbers
+  void Push(std::unique_ptr<MEventRecord> evt);
+
+  // Wait until all pushed events have been written, buffered events are
+  // then written also across missing event numbers (call after the producers
+  // have finished). An exception of the writer thread is rethrown here (once),
+  // after which events are dropped
+  void Flush();
+
+  // Flush and stop the writer thread (underlying writer is not closed),
+  // rethrows an exception of the writer thread as Flush
+  void Close();
+
+  AsyncWriterStats GetStats() const;
+  std::size_t      GetDepth() const { return DEPTH; }
+
+ private:
+  // Copy and assignment disabled
+  MAsyncWriter(const MAsyncWriter &);
+  MAsyncWriter &operator=(const MAsyncWriter &);
+
+  void WriterLoop();
+  void Deliver(std::unique_ptr<MEventRecord> evt);
+  void WriteReady(bool all);
+  void DropPending();
+  void RethrowError();
+
+  std::shared_ptr<MEventWriter> output = nullptr;
+  const std::size_t               DEPTH;
+  const std::size_t               BATCH;
+
+  std::unique_ptr<MPSCQueue<std::unique_ptr<MEventRecord>>> queue = nullptr;
+
+  std::thread             worker;
+  std::atomic<bool>       stop{false};
+  std::atomic<bool>       drain{false};  // Write the reorder buffer across gaps
+  std::mutex              sync_mutex;    // Synchronous mode and sleeping
+  std::condition_variable cv_wake;
+
+  // Reorder buffer, owned by the writer thread (synchronous mode: sync_mutex)
+  std::map<int, std::unique_ptr<MEventRecord>> pending;
+  int                                          next_number = 0;
+
+  // Writer thread failure
+  std::atomic<bool>  failed{false};
+  std::exception_ptr error = nullptr;
+
+  // Statistics
+  std::atomic<unsigned long> n_pushed{0};
+  std::atomic<unsigned long> n_written{0};
+  std::atomic<unsigned long> n_batches{0};
+  std::atomic<unsigned long> n_stalls{0};
+  std::atomic<unsigned long> n_stall_ns{0};
+  std::atomic<unsigned long> n_maxdepth{0};
+};
+
+}  // namespace gra
+
+#endif
@@ -10,7 +10,11 @@
 #include <limits.h>
 #include <unistd.h>
 #include <complex>
+#include <cstdint>
+#include <functional>
+#include <istream>
 #include <mutex>
+#include <ostream>
 #include <random>
 #include <regex>
 #include <sstream>
@@ -125,6 +129,55 @@ std::string        SystemName();
 std::string        HostName();
 const std::string  DateTime();
 
+// Write a file via a temporary file and rename, so that concurrent readers
+// never see a partial file. Throws std::invalid_argument on IO errors
+void WriteFileAtomic(const std::string &filename, const std::function<void(std::ostream &)> &write);
+
+// Binary IO of trivially copyable values, strings and vectors with a 64-bit
+// length prefix. Read errors throw std::runtime_error, stored lengths are
+// checked against the bytes left in the stream before any allocation
+constexpr std::uint64_t BINARY_MAXLEN = 1ULL << 32;  // Limit for unseekable streams
+
+std::uint64_t BinaryRemaining(std::istream &f);
+
+template <typename T>
+void BinaryPut(std::ostream &f, const T &x) {
+  f.write(reinterpret_cast<const char *>(&x), sizeof(T));
+}
+template <typename T>
+void BinaryPutArray(std::ostream &f, const std::vector<T> &v) {
+  f.write(reinterpret_cast<const char *>(v.data()), v.size() * sizeof(T));
+}
+template <typename T>
+void BinaryPutVector(std::ostream &f, const std::vector<T> &v) {
+  BinaryPut(f, static_cast<std::uint64_t>(v.size()));
+  BinaryPutArray(f, v);
+}
+inline void BinaryPutString(std::ostream &f, const std::string &s) {
+  BinaryPut(f, static_cast<std::uint64_t>(s.size()));
+  f.write(s.data(), s.size());
+}
+
+template <typename T>
+void BinaryGet(std::istream &f, T &x) {
+  f.read(reinterpret_cast<char *>(&x), sizeof(T));
+  if (!f) { throw std::runtime_error("unexpected end of file"); }
+}
+template <typename T>
+void BinaryGetArray(std::istream &f, std::vector<T> &v, std::uint64_t n) {
+  if (n > BinaryRemaining(f) / sizeof(T)) { throw std::runtime_error("corrupted array length"); }
+  v.resize(n);
+  f.read(reinterpret_cast<char *>(v.data()), n * sizeof(T));
+  if (!f) { throw std::runtime_error("unexpected end of file"); }
+}
+template <typename T>
+void BinaryGetVector(std::istream &f, std::vector<T> &v) {
+  std::uint64_t n = 0;
+  BinaryGet(f, n);
+  BinaryGetArray(f, v, n);
+}
+void BinaryGetString(std::istream &f, std::string &s);
+
 // Progress bar
 void PrintProgress(double ratio);
 void ClearProgress();
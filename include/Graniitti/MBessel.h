@@ -0,0 +1,46 @@
+// Batched Bessel function kernels for Fourier-Bessel integrals
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+#ifndef MBESSEL_H
+#define MBESSEL_H
+
+// C++
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace gra {
+namespace math {
+
+// Bessel J0(x[i]) -> y[i], i = 0,...,n-1
+//
+// Same polynomial approximation as the scalar BESSJ0 (extmath.hpp),
+// evaluated branch-free so that it vectorizes (AVX-512, AVX2, scalar fallback
+// chosen at runtime).
+void BESSJ0Batch(const double *x, double *y, std::size_t n);
+
+// Sum_i J0(b * x[i]) * (re[i] + i im[i])
+std::complex<double> J0Sum(double b, const double *x, const double *re, const double *im,
+                           std::size_t n);
+
+// Precomputed Fourier-Bessel integrand in structure-of-arrays format,
+// with Simpson weights and all constant factors included in (re,im)
+struct FBKernel {
+  std::vector<double> x;
+  std::vector<double> re;
+  std::vector<double> im;
+
+  bool Empty() const { return x.empty(); }
+
+  // Integral \int dx f(x) J0(b x) ~= Sum_i J0(b x_i) w_i f(x_i)
+  std::complex<double> Integral(double b) const {
+    return J0Sum(b, x.data(), re.data(), im.data(), x.size());
+  }
+};
+
+}  // namespace math
+}  // namespace gra
+
+#endif
@@ -90,6 +90,11 @@ class MCWSUM {
     wintsum += weight * x.Integral();
     error2sum += (weight * weight) * x.IntegralError2();
   }
+  void Add(const MCWSUM &other) {
+    wsum += other.wsum;
+    wintsum += other.wintsum;
+    error2sum += other.error2sum;
+  }
   double Integral() const {
     if (wsum > 0.0) {
       return wintsum / wsum;
@@ -106,6 +111,18 @@ class MCWSUM {
   }
   double IntegralError() const { return gra::math::msqrt(IntegralError2()); }
 
+  // Raw sums (for checkpointing)
+  void GetSums(double &w, double &wint, double &err2) const {
+    w    = wsum;
+    wint = wintsum;
+    err2 = error2sum;
+  }
+  void SetSums(double w, double wint, double err2) {
+    wsum      = w;
+    wintsum   = wint;
+    error2sum = err2;
+  }
+
  private:
   // \sum_i weight_i
   double wsum = 0.0;
@@ -0,0 +1,90 @@
+// VEGAS integration checkpoint
+//
+// Binary, versioned snapshot of the adapted VEGAS grid, the integral
+// statistics, the weight maximum, the phase space weight sums and the
+// histogram bounds, keyed by a hash
+// of the process, cuts, model parameters and numerics. Generation jobs
+// with a matching hash skip the integration phase.
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+#ifndef MCHECKPOINT_H
+#define MCHECKPOINT_H
+
+// C++
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gra {
+
+// Adaptive histogram bounds
+struct MCheckpointHist {
+  std::string name;
+  int         dim   = 1;
+  int         xbins = 0;
+  double      xmin  = 0.0;
+  double      xmax  = 0.0;
+  int         ybins = 0;
+  double      ymin  = 0.0;
+  double      ymax  = 0.0;
+};
+
+struct MVEGASCheckpoint {
+  static constexpr char          MAGIC[8] = {'G', 'R', 'A', 'V', 'E', 'G', 'A', 'S'};
+  static constexpr std::uint32_t VERSION  = 2;
+
+  std::uint32_t version   = 0;
+  std::uint64_t hash      = 0;    // Hash of the key string
+  std::string   key;              // Key string (process, cuts, model, numerics)
+  std::string   created;          // Date and time of writing
+  double        generator = 0.0;  // Generator version
+
+  // VEGAS grid
+  std::uint32_t       FDIM  = 0;
+  std::uint32_t       BINS  = 0;
+  std::uint32_t       NCALL = 0;
+  std::vector<double> region;  // [2 x FDIM]
+  std::vector<double> xmat;    // [BINS x FDIM] row-major
+
+  // VEGAS integral data
+  double sumdata = 0.0;
+  double sumchi2 = 0.0;
+  double sweight = 0.0;
+
+  // Integral statistics
+  double sigma         = 0.0;
+  double sigma_err     = 0.0;
+  double chi2          = 0.0;
+  double maxf          = 0.0;
+  double maxW          = 0.0;
+  double evaluations   = 0.0;
+  double amplitude_ok  = 0.0;
+  double kinematics_ok = 0.0;
+  double fidcuts_ok    = 0.0;
+  double vetocuts_ok   = 0.0;
+
+  // Decay tree phase space weights {W, W2, N} in depth-first order
+  std::vector<double> decayW;
+
+  // Phase space weight sums {wsum, wintsum, error2sum}
+  double DW_sum[3]       = {0.0, 0.0, 0.0};
+  double DW_sum_exact[3] = {0.0, 0.0, 0.0};
+
+  // Histogram bounds
+  std::vector<MCheckpointHist> hist;
+
+  // Write atomically (temporary file + rename)
+  void Write(const std::string &filename) const;
+
+  // Returns false if the file does not exist or is not a valid checkpoint
+  bool Read(const std::string &filename);
+
+  // Print the content summary
+  void Print(bool grid = false) const;
+};
+
+}  // namespace gra
+
+#endif
@@ -0,0 +1,139 @@
+// Columnar binary event file
+//
+// Events are stored in chunks of plain arrays (one array per particle,
+// vertex and event quantity), written and read back with one block IO
+// operation per array. Mother-daughter relations are kept as production
+// and end vertex indices, as in MEventRecord, so the conversion is
+// lossless. The file header carries the run information, the cross
+// section and a hash of the steering card. The final event count and cross
+// section are also in the end record, for non-seekable (compressed) output.
+//
+// Layout (native byte order):
+//   MAGIC | VERSION | events | xs | xs_err | cardhash | beams | strings
+//   CHNK  | counts  | event arrays | particle arrays | vertex arrays | weights
+//   ...
+//   END!  | events | xs | xs_err
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+#ifndef MCOLUMNAR_H
+#define MCOLUMNAR_H
+
+// C++
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Own
+#include "Graniitti/MCompress.h"
+#include "Graniitti/MEventRecord.h"
+#include "Graniitti/MEventWriter.h"
+
+namespace gra {
+
+// Run information
+struct MColumnarHeader {
+  static constexpr char          MAGIC[8] = {'G', 'R', 'A', 'C', 'O', 'L', 'M', 'N'};
+  static constexpr std::uint32_t VERSION  = 1;
+
+  std::uint32_t version  = VERSION;
+  std::uint64_t events   = 0;    // Number of events (updated when closing)
+  double        xs       = 0.0;  // Cross section (pb, updated when closing)
+  double        xs_err   = 0.0;
+  std::uint64_t cardhash = 0;    // Hash of the steering card content
+  std::int32_t  beam1    = 2212;
+  std::int32_t  beam2    = 2212;
+  double        E1       = 0.0;  // Beam energies (GeV)
+  double        E2       = 0.0;
+  std::string   generator;       // Free text
+  std::string   card;            // Steering card name
+};
+
+// One chunk of events, column by column
+struct MColumnarChunk {
+  // Event columns
+  std::vector<std::int32_t>  number;
+  std::vector<std::uint32_t> np;  // Number of particles
+  std::vector<std::uint32_t> nv;  // Number of vertices
+  std::vector<std::uint32_t> nw;  // Number of weights
+  std::vector<double>        xs;  // Cross section (pb)
+  std::vector<double>        xs_err;
+
+  // Particle columns (vertex indices are local to the event)
+  std::vector<std::int32_t> pdg;
+  std::vector<std::int32_t> status;
+  std::vector<std::int32_t> prod;
+  std::vector<std::int32_t> end;
+  std::vector<double>       px;
+  std::vector<double>       py;
+  std::vector<double>       pz;
+  std::vector<double>       e;
+  std::vector<double>       m;
+
+  // Vertex columns (mm)
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> z;
+  std::vector<double> t;
+
+  // Weight column
+  std::vector<double> w;
+
+  // Offsets of the first particle, vertex and weight of each event [N+1]
+  std::vector<std::size_t> p0 = {0};
+  std::vector<std::size_t> v0 = {0};
+  std::vector<std::size_t> w0 = {0};
+
+  std::size_t NEvents() const { return number.size(); }
+
+  void Clear();
+  void Append(const MEventRecord &evt);
+  void GetEvent(std::size_t k, MEventRecord &evt) const;
+  void Index();  // Recompute the offsets from the counts
+
+  // First and last mother (event local particle index, -1 for none)
+  void Mothers(std::size_t k, std::size_t i, int &m1, int &m2) const;
+};
+
+// Writer
+class MWriterColumnar : public MEventWriter {
+ public:
+  MWriterColumnar(std::ostream &os, const MColumnarHeader &header, std::size_t chunksize = 1000);
+  ~MWriterColumnar() { Close(); }
+  void Write(const MEventRecord &evt);
+  void Close();
+
+ private:
+  void WriteChunk();
+
+  std::ostream &  out;
+  MColumnarHeader head;
+  MColumnarChunk  chunk;
+  std::size_t     CHUNKSIZE = 1000;
+  std::streamoff  headpos   = -1;  // Position of the updated header fields
+  bool            closed    = false;
+};
+
+// Reader
+class MReaderColumnar {
+ public:
+  explicit MReaderColumnar(const std::string &filename);
+
+  const MColumnarHeader &Header() const { return head; }
+
+  // Returns false at the end of file
+  bool ReadChunk(MColumnarChunk &chunk);
+  bool ReadEvent(MEventRecord &evt);
+
+ private:
+  MInputStream    in;  // gzip compressed files are read transparently
+  MColumnarHeader head;
+  MColumnarChunk  buffer;
+  std::size_t     cursor = 0;
+};
+
+}  // namespace gra
+
+#endif
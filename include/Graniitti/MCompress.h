@@ -0,0 +1,161 @@
+// Block compressed output and transparently decompressed input streams
+//
+// The output stream cuts the byte stream into fixed size blocks, which are
+// compressed independently by worker threads and appended to the file in
+// order. With gzip each block is a complete gzip member, and a sequence of
+// members is a valid gzip file (RFC 1952), readable by gunzip, zcat etc.
+//
+// Codecs implement the MCodec interface, MakeCodec is the factory.
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+#ifndef MCOMPRESS_H
+#define MCOMPRESS_H
+
+// C++
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gra {
+
+// Codec interface
+class MCodec {
+ public:
+  virtual ~MCodec() {}
+
+  virtual std::string Name() const      = 0;
+  virtual std::string Extension() const = 0;  // File name suffix, e.g. ".gz"
+
+  // Compress one block into an independently decodable unit (thread safe)
+  virtual void Compress(const char *in, std::size_t n, std::string &out) const = 0;
+};
+
+// gzip via zlib
+class MCodecGzip : public MCodec {
+ public:
+  explicit MCodecGzip(int level = 6);
+
+  std::string Name() const { return "gzip:" + std::to_string(LEVEL); }
+  std::string Extension() const { return ".gz"; }
+  void        Compress(const char *in, std::size_t n, std::string &out) const;
+
+ private:
+  int LEVEL = 6;
+};
+
+// Codec by name: "gzip" or "gzip:<level 1-9>", nullptr for "none"
+std::shared_ptr<MCodec> MakeCodec(const std::string &name);
+
+// Output stream buffer with parallel block compression
+class MCompressBuf : public std::streambuf {
+ public:
+  // threads = 0 compresses in the calling thread
+  MCompressBuf(std::ostream &sink, std::shared_ptr<MCodec> codec, unsigned int threads,
+               std::size_t blocksize = 1 << 22);
+  ~MCompressBuf();
+
+  // Compress and write all remaining data, stop the workers
+  void Finish();
+
+ protected:
+  int_type        overflow(int_type c);
+  std::streamsize xsputn(const char *s, std::streamsize n);
+
+ private:
+  // Copy and assignment disabled
+  MCompressBuf(const MCompressBuf &);
+  MCompressBuf &operator=(const MCompressBuf &);
+
+  struct Block {
+    std::string        raw;
+    std::string        packed;
+    bool               done  = false;
+    std::exception_ptr error = nullptr;
+  };
+
+  void Submit();                // Hand the current block to the workers
+  void WriteDone(bool all);     // Write finished blocks in order
+  void WorkerLoop();
+
+  std::ostream &          sink;
+  std::shared_ptr<MCodec> codec;
+  const std::size_t       BLOCKSIZE;
+  const std::size_t       MAXINFLIGHT;
+  std::string             buffer;
+  bool                    finished = false;
+
+  std::vector<std::thread>           workers;
+  std::deque<std::shared_ptr<Block>> todo;      // Waiting for a worker
+  std::deque<std::shared_ptr<Block>> inflight;  // Not yet written, in file order
+  std::mutex                         mtx;
+  std::condition_variable            cv_task;
+  std::condition_variable            cv_done;
+  bool                               stop = false;
+};
+
+// Output stream with parallel block compression
+class MCompressStream : public std::ostream {
+ public:
+  MCompressStream(std::ostream &sink, std::shared_ptr<MCodec> codec, unsigned int threads)
+      : std::ostream(nullptr), buf(sink, codec, threads) {
+    rdbuf(&buf);
+  }
+  void Finish() {
+    flush();
+    buf.Finish();
+  }
+
+ private:
+  MCompressBuf buf;
+};
+
+// Input stream buffer decompressing (multi-member) gzip
+class MDecompressBuf : public std::streambuf {
+ public:
+  explicit MDecompressBuf(std::istream &source);
+  ~MDecompressBuf();
+
+ protected:
+  int_type underflow();
+
+ private:
+  // Copy and assignment disabled
+  MDecompressBuf(const MDecompressBuf &);
+  MDecompressBuf &operator=(const MDecompressBuf &);
+
+  std::istream &    src;
+  std::vector<char> in;
+  std::vector<char> out;
+  void *            zs  = nullptr;  // z_stream
+  bool              eof = false;
+};
+
+// Input file, gzip content is decompressed transparently (detected from
+// the magic bytes, not from the file name)
+class MInputStream : public std::istream {
+ public:
+  explicit MInputStream(const std::string &filename);
+
+  bool IsOpen() const { return file.is_open(); }
+  bool Compressed() const { return zbuf != nullptr; }
+
+ private:
+  std::ifstream                   file;
+  std::unique_ptr<MDecompressBuf> zbuf = nullptr;
+};
+
+}  // namespace gra
+
+#endif
@@ -33,7 +33,7 @@ class MContinuum : public MProcess {
     return EventWeight(randvec, aux);
   }
   double EventWeight(const std::vector<double> &randvec, AuxIntData &aux);
-  bool   EventRecord(HepMC3::GenEvent &evt);
+  bool   EventRecord(MEventRecord &evt);
   void   PrintInit(bool silent) const;
 
  private:
@@ -55,6 +55,14 @@ class MContinuum : public MProcess {
 
   // Auxialary (kt) vectors
   std::vector<M4Vec> pkt_;
+
+  // Kinematics buffers (re-used between events, no heap traffic per event)
+  std::vector<M4Vec>  p_;
+  std::vector<double> kt_;
+  std::vector<double> phi_;
+  std::vector<double> y_;
+  std::vector<double> mvec_;
+  std::vector<double> rvec_;
 };
 
 }  // namespace gra
@@ -0,0 +1,270 @@
+// Adaptive 2D cubature with an embedded rule error estimate
+//
+// Vector valued (complex) integrand over a rectangle. Degree 7 Genz-Malik
+// rule with the embedded degree 5 rule as the error estimate (17 points per
+// region), global subdivision of the region with the largest error along the
+// axis with the largest fourth difference.
+//
+// [REFERENCE: Genz, Malik, An adaptive algorithm for numerical integration over
+//  an N-dimensional rectangular region, J. Comput. Appl. Math. 6, 1980]
+// [REFERENCE: Berntsen, Espelid, Genz, An adaptive algorithm for the approximate
+//  calculation of multiple integrals, ACM TOMS 17, 1991]
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+#ifndef MCUBATURE_H
+#define MCUBATURE_H
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace gra {
+namespace math {
+
+class MCubature2D {
+ public:
+  MCubature2D() {}
+  ~MCubature2D() {}
+
+  // Integrand calls per region
+  static constexpr unsigned int NRULE = 17;
+
+  // Integrate f(x, y, out) over [a0,b0] x [a1,b1], where f writes dim values to out.
+  //
+  // Starts from N0 x N1 regions and subdivides until the summed error estimate
+  // is below max(reltol x sum_d |I_d|, abstol), or the next subdivision
+  // would exceed maxcalls.
+  //
+  // Returns the number of integrand calls
+  template <typename F>
+  unsigned int Integrate(F &&f, std::size_t dim, double a0, double b0, double a1, double b1,
+                         unsigned int N0, unsigned int N1, double reltol, double abstol,
+                         unsigned int maxcalls, std::vector<std::complex<double>> &result,
+                         double &error) {
+    DIM = dim;
+    regions.clear();
+    values.clear();
+    out.resize(dim);
+    f0.resize(dim);
+    s2.resize(dim);
+    s3.resize(dim);
+    s4.resize(dim);
+    s5.resize(dim);
+    d2.resize(2 * dim);
+    d3.resize(2 * dim);
+
+    N0 = std::max(1u, N0);
+    N1 = std::max(1u, N1);
+
+    const double h0 = (b0 - a0) / (2.0 * N0);
+    const double h1 = (b1 - a1) / (2.0 * N1);
+
+    unsigned int calls = 0;
+
+    // Initial regions
+    for (std::size_t i = 0; i < N0; ++i) {
+      for (std::size_t j = 0; j < N1; ++j) {
+        Region R;
+        R.c[0] = a0 + (2 * i + 1) * h0;
+        R.c[1] = a1 + (2 * j + 1) * h1;
+        R.h[0] = h0;
+        R.h[1] = h1;
+        R.slot = regions.size();
+        values.resize(values.size() + dim);
+        Rule(f, R);
+        calls += NRULE;
+        regions.push_back(R);
+      }
+    }
+    std::make_heap(regions.begin(), regions.end());
+
+    while (true) {
+      Sum(result, error);
+
+      double norm = 0.0;
+      for (const auto &v : result) { norm += std::abs(v); }
+      if (error <= std::max(reltol * norm, abstol)) { break; }
+      if (calls + 2 * NRULE > maxcalls) { break; }
+
+      // Split the worst region into two halves, first re-uses its slot
+      std::pop_heap(regions.begin(), regions.end());
+      Region R = regions.back();
+      regions.pop_back();
+
+      const unsigned int k = R.split;
+      R.h[k] *= 0.5;
+
+      Region A = R;
+      Region B = R;
+      A.c[k] -= R.h[k];
+      B.c[k] += R.h[k];
+      B.slot = values.size() / dim;
+      values.resize(values.size() + dim);
+
+      Rule(f, A);
+      Rule(f, B);
+      calls += 2 * NRULE;
+
+      regions.push_back(A);
+      std::push_heap(regions.begin(), regions.end());
+      regions.push_back(B);
+      std::push_heap(regions.begin(), regions.end());
+    }
+
+    return calls;
+  }
+
+  // Number of regions after the last call
+  std::size_t GetRegions() const { return regions.size(); }
+
+ private:
+  struct Region {
+    double       c[2]  = {0.0, 0.0};  // Center
+    double       h[2]  = {0.0, 0.0};  // Half-widths
+    double       err   = 0.0;         // Error estimate (sum over components)
+    std::size_t  slot  = 0;           // Integral estimate at values[slot x dim]
+    unsigned int split = 0;           // Axis to split next
+
+    bool operator<(const Region &other) const { return err < other.err; }
+  };
+
+  // Apply the degree 7/5 rule pair to region R
+  template <typename F>
+  void Rule(F &f, Region &R) {
+    // Generator points on [-1,1]^2
+    static const double L2 = std::sqrt(9.0 / 70.0);
+    static const double L4 = std::sqrt(9.0 / 10.0);
+    static const double L5 = std::sqrt(9.0 / 19.0);
+
+    // Weights (n = 2)
+    const double W1 = -3816.0 / 19683.0;
+    const double W2 = 980.0 / 6561.0;
+    const double W3 = 1020.0 / 19683.0;
+    const double W4 = 200.0 / 19683.0;
+    const double W5 = 6859.0 / 19683.0 / 4.0;
+
+    const double E1 = -971.0 / 729.0;
+    const double E2 = 245.0 / 486.0;
+    const double E3 = 65.0 / 1458.0;
+    const double E4 = 25.0 / 729.0;
+
+    // Fourth difference ratio (L2/L4)^2
+    const double RATIO = 1.0 / 7.0;
+
+    std::fill(s2.begin(), s2.end(), 0.0);
+    std::fill(s3.begin(), s3.end(), 0.0);
+    std::fill(s4.begin(), s4.end(), 0.0);
+    std::fill(s5.begin(), s5.end(), 0.0);
+    std::fill(d2.begin(), d2.end(), 0.0);
+    std::fill(d3.begin(), d3.end(), 0.0);
+
+    const double x = R.c[0];
+    const double y = R.c[1];
+    const double u = R.h[0];
+    const double v = R.h[1];
+
+    // Center
+    f(x, y, out.data());
+    for (std::size_t d = 0; d < DIM; ++d) { f0[d] = out[d]; }
+
+    // Axis points
+    const double a2[2] = {L2, -L2};
+    const double a4[2] = {L4, -L4};
+    for (std::size_t s = 0; s < 2; ++s) {
+      f(x + a2[s] * u, y, out.data());
+      for (std::size_t d = 0; d < DIM; ++d) {
+        s2[d] += out[d];
+        d2[d] += out[d];
+      }
+      f(x, y + a2[s] * v, out.data());
+      for (std::size_t d = 0; d < DIM; ++d) {
+        s2[d] += out[d];
+        d2[DIM + d] += out[d];
+      }
+      f(x + a4[s] * u, y, out.data());
+      for (std::size_t d = 0; d < DIM; ++d) {
+        s3[d] += out[d];
+        d3[d] += out[d];
+      }
+      f(x, y + a4[s] * v, out.data());
+      for (std::size_t d = 0; d < DIM; ++d) {
+        s3[d] += out[d];
+        d3[DIM + d] += out[d];
+      }
+    }
+
+    // Diagonal points
+    for (std::size_t s = 0; s < 2; ++s) {
+      for (std::size_t t = 0; t < 2; ++t) {
+        f(x + a4[s] * u, y + a4[t] * v, out.data());
+        for (std::size_t d = 0; d < DIM; ++d) { s4[d] += out[d]; }
+
+        f(x + (s == 0 ? L5 : -L5) * u, y + (t == 0 ? L5 : -L5) * v, out.data());
+        for (std::size_t d = 0; d < DIM; ++d) { s5[d] += out[d]; }
+      }
+    }
+
+    // Integral estimates and error
+    const double VOL = 4.0 * u * v;
+    R.err            = 0.0;
+    for (std::size_t d = 0; d < DIM; ++d) {
+      const std::complex<double> I7 =
+          VOL * (W1 * f0[d] + W2 * s2[d] + W3 * s3[d] + W4 * s4[d] + W5 * s5[d]);
+      const std::complex<double> I5 = VOL * (E1 * f0[d] + E2 * s2[d] + E3 * s3[d] + E4 * s4[d]);
+
+      values[R.slot * DIM + d] = I7;
+      R.err += std::abs(I7 - I5);
+    }
+
+    // Axis with the largest fourth difference (wider axis if equal)
+    double diff[2] = {0.0, 0.0};
+    for (std::size_t k = 0; k < 2; ++k) {
+      for (std::size_t d = 0; d < DIM; ++d) {
+        const std::complex<double> D2 = d2[k * DIM + d] - 2.0 * f0[d];
+        const std::complex<double> D3 = d3[k * DIM + d] - 2.0 * f0[d];
+        diff[k] += std::abs(D2 - RATIO * D3);
+      }
+    }
+    if (diff[0] == diff[1]) {
+      R.split = (u >= v) ? 0 : 1;
+    } else {
+      R.split = (diff[0] > diff[1]) ? 0 : 1;
+    }
+  }
+
+  // Total integral and error over all regions
+  void Sum(std::vector<std::complex<double>> &result, double &error) const {
+    result.assign(DIM, 0.0);
+    error = 0.0;
+    for (const auto &R : regions) {
+      for (std::size_t d = 0; d < DIM; ++d) { result[d] += values[R.slot * DIM + d]; }
+      error += R.err;
+    }
+  }
+
+  std::size_t DIM = 0;
+
+  // Region heap and integral estimates (re-used between calls)
+  std::vector<Region>               regions;
+  std::vector<std::complex<double>> values;
+
+  // Rule buffers
+  std::vector<std::complex<double>> out;
+  std::vector<std::complex<double>> f0;
+  std::vector<std::complex<double>> s2;
+  std::vector<std::complex<double>> s3;
+  std::vector<std::complex<double>> s4;
+  std::vector<std::complex<double>> s5;
+  std::vector<std::complex<double>> d2;
+  std::vector<std::complex<double>> d3;
+};
+
+}  // namespace math
+}  // namespace gra
+
+#endif
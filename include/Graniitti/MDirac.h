@@ -16,6 +16,7 @@
 #include "Graniitti/MKinematics.h"
 #include "Graniitti/MMath.h"
 #include "Graniitti/MMatrix.h"
+#include "Graniitti/MSpinor.h"
 
 // FTensor
 #include "FTensor.hpp"
@@ -35,8 +36,7 @@ class MDirac {
   FTensor::Tensor2<std::complex<double>, 4, 4> EpsMassiveSpin2(const M4Vec &k, int m) const;
 
   // Spin/spinor state collectors
-  std::array<std::vector<std::complex<double>>, 2>         SpinorStates(const M4Vec &      p,
-                                                                        const std::string &type) const;
+  std::array<DSpinor, 2> SpinorStates(const M4Vec &p, const std::string &type) const;
   std::array<FTensor::Tensor1<std::complex<double>, 4>, 2> MasslessSpin1States(
       const M4Vec &p, const std::string &type, bool INDEX_UP = true) const;
   std::array<FTensor::Tensor1<std::complex<double>, 4>, 3> MassiveSpin1States(
@@ -44,37 +44,37 @@ class MDirac {
 
   // Helicity spinors
   std::vector<std::complex<double>> XiSpinor(const M4Vec &p, int helicity) const;
-  std::vector<std::complex<double>> uHelChiral(const M4Vec &p, int helicity) const;
-  std::vector<std::complex<double>> vHelChiral(const M4Vec &p, int helicity) const;
+  DSpinor uHelChiral(const M4Vec &p, int helicity) const;
+  DSpinor vHelChiral(const M4Vec &p, int helicity) const;
 
-  std::vector<std::complex<double>> uHelDirac(const M4Vec &p, int helicity) const;
-  std::vector<std::complex<double>> vHelDirac(const M4Vec &p, int helicity) const;
+  DSpinor uHelDirac(const M4Vec &p, int helicity) const;
+  DSpinor vHelDirac(const M4Vec &p, int helicity) const;
 
   // Dirac adjoint
-  std::vector<std::complex<double>> Bar(const std::vector<std::complex<double>> &spinor) const;
+  DSpinor Bar(const DSpinor &spinor) const;
 
   // Feynman slash matrix operator
-  MMatrix<std::complex<double>> FSlash(const M4Vec &a) const;
+  DMatrix FSlash(const M4Vec &a) const;
 
   // Propagators
   FTensor::Tensor2<std::complex<double>, 4, 4> iD_y(const double q2) const;
-  MMatrix<std::complex<double>>                iD_F(const M4Vec &q, double m) const;
+  DMatrix                                      iD_F(const M4Vec &q, double m) const;
 
   // Dirac spinors
-  std::vector<std::complex<double>> uDirac(const M4Vec &p, int spin) const;
-  std::vector<std::complex<double>> vDirac(const M4Vec &p, int spin) const;
+  DSpinor uDirac(const M4Vec &p, int spin) const;
+  DSpinor vDirac(const M4Vec &p, int spin) const;
 
   // Spinor-Helicity style methods
-  std::complex<double>              sProd(const M4Vec &p1, const M4Vec &p2, int helicity) const;
-  std::vector<std::complex<double>> uGauge(const M4Vec &p, int helicity) const;
-  std::vector<std::complex<double>> vGauge(const M4Vec &p, int helicity) const;
+  std::complex<double> sProd(const M4Vec &p1, const M4Vec &p2, int helicity) const;
+  DSpinor              uGauge(const M4Vec &p, int helicity) const;
+  DSpinor              vGauge(const M4Vec &p, int helicity) const;
 
   // Charge conjugate operator
-  MMatrix<std::complex<double>> C_up() const;
+  DMatrix C_up() const;
 
   // Right and left chiral projectors
-  MMatrix<std::complex<double>> PR() const;
-  MMatrix<std::complex<double>> PL() const;
+  DMatrix PR() const;
+  DMatrix PL() const;
 
   // Angular Momentum operators
   MMatrix<std::complex<double>> J_operator(unsigned int i) const;
@@ -102,11 +102,10 @@ class MDirac {
   //
   // S = 1/\sqrt{2}(1 + y^5y^0)
   //
-  MMatrix<std::complex<double>> S_basis = {
-      std::vector<std::complex<double>>{1.0 / std::sqrt(2.0), 0.0, 1.0 / std::sqrt(2.0), 0.0},
-      std::vector<std::complex<double>>{0.0, 1.0 / std::sqrt(2.0), 0.0, 1.0 / std::sqrt(2.0)},
-      std::vector<std::complex<double>>{1.0 / std::sqrt(2.0), 0.0, -1.0 / std::sqrt(2.0), 0.0},
-      std::vector<std::complex<double>>{0.0, 1.0 / std::sqrt(2.0), 0.0, -1.0 / std::sqrt(2.0)}};
+  DMatrix S_basis = {{1.0 / std::sqrt(2.0), 0.0, 1.0 / std::sqrt(2.0), 0.0},
+                     {0.0, 1.0 / std::sqrt(2.0), 0.0, 1.0 / std::sqrt(2.0)},
+                     {1.0 / std::sqrt(2.0), 0.0, -1.0 / std::sqrt(2.0), 0.0},
+                     {0.0, 1.0 / std::sqrt(2.0), 0.0, -1.0 / std::sqrt(2.0)}};
 
   // Pauli matrices
   MMatrix<std::complex<double>> sigma_x = {std::vector<std::complex<double>>{0.0, 1.0},
@@ -118,13 +117,13 @@ class MDirac {
   MMatrix<std::complex<double>> sigma_z = {std::vector<std::complex<double>>{1.0, 0.0},
                                            std::vector<std::complex<double>>{0.0, 1.0}};
 
-  // Contravariant (up) and covariant (lo) gamma matrix set
-  std::vector<MMatrix<std::complex<double>>> gamma_up;
-  std::vector<MMatrix<std::complex<double>>> gamma_lo;
+  // Contravariant (up) and covariant (lo) gamma matrix set [0,1,2,3 and 5 at index 4]
+  std::array<DMatrix, 5> gamma_up;
+  std::array<DMatrix, 5> gamma_lo;
 
   // Contravariant (up) and covariant (lo) \sigma_{\mu\nu} matrices
-  std::vector<std::vector<MMatrix<std::complex<double>>>> sigma_up;
-  std::vector<std::vector<MMatrix<std::complex<double>>>> sigma_lo;
+  std::array<std::array<DMatrix, 4>, 4> sigma_up;
+  std::array<std::array<DMatrix, 4>, 4> sigma_lo;
 
   // Indices etc.
   std::vector<std::size_t> LI          = {0, 1, 2, 3};
@@ -134,7 +133,7 @@ class MDirac {
   MMatrix<double> g = MMatrix<double>(4, 4, "minkowski");
 
   // Identity matrix
-  MMatrix<std::complex<double>> I4 = MMatrix<std::complex<double>>(4, 4, "eye");
+  DMatrix I4 = DMatrix::Identity();
 
  protected:
   std::string BASIS = "";  // D for Dirac, C for Chiral
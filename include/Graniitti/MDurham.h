@@ -17,6 +17,7 @@
 #include "Graniitti/MAux.h"
 #include "Graniitti/MGlobals.h"
 #include "Graniitti/MKinematics.h"
+#include "Graniitti/MMatrix.h"
 #include "Graniitti/MSudakov.h"
 
 
@@ -81,8 +82,13 @@ class MDurham : public MAmplitudes {
   MDurham(gra::LORENTZSCALAR &lts, const std::string &modelfile);
   ~MDurham() {}
 
-  double      DurhamQCD(gra::LORENTZSCALAR &lts, const std::string &process);
-  double      DQtloop(gra::LORENTZSCALAR &lts, std::vector<std::vector<std::complex<double>>> Amp);
+  // Subprocesses
+  enum class DPROC { GG, QQBAR, MMBAR, CHIC0, FLUX };
+  static DPROC GetProcess(const std::string &process);
+
+  double      DurhamQCD(gra::LORENTZSCALAR &lts, DPROC process);
+  double      DQtloop(gra::LORENTZSCALAR &                                 lts,
+                      const std::vector<std::vector<std::complex<double>>> &Amp);
   inline void DScaleChoise(double qt2, double q1_2, double q2_2, double &Q1_2_scale,
                            double &Q2_2_scale) const;
 
@@ -92,6 +98,8 @@ class MDurham : public MAmplitudes {
 
   inline void DHelicity(const std::vector<double> &q1, const std::vector<double> &q2,
                         std::vector<std::complex<double>> &JzP) const;
+  inline void DHelicity(const double *q1, const double *q2,
+                        std::vector<std::complex<double>> &JzP) const;
 
   inline std::complex<double> DHelProj(const std::vector<std::complex<double>> &A,
                                        const std::vector<std::complex<double>> &JzP) const;
@@ -112,6 +120,23 @@ class MDurham : public MAmplitudes {
  private:
   // Parameters
   MDurhamParam Param;
+
+  // Qt-loop node table (flat index i x (N_phi+1) + j), built once
+  void                DInitLoopTable();
+  std::vector<double> loop_qtx;
+  std::vector<double> loop_qty;
+  MMatrix<double>     WSimpson;
+
+  // Per event buffers over the accepted loop nodes (re-used)
+  std::vector<std::size_t> loop_node;
+  std::vector<double>      loop_q;   // q1x, q1y, q2x, q2y
+  std::vector<double>      loop_qq;  // qt^2 x q1^2 x q2^2
+  std::vector<double>      loop_Q1;  // Pdf scales
+  std::vector<double>      loop_Q2;
+  std::vector<double>      loop_fg1;
+  std::vector<double>      loop_fg2;
+
+  std::vector<std::complex<double>> loop_JzP = std::vector<std::complex<double>>(4, 0.0);
 };
 
 }  // namespace gra
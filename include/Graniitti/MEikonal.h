@@ -8,10 +8,13 @@
 
 // C++
 #include <complex>
+#include <memory>
 #include <vector>
 
 // Own
 #include "Graniitti/M4Vec.h"
+#include "Graniitti/MArrayCache.h"
+#include "Graniitti/MBessel.h"
 #include "Graniitti/MForm.h"
 #include "Graniitti/MMath.h"
 #include "Graniitti/MMatrix.h"
@@ -41,9 +44,16 @@ struct MEikonalNumerics {
 
   double MaxLoopKT = 1.75;
 
+  bool CSV = false;  // Export arrays also as CSV text
+
   unsigned int NumberLoopKT  = 15;  // Number of kt steps  (default minimum)
   unsigned int NumberLoopPHI = 12;  // Number of phi steps (default minimum)
 
+  // Adaptive loop integration (instead of the fixed NumberLoopKT x NumberLoopPHI grid)
+  bool         LoopAdaptive = false;
+  double       LoopRelTol   = 1E-3;  // Relative tolerance (w.r.t. the Born amplitude)
+  unsigned int LoopMaxCalls = 2000;  // Maximum number of amplitude calls per loop integral
+
   // User setup (ND can be negative, to get below the default)
   void SetLoopDiscretization(int ND) {
     NumberLoopKT  = std::max(3, 3 * ND + (int)NumberLoopKT);
@@ -91,6 +101,47 @@ struct MEikonalNumerics {
           "ReadParameters: Error parsing " + inputfile + " (Check for extra/missing commas)";
       throw std::invalid_argument(str);
     }
+
+    // Optional
+    try {
+      CSV = j.at("NUMERICS_EIKONAL").at("CSV");
+    } catch (...) {
+      // Do nothing
+    }
+  }
+
+  // Read loop integration parameters from file (all optional)
+  void ReadLoopParameters() {
+    using json = nlohmann::json;
+
+    const std::string inputfile = gra::aux::GetBasePath(2) + "/modeldata/" + "NUMERICS.json";
+    const std::string data      = gra::aux::GetInputData(inputfile);
+    json              j;
+
+    try {
+      j = json::parse(data);
+    } catch (...) {
+      std::string str =
+          "ReadLoopParameters: Error parsing " + inputfile + " (Check for extra/missing commas)";
+      throw std::invalid_argument(str);
+    }
+
+    const std::string XID = "NUMERICS_EIKONAL";
+    try {
+      LoopAdaptive = j.at(XID).at("LoopAdaptive");
+    } catch (...) {
+      // Do nothing
+    }
+    try {
+      LoopRelTol = j.at(XID).at("LoopRelTol");
+    } catch (...) {
+      // Do nothing
+    }
+    try {
+      LoopMaxCalls = j.at(XID).at("LoopMaxCalls");
+    } catch (...) {
+      // Do nothing
+    }
   }
 };
 
@@ -157,12 +208,26 @@ class IArray1D {
     return str;
   }
 
-  bool                 WriteArray(const std::string &filename, bool overwrite) const;
-  bool                 ReadArray(const std::string &filename);
+  // Binary cache <filename>.bin, with optional CSV text <filename>.csv
+  bool WriteArray(const std::string &filename, bool overwrite, bool csv = false) const;
+  bool ReadArray(const std::string &filename);
+
+  // CSV text import/export
+  bool WriteArrayCSV(const std::string &filename, bool overwrite) const;
+  bool ReadArrayCSV(const std::string &filename);
+
   std::complex<double> Interpolate1D(double a) const;
 
   static const unsigned int X = 0;
   static const unsigned int Y = 1;
+
+ private:
+  MArrayHeader GetHeader() const;
+
+  // Read-only values [x, Re y, Im y] per grid point, shared between copies.
+  // D is resolved once by ReadArray, interpolation requires a successful ReadArray.
+  std::shared_ptr<const MArrayCache> cache = nullptr;
+  const double *                     D     = nullptr;
 };
 
 class MEikonal {
@@ -248,6 +313,12 @@ class MEikonal {
   bool S3INIT = false;
 
   void S3CalculateArray(IArray1D &add, std::complex<double> (MEikonal::*f)(double) const);
+
+  // Fourier-Bessel integrands, only kept during array construction
+  math::FBKernel S3DensityKernel() const;
+  math::FBKernel S3ScreeningKernel() const;
+  math::FBKernel DensityKernel;
+  math::FBKernel ScreeningKernel;
   void S3CalcXS();
   void S3InitCutPomerons();
 
@@ -0,0 +1,114 @@
+// Flat event record
+//
+// Particles and vertices in plain arrays, connected by indices, filled
+// directly by the processes and serialized by the MEventWriter classes
+// without building a HepMC3 object graph. Conversion to HepMC3::GenEvent
+// is available for external (user) HepMC3 writers.
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+#ifndef MEVENTRECORD_H
+#define MEVENTRECORD_H
+
+// C++
+#include <functional>
+#include <vector>
+
+// HepMC3
+#include "HepMC3/GenEvent.h"
+
+// Own
+#include "Graniitti/M4Vec.h"
+
+namespace gra {
+
+class MEventRecord {
+ public:
+  struct Particle {
+    double px = 0.0;
+    double py = 0.0;
+    double pz = 0.0;
+    double e  = 0.0;
+    double m  = 0.0;  // Generated mass
+    int    pdg    = 0;
+    int    status = 0;
+    int    prod   = -1;  // Production vertex index (-1 for none)
+    int    end    = -1;  // End vertex index (-1 for none)
+  };
+  struct Vertex {
+    double x   = 0.0;  // Position (mm)
+    double y   = 0.0;
+    double z   = 0.0;
+    double t   = 0.0;
+    int    nin = 0;  // Number of incoming particles
+    int    in1 = -1;  // Lowest incoming particle index
+
+    bool Zero() const { return x == 0.0 && y == 0.0 && z == 0.0 && t == 0.0; }
+  };
+
+  MEventRecord() {}
+
+  // Clear the content, keep the memory
+  void Clear() {
+    particles.clear();
+    vertices.clear();
+    weights.clear();
+    xs           = 0.0;
+    xs_err       = 0.0;
+    event_number = 0;
+  }
+
+  // Add particle, returns the index
+  int AddParticle(const M4Vec &p4, int pdg, int status) {
+    Particle p;
+    p.px     = p4.Px();
+    p.py     = p4.Py();
+    p.pz     = p4.Pz();
+    p.e      = p4.E();
+    p.m      = p4.M();
+    p.pdg    = pdg;
+    p.status = status;
+    particles.push_back(p);
+    return static_cast<int>(particles.size()) - 1;
+  }
+
+  // Add vertex at the 4-position (mm), returns the index
+  int AddVertex(const M4Vec &pos = M4Vec(0, 0, 0, 0)) {
+    Vertex v;
+    v.x = pos.X();
+    v.y = pos.Y();
+    v.z = pos.Z();
+    v.t = pos.T();
+    vertices.push_back(v);
+    return static_cast<int>(vertices.size()) - 1;
+  }
+
+  // Connect particle into / out from the vertex
+  void AddIn(int v, int p) {
+    particles[p].end = v;
+    if (vertices[v].nin == 0 || p < vertices[v].in1) { vertices[v].in1 = p; }
+    ++vertices[v].nin;
+  }
+  void AddOut(int v, int p) { particles[p].prod = v; }
+
+  // Conversion for HepMC3 writers and analysis hooks
+  void ToGenEvent(HepMC3::GenEvent &evt) const;
+  void FromGenEvent(const HepMC3::GenEvent &evt);
+
+  // Ancestry index in one pass over the vertex graph: for each particle, the
+  // OR of mask(p) over all its ancestors and over its direct parents
+  void AncestorMask(const std::function<unsigned int(const Particle &)> &mask,
+                    std::vector<unsigned int> &ancestors, std::vector<unsigned int> &parents) const;
+
+  std::vector<Particle> particles;
+  std::vector<Vertex>   vertices;
+  std::vector<double>   weights;
+  double                xs           = 0.0;  // Cross section (pb)
+  double                xs_err       = 0.0;  // Cross section error (pb)
+  int                   event_number = 0;
+};
+
+}  // namespace gra
+
+#endif
@@ -0,0 +1,128 @@
+// Event writers for the flat event record
+//
+// HepMC3 ASCII, HepMC2 (IO_GenEvent) and LHE text are formatted directly
+// from MEventRecord into a reused character buffer (std::to_chars number
+// conversion) and written with a single stream write per event.
+// MWriterGenEvent converts to HepMC3::GenEvent for any other HepMC3 writer.
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+#ifndef MEVENTWRITER_H
+#define MEVENTWRITER_H
+
+// C++
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// HepMC3
+#include "HepMC3/GenRunInfo.h"
+#include "HepMC3/Writer.h"
+
+// Own
+#include "Graniitti/MEventRecord.h"
+
+namespace gra {
+
+// Text buffer with fast number formatting
+class MTextBuffer {
+ public:
+  MTextBuffer() { buf.reserve(1 << 14); }
+
+  void Clear() { buf.clear(); }
+  void Put(char c) { buf.push_back(c); }
+  void Put(const char *s);
+  void Put(const std::string &s) { buf.append(s); }
+  void Put(int x);
+  void Put(long x);
+  void Put(unsigned long x);
+  void Put(double x);  // Shortest round-trip representation
+  void Flush(std::ostream &os);  // Throws if the stream fails
+  const std::string &Str() const { return buf; }
+
+ private:
+  std::string buf;
+};
+
+// Base class
+class MEventWriter {
+ public:
+  virtual ~MEventWriter() {}
+  virtual void Write(const MEventRecord &evt) = 0;
+  virtual void Close() {}
+};
+
+// HepMC3 ASCII (Asciiv3)
+class MWriterHepMC3 : public MEventWriter {
+ public:
+  MWriterHepMC3(std::ostream &os, std::shared_ptr<HepMC3::GenRunInfo> runinfo = nullptr);
+  ~MWriterHepMC3();  // Closes, errors are reported only by an explicit Close
+  void Write(const MEventRecord &evt);
+  void Close();
+
+ private:
+  std::ostream &    out;
+  MTextBuffer       tb;
+  std::vector<bool> written;  // Vertex line written
+  bool              closed = false;
+};
+
+// HepMC2 ASCII (IO_GenEvent)
+class MWriterHepMC2 : public MEventWriter {
+ public:
+  explicit MWriterHepMC2(std::ostream &os);
+  ~MWriterHepMC2();
+  void Write(const MEventRecord &evt);
+  void Close();
+
+ private:
+  void WriteParticle(const MEventRecord::Particle &p);
+
+  std::ostream &out;
+  MTextBuffer   tb;
+  int           barcode = 0;  // Particle counter of the event
+  bool          closed  = false;
+};
+
+// Les Houches Event file run information
+struct LHEINIT {
+  int    beam1    = 2212;
+  int    beam2    = 2212;
+  double E1       = 0.0;   // Beam energies (GeV)
+  double E2       = 0.0;
+  double xs       = 0.0;   // Cross section (pb)
+  double xs_err   = 0.0;
+  double maxw     = 1.0;   // Maximum event weight
+  bool   weighted = false;
+  std::string generator;   // Free text in the header block
+};
+
+// Les Houches Event file (LHEF 3.0)
+class MWriterLHE : public MEventWriter {
+ public:
+  MWriterLHE(std::ostream &os, const LHEINIT &init);
+  ~MWriterLHE();
+  void Write(const MEventRecord &evt);
+  void Close();
+
+ private:
+  std::ostream &out;
+  MTextBuffer   tb;
+  bool          closed = false;
+};
+
+// Any HepMC3 writer, via HepMC3::GenEvent conversion
+class MWriterGenEvent : public MEventWriter {
+ public:
+  explicit MWriterGenEvent(std::shared_ptr<HepMC3::Writer> writer) : output(writer) {}
+  void Write(const MEventRecord &evt);
+
+ private:
+  std::shared_ptr<HepMC3::Writer> output = nullptr;
+};
+
+}  // namespace gra
+
+#endif
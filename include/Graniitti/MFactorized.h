@@ -34,7 +34,7 @@ class MFactorized : public MProcess {
     return EventWeight(randvec, aux);
   }
   double EventWeight(const std::vector<double> &randvec, AuxIntData &aux);
-  bool   EventRecord(HepMC3::GenEvent &evt);
+  bool   EventRecord(MEventRecord &evt);
   void   PrintInit(bool silent) const;
 
  private:
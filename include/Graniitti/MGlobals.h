@@ -6,6 +6,12 @@
 #ifndef MGLOBALS_H
 #define MGLOBALS_H
 
+// C++
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+
 // Own
 #include "Graniitti/MSudakov.h"
 
@@ -14,18 +20,56 @@
 
 
 namespace gra {
+
+// Mutex with acquisition and contention counters, used to verify that the
+// per-event amplitude and flux paths never take the shared lock
+class MCountedMutex {
+ public:
+  void lock() {
+    if (!m.try_lock()) {
+      contended.fetch_add(1, std::memory_order_relaxed);
+      m.lock();
+    }
+    acquired.fetch_add(1, std::memory_order_relaxed);
+  }
+  bool try_lock() {
+    if (!m.try_lock()) { return false; }
+    acquired.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  void unlock() { m.unlock(); }
+
+  std::uint64_t Acquired() const { return acquired.load(std::memory_order_relaxed); }
+  std::uint64_t Contended() const { return contended.load(std::memory_order_relaxed); }
+  void          ResetCounters() {
+    acquired  = 0;
+    contended = 0;
+  }
+
+ private:
+  std::mutex                 m;
+  std::atomic<std::uint64_t> acquired{0};
+  std::atomic<std::uint64_t> contended{0};
+};
+
 // ======================================================================
 // These variables are initialized by MGraniitti.cc
 
 // Model tune
 extern std::string MODELPARAM;
 
-// Multithreading lock
-extern std::mutex g_mutex;
+// Multithreading lock (initialization and event bookkeeping only)
+extern MCountedMutex g_mutex;
 
 // For multithreaded VEGAS, to handle the exceptions from forked threads
 extern std::exception_ptr globalExceptionPtr;
 
+// Set globalExceptionPtr from a worker thread (thread safe, keeps the first)
+void SetGlobalException(std::exception_ptr e);
+
+// Number of threads for interpolation grid construction (follows CORES)
+extern unsigned int GRIDCORES;
+
 // ======================================================================
 
 }  // namespace gra
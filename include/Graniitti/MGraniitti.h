@@ -7,7 +7,14 @@
 #define MGRANIITTI_H
 
 // C++
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <complex>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <random>
 #include <thread>
@@ -21,16 +28,23 @@
 
 // Own
 #include "Graniitti/M4Vec.h"
+#include "Graniitti/MAsyncWriter.h"
 #include "Graniitti/MAux.h"
+#include "Graniitti/MCheckpoint.h"
+#include "Graniitti/MCompress.h"
 #include "Graniitti/MContinuum.h"
 #include "Graniitti/MEikonal.h"
+#include "Graniitti/MEventWriter.h"
 #include "Graniitti/MFactorized.h"
+#include "Graniitti/MGlobals.h"
 #include "Graniitti/MKinematics.h"
 #include "Graniitti/MMatrix.h"
+#include "Graniitti/MNeuroJacobian.h"
 #include "Graniitti/MParton.h"
 #include "Graniitti/MProcess.h"
 #include "Graniitti/MQuasiElastic.h"
 #include "Graniitti/MSpin.h"
+#include "Graniitti/MThreadPool.h"
 #include "Graniitti/MTimer.h"
 #include "Graniitti/MVEGAS.h"
 
@@ -54,6 +68,21 @@ class Stats {
     vetocuts_ok += (aux.vetocuts_ok ? 1.0 : 0.0);
   }
 
+  // Fuse thread local integration statistics
+  void Fuse(const Stats &other) {
+    evaluations += other.evaluations;
+    Wsum += other.Wsum;
+    W2sum += other.W2sum;
+
+    amplitude_ok += other.amplitude_ok;
+    kinematics_ok += other.kinematics_ok;
+    fidcuts_ok += other.fidcuts_ok;
+    vetocuts_ok += other.vetocuts_ok;
+
+    maxW = std::max(maxW, other.maxW);
+    maxf = std::max(maxf, other.maxf);
+  }
+
   // Calculate integrated cross section sigma and its
   // error for direct (simple) sampling. NOT TO BE USED WITH VEGAS!
   void CalculateCrossSection() {
@@ -90,6 +119,9 @@ class Stats {
   // Weight statistics VEGAS MC
   double maxf = 0.0;
   double chi2 = 0.0;
+
+  // Thread load imbalance of the last iteration (max/mean busy time - 1)
+  double imbalance = 0.0;
 };
 
 class MGraniitti {
@@ -144,19 +176,59 @@ class MGraniitti {
       std::string str = "MGraniitti::SetCORES: CORES < 0";
       throw std::invalid_argument(str);
     }
+    gra::GRIDCORES = CORES;
   }
   int  GetCores() const { return CORES; }
+
+  // Worker thread CPU affinity (none, compact, numa)
+  void SetAffinity(const std::string &affinity) {
+    if (!MThreadPool::ValidAffinity(affinity)) {
+      throw std::invalid_argument("MGraniitti::SetAffinity: Unknown affinity: " + affinity +
+                                  " (valid: none, compact, numa)");
+    }
+    AFFINITY = affinity;
+  }
+  std::string GetAffinity() const { return AFFINITY; }
   void SetIntegrator(const std::string &integrator) { INTEGRATOR = integrator; }
   void SetWeighted(bool weighted) { WEIGHTED = weighted; }
+  // Save / restore the VEGAS integration to / from a checkpoint file
+  void SetCheckpoint(bool checkpoint) { CHECKPOINT = checkpoint; }
+  // Current VEGAS integration state, its checkpoint key and file
+  void        GetCheckpoint(MVEGASCheckpoint &C) const;
+  std::string GetCheckpointKey() const;
+  std::string GetCheckpointFile(const std::string &key) const;
+  // Event generation shard (index / count), shards share the VEGAS checkpoint
+  void SetShard(int index, int count) {
+    if (count < 1 || index < 0 || index >= count) {
+      throw std::invalid_argument("MGraniitti::SetShard: Invalid shard " + std::to_string(index) +
+                                  " / " + std::to_string(count) + " (0 <= index < count)");
+    }
+    SHARD_INDEX = index;
+    SHARD_COUNT = count;
+    if (SHARD_COUNT > 1) { CHECKPOINT = true; }
+  }
+  // Asynchronous output writer queue depth (0 for synchronous writing)
+  void SetWriteQueue(int depth) {
+    if (depth < 0) {
+      throw std::invalid_argument("MGraniitti::SetWriteQueue: Queue depth < 0");
+    }
+    WRITEQUEUE = depth;
+  }
+  // Output compression (none, gzip, gzip:<1-9>)
+  void SetCompress(const std::string &compress) {
+    MakeCodec(compress);  // Throws if not valid
+    COMPRESS = compress;
+  }
   // Output file name
   void SetOutput(const std::string &output) { OUTPUT = output; }
   // Output file format
   void SetFormat(const std::string &format) {
-    if (format == "hepmc3" || format == "hepmc2" || format == "hepevt") {
+    if (format == "hepmc3" || format == "hepmc2" || format == "hepevt" || format == "lhe" ||
+        format == "grcol") {
       FORMAT = format;
     } else {
       throw std::invalid_argument("MGraniitti::SetFormat: Unknown output format: " + format +
-                                  " (valid: hepmc3, hepmc2, hepevt)");
+                                  " (valid: hepmc3, hepmc2, hepevt, lhe, grcol)");
     }
   }
 
@@ -203,10 +275,16 @@ class MGraniitti {
 
   std::string PROCESS = "null";  // Physics process identifier
 
-  bool        WEIGHTED   = false;   // Unweighted or weighted event generation
-  int         NEVENTS    = 0;       // Number of events to be generated
-  int         CORES      = 0;       // Number of CPU cores (threads) in use
-  std::string INTEGRATOR = "null";  // Integrator (VEGAS, FLAT, ...)
+  bool        WEIGHTED    = false;   // Unweighted or weighted event generation
+  int         NEVENTS     = 0;       // Number of events to be generated
+  int         CORES       = 0;       // Number of CPU cores (threads) in use
+  std::string AFFINITY    = "none";  // Worker thread CPU affinity
+  int         WRITEQUEUE  = 4096;    // Output writer queue depth
+  std::string COMPRESS    = "none";  // Output compression
+  std::string INTEGRATOR  = "null";  // Integrator (VEGAS, FLAT, ...)
+  bool        CHECKPOINT  = false;   // VEGAS integration checkpointing
+  int         SHARD_INDEX = 0;       // Event generation shard index
+  int         SHARD_COUNT = 1;       // Event generation shard count
 
   // SILENT OUTPUT
   bool HILJAA = false;
@@ -227,16 +305,36 @@ class MGraniitti {
   // Input string
   std::string FULL_INPUT_STR = "null";
 
+  // Process string (with @-commands)
+  std::string FULL_PROCESS_STR = "null";
+
   // HepMC outputfile
   std::string FULL_OUTPUT_STR = "null";
   std::string OUTPUT          = "null";
-  std::string FORMAT          = "null";  // hepmc3 or hepmc2 or hepevt
+  std::string FORMAT          = "null";  // hepmc3, hepmc2, hepevt, lhe or grcol
 
+  // Output file stream with a large buffer (must outlive the writers)
+  std::vector<char>              outputBuffer;
+  std::shared_ptr<std::ofstream> outputStream = nullptr;
+
+  // Block compression stage between the writers and the file stream
+  std::shared_ptr<MCompressStream> outputCompress = nullptr;
+
+  // HepMC3 run info and writers (user supplied, or HEPEVT)
   std::shared_ptr<HepMC3::GenRunInfo>        runinfo      = nullptr;
   std::shared_ptr<HepMC3::WriterAscii>       outputHepMC3 = nullptr;
   std::shared_ptr<HepMC3::WriterAsciiHepMC2> outputHepMC2 = nullptr;
   std::shared_ptr<HepMC3::WriterHEPEVT>      outputHEPEVT = nullptr;
 
+  // Event record writer (direct text, or one of the above)
+  std::shared_ptr<MEventWriter> outputWriter = nullptr;
+
+  // Asynchronous writer stage in front of the writer
+  std::unique_ptr<MAsyncWriter> outputAsync = nullptr;
+
+  // Persistent worker threads, worker tid owns pvec[tid]
+  std::unique_ptr<MThreadPool> pool = nullptr;
+
   // VEGAS creates copies here
   std::vector<MProcess *> pvec;
   MContinuum              proc_C;
@@ -264,6 +362,12 @@ class MGraniitti {
   // FLAT MC
   MCPARAM mcparam;
 
+  // -----------------------------------------------
+  // NEURO MC
+
+  neurojac::NEUROPARAM nparam;
+  neurojac::MNeuroFlow flow;
+
   // -----------------------------------------------
   // VEGAS MC
 
@@ -273,15 +377,44 @@ class MGraniitti {
   // DATA
   VEGASData VD;
 
+  // Thread local accumulators and statistics [CORES]
+  std::vector<VEGASLocal> VL;
+  std::vector<Stats>      VLstat;
+
   void VEGASInit(unsigned int init, unsigned int calls);
   int  VEGAS(unsigned int init, unsigned int calls, unsigned int iter, unsigned int N);
-  void VEGASMultiThread(unsigned int N, unsigned int tid, unsigned int init,
-                        unsigned int LOCALcalls);
+  void VEGASMultiThread(unsigned int N, unsigned int tid, unsigned int init, unsigned int calls,
+                        std::uint64_t stream);
+
+  // Phase space weight sums, reduced in chunk order
+  gra::kinematics::MCWSUM DW_sum;
+  gra::kinematics::MCWSUM DW_sum_exact;
+  void                    ReducePhaseSpaceSums();
+
+  // Dynamic chunk scheduling
+  VEGASReducer  VR;                // Chunk accumulators reduced in chunk order
+  std::uint64_t VEGAS_stream = 0;  // Running iteration counter (RNG stream id)
+  unsigned int  RNDSEED_base = 0;  // Master seed for RNG substreams
+
+  // RNG stream id of event generation iteration (or thread) of this shard,
+  // disjoint from the integration streams [0, 2^32) and from other shards
+  std::uint64_t GenerationStream(std::uint64_t iter) const {
+    return (1ULL << 63) | (static_cast<std::uint64_t>(SHARD_INDEX) << 32) | iter;
+  }
 
   // -----------------------------------------------
 
   void UnifyHistogramBounds();
 
+  // VEGAS checkpointing
+  bool ReadCheckpoint();
+  void WriteCheckpoint() const;
+
+  // Shard statistics sidecar
+  std::array<double, 3> shard_base = {{0.0, 0.0, 0.0}};  // Integral sums before generation
+  void                  GetIntegralSums(std::array<double, 3> &sums) const;
+  void                  WriteShardStat() const;
+
   // Calculate cross section
   void CalculateCrossSection();
 
@@ -294,6 +427,13 @@ class MGraniitti {
   void SampleFlat(unsigned int N);
   void SampleNeuro(unsigned int N);
 
+  // Plain MC (FLAT, NEURO): fills a chunk of unit hypercube points and their Jacobian weights
+  using PointBatch = std::function<void(unsigned int tid, std::vector<std::vector<double>> &u,
+                                        std::vector<double> &jac)>;
+  void SamplePlain(unsigned int N, const PointBatch &batch);
+  void PlainMultiThread(unsigned int N, unsigned int tid, unsigned int calls,
+                        std::uint64_t stream, const PointBatch &batch);
+
   // Helper functions
   void           PrintInit() const;
   int            SaveEvent(MProcess *pr, double W, double MAXW, const gra::AuxIntData &aux);
@@ -301,6 +441,7 @@ class MGraniitti {
   void           PrintStatistics(unsigned int N);
   gra::PARAM_RES ReadFactorized(const std::string &resparam_str);
   void           InitFileOutput();
+  void           CloseFileOutput();
 
   // Interpreter commands
   std::vector<aux::OneCMD> syntax;
@@ -0,0 +1,43 @@
+// Bounded task-parallel construction of interpolation grids
+//
+// Grid nodes k = 0,...,N-1 are handed out in chunks to a fixed number of
+// worker threads (instead of one OS thread per node), with progress
+// reporting from the first worker.
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+#ifndef MGRIDBUILDER_H
+#define MGRIDBUILDER_H
+
+// C++
+#include <cstddef>
+#include <functional>
+
+namespace gra {
+
+class MGridBuilder {
+ public:
+  // threads = 0 uses the global GRIDCORES setting (CORES),
+  // chunk = 0 chooses the chunk size automatically
+  MGridBuilder(unsigned int threads = 0, std::size_t chunk = 0);
+  ~MGridBuilder() {}
+
+  // Evaluate task(k) for all k = 0,...,N-1
+  void Run(std::size_t N, const std::function<void(std::size_t)> &task, bool progress = true);
+
+  // Evaluate task(k, tid) for all k = 0,...,N-1, where tid < GetThreads() is
+  // the index of the evaluating worker (for worker local resources)
+  void RunWorkers(std::size_t N, const std::function<void(std::size_t, unsigned int)> &task,
+                  bool progress = true);
+
+  unsigned int GetThreads() const { return THREADS; }
+
+ private:
+  unsigned int THREADS = 1;
+  std::size_t  CHUNK   = 0;
+};
+
+}  // namespace gra
+
+#endif
@@ -10,6 +10,8 @@
 // C++
 #include <complex>
 #include <random>
+#include <stdexcept>
+#include <string>
 #include <valarray>
 #include <vector>
 
@@ -25,6 +27,9 @@
 #include "Graniitti/MResonance.h"
 #include "Graniitti/MSudakov.h"
 
+// LHAPDF
+#include "LHAPDF/LHAPDF.h"
+
 
 namespace gra {
 namespace kinematics {
@@ -382,22 +387,21 @@ inline void Two2TwoLimit(double s, double E1, double E2, double E3, double E4, d
 //
 template <typename T>
 inline void LorentzBoost(const T &boost, double M0, T &p, int sign) {
-  std::valarray<double> p3 = {p.Px(), p.Py(), p.Pz()};
+  const double p3[3] = {p.Px(), p.Py(), p.Pz()};
 
   // Mother beta-vector
-  const std::valarray<double> beta = {sign * boost.Px() / boost.E(), sign * boost.Py() / boost.E(),
-                                      sign * boost.Pz() / boost.E()};
+  const double beta[3] = {sign * boost.Px() / boost.E(), sign * boost.Py() / boost.E(),
+                          sign * boost.Pz() / boost.E()};
   // Mother gamma-factor
   const double gamma = boost.E() / M0;
 
   // Apply transforms
-  const double kappa1 = (beta * p3).sum();  // Inner product
+  const double kappa1 = beta[0] * p3[0] + beta[1] * p3[1] + beta[2] * p3[2];  // Inner product
   const double kappa2 = gamma * (gamma * kappa1 / (1.0 + gamma) + p.E());
 
   // Vector sum
-  p3 += kappa2 * beta;
-
-  p = T(p3[0], p3[1], p3[2], gamma * (p.E() + kappa1));
+  p = T(p3[0] + kappa2 * beta[0], p3[1] + kappa2 * beta[1], p3[2] + kappa2 * beta[2],
+        gamma * (p.E() + kappa1));
 }
 
 // Flat variables in spherical coordinates
@@ -418,11 +422,11 @@ inline void Isotropic(double pnorm, T1 &p1, T1 &p2, double m1, double m2, T2 &rn
   FlatIsotropic(costheta, sintheta, phi, rng);
 
   // Jacobian of spherical coordinates
-  const std::valarray<double> k = {pnorm * sintheta * std::cos(phi),
-                                   pnorm * sintheta * std::sin(phi), pnorm * costheta};
+  const double k[3] = {pnorm * sintheta * std::cos(phi), pnorm * sintheta * std::sin(phi),
+                       pnorm * costheta};
 
   // Energies by on-shell condition
-  const std::valarray<double> e = {msqrt(pow2(m1) + pow2(pnorm)), msqrt(pow2(m2) + pow2(pnorm))};
+  const double e[2] = {msqrt(pow2(m1) + pow2(pnorm)), msqrt(pow2(m2) + pow2(pnorm))};
 
   // Back-to-back
   p1 = T1(k[0], k[1], k[2], e[0]);
@@ -481,15 +485,15 @@ inline MCW ThreeBodyPhaseSpace(const T1 &mother, double M0, const std::vector<do
   T1 p12;
 
   // Phase space boundaries [min,max]
-  const std::vector<double> m12bound = {m[1] + m[2], M0 - m[0]};
+  const double m12bound[2] = {m[1] + m[2], M0 - m[0]};
   double w_max = DecayMomentum(M0, m[0], m12bound[0]) * DecayMomentum(m12bound[1], m[1], m[2]);
   if (unweight == false) { w_max = 0; }
 
   // Accceptance-Rejection
-  const unsigned int  MAXTRIAL = 1e8;
-  std::vector<double> pnorm    = {0.0, 0.0};
-  double              m12      = 0;
-  MCW                 x;
+  const unsigned int MAXTRIAL = 1e8;
+  double             pnorm[2] = {0.0, 0.0};
+  double             m12      = 0;
+  MCW                x;
   do {
     m12      = rng.U(m12bound[0], m12bound[1]);  // Flat mass (in GeV, not GeV^2)
     pnorm[0] = DecayMomentum(M0, m[0], m12);
@@ -713,11 +717,14 @@ inline void Rotate(T &p, double theta, double phi) {
   const double s2 = std::sin(phi);
 
   // 3x3 Rotation matrix
-  const MMatrix<double> R = {{c1 * c2, -s2, s1 * c2}, {c1 * s2, c2, s1 * s2}, {-s1, 0.0, c1}};
+  const double R[3][3] = {{c1 * c2, -s2, s1 * c2}, {c1 * s2, c2, s1 * s2}, {-s1, 0.0, c1}};
 
   // Rotate
-  const std::vector<double> p3    = {p.Px(), p.Py(), p.Pz()};
-  const std::vector<double> p3new = R * p3;
+  const double p3[3] = {p.Px(), p.Py(), p.Pz()};
+  double       p3new[3];
+  for (std::size_t i = 0; i < 3; ++i) {
+    p3new[i] = R[i][0] * p3[0] + R[i][1] * p3[1] + R[i][2] * p3[2];
+  }
 
   p = T(p3new[0], p3new[1], p3new[2], p.E());
 }
@@ -764,6 +771,110 @@ inline void RotateZ(T &p, double angle) {
   p = T(px, py, pz, p.E());
 }
 
+// ----------------------------------------------------------------------
+// Batched transformations of 4-vectors in structure-of-arrays format
+//
+// Same arithmetic as the single 4-vector functions above, as plain loops
+// over contiguous components (vectorizable).
+
+struct M4VecSoA {
+  std::vector<double> px;
+  std::vector<double> py;
+  std::vector<double> pz;
+  std::vector<double> e;
+
+  std::size_t size() const { return e.size(); }
+
+  void resize(std::size_t n) {
+    px.resize(n);
+    py.resize(n);
+    pz.resize(n);
+    e.resize(n);
+  }
+
+  // Pack from / unpack to 4-vectors
+  void Load(const std::vector<M4Vec> &p) {
+    resize(p.size());
+    for (std::size_t i = 0; i < p.size(); ++i) {
+      px[i] = p[i].Px();
+      py[i] = p[i].Py();
+      pz[i] = p[i].Pz();
+      e[i]  = p[i].E();
+    }
+  }
+  void Store(std::vector<M4Vec> &p) const {
+    p.resize(size());
+    for (std::size_t i = 0; i < size(); ++i) { p[i].Set(px[i], py[i], pz[i], e[i]); }
+  }
+};
+
+// Lorentz boost of all vectors, see LorentzBoost
+inline void LorentzBoostSoA(const M4Vec &boost, double M0, M4VecSoA &p, int sign) {
+  const double bx    = sign * boost.Px() / boost.E();
+  const double by    = sign * boost.Py() / boost.E();
+  const double bz    = sign * boost.Pz() / boost.E();
+  const double gamma = boost.E() / M0;
+
+  double *__restrict__ px = p.px.data();
+  double *__restrict__ py = p.py.data();
+  double *__restrict__ pz = p.pz.data();
+  double *__restrict__ e  = p.e.data();
+
+  const std::size_t N = p.size();
+  for (std::size_t i = 0; i < N; ++i) {
+    const double kappa1 = bx * px[i] + by * py[i] + bz * pz[i];
+    const double kappa2 = gamma * (gamma * kappa1 / (1.0 + gamma) + e[i]);
+
+    px[i] = px[i] + kappa2 * bx;
+    py[i] = py[i] + kappa2 * by;
+    pz[i] = pz[i] + kappa2 * bz;
+    e[i]  = gamma * (e[i] + kappa1);
+  }
+}
+
+// Rotation of spatial parts by (theta,phi), see Rotate
+inline void RotateSoA(M4VecSoA &p, double theta, double phi) {
+  const double c1 = std::cos(theta);
+  const double s1 = std::sin(theta);
+  const double c2 = std::cos(phi);
+  const double s2 = std::sin(phi);
+
+  const double R[3][3] = {{c1 * c2, -s2, s1 * c2}, {c1 * s2, c2, s1 * s2}, {-s1, 0.0, c1}};
+
+  double *__restrict__ px = p.px.data();
+  double *__restrict__ py = p.py.data();
+  double *__restrict__ pz = p.pz.data();
+
+  const std::size_t N = p.size();
+  for (std::size_t i = 0; i < N; ++i) {
+    const double x = px[i];
+    const double y = py[i];
+    const double z = pz[i];
+
+    px[i] = R[0][0] * x + R[0][1] * y + R[0][2] * z;
+    py[i] = R[1][0] * x + R[1][1] * y + R[1][2] * z;
+    pz[i] = R[2][0] * x + R[2][1] * y + R[2][2] * z;
+  }
+}
+
+// Active rotation around z-axis, see RotateZ
+inline void RotateZSoA(M4VecSoA &p, double angle) {
+  const double costh = std::cos(angle);
+  const double sinth = std::sin(angle);
+
+  double *__restrict__ px = p.px.data();
+  double *__restrict__ py = p.py.data();
+
+  const std::size_t N = p.size();
+  for (std::size_t i = 0; i < N; ++i) {
+    const double x = px[i];
+    const double y = py[i];
+
+    px[i] = costh * x - sinth * y;
+    py[i] = sinth * x + costh * y;
+  }
+}
+
 
 // Find the closest 4-vector on lightcone
 //
@@ -1433,14 +1544,59 @@ inline void CMframe(std::vector<T> &p, const T &X, bool DEBUG = false) {
 }  // namespace kinematics
 
 
+// LHAPDF set owned by one process copy, i.e. by one thread. A copy loads
+// its own PDF object instead of sharing it, so that the per-event evaluation
+// needs no lock. Create with Init() at initialization time.
+class MPDFHandle {
+ public:
+  MPDFHandle() {}
+  MPDFHandle(const MPDFHandle &other) {
+    if (other.pdf != nullptr) { Init(other.name); }
+  }
+  MPDFHandle &operator=(const MPDFHandle &other) {
+    if (this != &other) {
+      Reset();
+      if (other.pdf != nullptr) { Init(other.name); }
+    }
+    return *this;
+  }
+  ~MPDFHandle() { Reset(); }
+
+  // Load the set, with one automatic download attempt
+  void Init(const std::string &pdfname) {
+    Reset();
+    name = pdfname;
+    for (int trials = 0;; ++trials) {
+      try {
+        pdf = LHAPDF::mkPDF(pdfname, 0);
+        return;
+      } catch (...) {
+        if (trials >= 1) {
+          throw std::invalid_argument("MPDFHandle::Init: Problem with reading LHAPDF '" +
+                                      pdfname + "'");
+        }
+        aux::AutoDownloadLHAPDF(pdfname);
+      }
+    }
+  }
+  void Reset() {
+    delete pdf;
+    pdf = nullptr;
+  }
+  LHAPDF::PDF *get() const { return pdf; }
+  LHAPDF::PDF *operator->() const { return pdf; }
+
+ private:
+  std::string  name;
+  LHAPDF::PDF *pdf = nullptr;
+};
+
+
 // Lorentz scalars and other common kinematic variables
 class LORENTZSCALAR {
  public:
   LORENTZSCALAR() {}
-  ~LORENTZSCALAR() {
-    delete GlobalSudakovPtr;
-    delete GlobalPdfPtr;
-  }
+  ~LORENTZSCALAR() { delete GlobalSudakovPtr; }
 
   // --------------------------------------------------------------------
   // Particle Database
@@ -1452,9 +1608,8 @@ class LORENTZSCALAR {
   MSudakov *GlobalSudakovPtr = nullptr;
 
   // Normal pdfs
-  std::string  LHAPDFSET    = "null";
-  LHAPDF::PDF *GlobalPdfPtr = nullptr;
-  int          pdf_trials   = 0;
+  std::string LHAPDFSET = "null";
+  MPDFHandle  GlobalPdf;
   // --------------------------------------------------------------------
 
   // Cascade sampling forced control initiated by corresponding amplitude functions
@@ -393,6 +393,24 @@ inline T CSIntegral(const std::vector<T> &f, double hstep) {
   return I;
 }
 
+// Composite Simpson's rule weights, such that CSIntegral(f, hstep) = sum_j w_j f_j
+//
+// Indexing: j = 0,1,...,N-1,N,  => length of w = N+1, N = even
+//
+inline std::vector<double> CSWeights(std::size_t N, double hstep) {
+  if (N % 2 != 0) {  // Must be even
+    std::string str =
+        "FATAL ERROR: gra::math::CSWeights N = " + std::to_string(N) + " is not even!";
+    throw std::invalid_argument(str);
+  }
+  std::vector<double> w(N + 1, 0.0);
+  for (std::size_t j = 1; j < N; ++j) { w[j] = (j % 2 == 0) ? 2.0 : 4.0; }
+  w[0] = 1.0;
+  w[N] = 1.0;
+  for (auto &x : w) { x *= hstep / 3.0; }
+  return w;
+}
+
 // Composite Simpson's 3/8 rule integral (qubic interpolation),
 // - hstep=(b-a)/3N the discretization size
 //
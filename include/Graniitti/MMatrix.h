@@ -333,6 +333,14 @@ class MMatrix {
   std::size_t size_row() const { return rows; }
   std::size_t size_col() const { return cols; }
 
+  // Free the storage, leaves an empty 0 x 0 matrix
+  void Clear() {
+    delete[] data;
+    data = nullptr;
+    rows = 0;
+    cols = 0;
+  }
+
  private:
   // Copy data from a to *this (after ReSize)
   void Copy(const MMatrix &a) {
@@ -19,7 +19,9 @@
 // Own
 #include "Graniitti/M4Vec.h"
 #include "Graniitti/MAux.h"
+#include "Graniitti/MCubature.h"
 #include "Graniitti/MEikonal.h"
+#include "Graniitti/MEventRecord.h"
 #include "Graniitti/MGlobals.h"
 #include "Graniitti/MH1.h"
 #include "Graniitti/MH2.h"
@@ -68,6 +70,28 @@ struct MPI {
   M4Vec p4;
 };
 
+// Screening loop integration table (per process instance)
+//
+// Loop kt-vectors and complex weights w = (2D-Simpson weight) x A_eik(kt^2) x kt,
+// including the step size factors. Built once per discretization and eikonal.
+struct MLoopTable {
+  std::vector<double>               kx;
+  std::vector<double>               ky;
+  std::vector<std::complex<double>> w;
+
+  // Discretization the table was built with
+  unsigned int NKT   = 0;
+  unsigned int NPHI  = 0;
+  double       MinKT = 0.0;
+  double       MaxKT = 0.0;
+
+  bool Empty() const { return w.empty(); }
+  bool Match(const MEikonalNumerics &num) const {
+    return !Empty() && NKT == num.NumberLoopKT && NPHI == num.NumberLoopPHI &&
+           MinKT == num.MinLoopKT && MaxKT == num.MaxLoopKT;
+  }
+};
+
 // Abstract process class
 class MProcess : public MUserHistograms {
  public:
@@ -82,7 +106,7 @@ class MProcess : public MUserHistograms {
 
   virtual double operator()(const std::vector<double> &randvec, AuxIntData &aux)  = 0;
   virtual double EventWeight(const std::vector<double> &randvec, AuxIntData &aux) = 0;
-  virtual bool   EventRecord(HepMC3::GenEvent &evt)                               = 0;
+  virtual bool   EventRecord(MEventRecord &evt)                                   = 0;
 
   // Set central system decay structure
   void      SetDecayMode(std::string str);
@@ -162,10 +186,19 @@ class MProcess : public MUserHistograms {
   // Pomeron loop screening
   void SetScreening(bool value) { SCREENING = value; }
   bool GetScreening() { return SCREENING; }
+  // Reuse of the loop invariant amplitude blocks within one screening loop
+  void SetLoopContext(bool value) { LOOPCONTEXT = value; }
   // Set/Get input eikonal
-  void     SetEikonal(const MEikonal &in) { Eikonal = in; }
+  void SetEikonal(const MEikonal &in) {
+    Eikonal   = in;
+    looptable = MLoopTable();  // Rebuilt at next use
+  }
   MEikonal GetEikonal() const { return Eikonal; }
 
+  // Screening loop statistics: loop integrals and amplitude calls in them
+  double GetLoopEvents() const { return loop_events; }
+  double GetLoopCalls() const { return loop_calls; }
+
   // Set LHAPDFSET name
   void SetLHAPDF(const std::string &in) {
     std::cout << "MProcess::SetLHAPDF: " << in << std::endl;
@@ -179,6 +212,11 @@ class MProcess : public MUserHistograms {
   void SetVetoCuts(const gra::VETOCUT &in) { vetocuts = in; }
 
   double GetMandelstam_s() const { return lts.s; }
+  int    GetExcitation() const { return EXCITATION; }
+
+  // Decay tree phase space weights {W, W2, N} in depth-first order (checkpointing)
+  void GetDecayWeights(std::vector<double> &w) const;
+  void SetDecayWeights(const std::vector<double> &w);
 
   // Set proton excitation to low-mass N*
   void SetExcitation(int in) {
@@ -264,6 +302,23 @@ class MProcess : public MUserHistograms {
 
   // Eikonal screening loop
   double S3ScreenedAmp2();
+  void   S3BuildLoopTable();
+  void   S3FixedLoop();
+  void   S3AdaptiveLoop();
+
+  // Screening loop table and re-usable buffers
+  MLoopTable                        looptable;
+  std::vector<std::complex<double>> loop_hamp0;
+  std::vector<std::complex<double>> loop_hamp;
+  std::vector<double>               loop_p1p = std::vector<double>(2, 0.0);
+  std::vector<double>               loop_p2p = std::vector<double>(2, 0.0);
+  std::vector<double>               loop_p1T = std::vector<double>(2, 0.0);
+  std::vector<double>               loop_p2T = std::vector<double>(2, 0.0);
+  gra::math::MCubature2D            loop_cubature;
+
+  // Keep as double to avoid overflow of range
+  double loop_events = 0.0;
+  double loop_calls  = 0.0;
 
   // First print
   void PrintSetup() const;
@@ -277,16 +332,19 @@ class MProcess : public MUserHistograms {
   // -------------------------------------------------------
   // Recursive function to treat decay trees
 
-  void SaveBranch(HepMC3::GenEvent &evt, const gra::MDecayBranch &branch,
-                  const HepMC3::GenParticlePtr &pX);
-  bool CommonRecord(HepMC3::GenEvent &evt);
+  void SaveBranch(MEventRecord &evt, const gra::MDecayBranch &branch, int pX);
+  bool CommonRecord(MEventRecord &evt);
   bool VetoCuts() const;
   bool CommonCuts() const;
   void FindDecayCuts(const gra::MDecayBranch &branch, bool &ok) const;
   void FindVetoCuts(const gra::MDecayBranch &branch, bool &ok) const;
   bool ConstructDecayKinematics(gra::MDecayBranch &branch);
-  void WriteDecayKinematics(const gra::MDecayBranch &branch, const HepMC3::GenParticlePtr &mother,
-                            HepMC3::GenEvent &evt);
+  void GetDecayWeights(const gra::MDecayBranch &branch, std::vector<double> &w) const;
+  void SetDecayWeights(gra::MDecayBranch &branch, const std::vector<double> &w,
+                       std::size_t &k);
+  std::vector<double> decay_m;  // Re-usable buffers for ConstructDecayKinematics
+  std::vector<M4Vec>  decay_p;
+  void WriteDecayKinematics(const gra::MDecayBranch &branch, int mother, MEventRecord &evt);
   void PrintFiducialCuts() const;
 
   void   GetOffShellMass(const gra::MDecayBranch &branch, double &mass);
@@ -350,10 +408,11 @@ class MProcess : public MUserHistograms {
   std::string PROCESS;             // Process identifier string
   std::string CID;                 // Phase space sampler identifier such as "F" or "C"
   std::string DECAYMODE;           // Decaymode identifier string
-  bool        SCREENING  = false;  // Pomeron loop on/off
-  int         EXCITATION = 0;      // Forward proton excitation (0 = off, 1 = single, 2 = double)
-  int         USERCUTS   = 0;      // User custom cuts identifier
-  int         FLATAMP    = 0;      // Flat matrix element mode
+  bool        SCREENING   = false;  // Pomeron loop on/off
+  bool        LOOPCONTEXT = true;   // Loop invariant amplitude cache on/off
+  int         EXCITATION  = 0;      // Forward proton excitation (0 = off, 1 = single, 2 = double)
+  int         USERCUTS    = 0;      // User custom cuts identifier
+  int         FLATAMP     = 0;      // Flat matrix element mode
 
   // ----------------------------------------------------------------------
   // Phase-space control
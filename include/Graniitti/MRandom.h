@@ -8,6 +8,7 @@
 
 // C++
 #include <complex>
+#include <cstdint>
 #include <random>
 #include <vector>
 
@@ -35,6 +36,25 @@ class MRandom {
   // Return current random seed
   unsigned int GetSeed() const { return RNDSEED; }
 
+  // Counter based substream: reseed the engine as a deterministic function of
+  // (seed, stream, substream) only. RNDSEED is kept unchanged.
+  void SetSubstream(std::uint64_t seed, std::uint64_t stream, std::uint64_t substream) {
+    std::uint64_t x = SplitMix64(seed);
+    x               = SplitMix64(x ^ stream);
+    x               = SplitMix64(x ^ substream);
+    rng.seed(x);
+    flat.reset();
+    gaussian.reset();
+  }
+
+  // SplitMix64 hash [REFERENCE: Steele, Lea, Flood, OOPSLA 2014]
+  static std::uint64_t SplitMix64(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+  }
+
   // Random sampling functions
   double U(double a, double b);
   double G(double mu, double sigma);
@@ -0,0 +1,75 @@
+// Event generation shards
+//
+// Statistics sidecar of one shard (shard index / shard count) of a run
+// split over independent processes or nodes, and the combination of the
+// shards into a total cross section.
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+#ifndef MSHARD_H
+#define MSHARD_H
+
+// C++
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gra {
+
+struct MShardStat {
+  int           shard  = 0;  // Shard index
+  int           shards = 1;  // Shard count
+  unsigned int  seed   = 0;  // Master random seed
+  std::uint64_t key    = 0;  // VEGAS checkpoint hash
+
+  std::string process;
+  std::string integrator;
+  std::string format;
+  std::string output;   // Event file
+  std::string created;  // Date and time of writing
+  double      sqrts    = 0.0;
+  bool        weighted = false;
+
+  // Event generation
+  double events    = 0.0;
+  double trials    = 0.0;
+  double overflow  = 0.0;
+  double maxweight = 0.0;
+
+  // Cross section and its error [barn]
+  double sigma     = 0.0;
+  double sigma_err = 0.0;
+
+  // Integral sums, before (base) and after (sums) the event generation
+  // VEGAS:      {sum I/var, sum I^2/var, sum 1/var} over iterations
+  // FLAT/NEURO: {sum W, sum W^2, evaluations}
+  std::array<double, 3> base = {{0.0, 0.0, 0.0}};
+  std::array<double, 3> sums = {{0.0, 0.0, 0.0}};
+
+  // Cross section and its error from integral sums
+  void CrossSection(const std::array<double, 3> &s);
+
+  // Write as JSON
+  void Write(const std::string &filename) const;
+
+  // Returns false if the file does not exist or is not valid
+  bool Read(const std::string &filename);
+
+  // Print one line summary
+  void Print() const;
+};
+
+// Shard suffix of output names, e.g. "_shard0003"
+std::string ShardSuffix(int shard, int shards);
+
+// Combine shards into total statistics. If all shards share the same base
+// (VEGAS checkpoint or deterministic integration), it is counted only once,
+// otherwise shards are treated as fully independent estimates, which requires
+// a different seed or checkpoint key per shard (throws otherwise).
+MShardStat MergeShards(const std::vector<MShardStat> &input, bool &shared_base);
+
+}  // namespace gra
+
+#endif
@@ -7,6 +7,7 @@
 #define MSPHERICAL_H
 
 // C++
+#include <array>
 #include <complex>
 #include <iostream>
 #include <vector>
@@ -94,16 +95,53 @@ struct SH {
   std::vector<double> t_lm_EML_error;
 };
 
+// Real spherical harmonic basis vector for all (l,m) up to LMAX at once,
+// output Y[LinearInd(l,m)] with the normalization of NReY(Y_complex_basis)
+class YLMBasis {
+ public:
+  YLMBasis(int lmax);
+  void Eval(double costheta, double phi, double *Y) const;
+
+  int LMAX  = 0;
+  int NCOEF = 0;
+
+ private:
+  std::vector<double> K;  // Normalization K(l,m), m >= 0, linear indexed
+};
+
+// Monte Carlo sums of one hypercell for one mode (fla, fid or det)
+struct SH_SUM {
+  Eigen::MatrixXd G;   // \sum_i Y_i Y_i^T
+  Eigen::MatrixXd G2;  // \sum_i (Y_i.Y_i) (Y_i.Y_i)^T (for the uncertainty)
+  Eigen::VectorXd E;   // \sum_i Y_i
+  Eigen::VectorXd E2;  // \sum_i Y_i.Y_i (for the uncertainty)
+
+  std::size_t N        = 0;  // Generated events in the hypercell
+  int         fiducial = 0;
+  int         selected = 0;  // Fiducial and selected
+};
+
+int ModeIndex(const std::string &mode);
+
+std::array<SH_SUM, 3> GetSums(const std::vector<Omega> &events, const std::vector<std::size_t> &ind,
+                              int LMAX);
+
 MMatrix<double> GetGMixing(const std::vector<Omega> &events, const std::vector<std::size_t> &ind,
                            int LMAX, const std::string &mode);
+MMatrix<double> GetGMixing(const SH_SUM &S, int LMAX, const std::string &mode);
 
 std::pair<std::vector<double>, std::vector<double>> GetELM(const std::vector<Omega> &      MC,
                                                            const std::vector<std::size_t> &ind,
                                                            int LMAX, const std::string &mode);
+std::pair<std::vector<double>, std::vector<double>> GetELM(const SH_SUM &S, int LMAX,
+                                                           const std::string &mode);
 
 std::vector<double> SphericalMoments(const std::vector<Omega> &      input,
                                      const std::vector<std::size_t> &ind, int LMAX,
                                      const std::string &mode);
+std::vector<double> SphericalMoments(const MMatrix<double> &Y_lm, const std::vector<Omega> &input,
+                                     const std::vector<std::size_t> &ind, int LMAX,
+                                     const std::string &mode);
 
 MMatrix<double> YLM(const std::vector<Omega> &events, int LMAX);
 
@@ -116,6 +154,13 @@ void PrintOutMoments(const std::vector<double> &x, const std::vector<double> &x_
 std::vector<std::size_t> GetIndices(const std::vector<Omega> &events, const std::vector<double> &M,
                                     const std::vector<double> &Pt, const std::vector<double> &Y);
 
+std::vector<std::vector<std::size_t>> GetHyperIndices(
+    const std::vector<Omega> &events, const std::vector<std::array<double, 2>> &M,
+    const std::vector<std::array<double, 2>> &Pt, const std::vector<std::array<double, 2>> &Y);
+
+void PrintHyperBin(const std::vector<double> &M, const std::vector<double> &Pt,
+                   const std::vector<double> &Y, std::size_t n, std::size_t N);
+
 void   TestSphericalIntegrals(int LMAX);
 int    LinearInd(int l, int m);
 double CalcError(double f2, double f, double N);
@@ -0,0 +1,164 @@
+// Fixed size Dirac spinor and 4x4 (gamma) matrix types [HEADER ONLY]
+//
+// Stack allocated, all products inlined, no dimension checks.
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+#ifndef MSPINOR_H
+#define MSPINOR_H
+
+// C++
+#include <array>
+#include <cmath>
+#include <complex>
+#include <initializer_list>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace gra {
+
+// Dirac spinor (4 complex components)
+using DSpinor = std::array<std::complex<double>, 4>;
+
+// Dirac matrix (4 x 4 complex), row-major
+class DMatrix {
+ public:
+  DMatrix() { d.fill(0.0); }
+
+  // For initializing with a = { {}, {}, {}, {} }
+  DMatrix(std::initializer_list<std::initializer_list<std::complex<double>>> list) {
+    d.fill(0.0);
+    std::size_t i = 0;
+    for (const auto &row : list) {
+      std::size_t j = 0;
+      for (const auto &x : row) {
+        d[4 * i + j] = x;
+        ++j;
+      }
+      ++i;
+    }
+  }
+
+  static DMatrix Identity() {
+    DMatrix I;
+    for (std::size_t i = 0; i < 4; ++i) { I.d[5 * i] = 1.0; }
+    return I;
+  }
+
+  // For indexing with [i][j] or (i,j)
+  std::complex<double> *      operator[](std::size_t row) { return d.data() + 4 * row; }
+  const std::complex<double> *operator[](std::size_t row) const { return d.data() + 4 * row; }
+  std::complex<double> &      operator()(std::size_t i, std::size_t j) { return d[4 * i + j]; }
+  const std::complex<double> &operator()(std::size_t i, std::size_t j) const {
+    return d[4 * i + j];
+  }
+
+  DMatrix &operator+=(const DMatrix &rhs) {
+    for (std::size_t k = 0; k < 16; ++k) { d[k] += rhs.d[k]; }
+    return *this;
+  }
+  DMatrix &operator-=(const DMatrix &rhs) {
+    for (std::size_t k = 0; k < 16; ++k) { d[k] -= rhs.d[k]; }
+    return *this;
+  }
+  DMatrix &operator*=(const std::complex<double> &rhs) {
+    for (std::size_t k = 0; k < 16; ++k) { d[k] *= rhs; }
+    return *this;
+  }
+
+  DMatrix operator-() const {
+    DMatrix out;
+    for (std::size_t k = 0; k < 16; ++k) { out.d[k] = -d[k]; }
+    return out;
+  }
+  DMatrix operator+(const DMatrix &rhs) const {
+    DMatrix out(*this);
+    return out += rhs;
+  }
+  DMatrix operator-(const DMatrix &rhs) const {
+    DMatrix out(*this);
+    return out -= rhs;
+  }
+  DMatrix operator*(const std::complex<double> &rhs) const {
+    DMatrix out(*this);
+    return out *= rhs;
+  }
+  DMatrix operator/(const std::complex<double> &rhs) const { return *this * (1.0 / rhs); }
+
+  // Matrix * Matrix
+  DMatrix operator*(const DMatrix &rhs) const {
+    DMatrix C;
+    for (std::size_t i = 0; i < 4; ++i) {
+      for (std::size_t k = 0; k < 4; ++k) {
+        const std::complex<double> a = d[4 * i + k];
+        for (std::size_t j = 0; j < 4; ++j) { C.d[4 * i + j] += a * rhs.d[4 * k + j]; }
+      }
+    }
+    return C;
+  }
+
+  // Matrix * column spinor
+  DSpinor operator*(const DSpinor &rhs) const {
+    DSpinor out;
+    for (std::size_t i = 0; i < 4; ++i) {
+      out[i] = d[4 * i] * rhs[0] + d[4 * i + 1] * rhs[1] + d[4 * i + 2] * rhs[2] +
+               d[4 * i + 3] * rhs[3];
+    }
+    return out;
+  }
+
+  // Frobenius norm
+  double FrobNorm() const {
+    double sum = 0.0;
+    for (std::size_t k = 0; k < 16; ++k) { sum += std::norm(d[k]); }
+    return std::sqrt(sum);
+  }
+
+  void Print(const std::string &name = "") const {
+    std::cout << "DMatrix::Print: " << name << " [4 x 4]" << std::endl;
+    std::cout << std::setprecision(4);
+    for (std::size_t i = 0; i < 4; ++i) {
+      for (std::size_t j = 0; j < 4; ++j) { std::cout << d[4 * i + j] << "\t"; }
+      std::cout << std::endl;
+    }
+  }
+
+  std::array<std::complex<double>, 16> d;
+};
+
+namespace dirac {
+
+// Row spinor * Matrix
+inline DSpinor VecMat(const DSpinor &a, const DMatrix &M) {
+  DSpinor out;
+  for (std::size_t j = 0; j < 4; ++j) {
+    out[j] = a[0] * M.d[j] + a[1] * M.d[4 + j] + a[2] * M.d[8 + j] + a[3] * M.d[12 + j];
+  }
+  return out;
+}
+
+// Inner product a^T b (no conjugation)
+inline std::complex<double> Dot(const DSpinor &a, const DSpinor &b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+}
+
+// Sandwich product \bar{a} M b
+inline std::complex<double> Sandwich(const DSpinor &a, const DMatrix &M, const DSpinor &b) {
+  return Dot(VecMat(a, M), b);
+}
+
+// Outer product a b^T
+inline DMatrix Outer(const DSpinor &a, const DSpinor &b) {
+  DMatrix out;
+  for (std::size_t i = 0; i < 4; ++i) {
+    for (std::size_t j = 0; j < 4; ++j) { out.d[4 * i + j] = a[i] * b[j]; }
+  }
+  return out;
+}
+
+}  // namespace dirac
+}  // namespace gra
+
+#endif
@@ -49,27 +49,46 @@ class MProc {
 
   virtual ~MProc() {}  // Needs to be virtual
 
+  // Construct the amplitude objects and resolve the final state routing,
+  // once per process copy before the event loop
+  virtual void Bind(gra::LORENTZSCALAR& lts) = 0;
+
+  // Amplitude squared, without string or final state checks
   virtual double Amp2(gra::LORENTZSCALAR& lts) = 0;
 
+  // Screening loop context (only Tensor Pomeron amplitudes cache currently)
+  void LoopBegin(gra::LORENTZSCALAR& lts) {
+    if (Tensor != nullptr) { Tensor->LoopBegin(lts); }
+  }
+  void LoopEnd() {
+    if (Tensor != nullptr) { Tensor->LoopEnd(); }
+  }
+
   // Processes usable with different fluxes
   // 2y ->
-  double GammaGammaCON(gra::LORENTZSCALAR& lts) {
-    double amp2 = 0.0;
+  void BindGammaGammaCON(gra::LORENTZSCALAR& lts) {
+    InitGamma(lts);
     if (!AssertN(2, lts.decaytree.size())) {
       throw std::invalid_argument(ISTATE + "[" + CHANNEL + "] requires 2-body final state");
     }
-
-    if (AssertN({24, -24}, PDGlist(lts))) {
-      amp2 = Gamma->AmpMG5_yy_ww.CalcAmp2(lts, 0.0);
-    } else if (AssertLeptonQuarkMonopolePair(PDGlist(lts))) {
-      amp2 = Gamma->yyffbar(lts);
+    const std::vector<int> pdg = PDGlist(lts);
+    if (AssertN({24, -24}, pdg)) {
+      yyCON = YYCON::WW;
+    } else if (AssertLeptonQuarkMonopolePair(pdg)) {
+      yyCON = YYCON::FFBAR;
     } else {
       ThrowUnknownFinalState();
     }
-
-    return amp2;
+  }
+  double GammaGammaCON(gra::LORENTZSCALAR& lts) {
+    if (yyCON == YYCON::WW) { return Gamma->AmpMG5_yy_ww.CalcAmp2(lts, 0.0); }
+    return Gamma->yyffbar(lts);
   }
 
+  // Gamma-Gamma continuum final state
+  enum class YYCON { WW, FFBAR };
+  YYCON yyCON = YYCON::FFBAR;
+
   // Process class containers
   std::unique_ptr<MGamma>         Gamma  = nullptr;
   std::unique_ptr<MDurham>        Durham = nullptr;
@@ -136,8 +155,8 @@ class PROC_0 : public MProc {
  public:
   PROC_0() : MProc("yy", "RES", {"Parametric resonance", "kt-EPA"}) {}
   ~PROC_0() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { InitGamma(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitGamma(lts);
     const double amp2 = Gamma->yyX(lts, lts.RESONANCES.begin()->second);
     return flux::ApplyktEPAfluxes(amp2, lts);
   }
@@ -146,8 +165,8 @@ class PROC_1 : public MProc {
  public:
   PROC_1() : MProc("yy", "Higgs", {"SM Higgs", "kt-EPA"}) {}
   ~PROC_1() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { InitGamma(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitGamma(lts);
     const double amp2 = Gamma->yyHiggs(lts);
     return flux::ApplyktEPAfluxes(amp2, lts);
   }
@@ -156,8 +175,8 @@ class PROC_2 : public MProc {
  public:
   PROC_2() : MProc("yy", "monopolium(0)", {"Monopolium (J=0)", "kt-EPA"}) {}
   ~PROC_2() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { InitGamma(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitGamma(lts);
     const double amp2 = Gamma->yyMP(lts);
     return flux::ApplyktEPAfluxes(amp2, lts);
   }
@@ -166,8 +185,8 @@ class PROC_3 : public MProc {
  public:
   PROC_3() : MProc("yy", "CON", {"Continuum l+l-, qqbar, W+W-, monopolepair", "kt-EPA"}) {}
   ~PROC_3() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { BindGammaGammaCON(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitGamma(lts);
     double amp2 = GammaGammaCON(lts);
     return flux::ApplyktEPAfluxes(amp2, lts);
   }
@@ -176,12 +195,13 @@ class PROC_4 : public MProc {
  public:
   PROC_4() : MProc("yy", "QED", {"Continuum l+l-, qqbar", "FULL QED"}) {}
   ~PROC_4() {}
-  virtual double Amp2(gra::LORENTZSCALAR& lts) {
+  virtual void Bind(gra::LORENTZSCALAR& lts) {
     InitTensor(lts);
-
     if (!AssertN(2, lts.decaytree.size())) {
       throw std::invalid_argument(ISTATE + "[" + CHANNEL + "] requires 2-body final state");
     }
+  }
+  virtual double Amp2(gra::LORENTZSCALAR& lts) {
     return Tensor->ME4(lts);
   }
 };
@@ -195,8 +215,8 @@ class PROC_5 : public MProc {
  public:
   PROC_5() : MProc("X", "EL", {"Elastic", "Eikonal Pomeron", "Use with screening loop on"}) {}
   ~PROC_5() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { InitRegge(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitRegge(lts);
     return abs2(Regge->ME2(lts, 1));
   }
 };
@@ -204,8 +224,8 @@ class PROC_6 : public MProc {
  public:
   PROC_6() : MProc("X", "SD", {"Single Diffractive", "Triple Pomeron", "With TOY fragmentation"}) {}
   ~PROC_6() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { InitRegge(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitRegge(lts);
     return abs2(Regge->ME2(lts, 2));
   }
 };
@@ -213,8 +233,8 @@ class PROC_7 : public MProc {
  public:
   PROC_7() : MProc("X", "DD", {"Double Diffractive", "Triple Pomeron", "With TOY fragmentation"}) {}
   ~PROC_7() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { InitRegge(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitRegge(lts);
     return abs2(Regge->ME2(lts, 3));
   }
 };
@@ -223,6 +243,7 @@ class PROC_8 : public MProc {
   PROC_8()
       : MProc("X", "ND", {"Non-Diffractive", "N-cut soft Pomerons", "With TOY fragmentation"}) {}
   ~PROC_8() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) {}
   virtual double Amp2(gra::LORENTZSCALAR& lts) { return 1.0; }
 };
 
@@ -234,8 +255,8 @@ class PROC_9 : public MProc {
  public:
   PROC_9() : MProc("PP", "RES", {"Parametric resonance", "Pomeron"}) {}
   ~PROC_9() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { InitRegge(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitRegge(lts);
     std::complex<double> A = 0.0;
 
     // Coherent sum of Resonances (loop over)
@@ -267,8 +288,8 @@ class PROC_10 : public MProc {
       : MProc("PP", "RESHEL",
               {"Sliding pomeron helicity amplitudes", "Pomeron", "DEVELOPER ONLY PROCESS!"}) {}
   ~PROC_10() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { InitRegge(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitRegge(lts);
     std::complex<double> A = 0.0;
     A                      = Regge->ME3HEL(lts, lts.RESONANCES.begin()->second);
     return abs2(A);
@@ -279,8 +300,8 @@ class PROC_11 : public MProc {
  public:
   PROC_11() : MProc("PP", "RESTENSOR", {"Parametric resonance", "Tensor Pomeron"}) {}
   ~PROC_11() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { InitTensor(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitTensor(lts);
     return Tensor->ME3(lts);
   }
 };
@@ -289,12 +310,13 @@ class PROC_12 : public MProc {
  public:
   PROC_12() : MProc("PP", "CONTENSOR", {"Hadron continuum 2-body", "Tensor Pomeron"}) {}
   ~PROC_12() {}
-  virtual double Amp2(gra::LORENTZSCALAR& lts) {
+  virtual void Bind(gra::LORENTZSCALAR& lts) {
     InitTensor(lts);
-
     if (!AssertN(2, lts.decaytree.size())) {
       throw std::invalid_argument(ISTATE + "[" + CHANNEL + "] requires 2-body final state");
     }
+  }
+  virtual double Amp2(gra::LORENTZSCALAR& lts) {
     return Tensor->ME4(lts);
   }
 };
@@ -305,13 +327,14 @@ class PROC_13 : public MProc {
       : MProc("PP", "CONTENSOR24",
               {"Hadron continuum 2-body > 4-body", "Tensor Pomeron", "DEVELOPER ONLY PROCESS!"}) {}
   ~PROC_13() {}
-  virtual double Amp2(gra::LORENTZSCALAR& lts) {
+  virtual void Bind(gra::LORENTZSCALAR& lts) {
     InitTensor(lts);
-
     if (!AssertN(2, lts.decaytree.size()) && !AssertN(4, lts.decaytree.size())) {
       throw std::invalid_argument(ISTATE + "[" + CHANNEL +
                                   "] requires 2 > {2x} or 4-body final state");
     }
+  }
+  virtual double Amp2(gra::LORENTZSCALAR& lts) {
     return Tensor->ME6(lts);
   }
 };
@@ -322,13 +345,13 @@ class PROC_14 : public MProc {
       : MProc("PP", "RES+CONTENSOR",
               {"Hadron resonances + continuum 2-body", "Tensor Pomeron / yP"}) {}
   ~PROC_14() {}
-  virtual double Amp2(gra::LORENTZSCALAR& lts) {
+  virtual void Bind(gra::LORENTZSCALAR& lts) {
     InitTensor(lts);
-
     if (!AssertN(2, lts.decaytree.size())) {
       throw std::invalid_argument(ISTATE + "[" + CHANNEL + "] requires 2-body final state");
     }
-
+  }
+  virtual double Amp2(gra::LORENTZSCALAR& lts) {
     // 1. Evaluate continuum matrix element -> helicity amplitudes to lts.hamp
     Tensor->ME4(lts);
 
@@ -362,21 +385,25 @@ class PROC_15 : public MProc {
  public:
   PROC_15() : MProc("PP", "CON", {"Hadron continuum 2/4/6-body", "Pomeron"}) {}
   ~PROC_15() {}
-  virtual double Amp2(gra::LORENTZSCALAR& lts) {
+  virtual void Bind(gra::LORENTZSCALAR& lts) {
     InitRegge(lts);
-
-    std::complex<double> A = 0.0;
-    if (AssertN(2, lts.decaytree.size())) {
-      A = Regge->ME4(lts, 1);
-    } else if (AssertN(4, lts.decaytree.size())) {
-      A = Regge->ME6(lts);
-    } else if (AssertN(6, lts.decaytree.size())) {
-      A = Regge->ME8(lts);
-    } else {
+    nbody = lts.decaytree.size();
+    if (nbody != 2 && nbody != 4 && nbody != 6) {
       throw std::invalid_argument(ISTATE + "[" + CHANNEL + "] requires 2, 4 or 6-body final state");
     }
+  }
+  virtual double Amp2(gra::LORENTZSCALAR& lts) {
+    std::complex<double> A = 0.0;
+    switch (nbody) {
+      case 2: A = Regge->ME4(lts, 1); break;
+      case 4: A = Regge->ME6(lts); break;
+      case 6: A = Regge->ME8(lts); break;
+    }
     return abs2(A);
   }
+
+ private:
+  std::size_t nbody = 0;
 };
 
 
@@ -384,12 +411,13 @@ class PROC_16 : public MProc {
  public:
   PROC_16() : MProc("PP", "CON-", {"Hadron continuum 2-body with [t-u] amp.", "Pomeron"}) {}
   ~PROC_16() {}
-  virtual double Amp2(gra::LORENTZSCALAR& lts) {
+  virtual void Bind(gra::LORENTZSCALAR& lts) {
     InitRegge(lts);
-
     if (!AssertN(2, lts.decaytree.size())) {
       throw std::invalid_argument(ISTATE + "[" + CHANNEL + "] requires 2-body final state");
     }
+  }
+  virtual double Amp2(gra::LORENTZSCALAR& lts) {
     std::complex<double> A = Regge->ME4(lts, -1);
     return abs2(A);
   }
@@ -400,13 +428,14 @@ class PROC_17 : public MProc {
  public:
   PROC_17() : MProc("PP", "RES+CON", {"Hadron resonances + continuum 2-body", "Pomeron / yP"}) {}
   ~PROC_17() {}
-  virtual double Amp2(gra::LORENTZSCALAR& lts) {
+  virtual void Bind(gra::LORENTZSCALAR& lts) {
     InitRegge(lts);
-    std::complex<double> A = 0.0;
-
     if (!AssertN(2, lts.decaytree.size())) {
       throw std::invalid_argument(ISTATE + "[" + CHANNEL + "] requires 2-body final state");
     }
+  }
+  virtual double Amp2(gra::LORENTZSCALAR& lts) {
+    std::complex<double> A = 0.0;
 
     // 1. Continuum matrix element
     A = Regge->ME4(lts, 1);
@@ -442,8 +471,8 @@ class PROC_18 : public MProc {
  public:
   PROC_18() : MProc("yP", "RES", {"Photoproduced resonance", "kt-EPA x Pomeron"}) {}
   ~PROC_18() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { InitRegge(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitRegge(lts);
     std::complex<double> A = 0.0;
 
     // Coherent sum of Resonances (loop over)
@@ -462,8 +491,8 @@ class PROC_19 : public MProc {
  public:
   PROC_19() : MProc("yP", "RESTENSOR", {"Photoproduced resonance", "QED x Tensor Pomeron"}) {}
   ~PROC_19() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { InitTensor(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitTensor(lts);
     return Tensor->ME3(lts);
   }
 };
@@ -473,8 +502,8 @@ class PROC_20 : public MProc {
  public:
   PROC_20() : MProc("OP", "RES", {"Oddproduced resonance", "Odderon x Pomeron"}) {}
   ~PROC_20() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { InitRegge(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitRegge(lts);
     std::complex<double> A = 0.0;
     // Coherent sum of Resonances (loop over)
     for (auto& x : lts.RESONANCES) {
@@ -495,12 +524,16 @@ class PROC_21 : public MProc {
  public:
   PROC_21() : MProc("gg", "chic(0)", {"QCD resonance chic(0)", "Durham QCD"}) {}
   ~PROC_21() {}
-  virtual double Amp2(gra::LORENTZSCALAR& lts) {
+  virtual void Bind(gra::LORENTZSCALAR& lts) {
     InitDurham(lts);
-    double amp2 = 0.0;
-    amp2        = Durham->DurhamQCD(lts, CHANNEL);
-    return amp2;
+    mode = MDurham::GetProcess(CHANNEL);
   }
+  virtual double Amp2(gra::LORENTZSCALAR& lts) {
+    return Durham->DurhamQCD(lts, mode);
+  }
+
+ private:
+  MDurham::DPROC mode = MDurham::DPROC::CHIC0;
 };
 
 class PROC_22 : public MProc {
@@ -509,19 +542,22 @@ class PROC_22 : public MProc {
       : MProc("gg", "CON",
               {"QCD continuum gg, 2 x pseudoscalar", "Durham QCD", "UNDER VALIDATION!"}) {}
   ~PROC_22() {}
-  virtual double Amp2(gra::LORENTZSCALAR& lts) {
+  virtual void Bind(gra::LORENTZSCALAR& lts) {
     InitDurham(lts);
-
-    double amp2 = 0.0;
     if (AssertN({21, 21}, PDGlist(lts))) {
-      amp2 = Durham->DurhamQCD(lts, "gg");
+      mode = MDurham::DPROC::GG;
     } else if (AssertN(2, lts.decaytree.size())) {
-      amp2 = Durham->DurhamQCD(lts, "MMbar");
+      mode = MDurham::DPROC::MMBAR;
     } else {
       ThrowUnknownFinalState();
     }
-    return amp2;
   }
+  virtual double Amp2(gra::LORENTZSCALAR& lts) {
+    return Durham->DurhamQCD(lts, mode);
+  }
+
+ private:
+  MDurham::DPROC mode = MDurham::DPROC::MMBAR;
 };
 
 class PROC_23 : public MProc {
@@ -529,10 +565,9 @@ class PROC_23 : public MProc {
   PROC_23()
       : MProc("gg", "FLUX", {"Durham flux with |A|^2 = 1", "Durham QCD", "SYSTEM TEST PROCESS!"}) {}
   ~PROC_23() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { InitDurham(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitDurham(lts);
-
-    return Durham->DurhamQCD(lts, "FLUX");
+    return Durham->DurhamQCD(lts, MDurham::DPROC::FLUX);
   }
 };
 
@@ -546,8 +581,8 @@ class PROC_24 : public MProc {
   PROC_24()
       : MProc("yy_LUX", "CON", {"Continuum l+l, qqbar, W+W-, monopolepair", "Collinear LUX-PDF"}) {}
   ~PROC_24() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { BindGammaGammaCON(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitGamma(lts);
     double amp2 = GammaGammaCON(lts);
     return flux::ApplyLUXfluxes(amp2, lts);
   }
@@ -559,8 +594,8 @@ class PROC_25 : public MProc {
       : MProc("yy_DZ", "CON",
               {"Continuum l+l, qqbar, W+W-, monopolepair", "Collinear Drees-Zeppenfeld EPA"}) {}
   ~PROC_25() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { BindGammaGammaCON(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitGamma(lts);
     double amp2 = GammaGammaCON(lts);
     return flux::ApplyDZfluxes(amp2, lts);
   }
@@ -571,8 +606,8 @@ class PROC_26 : public MProc {
   PROC_26()
       : MProc("yy", "FLUX", {"kt-EPA flux with |A|^2 = 1", "kt-EPA", "SYSTEM TEST PROCESS!"}) {}
   ~PROC_26() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { InitGamma(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitGamma(lts);
     double amp2 = 1.0;
     return flux::ApplyktEPAfluxes(amp2, lts);
   }
@@ -585,8 +620,8 @@ class PROC_27 : public MProc {
             "yy_DZ", "FLUX",
             {"DZ flux with |A|^2 = 1", "Collinear Drees-Zeppenfeld EPA", "SYSTEM TEST PROCESS!"}) {}
   ~PROC_27() {}
+  virtual void Bind(gra::LORENTZSCALAR& lts) { InitGamma(lts); }
   virtual double Amp2(gra::LORENTZSCALAR& lts) {
-    InitGamma(lts);
     double amp2 = 1.0;
     return flux::ApplyDZfluxes(amp2, lts);
   }
@@ -602,12 +637,36 @@ class MSubProc {
   MSubProc() {}
   ~MSubProc();
 
-  double GetBareAmplitude2(gra::LORENTZSCALAR& lts);
+  // Copies do not share process objects, each copy binds its own
+  MSubProc(const MSubProc& other);
+  MSubProc& operator=(const MSubProc& other);
+
+  // Activate the process and resolve its final state routing
+  void Bind(gra::LORENTZSCALAR& lts);
+
+  double GetBareAmplitude2(gra::LORENTZSCALAR& lts) {
+    if (active == nullptr) { Bind(lts); }
+    return active->Amp2(lts);
+  }
+
+  // Amplitude parts invariant over the screening loop are cached between these
+  void LoopBegin(gra::LORENTZSCALAR& lts) {
+    if (active == nullptr) { Bind(lts); }
+    active->LoopBegin(lts);
+  }
+  void LoopEnd() {
+    if (active != nullptr) { active->LoopEnd(); }
+  }
 
   std::string  ISTATE;       // "PP","yy","gg" etc.
   std::string  CHANNEL;      // "CON", "RES" etc.
   unsigned int LIPSDIM = 0;  // Lorentz Invariant Phase Space Dimension
 
+  // Channel identifier for per event checks
+  enum class ECHANNEL { OTHER, EL, SD, DD, ND };
+  ECHANNEL CHANNEL_ID = ECHANNEL::OTHER;
+  bool     DURHAM     = false;  // ISTATE == "gg"
+
   // Process descriptions
   std::map<std::string, std::vector<std::string>> Processes;
 
@@ -622,6 +681,7 @@ class MSubProc {
   void ActivateProcess();
 
   std::vector<MProc*> pr;
+  MProc*              active = nullptr;
 };
 
 }  // namespace gra
@@ -15,6 +15,7 @@
 #include "LHAPDF/LHAPDF.h"
 
 // Own
+#include "Graniitti/MArrayCache.h"
 #include "Graniitti/MAux.h"
 #include "Graniitti/MMath.h"
 #include "Graniitti/MTimer.h"
@@ -48,6 +49,7 @@ struct MSudakovNumerics {
   double sqrts = 0.0;
 
   bool DEBUG = false;
+  bool CSV   = false;  // Export arrays also as CSV text
 
   void ReadParameters() {
     // Read and parse
@@ -91,6 +93,13 @@ struct MSudakovNumerics {
                         " (Check for extra/missing commas)";
       throw std::invalid_argument(str);
     }
+
+    // Optional
+    try {
+      CSV = j.at("NUMERICS_SUDAKOV").at("CSV");
+    } catch (...) {
+      // Do nothing
+    }
   }
 };
 
@@ -164,9 +173,27 @@ class IArray2D {
     return str;
   }
 
-  bool                      WriteArray(const std::string &filename, bool overwrite) const;
-  bool                      ReadArray(const std::string &filename);
+  // Binary cache <filename>.bin, with optional CSV text <filename>.csv
+  bool WriteArray(const std::string &filename, bool overwrite, bool csv = false) const;
+  bool ReadArray(const std::string &filename);
+
+  // CSV text import/export
+  bool WriteArrayCSV(const std::string &filename, bool overwrite) const;
+  bool ReadArrayCSV(const std::string &filename);
+
   std::pair<double, double> Interpolate2D(double A, double B) const;
+
+  // Batched Interpolate2D(A[k], B) -> (Z[k], dZ[k]), k = 0,...,n-1,
+  // with the B-direction (fixed row pair) weights computed once
+  void Interpolate2DBatch(const double *A, double B, double *Z, double *dZ, std::size_t n) const;
+
+ private:
+  MArrayHeader GetHeader() const;
+
+  // Read-only values [a, b, Z, dZ] per grid point (row-major), shared between copies.
+  // D is resolved once by ReadArray, interpolation requires a successful ReadArray.
+  std::shared_ptr<const MArrayCache> cache = nullptr;
+  const double *                     D     = nullptr;
 };
 
 // Sudakov suppression and skewed pdf
@@ -183,6 +210,9 @@ class MSudakov {
   std::pair<double, double> Sudakov_T(double qt2, double M);
 
   double fg_xQ2M(double x, double q2, double M) const;
+
+  // Batched fg_xQ2M(x, q2[k], M) -> out[k], k = 0,...,n-1, with x and M fixed
+  void fg_xQ2M_Batch(double x, const double *q2, double M, double *out, std::size_t n) const;
   double AlphaS_Q2(double q2) const;
   double NumFlavor(double q2) const;
   double xg_xQ2(double x, double Q2) const;
@@ -113,6 +113,12 @@ class MTensorPomeron : public MDirac {
   double ME4(gra::LORENTZSCALAR &lts) const;
   double ME6(gra::LORENTZSCALAR &lts) const;
 
+  // Screening loop context: parts invariant over the loop kt-nodes (beam
+  // spinors, resonance decay vertices while the decay products stay fixed)
+  // are evaluated once per phase space point
+  void LoopBegin(const gra::LORENTZSCALAR &lts) const;
+  void LoopEnd() const { loop.active = false; }
+
   // Scalar, Pseudoscalar, Tensor coupling structures
   FTensor::Tensor4<std::complex<double>, 4, 4, 4, 4> iG_PPS_0() const;
   FTensor::Tensor4<std::complex<double>, 4, 4, 4, 4> iG_PPS_1(const M4Vec &q1, const M4Vec &q2,
@@ -141,26 +147,23 @@ class MTensorPomeron : public MDirac {
 
   FTensor::Tensor2<std::complex<double>, 4, 4> iG_PppHE(const M4Vec &prime, const M4Vec p) const;
 
-  FTensor::Tensor1<std::complex<double>, 4> iG_yee(
-      const M4Vec &prime, const M4Vec &p, const std::vector<std::complex<double>> &ubar,
-      const std::vector<std::complex<double>> &u) const;
+  FTensor::Tensor1<std::complex<double>, 4> iG_yee(const M4Vec &prime, const M4Vec &p,
+                                                   const DSpinor &ubar, const DSpinor &u) const;
 
-  FTensor::Tensor2<std::complex<double>, 4, 4> iG_yeebary(
-      const std::vector<std::complex<double>> &ubar, const MMatrix<std::complex<double>> &iSF,
-      const std::vector<std::complex<double>> &v) const;
+  FTensor::Tensor2<std::complex<double>, 4, 4> iG_yeebary(const DSpinor &ubar, const DMatrix &iSF,
+                                                          const DSpinor &v) const;
 
-  FTensor::Tensor1<std::complex<double>, 4> iG_ypp(
-      const M4Vec &prime, const M4Vec &p, const std::vector<std::complex<double>> &ubar,
-      const std::vector<std::complex<double>> &u) const;
+  FTensor::Tensor1<std::complex<double>, 4> iG_ypp(const M4Vec &prime, const M4Vec &p,
+                                                   const DSpinor &ubar, const DSpinor &u) const;
 
-  FTensor::Tensor2<std::complex<double>, 4, 4> iG_Ppp(
-      const M4Vec &prime, const M4Vec &p, const std::vector<std::complex<double>> &ubar,
-      const std::vector<std::complex<double>> &u) const;
+  FTensor::Tensor2<std::complex<double>, 4, 4> iG_Ppp(const M4Vec &prime, const M4Vec &p,
+                                                      const DSpinor &ubar, const DSpinor &u) const;
 
-  FTensor::Tensor4<std::complex<double>, 4, 4, 4, 4> iG_PppbarP(
-      const M4Vec &prime, const std::vector<std::complex<double>> &ubar, const M4Vec &pt,
-      const MMatrix<std::complex<double>> &iSF, const std::vector<std::complex<double>> &v,
-      const M4Vec &p) const;
+  FTensor::Tensor4<std::complex<double>, 4, 4, 4, 4> iG_PppbarP(const M4Vec &prime,
+                                                                const DSpinor &ubar,
+                                                                const M4Vec &pt, const DMatrix &iSF,
+                                                                const DSpinor &v,
+                                                                const M4Vec &p) const;
 
   FTensor::Tensor2<std::complex<double>, 4, 4>       iG_Ppsps(const M4Vec &prime, const M4Vec &p,
                                                               double g1) const;
@@ -254,6 +257,35 @@ class MTensorPomeron : public MDirac {
   MTensor<double> T2;
   MTensor<double> T3;
 
+  // Pomeron and tensor Reggeon propagator structure
+  // g_{\mu\kappa} g_{\nu\lambda} + g_{\mu\lambda} g_{\nu\kappa} - 1/2 g_{\mu\nu} g_{\kappa\lambda}
+  FTensor::Tensor4<double, 4, 4, 4, 4> D_PT;
+
+  // Resonance decay vertex, a function of the decay products only
+  struct DecayVertex {
+    bool                                                      valid = false;
+    M4Vec                                                     p3;
+    M4Vec                                                     p4;
+    std::vector<std::complex<double>>                         amp;     // Scalar per helicity
+    FTensor::Tensor1<std::complex<double>, 4>                 vec;     // Vector current
+    std::vector<FTensor::Tensor2<std::complex<double>, 4, 4>> tensor;  // Rank-2 per helicity
+  };
+
+  // Screening loop context
+  struct LoopContext {
+    bool                     active = false;
+    std::array<DSpinor, 2>   u_a;
+    std::array<DSpinor, 2>   u_b;
+    std::vector<DecayVertex> decay;  // Per resonance
+  };
+  mutable LoopContext loop;
+
+  DecayVertex &LoopDecayVertex(std::size_t r, const M4Vec &p3, const M4Vec &p4,
+                               DecayVertex &local) const;
+
+  void BeamSpinors(const gra::LORENTZSCALAR &lts, std::array<DSpinor, 2> &u_a,
+                   std::array<DSpinor, 2> &u_b) const;
+
   // Parameters
   MTensorPomeronParam Param;
 };
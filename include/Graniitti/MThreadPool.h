@@ -0,0 +1,70 @@
+// Persistent worker thread pool with optional CPU affinity
+//
+// Workers are created once and kept alive across VEGAS grid iterations
+// and the integration -> event generation transition, so that each
+// worker keeps its own (first-touch allocated) process clone warm.
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+#ifndef MTHREADPOOL_H
+#define MTHREADPOOL_H
+
+// C++
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gra {
+class MThreadPool {
+ public:
+  // affinity: "none", "compact" (worker k -> cpu k) or
+  //           "numa" (workers interleaved over NUMA nodes)
+  MThreadPool(unsigned int N, const std::string &affinity = "none");
+  ~MThreadPool();
+
+  // Run task(tid) on every worker tid = 0,...,N-1 and wait until all are done
+  void Run(const std::function<void(unsigned int)> &task);
+
+  unsigned int      Size() const { return workers.size(); }
+  const std::string GetAffinity() const { return AFFINITY; }
+
+  // CPU id list for each worker (empty if no affinity in use)
+  const std::vector<int> &GetCPUMap() const { return cpumap; }
+
+  // Valid affinity modes
+  static bool ValidAffinity(const std::string &affinity) {
+    return (affinity == "none" || affinity == "compact" || affinity == "numa");
+  }
+
+ private:
+  // Copy and assignment disabled
+  MThreadPool(const MThreadPool &);
+  MThreadPool &operator=(const MThreadPool &);
+
+  void WorkerLoop(unsigned int tid);
+  void CreateCPUMap(unsigned int N);
+
+  std::string              AFFINITY = "none";
+  std::vector<std::thread> workers;
+  std::vector<int>         cpumap;
+
+  std::mutex              mtx;
+  std::condition_variable cv_task;
+  std::condition_variable cv_done;
+
+  std::function<void(unsigned int)> task_;
+  std::exception_ptr                task_exception = nullptr;
+  std::uint64_t                     generation = 0;
+  unsigned int                      pending    = 0;
+  bool                              stop       = false;
+};
+
+}  // namespace gra
+
+#endif
@@ -9,8 +9,16 @@
 #ifndef MVEGAS_H
 #define MVEGAS_H
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
+#include "Graniitti/MCW.h"
+
 
 namespace gra {
 
@@ -27,11 +35,162 @@ struct VEGASPARAM {
   int          DEBUG     = -1;     // Debug mode
 
   // User cannot set these
+  unsigned int CHUNK   = 256;      // Number of calls per scheduling chunk
+  unsigned int WINDOW  = 4;        // Chunk reduction buffers per thread
   unsigned int MAXFDIM = 100;      // Maximum integral dimension
   double       EPS     = 1.0e-30;  // Epsilon parameter
 };
 
 
+// Thread local load balance information
+struct alignas(64) VEGASLocal {
+  void Clear() {
+    busytime = 0.0;
+    calls    = 0.0;
+    chunks   = 0.0;
+  }
+
+  double busytime = 0.0;  // Seconds spent in this iteration
+  double calls    = 0.0;  // Integrand calls done
+  double chunks   = 0.0;  // Chunks done
+};
+
+// Accumulators of one chunk (a reduction buffer slot)
+struct alignas(64) VEGASSlot {
+  // Allocate [BINS x FDIM] grid accumulators (none with bins = 0)
+  void Init(unsigned int bins, unsigned int fdim) {
+    if (fmat.size() != bins || (bins > 0 && fmat[0].size() != fdim)) {
+      fmat  = std::vector<std::vector<double>>(bins, std::vector<double>(fdim, 0.0));
+      f2mat = std::vector<std::vector<double>>(bins, std::vector<double>(fdim, 0.0));
+    }
+    Clear();
+  }
+
+  // Zero the accumulators (keeps memory)
+  void Clear() {
+    for (auto &row : fmat) { std::fill(row.begin(), row.end(), 0.0); }
+    for (auto &row : f2mat) { std::fill(row.begin(), row.end(), 0.0); }
+    fsum         = 0.0;
+    f2sum        = 0.0;
+    DW_sum       = gra::kinematics::MCWSUM();
+    DW_sum_exact = gra::kinematics::MCWSUM();
+  }
+
+  // Add the sums of other (of the same dimensions)
+  void Add(const VEGASSlot &other) {
+    fsum += other.fsum;
+    f2sum += other.f2sum;
+    DW_sum.Add(other.DW_sum);
+    DW_sum_exact.Add(other.DW_sum_exact);
+    for (std::size_t i = 0; i < fmat.size(); ++i) {
+      for (std::size_t j = 0; j < fmat[i].size(); ++j) {
+        fmat[i][j] += other.fmat[i][j];
+        f2mat[i][j] += other.f2mat[i][j];
+      }
+    }
+  }
+
+  double fsum  = 0.0;
+  double f2sum = 0.0;
+
+  // Phase space weight sums of the chunk
+  gra::kinematics::MCWSUM DW_sum;
+  gra::kinematics::MCWSUM DW_sum_exact;
+
+  // Matrices [BINS x FDIM]
+  std::vector<std::vector<double>> fmat;
+  std::vector<std::vector<double>> f2mat;
+};
+
+// Ordered reduction of chunk accumulators. Threads take chunks dynamically,
+// chunk c is accumulated into the buffer c % W of a ring of W buffers, and the
+// buffers are added to the total in chunk order. Thus the sums do not depend on
+// the number of threads or on which thread ran which chunk, while the memory is
+// bounded by a few buffers per thread.
+class VEGASReducer {
+ public:
+  // Split calls into chunks and reset, returns the number of chunks. Grid
+  // accumulators [bins x fdim] are allocated with bins > 0.
+  unsigned int Init(unsigned int calls, const VEGASPARAM &param, unsigned int threads,
+                    unsigned int bins, unsigned int fdim) {
+    Nchunks              = (calls + param.CHUNK - 1) / param.CHUNK;
+    const unsigned int W = std::max(1U, std::min(Nchunks, param.WINDOW * threads));
+    if (buffers.size() != W) {
+      buffers.resize(W);
+      ready.reset(new std::atomic<std::int64_t>[W]);
+    }
+    for (std::size_t w = 0; w < W; ++w) {
+      buffers[w].Init(bins, fdim);
+      ready[w] = -1;
+    }
+    total.Init(bins, fdim);
+    next    = 0;
+    reduced = 0;
+    aborted = false;
+    return Nchunks;
+  }
+
+  // Take the next chunk, returns false if all chunks have been taken
+  bool Next(unsigned int &chunk) {
+    chunk = next.fetch_add(1);
+    return chunk < Nchunks;
+  }
+
+  // Buffer of a taken chunk, waits until the previous chunk using the same
+  // buffer has been reduced (nullptr if aborted meanwhile)
+  VEGASSlot *Acquire(unsigned int chunk) {
+    while (chunk >= reduced.load() + buffers.size()) {
+      if (aborted) { return nullptr; }
+      Reduce();
+      std::this_thread::yield();
+    }
+    return &buffers[chunk % buffers.size()];
+  }
+
+  // Chunk done, its buffer is reduced in turn
+  void Release(unsigned int chunk) {
+    ready[chunk % buffers.size()] = chunk;
+    Reduce();
+  }
+
+  // Stop waiting for buffers (exception or enough events generated)
+  void Abort() { aborted = true; }
+
+  // Add consecutive finished chunks to the total, by one thread at a time
+  void Reduce() {
+    while (mutex.try_lock()) {
+      unsigned int c = reduced.load();
+      while (c < Nchunks && ready[c % buffers.size()] == c) {
+        VEGASSlot &S = buffers[c % buffers.size()];
+        total.Add(S);
+        S.Clear();
+        ready[c % buffers.size()] = -1;
+        reduced                   = ++c;
+      }
+      mutex.unlock();
+
+      // Check for a chunk released while the lock was held
+      if (c >= Nchunks || ready[c % buffers.size()] != c) { break; }
+    }
+  }
+
+  // Number of chunks added to the total
+  unsigned int Reduced() const { return reduced.load(); }
+
+  // Sums over the reduced chunks
+  VEGASSlot total;
+
+ private:
+  unsigned int           Nchunks = 0;
+  std::vector<VEGASSlot> buffers;
+
+  std::unique_ptr<std::atomic<std::int64_t>[]> ready;  // Chunk in the buffer, -1 if none
+  std::atomic<unsigned int>                    next{0};
+  std::atomic<unsigned int>                    reduced{0};
+  std::atomic<bool>                            aborted{false};
+  std::mutex                                   mutex;
+};
+
 // Vegas MC adaptation data
 struct VEGASData {
   // VEGAS initialization function
@@ -55,19 +214,6 @@ struct VEGASData {
     }
   }
 
-  // Create number of calls per thread, they need to sum to calls
-  std::vector<unsigned int> GetLocalCalls(int calls, int N_threads) {
-    std::vector<unsigned int> localcalls(N_threads, 0.0);
-    int                       sum = 0;
-    for (int k = 0; k < N_threads; ++k) {
-      localcalls[k] = std::floor(calls / N_threads);
-      sum += localcalls[k];
-    }
-    // Add remainder to the thread number[0]
-    localcalls[0] += calls - sum;
-    return localcalls;
-  }
-
   // Initialize
   void InitGridDependent(const VEGASPARAM &param) {
     // Create grid spacing
@@ -141,6 +287,18 @@ struct VEGASData {
     }
   }
 
+  // Iteration sums from the chunk reduction
+  void SetSums(const VEGASSlot &total, const VEGASPARAM &param) {
+    fsum  = total.fsum;
+    f2sum = total.f2sum;
+    for (std::size_t i = 0; i < param.BINS; ++i) {
+      for (std::size_t j = 0; j < FDIM; ++j) {
+        fmat[i][j]  = total.fmat[i][j];
+        f2mat[i][j] = total.f2mat[i][j];
+      }
+    }
+  }
+
   // Initialize sampling region [0,1] x [0,1] x ... x [0,1]
   void InitRegion(unsigned int fdim) {
     FDIM = fdim;
@@ -194,13 +194,15 @@ goto SKIPLABEL; // GRANIITTI: Skip this block
   	// Define permutation
   	for (int i = 0; i < nexternal; ++i) { perm[i] = i; }
 
-  	// Loop over helicity combinations
+  	// Loop over helicity combinations, vanishing ones skipped after the warm-up
   	for (int ihel = 0; ihel < ncomb; ++ihel) {
+    		if (!helfilter.Evaluate(ihel)) { continue; }
     		calculate_wavefunctions(perm, helicities[ihel]);
 
     		// Sum of subamplitudes (s,t,u,...)
     		for (int k = 0; k < namplitudes; ++k) { lts.hamp[ihel] += amp[k]; }
 	}
+	helfilter.Update(lts.hamp);
 
 	// Total amplitude squared over all helicity combinations individually
 	double amp2 = 0.0;
@@ -5,8 +5,11 @@
 
 // C++
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 // C-file processing
@@ -39,16 +42,18 @@
 #include "HepMC3/GenVertex.h"
 #include "HepMC3/Print.h"
 #include "HepMC3/ReaderAscii.h"
-#include "HepMC3/Relatives.h"
-#include "HepMC3/Selector.h"
 
 // Own
 #include "Graniitti/Analysis/MAnalyzer.h"
 #include "Graniitti/Analysis/MMultiplet.h"
 #include "Graniitti/M4Vec.h"
+#include "Graniitti/MColumnar.h"
+#include "Graniitti/MCompress.h"
+#include "Graniitti/MEventRecord.h"
 #include "Graniitti/MKinematics.h"
 #include "Graniitti/MMath.h"
 #include "Graniitti/MPDG.h"
+#include "Graniitti/MTimer.h"
 
 const bool DEBUG = false;
 
@@ -127,32 +132,123 @@ MAnalyzer::MAnalyzer(const std::string &ID) {
 // Destructor
 MAnalyzer::~MAnalyzer() {}
 
+namespace {
+
+// Ancestry index bits
+constexpr unsigned int ANC_SYSTEM = 1;  // Central system
+constexpr unsigned int ANC_NSTAR  = 2;  // Excited forward system
+
+unsigned int AncestryBits(const MEventRecord::Particle &p) {
+  return ((std::abs(p.pdg) == PDG::PDG_system) ? ANC_SYSTEM : 0) |
+         ((std::abs(p.pdg) == PDG::PDG_NSTAR) ? ANC_NSTAR : 0);
+}
+
+M4Vec P4(const MEventRecord::Particle &p) { return M4Vec(p.px, p.py, p.pz, p.e); }
+
+// Number of HepMC3 ASCII events parsed per batch
+constexpr std::size_t ASCII_BATCH = 256;
+
+// One input file, read in batches under a lock: a chunk of the columnar
+// file or a group of parsed HepMC3 events. The event records are built
+// from the batch outside the lock.
+class MEventSource {
+ public:
+  explicit MEventSource(const std::string &filename) : path(filename) {
+    columnar = (path.find(".grcol") != std::string::npos);
+    if (columnar) {
+      col = std::make_unique<MReaderColumnar>(path);
+    } else {
+      stream = std::make_unique<MInputStream>(path);
+      if (!stream->IsOpen()) {
+        throw std::invalid_argument("MAnalyzer::HepMC3Read: Cannot open file " + path);
+      }
+      ascii = std::make_unique<HepMC3::ReaderAscii>(*stream);
+      if (ascii->failed()) {
+        throw std::invalid_argument("MAnalyzer::HepMC3Read: Cannot open file " + path);
+      }
+    }
+  }
+  ~MEventSource() {
+    if (ascii != nullptr) { ascii->close(); }
+  }
+
+  // Returns false when the file is exhausted
+  bool Next(MColumnarChunk &chunk, std::vector<HepMC3::GenEvent> &gevt, std::size_t &n) {
+    std::lock_guard<std::mutex> lock(mtx);
+    n = 0;
+    if (done) { return false; }
+    if (columnar) {
+      if (!col->ReadChunk(chunk)) {
+        done = true;
+        return false;
+      }
+      n = chunk.NEvents();
+      if (n > 0) { xs = chunk.xs.back(); }
+    } else {
+      if (gevt.size() < ASCII_BATCH) { gevt.resize(ASCII_BATCH); }
+      while (n < ASCII_BATCH) {
+        ascii->read_event(gevt[n]);
+        if (ascii->failed()) {
+          done = true;
+          break;
+        }
+        ++n;
+      }
+      if (n == 0) { return false; }
+      if (auto cs = gevt[n - 1].cross_section()) { xs = cs->xsec(); }
+    }
+    events += n;
+    return true;
+  }
+
+  const std::string path;
+  bool              columnar = false;
+  std::size_t       events   = 0;    // Events read
+  double            xs       = 0.0;  // Cross section of the last event read (pb)
+
+ private:
+  std::unique_ptr<MReaderColumnar>     col    = nullptr;
+  std::unique_ptr<MInputStream>        stream = nullptr;
+  std::unique_ptr<HepMC3::ReaderAscii> ascii  = nullptr;
+  std::mutex                           mtx;
+  bool                                 done = false;
+};
+
+}  // namespace
+
 // "Oracle" histogram filler:
 //
 // Oracle here means that in this function we (may) use event tree information,
 // not just pure fiducial final state information based on purely physical observables.
 //
+// The input may list several files of one sample as "name1+name2+...", for
+// each the columnar file is used if available, HepMC3 ASCII otherwise, and
+// gzip compressed (.gz) files are decompressed transparently. With THREADS > 1
+// worker threads pull event batches from the files and fill thread-local
+// histogram copies, which are added to the histograms at the end.
+//
 double MAnalyzer::HepMC3_OracleFill(const std::string input, unsigned int multiplicity,
                                     int finalPDG, unsigned int MAXEVENTS,
                                     std::map<std::string, std::shared_ptr<h1Multiplet>> &   h1,
                                     std::map<std::string, std::shared_ptr<h2Multiplet>> &   h2,
                                     std::map<std::string, std::shared_ptr<hProfMultiplet>> &hP,
-                                    unsigned int                                            SID) {
-  inputfile                     = input;
-  const std::string   totalpath = gra::aux::GetBasePath(2) + "/output/" + input + ".hepmc3";
-  HepMC3::ReaderAscii input_file(totalpath);
-
-  if (input_file.failed()) {
-    throw std::invalid_argument("MAnalyzer::HepMC3Read: Cannot open file " + totalpath);
+                                    unsigned int SID, unsigned int THREADS) {
+  inputfile = input;
+  THREADS   = std::max(1U, THREADS);
+
+  std::vector<std::unique_ptr<MEventSource>> sources;
+  for (const auto &name : gra::aux::SplitStr2Str(input, '+')) {
+    const std::string basepath  = gra::aux::GetBasePath(2) + "/output/" + name;
+    std::string       totalpath = basepath + ".hepmc3";
+    for (const char *ext : {".grcol", ".grcol.gz", ".hepmc3", ".hepmc3.gz"}) {
+      if (gra::aux::FileExist(basepath + ext)) {
+        totalpath = basepath + ext;
+        break;
+      }
+    }
+    sources.push_back(std::make_unique<MEventSource>(totalpath));
   }
 
-  // Event loop
-  unsigned int events_read = 0;
-
-  // Variables for calculating selection efficiency
-  double totalW = 0;
-  double selecW = 0;
-
   // ---------------------------------------------------------------------
   // Set final state [charged pair or neutral pair]
   MPDG PDG;
@@ -163,65 +259,97 @@ double MAnalyzer::HepMC3_OracleFill(const std::string input, unsigned int multip
   const int NEGfinalPDG = (p.chargeX3 != 0) ? -finalPDG : 0;  // Do not double count neutral
   // ---------------------------------------------------------------------
 
-  while (true) {
-    // Read event from input file
-    HepMC3::GenEvent evt(HepMC3::Units::GEV, HepMC3::Units::MM);
-    input_file.read_event(evt);
-
-    // Reading failed
-    if (input_file.failed()) {
-      if (events_read == 0) {
-        throw std::invalid_argument("MAnalyzer::HepMC3Read: File " + totalpath + " is empty!");
-      } else {
-        break;
-      }
+  // Histograms filled in the event loop
+  std::vector<TH1 *> shared = {hE_Pions.get(),    hE_Gamma.get(),   hE_Neutron.get(),
+                               hE_GammaNeutron.get(), hXF_Pions.get(), hXF_Gamma.get(),
+                               hXF_Neutron.get(), hEta_Pions.get(), hEta_Gamma.get(),
+                               hEta_Neutron.get(), hM_NSTAR.get()};
+  for (std::size_t l = 0; l < 8; ++l) { shared.push_back(hPl[l].get()); }
+  for (std::size_t i = 0; i < NFR; ++i) {
+    for (std::size_t j = 0; j < NFR; ++j) {
+      shared.push_back(h2CosTheta[i][j].get());
+      shared.push_back(h2Phi[i][j].get());
     }
-    if (events_read == 0) {
-      HepMC3::Print::listing(evt);
-      HepMC3::Print::content(evt);
+  }
+  for (const auto &x : h1) { shared.push_back(x.second->h[SID]); }
+  for (const auto &x : h2) { shared.push_back(x.second->h[SID]); }
+  for (const auto &x : hP) { shared.push_back(x.second->h[SID]); }
+
+  // Thread-local copies (created here, ROOT object creation is not thread safe)
+  std::vector<MAnalyzerLocal> local(THREADS);
+  if (THREADS > 1) {
+    ROOT::EnableThreadSafety();
+    for (const auto &t : indices(local)) {
+      for (TH1 *h : shared) {
+        TH1 *c = static_cast<TH1 *>(h->Clone(Form("%s_thread%lu", h->GetName(), t)));
+        c->SetDirectory(nullptr);
+        c->Reset();
+        local[t].copy[h] = c;
+      }
     }
-    ++events_read;
+  }
 
-    // *** Get generator cross section (in picobarns by HepMC3 convention) ***
-    std::shared_ptr<HepMC3::GenCrossSection> cs =
-        evt.attribute<HepMC3::GenCrossSection>("GenCrossSection");
-    if (cs) {
-      cross_section = 1E-12 * cs->xsec(0);  // turn into barns
-    } else {
-      std::cout << "Problem accessing 'GenCrossSection' attribute!" << std::endl;
+  // Analysis of one event
+  auto ProcessEvent = [&](const MEventRecord &evt, std::size_t index, MAnalyzerLocal &L) {
+    if (index == 0) {
+      HepMC3::GenEvent gevt(HepMC3::Units::GEV, HepMC3::Units::MM);
+      evt.ToGenEvent(gevt);
+      HepMC3::Print::listing(gevt);
+      HepMC3::Print::content(gevt);
     }
-    // --------------------------------------------------------------
+    const auto H1 = [&](const char *name) { return L.Get(h1.at(name)->h[SID]); };
+    const auto H2 = [&](const char *name) { return L.Get(h2.at(name)->h[SID]); };
+    const auto HP = [&](const char *name) { return L.Get(hP.at(name)->h[SID]); };
 
     // *** Get event weight (always in barn units) ***
-    double W = 1.0;
-    if (evt.weights().size() != 0) {  // check do we have weights saved
-      W = evt.weights()[0];           // take the first one
-    }
-    totalW += W;
+    const double W = (evt.weights.size() != 0) ? evt.weights[0] : 1.0;  // take the first one
+    L.totalW += W;
     // --------------------------------------------------------------
 
-    // Central particles
+    // Ancestry index, one pass over the vertex graph
+    evt.AncestorMask(AncestryBits, L.ancestors, L.parents);
+
+    // Central particles (ancestor is a central system) and protons
     std::vector<M4Vec> pip;
     std::vector<M4Vec> pim;
 
-    for (HepMC3::ConstGenParticlePtr p1 :
-         HepMC3::applyFilter(HepMC3::StandardSelector::PDG_ID == finalPDG, evt.particles())) {
-      M4Vec pvec = gra::aux::HepMC2M4Vec(p1->momentum());
+    bool  beam_protons = false;
+    M4Vec p_beam_plus;
+    M4Vec p_beam_minus;
+    M4Vec p_final_plus;
+    M4Vec p_final_minus;
+
+    for (const auto &i : indices(evt.particles)) {
+      const MEventRecord::Particle &p1 = evt.particles[i];
 
-      // Check that ancestor is a central system
-      std::vector<HepMC3::ConstGenParticlePtr> results =
-          HepMC3::applyFilter(*abs(HepMC3::StandardSelector::PDG_ID) == PDG::PDG_system,
-                              HepMC3::Relatives::ANCESTORS(p1));
-      if (results.size() != 0) { pip.push_back(pvec); }
-    }
-    for (HepMC3::ConstGenParticlePtr p1 :
-         HepMC3::applyFilter(HepMC3::StandardSelector::PDG_ID == NEGfinalPDG, evt.particles())) {
-      M4Vec pvec = gra::aux::HepMC2M4Vec(p1->momentum());
-
-      // Check that ancestor is a central system
-      std::vector<HepMC3::ConstGenParticlePtr> results = HepMC3::applyFilter(
-          HepMC3::StandardSelector::PDG_ID == PDG::PDG_system, HepMC3::Relatives::ANCESTORS(p1));
-      if (results.size() != 0) { pim.push_back(pvec); }
+      if (L.ancestors[i] & ANC_SYSTEM) {
+        if (p1.pdg == finalPDG) {
+          pip.push_back(P4(p1));
+        } else if (p1.pdg == NEGfinalPDG) {
+          pim.push_back(P4(p1));
+        }
+      }
+      if (p1.pdg != PDG::PDG_p) { continue; }
+
+      // Beam (initial state) protons
+      if (p1.status == PDG::PDG_BEAM) {
+        beam_protons = true;
+        const M4Vec pvec = P4(p1);
+        if (pvec.Rap() > 0) {
+          p_beam_plus = pvec;
+        } else {
+          p_beam_minus = pvec;
+        }
+      }
+      // Final state protons, ancestor is NOT excited forward system or central system
+      if (p1.status == PDG::PDG_STABLE && (L.ancestors[i] & (ANC_SYSTEM | ANC_NSTAR)) == 0) {
+        const M4Vec pvec = P4(p1);
+        if (pvec.Rap() > 0) {
+          p_final_plus = pvec;
+        } else {
+          p_final_minus = pvec;
+        }
+      }
     }
 
     // CHECK CONDITION
@@ -230,7 +358,7 @@ double MAnalyzer::HepMC3_OracleFill(const std::string input, unsigned int multip
           "MAnalyzer::ReadHepMC3:: Multiplicity condition not filled +[%lu] "
           "-[%lu] %d! \n",
           pip.size(), pim.size(), multiplicity);
-      continue;  // skip event
+      return;  // skip event
     }
 
     // ---------------------------------------------------------------
@@ -239,65 +367,20 @@ double MAnalyzer::HepMC3_OracleFill(const std::string input, unsigned int multip
     for (const auto &x : pip) { system += x; }
     for (const auto &x : pim) { system += x; }
 
-    std::vector<HepMC3::GenParticlePtr> beam_protons =
-        HepMC3::applyFilter(HepMC3::StandardSelector::STATUS == PDG::PDG_BEAM &&
-                                HepMC3::StandardSelector::PDG_ID == PDG::PDG_p,
-                            evt.particles());
-
-    std::vector<HepMC3::GenParticlePtr> final_protons =
-        HepMC3::applyFilter(HepMC3::StandardSelector::STATUS == PDG::PDG_STABLE &&
-                                HepMC3::StandardSelector::PDG_ID == PDG::PDG_p,
-                            evt.particles());
-
-    M4Vec p_beam_plus;
-    M4Vec p_beam_minus;
-    M4Vec p_final_plus;
-    M4Vec p_final_minus;
-
     // If we have full event, check energy-momentum
-    if (beam_protons.size()) {
+    if (beam_protons) {
       // ==============================================================
-      sqrts = CheckEnergyMomentum(evt);
+      L.sqrts = CheckEnergyMomentum(evt);
       // ==============================================================
     }
 
-    // Beam (initial state ) protons
-    for (const HepMC3::GenParticlePtr &p1 : beam_protons) {
-      M4Vec pvec = gra::aux::HepMC2M4Vec(p1->momentum());
-      if (pvec.Rap() > 0) {
-        p_beam_plus = pvec;
-      } else {
-        p_beam_minus = pvec;
-      }
-    }
-
-    // Final state protons
-    for (const HepMC3::GenParticlePtr &p1 : final_protons) {
-      M4Vec pvec = gra::aux::HepMC2M4Vec(p1->momentum());
-
-      // Check that ancestor is NOT excited forward system or central system
-      std::vector<HepMC3::GenParticlePtr> results =
-          HepMC3::applyFilter(HepMC3::StandardSelector::PDG_ID == PDG::PDG_NSTAR ||
-                                  HepMC3::StandardSelector::PDG_ID == -PDG::PDG_NSTAR ||
-                                  HepMC3::StandardSelector::PDG_ID == PDG::PDG_system,
-                              HepMC3::Relatives::ANCESTORS(p1));
-
-      if (results.size() == 0) {
-        if (pvec.Rap() > 0) {
-          p_final_plus = pvec;
-        } else {
-          p_final_minus = pvec;
-        }
-      }
-    }
-
     // Observables for 2-body case only
     if (multiplicity == 2) {
-      FrameObservables(W, evt, p_beam_plus, p_beam_minus, p_final_plus, p_final_minus, pip, pim);
+      FrameObservables(W, p_beam_plus, p_beam_minus, p_final_plus, p_final_minus, pip, pim, L);
     }
 
     // Observables for N stars
-    NStarObservables(W, evt);
+    NStarObservables(W, evt, L);
 
     // **************************************************************
     // SUPERPLOTTER >>
@@ -315,15 +398,15 @@ double MAnalyzer::HepMC3_OracleFill(const std::string input, unsigned int multip
       const double Y  = system.Rap();
 
       // 1D: System
-      h1["h1_S_M"]->h[SID]->Fill(M, W);
-      h1["h1_S_Pt"]->h[SID]->Fill(Pt, W);
-      h1["h1_S_Pt2"]->h[SID]->Fill(math::pow2(Pt), W);
-      h1["h1_S_Y"]->h[SID]->Fill(Y, W);
-      hP["hP_S_M_Pt"]->h[SID]->Fill(M, Pt, W);
+      H1("h1_S_M")->Fill(M, W);
+      H1("h1_S_Pt")->Fill(Pt, W);
+      H1("h1_S_Pt2")->Fill(math::pow2(Pt), W);
+      H1("h1_S_Y")->Fill(Y, W);
+      HP("hP_S_M_Pt")->Fill(M, Pt, W);
 
       // 1D: 1-Body
-      h1["h1_1B_pt"]->h[SID]->Fill(a.Pt(), W);
-      h1["h1_1B_eta"]->h[SID]->Fill(a.Eta(), W);
+      H1("h1_1B_pt")->Fill(a.Pt(), W);
+      H1("h1_1B_eta")->Fill(a.Eta(), W);
 
       // 1D: Forward proton pair
       double deltaphi_pp = -1.0;
@@ -337,26 +420,26 @@ double MAnalyzer::HepMC3_OracleFill(const std::string input, unsigned int multip
         M4Vec        pp_diff = p_final_plus - p_final_minus;
         const double pp_dpt  = pp_diff.Pt();
 
-        h1["h1_PP_dphi"]->h[SID]->Fill(deltaphi_pp, W);
-        h1["h1_PP_t1"]->h[SID]->Fill(t1, W);
-        h1["h1_PP_dpt"]->h[SID]->Fill(pp_dpt, W);
+        H1("h1_PP_dphi")->Fill(deltaphi_pp, W);
+        H1("h1_PP_t1")->Fill(t1, W);
+        H1("h1_PP_dpt")->Fill(pp_dpt, W);
 
-        h2["h2_S_M_dphipp"]->h[SID]->Fill(M, deltaphi_pp, W);
-        h2["h2_S_M_dpt"]->h[SID]->Fill(M, pp_dpt, W);
-        h2["h2_S_M_t"]->h[SID]->Fill(M, std::abs(t1), W);
+        H2("h2_S_M_dphipp")->Fill(M, deltaphi_pp, W);
+        H2("h2_S_M_dpt")->Fill(M, pp_dpt, W);
+        H2("h2_S_M_t")->Fill(M, std::abs(t1), W);
       }
 
       // 2D
-      h2["h2_S_M_Pt"]->h[SID]->Fill(M, Pt, W);
-      h2["h2_S_M_pt"]->h[SID]->Fill(M, a.Pt(), W);
+      H2("h2_S_M_Pt")->Fill(M, Pt, W);
+      H2("h2_S_M_pt")->Fill(M, a.Pt(), W);
 
       // 2-Body only
       if (multiplicity == 2) {
-        hP["hP_2B_M_dphi"]->h[SID]->Fill(M, a.DeltaPhi(b), W);
-        h1["h1_2B_acop"]->h[SID]->Fill(1.0 - a.DeltaPhi(b) / gra::math::PI, W);
-        h1["h1_2B_diffrap"]->h[SID]->Fill(b.Rap() - a.Rap(), W);
-        h2["h2_2B_M_dphi"]->h[SID]->Fill(M, a.DeltaPhi(b), W);
-        h2["h2_2B_eta1_eta2"]->h[SID]->Fill(a.Eta(), b.Eta(), W);
+        HP("hP_2B_M_dphi")->Fill(M, a.DeltaPhi(b), W);
+        H1("h1_2B_acop")->Fill(1.0 - a.DeltaPhi(b) / gra::math::PI, W);
+        H1("h1_2B_diffrap")->Fill(b.Rap() - a.Rap(), W);
+        H2("h2_2B_M_dphi")->Fill(M, a.DeltaPhi(b), W);
+        H2("h2_2B_eta1_eta2")->Fill(a.Eta(), b.Eta(), W);
 
 
         // Frame transform
@@ -380,50 +463,50 @@ double MAnalyzer::HepMC3_OracleFill(const std::string input, unsigned int multip
         gra::kinematics::PGframe(PG, X, direction, p_beam_plus, p_beam_minus);
 
 
-        h1["h1_costheta_CM"]->h[SID]->Fill(CM[0].CosTheta(), W);
-        h1["h1_costheta_HX"]->h[SID]->Fill(HX[0].CosTheta(), W);
-        h1["h1_costheta_CS"]->h[SID]->Fill(CS[0].CosTheta(), W);
-        h1["h1_costheta_GJ"]->h[SID]->Fill(GJ[0].CosTheta(), W);
-        h1["h1_costheta_PG"]->h[SID]->Fill(PG[0].CosTheta(), W);
-        h1["h1_costheta_LAB"]->h[SID]->Fill(a.CosTheta(), W);
+        H1("h1_costheta_CM")->Fill(CM[0].CosTheta(), W);
+        H1("h1_costheta_HX")->Fill(HX[0].CosTheta(), W);
+        H1("h1_costheta_CS")->Fill(CS[0].CosTheta(), W);
+        H1("h1_costheta_GJ")->Fill(GJ[0].CosTheta(), W);
+        H1("h1_costheta_PG")->Fill(PG[0].CosTheta(), W);
+        H1("h1_costheta_LAB")->Fill(a.CosTheta(), W);
 
 
-        h1["h1_phi_CM"]->h[SID]->Fill(CM[0].Phi(), W);
-        h1["h1_phi_HX"]->h[SID]->Fill(HX[0].Phi(), W);
-        h1["h1_phi_CS"]->h[SID]->Fill(CS[0].Phi(), W);
-        h1["h1_phi_GJ"]->h[SID]->Fill(GJ[0].Phi(), W);
-        h1["h1_phi_PG"]->h[SID]->Fill(PG[0].Phi(), W);
-        h1["h1_phi_LAB"]->h[SID]->Fill(a.Phi(), W);
+        H1("h1_phi_CM")->Fill(CM[0].Phi(), W);
+        H1("h1_phi_HX")->Fill(HX[0].Phi(), W);
+        H1("h1_phi_CS")->Fill(CS[0].Phi(), W);
+        H1("h1_phi_GJ")->Fill(GJ[0].Phi(), W);
+        H1("h1_phi_PG")->Fill(PG[0].Phi(), W);
+        H1("h1_phi_LAB")->Fill(a.Phi(), W);
 
 
-        h2["h2_2B_costheta_phi_CM"]->h[SID]->Fill(CM[0].CosTheta(), CM[0].Phi(), W);
-        h2["h2_2B_costheta_phi_HX"]->h[SID]->Fill(HX[0].CosTheta(), HX[0].Phi(), W);
-        h2["h2_2B_costheta_phi_CS"]->h[SID]->Fill(CS[0].CosTheta(), CS[0].Phi(), W);
-        h2["h2_2B_costheta_phi_GJ"]->h[SID]->Fill(GJ[0].CosTheta(), GJ[0].Phi(), W);
-        h2["h2_2B_costheta_phi_PG"]->h[SID]->Fill(PG[0].CosTheta(), PG[0].Phi(), W);
-        h2["h2_2B_costheta_phi_LAB"]->h[SID]->Fill(a.CosTheta(), a.Phi(), W);
+        H2("h2_2B_costheta_phi_CM")->Fill(CM[0].CosTheta(), CM[0].Phi(), W);
+        H2("h2_2B_costheta_phi_HX")->Fill(HX[0].CosTheta(), HX[0].Phi(), W);
+        H2("h2_2B_costheta_phi_CS")->Fill(CS[0].CosTheta(), CS[0].Phi(), W);
+        H2("h2_2B_costheta_phi_GJ")->Fill(GJ[0].CosTheta(), GJ[0].Phi(), W);
+        H2("h2_2B_costheta_phi_PG")->Fill(PG[0].CosTheta(), PG[0].Phi(), W);
+        H2("h2_2B_costheta_phi_LAB")->Fill(a.CosTheta(), a.Phi(), W);
 
 
-        h2["h2_2B_M_costheta_CM"]->h[SID]->Fill(M, CM[0].CosTheta(), W);
-        h2["h2_2B_M_costheta_HX"]->h[SID]->Fill(M, HX[0].CosTheta(), W);
-        h2["h2_2B_M_costheta_CS"]->h[SID]->Fill(M, CS[0].CosTheta(), W);
-        h2["h2_2B_M_costheta_GJ"]->h[SID]->Fill(M, GJ[0].CosTheta(), W);
-        h2["h2_2B_M_costheta_PG"]->h[SID]->Fill(M, PG[0].CosTheta(), W);
-        h2["h2_2B_M_costheta_LAB"]->h[SID]->Fill(M, a.CosTheta(), W);
+        H2("h2_2B_M_costheta_CM")->Fill(M, CM[0].CosTheta(), W);
+        H2("h2_2B_M_costheta_HX")->Fill(M, HX[0].CosTheta(), W);
+        H2("h2_2B_M_costheta_CS")->Fill(M, CS[0].CosTheta(), W);
+        H2("h2_2B_M_costheta_GJ")->Fill(M, GJ[0].CosTheta(), W);
+        H2("h2_2B_M_costheta_PG")->Fill(M, PG[0].CosTheta(), W);
+        H2("h2_2B_M_costheta_LAB")->Fill(M, a.CosTheta(), W);
 
 
-        h2["h2_2B_M_phi_CM"]->h[SID]->Fill(M, CM[0].Phi(), W);
-        h2["h2_2B_M_phi_HX"]->h[SID]->Fill(M, HX[0].Phi(), W);
-        h2["h2_2B_M_phi_CS"]->h[SID]->Fill(M, CS[0].Phi(), W);
-        h2["h2_2B_M_phi_GJ"]->h[SID]->Fill(M, GJ[0].Phi(), W);
-        h2["h2_2B_M_phi_PG"]->h[SID]->Fill(M, PG[0].Phi(), W);
-        h2["h2_2B_M_phi_LAB"]->h[SID]->Fill(M, a.Phi(), W);
+        H2("h2_2B_M_phi_CM")->Fill(M, CM[0].Phi(), W);
+        H2("h2_2B_M_phi_HX")->Fill(M, HX[0].Phi(), W);
+        H2("h2_2B_M_phi_CS")->Fill(M, CS[0].Phi(), W);
+        H2("h2_2B_M_phi_GJ")->Fill(M, GJ[0].Phi(), W);
+        H2("h2_2B_M_phi_PG")->Fill(M, PG[0].Phi(), W);
+        H2("h2_2B_M_phi_LAB")->Fill(M, a.Phi(), W);
 
 
         // ---------------------------------------------------------------------------
-        hP["hP_S_M_PL2_CM"]->h[SID]->Fill(M, math::LegendrePl(2, CM[0].CosTheta()), W);
-        hP["hP_S_M_PL4_CM"]->h[SID]->Fill(M, math::LegendrePl(4, CM[0].CosTheta()), W);
-        h2["h2_2B_eta1_eta2"]->h[SID]->Fill(a.Eta(), b.Eta(), W);
+        HP("hP_S_M_PL2_CM")->Fill(M, math::LegendrePl(2, CM[0].CosTheta()), W);
+        HP("hP_S_M_PL4_CM")->Fill(M, math::LegendrePl(4, CM[0].CosTheta()), W);
+        H2("h2_2B_eta1_eta2")->Fill(a.Eta(), b.Eta(), W);
         // ---------------------------------------------------------------------------
       }
 
@@ -438,25 +521,105 @@ double MAnalyzer::HepMC3_OracleFill(const std::string input, unsigned int multip
     // << SUPERPLOTTER
     // **************************************************************
 
-    if (events_read >= MAXEVENTS) {
-      std::cout << "MAnalyzer::HepMC3Read: Maximum event count " << MAXEVENTS << " reached!";
-      break;  // Enough events
+    // [THIS AS LAST!] Sum selected event weights
+    L.selecW += W;
+  };
+
+  // Event loop: each worker starts from a different file and moves on to
+  // the others once it is exhausted
+  std::atomic<std::size_t> counter(0);
+  std::atomic<bool>        stop(false);
+  MTimer                   timer;
+
+  auto Worker = [&](unsigned int t) {
+    MColumnarChunk                chunk;
+    std::vector<HepMC3::GenEvent> gevt;
+    MEventRecord                  evt;
+    std::size_t                   n = 0;
+
+    try {
+      for (std::size_t k = 0; k < sources.size() && !stop; ++k) {
+        MEventSource &S = *sources[(t + k) % sources.size()];
+        while (!stop && S.Next(chunk, gevt, n)) {
+          for (std::size_t i = 0; i < n; ++i) {
+            const std::size_t index = counter++;
+            if (index >= MAXEVENTS) {
+              if (!stop.exchange(true)) {
+                std::cout << "MAnalyzer::HepMC3Read: Maximum event count " << MAXEVENTS
+                          << " reached!" << std::endl;
+              }
+              break;  // Enough events
+            }
+            if (S.columnar) {
+              chunk.GetEvent(i, evt);
+            } else {
+              evt.FromGenEvent(gevt[i]);
+            }
+            ProcessEvent(evt, index, local[t]);
+            ++local[t].events;
+
+            if ((index + 1) % 100000 == 0) {
+              printf("Events processed: %lu \n", index + 1);
+            }
+          }
+        }
+      }
+    } catch (...) {
+      local[t].error = std::current_exception();
+      stop           = true;
     }
+  };
 
-    if (events_read % 10000 == 0) {
-      std::cout << std::endl << "Events processed: " << events_read << std::endl;
+  if (THREADS == 1) {
+    Worker(0);
+  } else {
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < THREADS; ++t) { workers.push_back(std::thread(Worker, t)); }
+    for (auto &w : workers) { w.join(); }
+  }
+  const double elapsed = timer.ElapsedSec();
+
+  // Merge the thread-local results
+  double      totalW      = 0;
+  double      selecW      = 0;
+  std::size_t events_read = 0;
+  for (auto &L : local) {
+    for (const auto &x : L.copy) {
+      x.first->Add(x.second);
+      delete x.second;
     }
-    // [THIS AS LAST!] Sum selected event weights
-    selecW += W;
+    L.copy.clear();
+    if (L.sqrts > 0) { sqrts = L.sqrts; }
+    N_STAR_ON = N_STAR_ON || L.nstar;
+    totalW += L.totalW;
+    selecW += L.selecW;
+    events_read += L.events;
+  }
+  for (const auto &L : local) {
+    if (L.error) { std::rethrow_exception(L.error); }
   }
-  std::cout << std::endl;
-  std::cout << "MAnalyzer::HepMC3Read: Events processed in total: " << events_read << std::endl;
 
-  // Close HepMC3 file
-  input_file.close();
+  // Cross section, event count weighted over the files
+  std::size_t read = 0;
+  cross_section    = 0.0;
+  for (const auto &S : sources) {
+    cross_section += 1E-12 * S->xs * S->events;  // turn into barns
+    read += S->events;
+  }
+  if (read == 0) {
+    throw std::invalid_argument("MAnalyzer::HepMC3Read: Input <" + input + "> is empty!");
+  }
+  cross_section /= read;
+  if (cross_section == 0.0) {
+    std::cout << "Problem accessing 'GenCrossSection' attribute!" << std::endl;
+  }
+
+  std::cout << std::endl;
+  printf("MAnalyzer::HepMC3Read: Events processed in total: %lu (%0.0f events/s, %u threads) \n",
+         events_read, events_read / std::max(elapsed, 1E-9), THREADS);
 
   if (selecW == 0.0) {
-    throw std::invalid_argument("MAnalyzer::HepMC3Read:: Valid events in <" + totalpath + ">" +
+    throw std::invalid_argument("MAnalyzer::HepMC3Read:: Valid events in <" + input + ">" +
                                 " == 0 out of " + std::to_string(events_read));
   }
   // Take into account extra fiducial cut efficiency here
@@ -468,36 +631,30 @@ double MAnalyzer::HepMC3_OracleFill(const std::string input, unsigned int multip
 }
 
 // Sanity check
-double MAnalyzer::CheckEnergyMomentum(HepMC3::GenEvent &evt) const {
-  std::vector<HepMC3::GenParticlePtr> all_init = HepMC3::applyFilter(
-      HepMC3::StandardSelector::STATUS == PDG::PDG_BEAM, evt.particles());  // Beam
-
-  std::vector<HepMC3::GenParticlePtr> all_final = HepMC3::applyFilter(
-      HepMC3::StandardSelector::STATUS == PDG::PDG_STABLE, evt.particles());  // Final state
-
+double MAnalyzer::CheckEnergyMomentum(const MEventRecord &evt) const {
   M4Vec beam(0, 0, 0, 0);
-  for (const HepMC3::GenParticlePtr &p1 : all_init) {
-    beam += gra::aux::HepMC2M4Vec(p1->momentum());
-  }
   M4Vec final(0, 0, 0, 0);
-  for (const HepMC3::GenParticlePtr &p1 : all_final) {
-    final += gra::aux::HepMC2M4Vec(p1->momentum());
+  for (const auto &p1 : evt.particles) {
+    if (p1.status == PDG::PDG_BEAM) { beam += P4(p1); }      // Beam
+    if (p1.status == PDG::PDG_STABLE) { final += P4(p1); }  // Final state
   }
   if (!gra::math::CheckEMC(beam - final)) {
     gra::aux::PrintWarning();
     std::cout << rang::fg::red << "Energy-Momentum not conserved!" << rang::fg::reset << std::endl;
     (beam - final).Print();
-    HepMC3::Print::listing(evt);
-    HepMC3::Print::content(evt);
+    HepMC3::GenEvent gevt(HepMC3::Units::GEV, HepMC3::Units::MM);
+    evt.ToGenEvent(gevt);
+    HepMC3::Print::listing(gevt);
+    HepMC3::Print::content(gevt);
   }
   return beam.M();
 }
 
 // 2-body angular observables
-void MAnalyzer::FrameObservables(double W, HepMC3::GenEvent &evt, const M4Vec &p_beam_plus,
-                                 const M4Vec &p_beam_minus, const M4Vec &p_final_plus,
-                                 const M4Vec &p_final_minus, const std::vector<M4Vec> &pip,
-                                 const std::vector<M4Vec> &pim) {
+void MAnalyzer::FrameObservables(double W, const M4Vec &p_beam_plus, const M4Vec &p_beam_minus,
+                                 const M4Vec &p_final_plus, const M4Vec &p_final_minus,
+                                 const std::vector<M4Vec> &pip, const std::vector<M4Vec> &pim,
+                                 MAnalyzerLocal &L) const {
   // Find index
   const auto ind = [&](const std::string str) {
     for (const auto &i : indices(analyzer::FRAMES)) {
@@ -545,130 +702,71 @@ void MAnalyzer::FrameObservables(double W, HepMC3::GenEvent &evt, const M4Vec &p
   for (std::size_t l = 0; l < 8; ++l) {  // note l+1
     // Take first daughter [0]
     double value = gra::math::LegendrePl((l + 1), pions[ind("CM")][0].CosTheta());
-    hPl[l]->Fill(X.M(), value, W);
+    L.Get(hPl[l])->Fill(X.M(), value, W);
   }
 
   // FRAME correlations
   for (std::size_t i = 0; i < analyzer::FRAMES.size(); ++i) {
     for (std::size_t j = 0; j < analyzer::FRAMES.size(); ++j) {
-      h2CosTheta[i][j]->Fill(pions[i][0].CosTheta(), pions[j][0].CosTheta(), W);
-      h2Phi[i][j]->Fill(pions[i][0].Phi(), pions[j][0].Phi(), W);
+      L.Get(h2CosTheta[i][j])->Fill(pions[i][0].CosTheta(), pions[j][0].CosTheta(), W);
+      L.Get(h2Phi[i][j])->Fill(pions[i][0].Phi(), pions[j][0].Phi(), W);
     }
   }
 }
 
 // Forward system observables
-void MAnalyzer::NStarObservables(double W, HepMC3::GenEvent &evt) {
-  // Excite forward system particles
-  std::vector<HepMC3::GenParticlePtr> search_gammas =
-      HepMC3::applyFilter(HepMC3::StandardSelector::PDG_ID == PDG::PDG_gamma, evt.particles());
-
-  std::vector<HepMC3::GenParticlePtr> search_neutrons =
-      HepMC3::applyFilter(HepMC3::StandardSelector::PDG_ID == PDG::PDG_n, evt.particles());
-
-  std::vector<HepMC3::GenParticlePtr> search_pip =
-      HepMC3::applyFilter(HepMC3::StandardSelector::PDG_ID == PDG::PDG_pip, evt.particles());
-
-  std::vector<HepMC3::GenParticlePtr> search_pim =
-      HepMC3::applyFilter(HepMC3::StandardSelector::PDG_ID == PDG::PDG_pim, evt.particles());
-
-  std::vector<HepMC3::GenParticlePtr> search_nstar =
-      HepMC3::applyFilter(HepMC3::StandardSelector::PDG_ID == PDG::PDG_NSTAR ||
-                              HepMC3::StandardSelector::PDG_ID == -PDG::PDG_NSTAR,
-                          evt.particles());
-
+void MAnalyzer::NStarObservables(double W, const MEventRecord &evt, MAnalyzerLocal &L) const {
   // Find out if we excited one or two protons
   bool excited_plus  = false;
   bool excited_minus = false;
-  for (const HepMC3::GenParticlePtr &p1 : search_nstar) {
-    M4Vec pvec = gra::aux::HepMC2M4Vec(p1->momentum());
-    hM_NSTAR->Fill(pvec.M(), W);
+  for (const auto &p1 : evt.particles) {
+    if (std::abs(p1.pdg) != PDG::PDG_NSTAR) { continue; }
+    M4Vec pvec = P4(p1);
+    L.Get(hM_NSTAR)->Fill(pvec.M(), W);
 
     if (pvec.Rap() > 0) { excited_plus = true; }
     if (pvec.Rap() < 0) { excited_minus = true; }
   }
   // Excited system found
-  if (excited_plus || excited_minus) { N_STAR_ON = true; }
+  if (excited_plus || excited_minus) { L.nstar = true; }
 
   // N* system decay products
+  double gamma_e_plus    = 0;
+  double gamma_e_minus   = 0;
+  double neutron_e_plus  = 0;
+  double neutron_e_minus = 0;
 
-  // Gammas
-  double gamma_e_plus  = 0;
-  double gamma_e_minus = 0;
-
-  // Gammas
-  for (const HepMC3::GenParticlePtr &p1 : search_gammas) {
-    M4Vec pvec = gra::aux::HepMC2M4Vec(p1->momentum());
-
-    // Check that ancestor is excited forward system
-    std::vector<HepMC3::GenParticlePtr> ancestor =
-        HepMC3::applyFilter(HepMC3::StandardSelector::PDG_ID == PDG::PDG_NSTAR ||
-                                HepMC3::StandardSelector::PDG_ID == -PDG::PDG_NSTAR,
-                            HepMC3::Relatives::ANCESTORS(p1));
+  for (const auto &i : indices(evt.particles)) {
+    const MEventRecord::Particle &p1 = evt.particles[i];
 
-    if (ancestor.size() != 0) {
-      hEta_Gamma->Fill(pvec.Eta(), W);
-      hE_Gamma->Fill(pvec.E(), W);
-      hXF_Gamma->Fill(pvec.Pz() / (sqrts / 2), W);
+    // Gammas, ancestor is the excited forward system
+    if (p1.pdg == PDG::PDG_gamma && (L.ancestors[i] & ANC_NSTAR)) {
+      M4Vec pvec = P4(p1);
+      L.Get(hEta_Gamma)->Fill(pvec.Eta(), W);
+      L.Get(hE_Gamma)->Fill(pvec.E(), W);
+      L.Get(hXF_Gamma)->Fill(pvec.Pz() / (L.sqrts / 2), W);
 
       if (excited_plus && pvec.Rap() > 0) { gamma_e_plus += pvec.E(); }
       if (excited_minus && pvec.Rap() < 0) { gamma_e_minus += pvec.E(); }
     }
-  }
 
-  // Pi+
-  for (const HepMC3::GenParticlePtr &p1 : search_pip) {
-    // HepMC3::Print::line(p1);
+    // Pions and neutrons, parent is the excited system
+    if ((L.parents[i] & ANC_NSTAR) == 0) { continue; }
 
-    // Check that parent is the excited system
-    std::vector<HepMC3::GenParticlePtr> parents = p1->parents();
-    bool                                found   = false;
-    for (const auto &k : indices(parents)) {
-      if (std::abs(parents[k]->pid()) == PDG::PDG_NSTAR) { found = true; }
-    }
-    if (found) {
-      M4Vec pvec = gra::aux::HepMC2M4Vec(p1->momentum());
-      hEta_Pions->Fill(pvec.Eta(), W);
-      hE_Pions->Fill(pvec.E(), W);
-      hXF_Pions->Fill(pvec.Pz() / (sqrts / 2), W);
+    // Pi+ and Pi-
+    if (p1.pdg == PDG::PDG_pip || p1.pdg == PDG::PDG_pim) {
+      M4Vec pvec = P4(p1);
+      L.Get(hEta_Pions)->Fill(pvec.Eta(), W);
+      L.Get(hE_Pions)->Fill(pvec.E(), W);
+      L.Get(hXF_Pions)->Fill(pvec.Pz() / (L.sqrts / 2), W);
     }
-  }
-
-  // Pi-
-  for (const HepMC3::GenParticlePtr &p1 : search_pim) {
-    // HepMC3::Print::line(p1);
 
-    // Check that parent is the excited system
-    std::vector<HepMC3::GenParticlePtr> parents = p1->parents();
-    bool                                found   = false;
-    for (const auto &k : indices(parents)) {
-      if (std::abs(parents[k]->pid()) == PDG::PDG_NSTAR) { found = true; }
-    }
-    if (found) {
-      M4Vec pvec = gra::aux::HepMC2M4Vec(p1->momentum());
-      hEta_Pions->Fill(pvec.Eta(), W);
-      hE_Pions->Fill(pvec.E(), W);
-      hXF_Pions->Fill(pvec.Pz() / (sqrts / 2), W);
-    }
-  }
-
-  // Neutrons
-  double neutron_e_plus  = 0;
-  double neutron_e_minus = 0;
-
-  for (const HepMC3::GenParticlePtr &p1 : search_neutrons) {
-    M4Vec pvec = gra::aux::HepMC2M4Vec(p1->momentum());
-
-    // Check that parent is the excited system
-    std::vector<HepMC3::GenParticlePtr> parents = p1->parents();
-    bool                                found   = false;
-    for (const auto &k : indices(parents)) {
-      if (std::abs(parents[k]->pid()) == PDG::PDG_NSTAR) { found = true; }
-    }
-    if (found) {
-      hEta_Neutron->Fill(pvec.Eta(), W);
-      hE_Neutron->Fill(pvec.E(), W);
-      hXF_Neutron->Fill(pvec.Pz() / (sqrts / 2), W);
+    // Neutrons
+    if (p1.pdg == PDG::PDG_n) {
+      M4Vec pvec = P4(p1);
+      L.Get(hEta_Neutron)->Fill(pvec.Eta(), W);
+      L.Get(hE_Neutron)->Fill(pvec.E(), W);
+      L.Get(hXF_Neutron)->Fill(pvec.Pz() / (L.sqrts / 2), W);
 
       if (excited_plus && pvec.Rap() > 0) { neutron_e_plus += pvec.E(); }
       if (excited_minus && pvec.Rap() < 0) { neutron_e_minus += pvec.E(); }
@@ -676,8 +774,8 @@ void MAnalyzer::NStarObservables(double W, HepMC3::GenEvent &evt) {
   }
 
   // Gamma+Neutron energy histogram
-  if (excited_plus) { hE_GammaNeutron->Fill(gamma_e_plus + neutron_e_plus, W); }
-  if (excited_minus) { hE_GammaNeutron->Fill(gamma_e_minus + neutron_e_minus, W); }
+  if (excited_plus) { L.Get(hE_GammaNeutron)->Fill(gamma_e_plus + neutron_e_plus, W); }
+  if (excited_minus) { L.Get(hE_GammaNeutron)->Fill(gamma_e_minus + neutron_e_minus, W); }
 }
 
 double powerlaw(double *x, double *par) {
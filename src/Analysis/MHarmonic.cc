@@ -8,11 +8,14 @@
 // Licensed under the MIT License <http://opensource.org/licenses/MIT>.
 
 // C++
+#include <algorithm>
+#include <atomic>
 #include <complex>
 #include <iostream>
 #include <random>
 #include <regex>
 #include <string>
+#include <thread>
 #include <vector>
 
 // ROOT
@@ -39,6 +42,7 @@
 #include "Graniitti/MMath.h"
 #include "Graniitti/MPDG.h"
 #include "Graniitti/MSpherical.h"
+#include "Graniitti/MThreadPool.h"
 
 // Eigen
 #include <Eigen/Dense>
@@ -955,28 +959,55 @@ void MHarmonic::HyperLoop(void (*fitfunc)(int &, double *, double &, double *, i
     grid[2][k].max = grid[2][k].min + Y_STEP;
   }
 
+  // Bin intervals
+  std::vector<std::vector<std::array<double, 2>>> edges(grid.size());
+  for (const auto &d : indices(grid)) {
+    for (const auto &e : grid[d]) { edges[d].push_back({e.min, e.max}); }
+  }
+  auto binindex = [&](std::size_t i, std::size_t j, std::size_t k) {
+    return (i * grid[1].size() + j) * grid[2].size() + k;
+  };
+
   // ------------------------------------------------------------------
   // Expand the detector transfer function
 
+  // MC events of each hyperbin in one pass
+  const std::vector<std::vector<std::size_t>> MC_bins =
+      gra::spherical::GetHyperIndices(MC, edges[0], edges[1], edges[2]);
+
+  // Basis sums of all modes (fla, fid, det), hyperbins in parallel
+  std::vector<std::array<gra::spherical::SH_SUM, 3>> MC_sums(MC_bins.size());
+  {
+    const unsigned int NCPU = std::max(1u, std::thread::hardware_concurrency());
+    MThreadPool pool(std::max(1u, std::min(NCPU, static_cast<unsigned int>(MC_bins.size()))));
+    std::atomic<std::size_t> next(0);
+    pool.Run([&](unsigned int) {
+      for (std::size_t b = next++; b < MC_bins.size(); b = next++) {
+        MC_sums[b] = gra::spherical::GetSums(MC, MC_bins[b], param.LMAX);
+      }
+    });
+  }
+
   for (const auto &i : indices(grid[0])) {
     for (const auto &j : indices(grid[1])) {
       for (const auto &k : indices(grid[2])) {
-        const std::vector<std::size_t> MC_ind = gra::spherical::GetIndices(
-            MC, {grid[0][i].min, grid[0][i].max}, {grid[1][j].min, grid[1][j].max},
-            {grid[2][k].min, grid[2][k].max});
+        const std::size_t b = binindex(i, j, k);
+        gra::spherical::PrintHyperBin(
+            {grid[0][i].min, grid[0][i].max}, {grid[1][j].min, grid[1][j].max},
+            {grid[2][k].min, grid[2][k].max}, MC_bins[b].size(), MC.size());
 
         // Acceptance mixing matrices
-        fla_DET({i, j, k}).MIXlm = gra::spherical::GetGMixing(MC, MC_ind, param.LMAX, "fla");
-        fid_DET({i, j, k}).MIXlm = gra::spherical::GetGMixing(MC, MC_ind, param.LMAX, "fid");
-        det_DET({i, j, k}).MIXlm = gra::spherical::GetGMixing(MC, MC_ind, param.LMAX, "det");
+        fla_DET({i, j, k}).MIXlm = gra::spherical::GetGMixing(MC_sums[b][0], param.LMAX, "fla");
+        fid_DET({i, j, k}).MIXlm = gra::spherical::GetGMixing(MC_sums[b][1], param.LMAX, "fid");
+        det_DET({i, j, k}).MIXlm = gra::spherical::GetGMixing(MC_sums[b][2], param.LMAX, "det");
 
         // Get efficiency decomposition for this interval
         std::pair<std::vector<double>, std::vector<double>> E0 =
-            gra::spherical::GetELM(MC, MC_ind, param.LMAX, "fla");
+            gra::spherical::GetELM(MC_sums[b][0], param.LMAX, "fla");
         std::pair<std::vector<double>, std::vector<double>> E1 =
-            gra::spherical::GetELM(MC, MC_ind, param.LMAX, "fid");
+            gra::spherical::GetELM(MC_sums[b][1], param.LMAX, "fid");
         std::pair<std::vector<double>, std::vector<double>> E2 =
-            gra::spherical::GetELM(MC, MC_ind, param.LMAX, "det");
+            gra::spherical::GetELM(MC_sums[b][2], param.LMAX, "det");
 
         fla_DET({i, j, k}).E_lm       = E0.first;
         fla_DET({i, j, k}).E_lm_error = E0.second;
@@ -998,6 +1029,10 @@ void MHarmonic::HyperLoop(void (*fitfunc)(int &, double *, double &, double *, i
     // Pre-Calculate once Spherical Harmonics for the MINUIT fit
     DATA_events = DATA[ind].EVENTS;
     Y_lm        = gra::spherical::YLM(DATA_events, param.LMAX);
+
+    // Data events of each hyperbin in one pass
+    const std::vector<std::vector<std::size_t>> DATA_bins =
+        gra::spherical::GetHyperIndices(DATA_events, edges[0], edges[1], edges[2]);
     // --------------------------------------------------------
 
     double chi2 = 0.0;
@@ -1017,9 +1052,11 @@ void MHarmonic::HyperLoop(void (*fitfunc)(int &, double *, double &, double *, i
       for (const auto &j : indices(grid[1])) {
         for (const auto &k : indices(grid[2])) {
           // Data indices
-          DATA_ind = gra::spherical::GetIndices(DATA_events, {grid[0][i].min, grid[0][i].max},
-                                                {grid[1][j].min, grid[1][j].max},
-                                                {grid[2][k].min, grid[2][k].max});
+          DATA_ind = DATA_bins[binindex(i, j, k)];
+          gra::spherical::PrintHyperBin({grid[0][i].min, grid[0][i].max},
+                                        {grid[1][j].min, grid[1][j].max},
+                                        {grid[2][k].min, grid[2][k].max}, DATA_ind.size(),
+                                        DATA_events.size());
 
           const unsigned int MINEVENTS = 75;
           if (DATA_ind.size() < MINEVENTS) {
@@ -1031,9 +1068,9 @@ void MHarmonic::HyperLoop(void (*fitfunc)(int &, double *, double &, double *, i
           // ALGORITHM 1: DIRECT / OBSERVED / ALGEBRAIC decomposition
 
           fid[META]({i, j, k}).t_lm_MPP =
-              gra::spherical::SphericalMoments(DATA_events, DATA_ind, param.LMAX, "fid");
+              gra::spherical::SphericalMoments(Y_lm, DATA_events, DATA_ind, param.LMAX, "fid");
           det[META]({i, j, k}).t_lm_MPP =
-              gra::spherical::SphericalMoments(DATA_events, DATA_ind, param.LMAX, "det");
+              gra::spherical::SphericalMoments(Y_lm, DATA_events, DATA_ind, param.LMAX, "det");
 
           // Forward matrix
           Eigen::MatrixXd M = gra::aux::Matrix2Eigen(det_DET({i, j, k}).MIXlm);
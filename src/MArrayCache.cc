@@ -0,0 +1,112 @@
+// Binary memory mapped cache for interpolation arrays
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <cstring>
+#include <stdexcept>
+
+// C file processing
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+// Own
+#include "Graniitti/MArrayCache.h"
+#include "Graniitti/MAux.h"
+
+namespace gra {
+
+constexpr char          MArrayHeader::MAGIC[8];
+constexpr std::uint32_t MArrayHeader::VERSION;
+
+// Values start right after the header, keep them 8-byte aligned
+static_assert(sizeof(MArrayHeader) % sizeof(double) == 0, "MArrayHeader: Bad alignment");
+
+bool MArrayHeader::Compatible(const MArrayHeader &other) const {
+  if (std::memcmp(magic, other.magic, sizeof(magic)) != 0) { return false; }
+  if (version != other.version || ndim != other.ndim || hash != other.hash ||
+      ncol != other.ncol) {
+    return false;
+  }
+  for (std::size_t k = 0; k < ndim; ++k) {
+    if (N[k] != other.N[k] || islog[k] != other.islog[k] || MIN[k] != other.MIN[k] ||
+        MAX[k] != other.MAX[k]) {
+      return false;
+    }
+  }
+  return sqrts == other.sqrts;
+}
+
+MArrayCache::~MArrayCache() {
+  if (mapped != nullptr) { munmap(mapped, mappedsize); }
+}
+
+void MArrayCache::Write(const std::string &filename, MArrayHeader header,
+                        const std::vector<double> &values) {
+  std::memcpy(header.magic, MArrayHeader::MAGIC, sizeof(header.magic));
+  header.version = MArrayHeader::VERSION;
+  header.nvalues = values.size();
+
+  aux::WriteFileAtomic(filename, [&](std::ostream &file) {
+    aux::BinaryPut(file, header);
+    aux::BinaryPutArray(file, values);
+  });
+}
+
+std::shared_ptr<const MArrayCache> MArrayCache::Map(const std::string & filename,
+                                                    const MArrayHeader &expected) {
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) { return nullptr; }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(MArrayHeader)) {
+    close(fd);
+    return nullptr;
+  }
+
+  std::shared_ptr<MArrayCache> cache(new MArrayCache());
+  const std::size_t            filesize = st.st_size;
+
+  // Header
+  if (pread(fd, &cache->header, sizeof(MArrayHeader), 0) != (ssize_t)sizeof(MArrayHeader)) {
+    close(fd);
+    return nullptr;
+  }
+  MArrayHeader want = expected;
+  std::memcpy(want.magic, MArrayHeader::MAGIC, sizeof(want.magic));
+  want.version = MArrayHeader::VERSION;
+
+  if (!cache->header.Compatible(want) ||
+      filesize != sizeof(MArrayHeader) + cache->header.nvalues * sizeof(double)) {
+    close(fd);
+    return nullptr;
+  }
+
+  // Read-only shared mapping
+  void *ptr = mmap(nullptr, filesize, PROT_READ, MAP_SHARED, fd, 0);
+  if (ptr != MAP_FAILED) {
+    cache->mapped     = ptr;
+    cache->mappedsize = filesize;
+    cache->values     = reinterpret_cast<const double *>(static_cast<const char *>(ptr) +
+                                                     sizeof(MArrayHeader));
+    madvise(ptr, filesize, MADV_WILLNEED);
+  } else {
+    // Fallback to a private copy
+    cache->buffer.resize(cache->header.nvalues);
+    const ssize_t bytes = cache->header.nvalues * sizeof(double);
+    if (pread(fd, cache->buffer.data(), bytes, sizeof(MArrayHeader)) != bytes) {
+      close(fd);
+      return nullptr;
+    }
+    cache->values = cache->buffer.data();
+  }
+  close(fd);  // Mapping stays valid
+
+  return cache;
+}
+
+}  // namespace gra
@@ -0,0 +1,194 @@
+// Asynchronous batched event writer
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+// Own
+#include "Graniitti/MAsyncWriter.h"
+
+namespace gra {
+
+MAsyncWriter::MAsyncWriter(std::shared_ptr<MEventWriter> writer, std::size_t depth,
+                           std::size_t batch)
+    : output(writer), DEPTH(depth), BATCH(std::max((std::size_t)1, batch)) {
+  if (output == nullptr) { throw std::invalid_argument("MAsyncWriter: Output writer is nullptr"); }
+
+  // Asynchronous mode
+  if (DEPTH > 0) {
+    queue  = std::make_unique<MPSCQueue<std::unique_ptr<MEventRecord>>>(DEPTH);
+    worker = std::thread([this] { WriterLoop(); });
+  }
+}
+
+MAsyncWriter::~MAsyncWriter() {
+  try {
+    Close();
+  } catch (...) {
+    // Not reported by Flush or Close before destruction, nothing to do here
+  }
+}
+
+void MAsyncWriter::Push(std::unique_ptr<MEventRecord> evt) {
+  // Synchronous mode
+  if (queue == nullptr) {
+    std::lock_guard<std::mutex> lock(sync_mutex);
+    ++n_pushed;
+    ++n_batches;
+    Deliver(std::move(evt));
+    return;
+  }
+
+  // Writer thread has failed, the error is reported by Flush / Close
+  if (failed.load(std::memory_order_acquire)) { return; }
+
+  ++n_pushed;
+
+  // Back-pressure: spin-yield until there is space
+  if (!queue->TryPush(std::move(evt))) {
+    ++n_stalls;
+    const auto t0 = std::chrono::steady_clock::now();
+    cv_wake.notify_one();
+    do {
+      std::this_thread::yield();
+    } while (!queue->TryPush(std::move(evt)));
+    n_stall_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - t0)
+                      .count();
+  }
+
+  // Maximum occupancy
+  const unsigned long depth = queue->Size();
+  unsigned long       prev  = n_maxdepth.load(std::memory_order_relaxed);
+  while (depth > prev && !n_maxdepth.compare_exchange_weak(prev, depth)) {}
+
+  // Wake up writer once a full batch is available
+  if (depth >= BATCH) { cv_wake.notify_one(); }
+}
+
+void MAsyncWriter::WriterLoop() {
+  std::vector<std::unique_ptr<MEventRecord>> batch;
+  batch.reserve(BATCH);
+
+  while (true) {
+    std::unique_ptr<MEventRecord> evt;
+    while (batch.size() < BATCH && queue->TryPop(evt)) { batch.push_back(std::move(evt)); }
+
+    if (!batch.empty()) {
+      // After a failure the queue is only drained, so that producers do not stall
+      for (auto &e : batch) {
+        if (failed.load(std::memory_order_relaxed)) {
+          ++n_written;
+          continue;
+        }
+        try {
+          Deliver(std::move(e));
+        } catch (...) {
+          error = std::current_exception();
+          failed.store(true, std::memory_order_release);
+          DropPending();
+        }
+      }
+      ++n_batches;
+      batch.clear();
+      continue;
+    }
+
+    // Queue empty, write out the reorder buffer when requested
+    if (!pending.empty() && (drain || stop)) {
+      try {
+        WriteReady(true);
+      } catch (...) {
+        error = std::current_exception();
+        failed.store(true, std::memory_order_release);
+        DropPending();
+      }
+      continue;
+    }
+    if (stop) { break; }
+    std::unique_lock<std::mutex> lock(sync_mutex);
+    cv_wake.wait_for(lock, std::chrono::milliseconds(2));
+  }
+}
+
+// Buffer the event and write all which are next in event number order
+void MAsyncWriter::Deliver(std::unique_ptr<MEventRecord> evt) {
+  const int number = evt->event_number;
+  pending.emplace(number, std::move(evt));
+  WriteReady(false);
+}
+
+// With all = true, buffered events are written also across missing numbers
+void MAsyncWriter::WriteReady(bool all) {
+  while (!pending.empty() && (all || pending.begin()->first <= next_number)) {
+    std::unique_ptr<MEventRecord> evt = std::move(pending.begin()->second);
+    pending.erase(pending.begin());
+    next_number = std::max(next_number, evt->event_number + 1);
+    ++n_written;  // Counted also if the write fails, so that Flush does not wait forever
+    output->Write(*evt);
+  }
+}
+
+// Buffered events are dropped after a failure
+void MAsyncWriter::DropPending() {
+  n_written += pending.size();
+  pending.clear();
+}
+
+void MAsyncWriter::Flush() {
+  if (queue == nullptr) {
+    std::lock_guard<std::mutex> lock(sync_mutex);
+    WriteReady(true);
+    return;
+  }
+  drain = true;
+  while (n_written.load() < n_pushed.load()) {
+    cv_wake.notify_one();
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  drain = false;
+  RethrowError();
+}
+
+void MAsyncWriter::Close() {
+  if (worker.joinable()) {
+    drain = true;
+    while (n_written.load() < n_pushed.load()) {
+      cv_wake.notify_one();
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    stop = true;
+    cv_wake.notify_one();
+    worker.join();
+  } else if (queue == nullptr) {
+    std::lock_guard<std::mutex> lock(sync_mutex);
+    WriteReady(true);
+  }
+  RethrowError();
+}
+
+// Called by the owner thread, the error is written before failed is set
+void MAsyncWriter::RethrowError() {
+  if (failed.load(std::memory_order_acquire) && error != nullptr) {
+    std::exception_ptr e = nullptr;
+    std::swap(e, error);
+    std::rethrow_exception(e);
+  }
+}
+
+AsyncWriterStats MAsyncWriter::GetStats() const {
+  AsyncWriterStats s;
+  s.pushed    = n_pushed.load();
+  s.written   = n_written.load();
+  s.batches   = n_batches.load();
+  s.stalls    = n_stalls.load();
+  s.stalltime = n_stall_ns.load() * 1e-9;
+  s.maxdepth  = n_maxdepth.load();
+  return s;
+}
+
+}  // namespace gra
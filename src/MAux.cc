@@ -5,6 +5,7 @@
 
 // C++
 #include <complex>
+#include <cstdio>
 #include <fstream>
 #include <iostream>
 #include <regex>
@@ -166,6 +167,53 @@ std::uintmax_t GetFileSize(const std::string &filename) {
   return rc == 0 ? stat_buf.st_size : 0;
 }
 
+void WriteFileAtomic(const std::string &filename, const std::function<void(std::ostream &)> &write) {
+  const std::string tmpname = filename + ".tmp" + std::to_string(getpid());
+  {
+    std::ofstream f(tmpname, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!f.is_open()) {
+      throw std::invalid_argument("WriteFileAtomic: Fatal IO-error with: " + tmpname);
+    }
+    try {
+      write(f);
+    } catch (...) {
+      f.close();
+      std::remove(tmpname.c_str());
+      throw;
+    }
+    f.close();
+    if (!f) {
+      std::remove(tmpname.c_str());
+      throw std::invalid_argument("WriteFileAtomic: Error writing: " + tmpname);
+    }
+  }
+  if (std::rename(tmpname.c_str(), filename.c_str()) != 0) {
+    std::remove(tmpname.c_str());
+    throw std::invalid_argument("WriteFileAtomic: Could not rename " + tmpname + " to " +
+                                filename);
+  }
+}
+
+// Bytes left in a seekable stream, BINARY_MAXLEN otherwise
+std::uint64_t BinaryRemaining(std::istream &f) {
+  const std::streampos pos = f.tellg();
+  if (pos < 0) { return BINARY_MAXLEN; }
+  f.seekg(0, std::ios::end);
+  const std::streampos end = f.tellg();
+  f.seekg(pos);
+  if (!f || end < pos) { throw std::runtime_error("could not determine file size"); }
+  return static_cast<std::uint64_t>(end - pos);
+}
+
+void BinaryGetString(std::istream &f, std::string &s) {
+  std::uint64_t n = 0;
+  BinaryGet(f, n);
+  if (n > BinaryRemaining(f)) { throw std::runtime_error("corrupted string length"); }
+  s.resize(n);
+  f.read(&s[0], n);
+  if (!f) { throw std::runtime_error("unexpected end of file"); }
+}
+
 // Get Process Memory Usage (linux/BSD/OSX) in bytes
 void GetProcessMemory(double &peak_use, double &resident_use) {
   // Peak memory
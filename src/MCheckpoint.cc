@@ -0,0 +1,204 @@
+// VEGAS integration checkpoint
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+// Own
+#include "Graniitti/MAux.h"
+#include "Graniitti/MCheckpoint.h"
+
+using gra::aux::BinaryGet;
+using gra::aux::BinaryGetString;
+using gra::aux::BinaryGetVector;
+using gra::aux::BinaryPut;
+using gra::aux::BinaryPutString;
+using gra::aux::BinaryPutVector;
+
+namespace gra {
+
+constexpr char          MVEGASCheckpoint::MAGIC[8];
+constexpr std::uint32_t MVEGASCheckpoint::VERSION;
+
+void MVEGASCheckpoint::Write(const std::string &filename) const {
+  aux::WriteFileAtomic(filename, [&](std::ostream &f) {
+    f.write(MAGIC, sizeof(MAGIC));
+    BinaryPut(f, VERSION);
+    BinaryPut(f, hash);
+    BinaryPutString(f, key);
+    BinaryPutString(f, created);
+    BinaryPut(f, generator);
+
+    BinaryPut(f, FDIM);
+    BinaryPut(f, BINS);
+    BinaryPut(f, NCALL);
+    BinaryPutVector(f, region);
+    BinaryPutVector(f, xmat);
+
+    BinaryPut(f, sumdata);
+    BinaryPut(f, sumchi2);
+    BinaryPut(f, sweight);
+
+    const double S[10] = {sigma,       sigma_err,    chi2,          maxf,       maxW,
+                          evaluations, amplitude_ok, kinematics_ok, fidcuts_ok, vetocuts_ok};
+    for (const auto &x : S) { BinaryPut(f, x); }
+
+    BinaryPutVector(f, decayW);
+    for (const auto &x : DW_sum) { BinaryPut(f, x); }
+    for (const auto &x : DW_sum_exact) { BinaryPut(f, x); }
+
+    BinaryPut(f, static_cast<std::uint64_t>(hist.size()));
+    for (const auto &h : hist) {
+      BinaryPutString(f, h.name);
+      BinaryPut(f, h.dim);
+      BinaryPut(f, h.xbins);
+      BinaryPut(f, h.xmin);
+      BinaryPut(f, h.xmax);
+      BinaryPut(f, h.ybins);
+      BinaryPut(f, h.ymin);
+      BinaryPut(f, h.ymax);
+    }
+  });
+}
+
+bool MVEGASCheckpoint::Read(const std::string &filename) {
+  std::ifstream f(filename, std::ios::in | std::ios::binary);
+  if (!f.is_open()) { return false; }
+
+  try {
+    char magic[8] = {0};
+    f.read(magic, sizeof(magic));
+    if (!f || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+      throw std::runtime_error("not a VEGAS checkpoint file");
+    }
+    BinaryGet(f, version);
+    if (version != VERSION) {
+      throw std::runtime_error("version " + std::to_string(version) + " (expected " +
+                               std::to_string(VERSION) + ")");
+    }
+    BinaryGet(f, hash);
+    BinaryGetString(f, key);
+    BinaryGetString(f, created);
+    BinaryGet(f, generator);
+
+    BinaryGet(f, FDIM);
+    BinaryGet(f, BINS);
+    BinaryGet(f, NCALL);
+    BinaryGetVector(f, region);
+    BinaryGetVector(f, xmat);
+    if (region.size() != 2 * (std::size_t)FDIM || xmat.size() != (std::size_t)BINS * FDIM) {
+      throw std::runtime_error("grid size does not match FDIM x BINS");
+    }
+
+    BinaryGet(f, sumdata);
+    BinaryGet(f, sumchi2);
+    BinaryGet(f, sweight);
+
+    double S[10];
+    for (auto &x : S) { BinaryGet(f, x); }
+    sigma         = S[0];
+    sigma_err     = S[1];
+    chi2          = S[2];
+    maxf          = S[3];
+    maxW          = S[4];
+    evaluations   = S[5];
+    amplitude_ok  = S[6];
+    kinematics_ok = S[7];
+    fidcuts_ok    = S[8];
+    vetocuts_ok   = S[9];
+
+    BinaryGetVector(f, decayW);
+    for (auto &x : DW_sum) { BinaryGet(f, x); }
+    for (auto &x : DW_sum_exact) { BinaryGet(f, x); }
+
+    std::uint64_t nhist = 0;
+    BinaryGet(f, nhist);
+    // Each entry holds at least the name length and the binning
+    const std::uint64_t minsize = sizeof(std::uint64_t) + 3 * sizeof(int) + 4 * sizeof(double);
+    if (nhist > aux::BinaryRemaining(f) / minsize) {
+      throw std::runtime_error("corrupted histogram count");
+    }
+    hist.resize(nhist);
+    for (auto &h : hist) {
+      BinaryGetString(f, h.name);
+      BinaryGet(f, h.dim);
+      BinaryGet(f, h.xbins);
+      BinaryGet(f, h.xmin);
+      BinaryGet(f, h.xmax);
+      BinaryGet(f, h.ybins);
+      BinaryGet(f, h.ymin);
+      BinaryGet(f, h.ymax);
+    }
+  } catch (const std::runtime_error &e) {
+    std::cout << "MVEGASCheckpoint::Read: Invalid checkpoint " << filename << " (" << e.what()
+              << ")" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void MVEGASCheckpoint::Print(bool grid) const {
+  printf("Format version:      %u \n", version);
+  printf("Generator version:   %0.3f \n", generator);
+  printf("Created:             %s \n", created.c_str());
+  printf("Hash:                %llu \n", static_cast<unsigned long long>(hash));
+  printf("\n");
+  printf("VEGAS dimension:     %u \n", FDIM);
+  printf("VEGAS bins:          %u \n", BINS);
+  printf("VEGAS calls:         %u \n", NCALL);
+  printf("\n");
+  printf("Cross section:       %0.4E +- %0.4E barn \n", sigma, sigma_err);
+  printf("Chi2:                %0.3f \n", chi2);
+  printf("Maximum weight:      %0.4E \n", maxf);
+  printf("Evaluations:         %0.0f \n", evaluations);
+  if (evaluations > 0) {
+    printf("Kinematics / fiducial / veto / amplitude ok:  %0.3f / %0.3f / %0.3f / %0.3f \n",
+           kinematics_ok / evaluations, fidcuts_ok / evaluations, vetocuts_ok / evaluations,
+           amplitude_ok / evaluations);
+  }
+  printf("Decay tree weights:  %lu \n", decayW.size() / 3);
+  if (DW_sum[0] > 0.0) {
+    printf("Phase space volume:  %0.4E +- %0.4E \n", DW_sum[1] / DW_sum[0],
+           std::sqrt(DW_sum[2]) / DW_sum[0]);
+  }
+  printf("Histograms:          %lu \n", hist.size());
+  for (const auto &h : hist) {
+    if (h.dim == 1) {
+      printf("  %-24s [%d bins, %0.3E, %0.3E] \n", h.name.c_str(), h.xbins, h.xmin, h.xmax);
+    } else {
+      printf("  %-24s [%d bins, %0.3E, %0.3E] x [%d bins, %0.3E, %0.3E] \n", h.name.c_str(),
+             h.xbins, h.xmin, h.xmax, h.ybins, h.ymin, h.ymax);
+    }
+  }
+
+  // Grid: width of the narrowest and widest bin per dimension
+  printf("\n");
+  for (std::size_t j = 0; j < FDIM; ++j) {
+    double minw = 1e99;
+    double maxw = 0.0;
+    double prev = 0.0;
+    for (std::size_t i = 0; i < BINS; ++i) {
+      const double w = xmat[i * FDIM + j] - prev;
+      minw           = std::min(minw, w);
+      maxw           = std::max(maxw, w);
+      prev           = xmat[i * FDIM + j];
+    }
+    printf("Grid dimension %2lu:   bin width [%0.3E, %0.3E] \n", j, minw, maxw);
+    if (grid) {
+      for (std::size_t i = 0; i < BINS; ++i) { printf("  %0.6f", xmat[i * FDIM + j]); }
+      printf("\n");
+    }
+  }
+  printf("\n");
+  printf("Key: \n%s \n", key.c_str());
+}
+
+}  // namespace gra
@@ -0,0 +1,353 @@
+// Columnar binary event file
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <cstring>
+#include <stdexcept>
+
+// Own
+#include "Graniitti/MAux.h"
+#include "Graniitti/MColumnar.h"
+
+using gra::aux::BinaryGet;
+using gra::aux::BinaryGetArray;
+using gra::aux::BinaryGetString;
+using gra::aux::BinaryPut;
+using gra::aux::BinaryPutArray;
+using gra::aux::BinaryPutString;
+
+namespace gra {
+
+constexpr char          MColumnarHeader::MAGIC[8];
+constexpr std::uint32_t MColumnarHeader::VERSION;
+
+namespace {
+
+constexpr char TAG_CHUNK[4] = {'C', 'H', 'N', 'K'};
+constexpr char TAG_END[4]   = {'E', 'N', 'D', '!'};
+
+}  // namespace
+
+// ----------------------------------------------------------------------
+// Chunk
+
+void MColumnarChunk::Clear() {
+  number.clear();
+  np.clear();
+  nv.clear();
+  nw.clear();
+  xs.clear();
+  xs_err.clear();
+
+  pdg.clear();
+  status.clear();
+  prod.clear();
+  end.clear();
+  px.clear();
+  py.clear();
+  pz.clear();
+  e.clear();
+  m.clear();
+
+  x.clear();
+  y.clear();
+  z.clear();
+  t.clear();
+
+  w.clear();
+
+  p0.assign(1, 0);
+  v0.assign(1, 0);
+  w0.assign(1, 0);
+}
+
+void MColumnarChunk::Append(const MEventRecord &evt) {
+  number.push_back(evt.event_number);
+  np.push_back(evt.particles.size());
+  nv.push_back(evt.vertices.size());
+  nw.push_back(evt.weights.size());
+  xs.push_back(evt.xs);
+  xs_err.push_back(evt.xs_err);
+
+  for (const auto &p : evt.particles) {
+    pdg.push_back(p.pdg);
+    status.push_back(p.status);
+    prod.push_back(p.prod);
+    end.push_back(p.end);
+    px.push_back(p.px);
+    py.push_back(p.py);
+    pz.push_back(p.pz);
+    e.push_back(p.e);
+    m.push_back(p.m);
+  }
+  for (const auto &v : evt.vertices) {
+    x.push_back(v.x);
+    y.push_back(v.y);
+    z.push_back(v.z);
+    t.push_back(v.t);
+  }
+  w.insert(w.end(), evt.weights.begin(), evt.weights.end());
+
+  p0.push_back(pdg.size());
+  v0.push_back(x.size());
+  w0.push_back(w.size());
+}
+
+void MColumnarChunk::Index() {
+  p0.assign(1, 0);
+  v0.assign(1, 0);
+  w0.assign(1, 0);
+  for (std::size_t k = 0; k < NEvents(); ++k) {
+    p0.push_back(p0.back() + np[k]);
+    v0.push_back(v0.back() + nv[k]);
+    w0.push_back(w0.back() + nw[k]);
+  }
+}
+
+void MColumnarChunk::GetEvent(std::size_t k, MEventRecord &evt) const {
+  evt.Clear();
+  evt.event_number = number[k];
+  evt.xs           = xs[k];
+  evt.xs_err       = xs_err[k];
+  evt.weights.assign(w.begin() + w0[k], w.begin() + w0[k + 1]);
+
+  for (std::size_t j = v0[k]; j < v0[k + 1]; ++j) { evt.AddVertex(M4Vec(x[j], y[j], z[j], t[j])); }
+  for (std::size_t i = p0[k]; i < p0[k + 1]; ++i) {
+    MEventRecord::Particle p;
+    p.px     = px[i];
+    p.py     = py[i];
+    p.pz     = pz[i];
+    p.e      = e[i];
+    p.m      = m[i];
+    p.pdg    = pdg[i];
+    p.status = status[i];
+    evt.particles.push_back(p);
+
+    const int n = static_cast<int>(evt.particles.size()) - 1;
+    if (prod[i] >= 0) { evt.AddOut(prod[i], n); }
+    if (end[i] >= 0) { evt.AddIn(end[i], n); }
+  }
+}
+
+void MColumnarChunk::Mothers(std::size_t k, std::size_t i, int &m1, int &m2) const {
+  m1 = -1;
+  m2 = -1;
+  const int v = prod[p0[k] + i];
+  if (v < 0) { return; }
+  for (std::size_t j = p0[k]; j < p0[k + 1]; ++j) {
+    if (end[j] == v) {
+      if (m1 < 0) { m1 = j - p0[k]; }
+      m2 = j - p0[k];
+    }
+  }
+}
+
+// ----------------------------------------------------------------------
+// Writer
+
+MWriterColumnar::MWriterColumnar(std::ostream &os, const MColumnarHeader &header,
+                                 std::size_t chunksize)
+    : out(os), head(header), CHUNKSIZE(chunksize) {
+  if (CHUNKSIZE == 0) {
+    throw std::invalid_argument("MWriterColumnar: Chunk size must be > 0");
+  }
+  head.version = MColumnarHeader::VERSION;
+
+  out.write(MColumnarHeader::MAGIC, sizeof(MColumnarHeader::MAGIC));
+  BinaryPut(out, head.version);
+  headpos = out.tellp();  // -1 if the stream is not seekable
+  BinaryPut(out, head.events);
+  BinaryPut(out, head.xs);
+  BinaryPut(out, head.xs_err);
+  BinaryPut(out, head.cardhash);
+  BinaryPut(out, head.beam1);
+  BinaryPut(out, head.beam2);
+  BinaryPut(out, head.E1);
+  BinaryPut(out, head.E2);
+  BinaryPutString(out, head.generator);
+  BinaryPutString(out, head.card);
+}
+
+void MWriterColumnar::Write(const MEventRecord &evt) {
+  chunk.Append(evt);
+  ++head.events;
+  head.xs     = evt.xs;
+  head.xs_err = evt.xs_err;
+  if (chunk.NEvents() >= CHUNKSIZE) { WriteChunk(); }
+}
+
+void MWriterColumnar::WriteChunk() {
+  if (chunk.NEvents() == 0) { return; }
+
+  out.write(TAG_CHUNK, sizeof(TAG_CHUNK));
+  BinaryPut(out, static_cast<std::uint64_t>(chunk.NEvents()));
+  BinaryPut(out, static_cast<std::uint64_t>(chunk.pdg.size()));
+  BinaryPut(out, static_cast<std::uint64_t>(chunk.x.size()));
+  BinaryPut(out, static_cast<std::uint64_t>(chunk.w.size()));
+
+  BinaryPutArray(out, chunk.number);
+  BinaryPutArray(out, chunk.np);
+  BinaryPutArray(out, chunk.nv);
+  BinaryPutArray(out, chunk.nw);
+  BinaryPutArray(out, chunk.xs);
+  BinaryPutArray(out, chunk.xs_err);
+
+  BinaryPutArray(out, chunk.pdg);
+  BinaryPutArray(out, chunk.status);
+  BinaryPutArray(out, chunk.prod);
+  BinaryPutArray(out, chunk.end);
+  BinaryPutArray(out, chunk.px);
+  BinaryPutArray(out, chunk.py);
+  BinaryPutArray(out, chunk.pz);
+  BinaryPutArray(out, chunk.e);
+  BinaryPutArray(out, chunk.m);
+
+  BinaryPutArray(out, chunk.x);
+  BinaryPutArray(out, chunk.y);
+  BinaryPutArray(out, chunk.z);
+  BinaryPutArray(out, chunk.t);
+
+  BinaryPutArray(out, chunk.w);
+
+  chunk.Clear();
+}
+
+// The event count and the final cross section are written to the header
+// if the stream is seekable, and always to the end record
+void MWriterColumnar::Close() {
+  if (closed) { return; }
+  closed = true;
+
+  WriteChunk();
+  out.write(TAG_END, sizeof(TAG_END));
+  BinaryPut(out, head.events);
+  BinaryPut(out, head.xs);
+  BinaryPut(out, head.xs_err);
+
+  if (headpos >= 0) {
+    const std::streampos endpos = out.tellp();
+    out.seekp(headpos);
+    BinaryPut(out, head.events);
+    BinaryPut(out, head.xs);
+    BinaryPut(out, head.xs_err);
+    out.seekp(endpos);
+  }
+  out.flush();
+}
+
+// ----------------------------------------------------------------------
+// Reader
+
+MReaderColumnar::MReaderColumnar(const std::string &filename)
+    : in(filename) {
+  if (!in.IsOpen()) {
+    throw std::invalid_argument("MReaderColumnar: Cannot open file " + filename);
+  }
+  char magic[8] = {0};
+  in.read(magic, sizeof(magic));
+  if (!in || std::memcmp(magic, MColumnarHeader::MAGIC, sizeof(magic)) != 0) {
+    throw std::invalid_argument("MReaderColumnar: Not a columnar event file " + filename);
+  }
+  try {
+    BinaryGet(in, head.version);
+    if (head.version != MColumnarHeader::VERSION) {
+      throw std::invalid_argument("MReaderColumnar: File " + filename + " has version " +
+                                  std::to_string(head.version) + " (expected " +
+                                  std::to_string(MColumnarHeader::VERSION) + ")");
+    }
+    BinaryGet(in, head.events);
+    BinaryGet(in, head.xs);
+    BinaryGet(in, head.xs_err);
+    BinaryGet(in, head.cardhash);
+    BinaryGet(in, head.beam1);
+    BinaryGet(in, head.beam2);
+    BinaryGet(in, head.E1);
+    BinaryGet(in, head.E2);
+    BinaryGetString(in, head.generator);
+    BinaryGetString(in, head.card);
+  } catch (const std::runtime_error &e) {
+    throw std::invalid_argument("MReaderColumnar: " + filename + ": " + e.what());
+  }
+}
+
+bool MReaderColumnar::ReadChunk(MColumnarChunk &chunk) {
+  chunk.Clear();
+
+  char tag[4] = {0};
+  in.read(tag, sizeof(tag));
+  if (!in) { return false; }  // Truncated file (writer not closed)
+
+  try {
+    if (std::memcmp(tag, TAG_END, sizeof(tag)) == 0) {
+      BinaryGet(in, head.events);
+      BinaryGet(in, head.xs);
+      BinaryGet(in, head.xs_err);
+      return false;
+    }
+    if (std::memcmp(tag, TAG_CHUNK, sizeof(tag)) != 0) {
+      throw std::invalid_argument("MReaderColumnar: Corrupted chunk tag");
+    }
+
+    std::uint64_t N  = 0;
+    std::uint64_t NP = 0;
+    std::uint64_t NV = 0;
+    std::uint64_t NW = 0;
+    BinaryGet(in, N);
+    BinaryGet(in, NP);
+    BinaryGet(in, NV);
+    BinaryGet(in, NW);
+
+    BinaryGetArray(in, chunk.number, N);
+    BinaryGetArray(in, chunk.np, N);
+    BinaryGetArray(in, chunk.nv, N);
+    BinaryGetArray(in, chunk.nw, N);
+    BinaryGetArray(in, chunk.xs, N);
+    BinaryGetArray(in, chunk.xs_err, N);
+
+    BinaryGetArray(in, chunk.pdg, NP);
+    BinaryGetArray(in, chunk.status, NP);
+    BinaryGetArray(in, chunk.prod, NP);
+    BinaryGetArray(in, chunk.end, NP);
+    BinaryGetArray(in, chunk.px, NP);
+    BinaryGetArray(in, chunk.py, NP);
+    BinaryGetArray(in, chunk.pz, NP);
+    BinaryGetArray(in, chunk.e, NP);
+    BinaryGetArray(in, chunk.m, NP);
+
+    BinaryGetArray(in, chunk.x, NV);
+    BinaryGetArray(in, chunk.y, NV);
+    BinaryGetArray(in, chunk.z, NV);
+    BinaryGetArray(in, chunk.t, NV);
+
+    BinaryGetArray(in, chunk.w, NW);
+
+    chunk.Index();
+    if (chunk.p0.back() != NP || chunk.v0.back() != NV || chunk.w0.back() != NW) {
+      throw std::invalid_argument("MReaderColumnar: Corrupted chunk counts");
+    }
+    for (std::size_t k = 0; k < N; ++k) {
+      const int nv = chunk.nv[k];
+      for (std::size_t i = chunk.p0[k]; i < chunk.p0[k + 1]; ++i) {
+        if (chunk.prod[i] >= nv || chunk.end[i] >= nv) {
+          throw std::invalid_argument("MReaderColumnar: Corrupted vertex index");
+        }
+      }
+    }
+  } catch (const std::runtime_error &e) {
+    throw std::invalid_argument(std::string("MReaderColumnar: ") + e.what());
+  }
+  return true;
+}
+
+bool MReaderColumnar::ReadEvent(MEventRecord &evt) {
+  while (cursor >= buffer.NEvents()) {
+    if (!ReadChunk(buffer)) { return false; }
+    cursor = 0;
+  }
+  buffer.GetEvent(cursor++, evt);
+  return true;
+}
+
+}  // namespace gra
@@ -0,0 +1,256 @@
+// Block compressed output and transparently decompressed input streams
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <algorithm>
+#include <stdexcept>
+
+// zlib
+#include <zlib.h>
+
+// Own
+#include "Graniitti/MCompress.h"
+
+namespace gra {
+
+// ----------------------------------------------------------------------
+// Codecs
+
+MCodecGzip::MCodecGzip(int level) : LEVEL(level) {
+  if (LEVEL < 1 || LEVEL > 9) {
+    throw std::invalid_argument("MCodecGzip: Compression level " + std::to_string(LEVEL) +
+                                " not in [1,9]");
+  }
+}
+
+// One complete gzip member (windowBits 15 + 16 = gzip wrapper)
+void MCodecGzip::Compress(const char *in, std::size_t n, std::string &out) const {
+  z_stream zs = {};
+  if (deflateInit2(&zs, LEVEL, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    throw std::invalid_argument("MCodecGzip::Compress: deflateInit2 failed");
+  }
+  out.resize(deflateBound(&zs, n) + 32);
+
+  zs.next_in   = reinterpret_cast<Bytef *>(const_cast<char *>(in));
+  zs.avail_in  = n;
+  zs.next_out  = reinterpret_cast<Bytef *>(&out[0]);
+  zs.avail_out = out.size();
+  const int ret = deflate(&zs, Z_FINISH);
+  out.resize(zs.total_out);
+  deflateEnd(&zs);
+
+  if (ret != Z_STREAM_END) { throw std::invalid_argument("MCodecGzip::Compress: deflate failed"); }
+}
+
+std::shared_ptr<MCodec> MakeCodec(const std::string &name) {
+  if (name == "none" || name == "") { return nullptr; }
+  if (name == "gzip") { return std::make_shared<MCodecGzip>(); }
+  if (name.size() == 6 && name.substr(0, 5) == "gzip:" && name[5] >= '1' && name[5] <= '9') {
+    return std::make_shared<MCodecGzip>(name[5] - '0');
+  }
+  throw std::invalid_argument("MakeCodec: Unknown compression: " + name +
+                              " (valid: none, gzip, gzip:<1-9>)");
+}
+
+// ----------------------------------------------------------------------
+// Compressed output
+
+MCompressBuf::MCompressBuf(std::ostream &os, std::shared_ptr<MCodec> c, unsigned int threads,
+                           std::size_t blocksize)
+    : sink(os), codec(c), BLOCKSIZE(blocksize), MAXINFLIGHT(2 * std::max(1U, threads)) {
+  if (codec == nullptr) { throw std::invalid_argument("MCompressBuf: Codec is nullptr"); }
+  buffer.reserve(BLOCKSIZE);
+  for (unsigned int i = 0; i < threads; ++i) {
+    workers.push_back(std::thread([this] { WorkerLoop(); }));
+  }
+}
+
+MCompressBuf::~MCompressBuf() {
+  try {
+    Finish();
+  } catch (...) {
+    // Destructor does not throw
+  }
+}
+
+MCompressBuf::int_type MCompressBuf::overflow(int_type c) {
+  if (c != traits_type::eof()) {
+    buffer.push_back(traits_type::to_char_type(c));
+    if (buffer.size() >= BLOCKSIZE) { Submit(); }
+  }
+  return traits_type::not_eof(c);
+}
+
+std::streamsize MCompressBuf::xsputn(const char *s, std::streamsize n) {
+  std::streamsize k = 0;
+  while (k < n) {
+    const std::size_t m = std::min<std::size_t>(n - k, BLOCKSIZE - buffer.size());
+    buffer.append(s + k, m);
+    k += m;
+    if (buffer.size() >= BLOCKSIZE) { Submit(); }
+  }
+  return n;
+}
+
+void MCompressBuf::Submit() {
+  if (buffer.empty()) { return; }
+
+  std::shared_ptr<Block> block = std::make_shared<Block>();
+  block->raw.swap(buffer);
+  buffer.reserve(BLOCKSIZE);
+
+  // Synchronous mode
+  if (workers.empty()) {
+    codec->Compress(block->raw.data(), block->raw.size(), block->packed);
+    sink.write(block->packed.data(), block->packed.size());
+    return;
+  }
+
+  // Back-pressure: at most MAXINFLIGHT blocks in memory
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv_done.wait(lock, [this] { return inflight.size() < MAXINFLIGHT || inflight.front()->done; });
+  }
+  WriteDone(false);
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    todo.push_back(block);
+    inflight.push_back(block);
+  }
+  cv_task.notify_one();
+}
+
+void MCompressBuf::WriteDone(bool all) {
+  while (true) {
+    std::shared_ptr<Block> block = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      if (inflight.empty()) { return; }
+      if (all) { cv_done.wait(lock, [this] { return inflight.front()->done; }); }
+      if (!inflight.front()->done) { return; }
+      block = inflight.front();
+      inflight.pop_front();
+    }
+    if (block->error) { std::rethrow_exception(block->error); }
+    sink.write(block->packed.data(), block->packed.size());
+  }
+}
+
+void MCompressBuf::WorkerLoop() {
+  while (true) {
+    std::shared_ptr<Block> block = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      cv_task.wait(lock, [this] { return stop || !todo.empty(); });
+      if (todo.empty()) { return; }  // stop
+      block = todo.front();
+      todo.pop_front();
+    }
+    try {
+      codec->Compress(block->raw.data(), block->raw.size(), block->packed);
+    } catch (...) {
+      block->error = std::current_exception();
+    }
+    std::string().swap(block->raw);
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      block->done = true;
+    }
+    cv_done.notify_all();
+  }
+}
+
+void MCompressBuf::Finish() {
+  if (finished) { return; }
+  finished = true;
+
+  Submit();
+  WriteDone(true);
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    stop = true;
+  }
+  cv_task.notify_all();
+  for (auto &w : workers) { w.join(); }
+  workers.clear();
+  sink.flush();
+}
+
+// ----------------------------------------------------------------------
+// Decompressed input
+
+MDecompressBuf::MDecompressBuf(std::istream &source) : src(source), in(1 << 16), out(1 << 18) {
+  z_stream *s = new z_stream();
+  // windowBits 15 + 32 = automatic zlib / gzip header detection
+  if (inflateInit2(s, 15 + 32) != Z_OK) {
+    delete s;
+    throw std::invalid_argument("MDecompressBuf: inflateInit2 failed");
+  }
+  zs = s;
+  setg(out.data(), out.data(), out.data());
+}
+
+MDecompressBuf::~MDecompressBuf() {
+  z_stream *s = static_cast<z_stream *>(zs);
+  inflateEnd(s);
+  delete s;
+}
+
+MDecompressBuf::int_type MDecompressBuf::underflow() {
+  if (gptr() < egptr()) { return traits_type::to_int_type(*gptr()); }
+
+  z_stream *s = static_cast<z_stream *>(zs);
+  s->next_out  = reinterpret_cast<Bytef *>(out.data());
+  s->avail_out = out.size();
+
+  // Until at least one byte is produced or the input ends
+  while (s->avail_out == out.size()) {
+    if (s->avail_in == 0) {
+      if (eof) { break; }
+      src.read(in.data(), in.size());
+      s->avail_in = src.gcount();
+      s->next_in  = reinterpret_cast<Bytef *>(in.data());
+      if (s->avail_in == 0) {
+        eof = true;
+        break;
+      }
+    }
+    const int ret = inflate(s, Z_NO_FLUSH);
+    if (ret == Z_STREAM_END) {
+      // Next gzip member
+      inflateReset(s);
+    } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+      throw std::invalid_argument("MDecompressBuf: Corrupted compressed data (zlib error " +
+                                  std::to_string(ret) + ")");
+    }
+  }
+
+  const std::size_t n = out.size() - s->avail_out;
+  setg(out.data(), out.data(), out.data() + n);
+  return (n == 0) ? traits_type::eof() : traits_type::to_int_type(*gptr());
+}
+
+MInputStream::MInputStream(const std::string &filename)
+    : std::istream(nullptr), file(filename, std::ios::in | std::ios::binary) {
+  if (!file.is_open()) {
+    setstate(std::ios::failbit);
+    return;
+  }
+  // gzip magic bytes
+  char magic[2] = {0, 0};
+  file.read(magic, 2);
+  const bool gzip = (file.gcount() == 2 && magic[0] == '\x1f' && magic[1] == '\x8b');
+  file.clear();
+  file.seekg(0);
+
+  if (gzip) {
+    zbuf = std::make_unique<MDecompressBuf>(file);
+    rdbuf(zbuf.get());
+  } else {
+    rdbuf(file.rdbuf());
+  }
+}
+
+}  // namespace gra
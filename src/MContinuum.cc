@@ -101,7 +101,8 @@ bool MContinuum::LoopKinematics(const std::vector<double> &p1p, const std::vecto
   lts.pfinal[2].SetPxPy(p2p[0], p2p[1]);
 
   // Get central final states pT degrees of freedom
-  std::vector<M4Vec> p(Kf, M4Vec(0, 0, 0, 0));
+  p_.assign(Kf, M4Vec(0, 0, 0, 0));
+  std::vector<M4Vec> &p = p_;
   BLinearSystem(p, pkt_, lts.pfinal[1], lts.pfinal[2]);
 
   // Set central particles px,py,pz,e
@@ -196,7 +197,7 @@ double MContinuum::EventWeight(const std::vector<double> &randvec, AuxIntData &a
 bool MContinuum::FiducialCuts() const { return CommonCuts(); }
 
 // Record event
-bool MContinuum::EventRecord(HepMC3::GenEvent &evt) { return CommonRecord(evt); }
+bool MContinuum::EventRecord(MEventRecord &evt) { return CommonRecord(evt); }
 
 void MContinuum::PrintInit(bool silent) const {
   if (!silent) {
@@ -299,35 +300,34 @@ bool MContinuum::BNRandomKin(unsigned int Nf, const std::vector<double> &randvec
   // ==============================================================
 
   // Intermediate kt
-  std::vector<double> kt(Kf - 1, 0.0);  // Kf-1
-  size_t              ind = offset;
-  for (const auto &i : indices(kt)) {
-    kt[i] = gcuts.kt_min + (gcuts.kt_max - gcuts.kt_min) * randvec[ind];
+  kt_.resize(Kf - 1);  // Kf-1
+  size_t ind = offset;
+  for (const auto &i : indices(kt_)) {
+    kt_[i] = gcuts.kt_min + (gcuts.kt_max - gcuts.kt_min) * randvec[ind];
     ++ind;
   }
 
   // Intermediate phi
-  std::vector<double> phi(Kf - 1, 0.0);  // Kf-1
-  for (const auto &i : indices(phi)) {
-    phi[i] = 2.0 * PI * randvec[ind];
+  phi_.resize(Kf - 1);  // Kf-1
+  for (const auto &i : indices(phi_)) {
+    phi_[i] = 2.0 * PI * randvec[ind];
     ++ind;
   }
 
   // Final state rapidity
-  std::vector<double> y(Kf, 0.0);  // Kf
-  for (const auto &i : indices(y)) {
-    y[i] = gcuts.rap_min + (gcuts.rap_max - gcuts.rap_min) * randvec[ind];
+  y_.resize(Kf);  // Kf
+  for (const auto &i : indices(y_)) {
+    y_[i] = gcuts.rap_min + (gcuts.rap_max - gcuts.rap_min) * randvec[ind];
     ++ind;
   }
 
   // Forward N* system masses
-  std::vector<double> mvec;
-  std::vector<double> rvec;
-  if (EXCITATION == 1) { rvec = {randvec[ind]}; }
-  if (EXCITATION == 2) { rvec = {randvec[ind], randvec[ind + 1]}; }
-  SampleForwardMasses(mvec, rvec);
+  rvec_.clear();
+  if (EXCITATION >= 1) { rvec_.push_back(randvec[ind]); }
+  if (EXCITATION == 2) { rvec_.push_back(randvec[ind + 1]); }
+  SampleForwardMasses(mvec_, rvec_);
 
-  return BNBuildKin(Nf, pt1, pt2, phi1, phi2, kt, phi, y, mvec[0], mvec[1]);
+  return BNBuildKin(Nf, pt1, pt2, phi1, phi2, kt_, phi_, y_, mvec_[0], mvec_[1]);
 }
 
 // Build kinematics of 2->N
@@ -357,7 +357,8 @@ bool MContinuum::BNBuildKin(unsigned int Nf, double pt1, double pt2, double phi1
   }
 
   // Apply linear system to get p
-  std::vector<M4Vec> p(Kf, M4Vec(0, 0, 0, 0));
+  p_.assign(Kf, M4Vec(0, 0, 0, 0));
+  std::vector<M4Vec> &p = p_;
   BLinearSystem(p, pkt_, p1, p2);
 
   // Set pz and E for central final states
@@ -529,10 +530,15 @@ void MContinuum::BLinearSystem(std::vector<M4Vec> &p, const std::vector<M4Vec> &
 
   // Construct vector b
   const unsigned int Kf = p.size();  // Number of central system particles
-  std::vector<M4Vec> b(Kf);
-  const M4Vec        p1p2sum = p1f + p2f;
+  if (Kf < 2 || Kf > A.size() + 1) {
+    throw std::invalid_argument("MContinuum::BLinearSystem: Central multiplicity " +
+                                std::to_string(Kf) + " not in [2," + std::to_string(A.size() + 1) +
+                                "]");
+  }
+  M4Vec       b[8];  // Kf <= 8, on the stack
+  const M4Vec p1p2sum = p1f + p2f;
 
-  for (const auto &i : indices(b)) {
+  for (std::size_t i = 0; i < Kf; ++i) {
     if (i == 0) {
       b[i] = q[0] - p1p2sum;
     } else {
@@ -543,7 +549,7 @@ void MContinuum::BLinearSystem(std::vector<M4Vec> &p, const std::vector<M4Vec> &
   // Apply linear system p = Ab to get px,py components for each p[i]
   const unsigned int index = Kf - 2;  // -2 because of C++
   for (const auto &i : indices(p)) {
-    for (const auto &j : indices(b)) {
+    for (std::size_t j = 0; j < Kf; ++j) {
       p[i] += b[j] * A[index][i][j];  // notice plus
     }
   }
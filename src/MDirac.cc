@@ -54,50 +54,46 @@ void MDirac::InitGammaMatrices(const std::string &basis) {
   // PARITY OPERATOR = y^0
   // Intrinsic parity of fermions +1, anti-fermion -1
 
-  const MMatrix<std::complex<double>> y0_chiral{
-      std::vector<std::complex<double>>{0.0, 0.0, 1.0, 0.0},
-      std::vector<std::complex<double>>{0.0, 0.0, 0.0, 1.0},
-      std::vector<std::complex<double>>{1.0, 0.0, 0.0, 0.0},
-      std::vector<std::complex<double>>{0.0, 1.0, 0.0, 0.0}};
-
-  const MMatrix<std::complex<double>> y0_dirac{
-      std::vector<std::complex<double>>{1.0, 0.0, 0.0, 0.0},
-      std::vector<std::complex<double>>{0.0, 1.0, 0.0, 0.0},
-      std::vector<std::complex<double>>{0.0, 0.0, -1.0, 0.0},
-      std::vector<std::complex<double>>{0.0, 0.0, 0.0, -1.0}};
+  const DMatrix y0_chiral{{0.0, 0.0, 1.0, 0.0},
+                          {0.0, 0.0, 0.0, 1.0},
+                          {1.0, 0.0, 0.0, 0.0},
+                          {0.0, 1.0, 0.0, 0.0}};
+
+  const DMatrix y0_dirac{{1.0, 0.0, 0.0, 0.0},
+                         {0.0, 1.0, 0.0, 0.0},
+                         {0.0, 0.0, -1.0, 0.0},
+                         {0.0, 0.0, 0.0, -1.0}};
 
   // \equiv i \gamma^0\gamma^1\gamma^2\gamma^3
-  const MMatrix<std::complex<double>> y5_chiral{
-      std::vector<std::complex<double>>{-1.0, 0.0, 0.0, 0.0},
-      std::vector<std::complex<double>>{0.0, -1.0, 0.0, 0.0},
-      std::vector<std::complex<double>>{0.0, 0.0, 1.0, 0.0},
-      std::vector<std::complex<double>>{0.0, 0.0, 0.0, 1.0}};
+  const DMatrix y5_chiral{{-1.0, 0.0, 0.0, 0.0},
+                          {0.0, -1.0, 0.0, 0.0},
+                          {0.0, 0.0, 1.0, 0.0},
+                          {0.0, 0.0, 0.0, 1.0}};
 
   // \equiv i \gamma^0\gamma^1\gamma^2\gamma^3
-  const MMatrix<std::complex<double>> y5_dirac{
-      std::vector<std::complex<double>>{0.0, 0.0, 1.0, 0.0},
-      std::vector<std::complex<double>>{0.0, 0.0, 0.0, 1.0},
-      std::vector<std::complex<double>>{1.0, 0.0, 0.0, 0.0},
-      std::vector<std::complex<double>>{0.0, 1.0, 0.0, 0.0}};
+  const DMatrix y5_dirac{{0.0, 0.0, 1.0, 0.0},
+                         {0.0, 0.0, 0.0, 1.0},
+                         {1.0, 0.0, 0.0, 0.0},
+                         {0.0, 1.0, 0.0, 0.0}};
 
   // ------------------------------------------------------------------
   // Both chiral and dirac basis
   // Contravariant matrices (upper index)
 
-  MMatrix<std::complex<double>> y1_up{std::vector<std::complex<double>>{0.0, 0.0, 0.0, 1.0},
-                                      std::vector<std::complex<double>>{0.0, 0.0, 1.0, 0.0},
-                                      std::vector<std::complex<double>>{0.0, -1.0, 0.0, 0.0},
-                                      std::vector<std::complex<double>>{-1.0, 0.0, 0.0, 0.0}};
+  DMatrix y1_up{{0.0, 0.0, 0.0, 1.0},
+                {0.0, 0.0, 1.0, 0.0},
+                {0.0, -1.0, 0.0, 0.0},
+                {-1.0, 0.0, 0.0, 0.0}};
 
-  MMatrix<std::complex<double>> y2_up{std::vector<std::complex<double>>{0.0, 0.0, 0.0, -zi},
-                                      std::vector<std::complex<double>>{0.0, 0.0, zi, 0.0},
-                                      std::vector<std::complex<double>>{0.0, zi, 0.0, 0.0},
-                                      std::vector<std::complex<double>>{-zi, 0.0, 0.0, 0.0}};
+  DMatrix y2_up{{0.0, 0.0, 0.0, -zi},
+                {0.0, 0.0, zi, 0.0},
+                {0.0, zi, 0.0, 0.0},
+                {-zi, 0.0, 0.0, 0.0}};
 
-  MMatrix<std::complex<double>> y3_up{std::vector<std::complex<double>>{0.0, 0.0, 1.0, 0.0},
-                                      std::vector<std::complex<double>>{0.0, 0.0, 0.0, -1.0},
-                                      std::vector<std::complex<double>>{-1.0, 0.0, 0.0, 0.0},
-                                      std::vector<std::complex<double>>{0.0, 1.0, 0.0, 0.0}};
+  DMatrix y3_up{{0.0, 0.0, 1.0, 0.0},
+                {0.0, 0.0, 0.0, -1.0},
+                {-1.0, 0.0, 0.0, 0.0},
+                {0.0, 1.0, 0.0, 0.0}};
 
   // ------------------------------------------------------------------
   // Contravariant and covariant
@@ -111,12 +107,7 @@ void MDirac::InitGammaMatrices(const std::string &basis) {
   }
 
   // sigma = i/2 [\gamma^\mu, \gamma^\nu]
-  // \sigma_{\mu\nu} each [mu][nu] contains one MMatrix
-  sigma_up = std::vector<std::vector<MMatrix<std::complex<double>>>>(
-      4, std::vector<MMatrix<std::complex<double>>>(4, MMatrix<std::complex<double>>(4, 4)));
-  sigma_lo = std::vector<std::vector<MMatrix<std::complex<double>>>>(
-      4, std::vector<MMatrix<std::complex<double>>>(4, MMatrix<std::complex<double>>(4, 4)));
-
+  // \sigma_{\mu\nu} each [mu][nu] contains one DMatrix
   for (const auto &mu : LI) {
     for (const auto &nu : LI) {
       sigma_up[mu][nu] = (gamma_up[mu] * gamma_up[nu] - gamma_up[nu] * gamma_up[mu]) * (zi / 2.0);
@@ -127,9 +118,9 @@ void MDirac::InitGammaMatrices(const std::string &basis) {
 
 // Chirality projectors, valid for all gamma representations
 // Right handed
-MMatrix<std::complex<double>> MDirac::PR() const { return (I4 + gamma_up[4]) * 0.5; }
+DMatrix MDirac::PR() const { return (I4 + gamma_up[4]) * 0.5; }
 // Left handed
-MMatrix<std::complex<double>> MDirac::PL() const { return (I4 - gamma_up[4]) * 0.5; }
+DMatrix MDirac::PL() const { return (I4 - gamma_up[4]) * 0.5; }
 
 
 // Two component Weyl (chiral) spinor
@@ -150,7 +141,7 @@ std::vector<std::complex<double>> MDirac::XiSpinor(const M4Vec &p, int helicity)
 //
 // <@@ DEFINED IN CHIRAL GAMMA MATRIX REPRESENTATION @@>
 //
-std::vector<std::complex<double>> MDirac::uHelChiral(const M4Vec &p, int helicity) const {
+DSpinor MDirac::uHelChiral(const M4Vec &p, int helicity) const {
   if (BASIS != "C") { throw std::invalid_argument("MDirac::uHelChiral: Wrong gamma basis in use"); }
 
   const double E      = p.E();
@@ -181,15 +172,15 @@ std::vector<std::complex<double>> MDirac::uHelChiral(const M4Vec &p, int helicit
 //
 // <@@ DEFINED IN CHIRAL GAMMA MATRIX REPRESENTATION @@>
 //
-std::vector<std::complex<double>> MDirac::vHelChiral(const M4Vec &p, int helicity) const {
+DSpinor MDirac::vHelChiral(const M4Vec &p, int helicity) const {
   if (BASIS != "C") { throw std::invalid_argument("MDirac::vHelChiral: Wrong gamma basis in use"); }
 
   if (helicity != 1 && helicity != -1) {
     throw std::invalid_argument("MDirac::vHelChiral: helicity is not -1 or 1");
   }
   // Flip the helicity, so we can use particle solution permutated
-  helicity                                  = -helicity;
-  const std::vector<std::complex<double>> v = uHelChiral(p, helicity);
+  helicity        = -helicity;
+  const DSpinor v = uHelChiral(p, helicity);
   return {-v[0], -v[1], v[2], v[3]};
 
   throw std::invalid_argument("MDirac::vHelChiral: helicity is not -1 or 1");
@@ -213,7 +204,7 @@ std::vector<std::complex<double>> MDirac::vHelChiral(const M4Vec &p, int helicit
 // Remember: In the limit E >> m (only then)
 // -> left and right handed chiral states == helicity states.
 //
-std::vector<std::complex<double>> MDirac::uHelDirac(const M4Vec &p, int helicity) const {
+DSpinor MDirac::uHelDirac(const M4Vec &p, int helicity) const {
   if (BASIS != "D") { throw std::invalid_argument("MDirac::uHelDirac: Wrong gamma basis in use"); }
 
   const double E  = p.E();
@@ -242,14 +233,14 @@ std::vector<std::complex<double>> MDirac::uHelDirac(const M4Vec &p, int helicity
 //
 // <@@ DEFINED IN DIRAC GAMMA-MATRIX REPRESENTATION @@>
 //
-std::vector<std::complex<double>> MDirac::vHelDirac(const M4Vec &p, int helicity) const {
+DSpinor MDirac::vHelDirac(const M4Vec &p, int helicity) const {
   if (BASIS != "D") { throw std::invalid_argument("MDirac::vHelDirac: Wrong gamma basis in use"); }
   if (helicity != 1 && helicity != -1) {
     throw std::invalid_argument("MDirac::vHelDirac: helicity is not -1 or 1");
   }
   // Flip the helicity, so we can use particle solution permutated
-  helicity                                  = -helicity;
-  const std::vector<std::complex<double>> v = uHelDirac(p, helicity);
+  helicity        = -helicity;
+  const DSpinor v = uHelDirac(p, helicity);
   return {v[2], v[3], v[0], v[1]};
 }
 // -----------------------------------------------------------------------
@@ -260,7 +251,7 @@ std::vector<std::complex<double>> MDirac::vHelDirac(const M4Vec &p, int helicity
 //
 // <@@ DEFINED IN DIRAC GAMMA MATRIX REPRESENTATION @@>
 //
-std::vector<std::complex<double>> MDirac::uDirac(const M4Vec &p, int spin) const {
+DSpinor MDirac::uDirac(const M4Vec &p, int spin) const {
   if (BASIS != "D") { throw std::invalid_argument("MDirac::uDirac: Wrong gamma basis in use"); }
   if (spin != -1 && spin != 1) {
     throw std::invalid_argument("MDirac::uDirac: spin state argument != -1 or 1");
@@ -280,15 +271,15 @@ std::vector<std::complex<double>> MDirac::uDirac(const M4Vec &p, int spin) const
 //
 // <@@ DEFINED IN DIRAC GAMMA MATRIX REPRESENTATION @@>
 //
-std::vector<std::complex<double>> MDirac::vDirac(const M4Vec &p, int spin) const {
+DSpinor MDirac::vDirac(const M4Vec &p, int spin) const {
   if (BASIS != "D") { throw std::invalid_argument("MDirac::vDirac: Wrong gamma basis in use"); }
   if (!(spin == -1 || spin == 1)) {
     throw std::invalid_argument("MDirac::vDirac: spin state argument != -1 or 1");
   }
 
   // Flip the spin, then use the u-particle solution permutated
-  spin                                      = -spin;
-  const std::vector<std::complex<double>> v = uDirac(p, spin);
+  spin            = -spin;
+  const DSpinor v = uDirac(p, spin);
   return {v[2], v[3], v[0], v[1]};
 }
 // -----------------------------------------------------------------------
@@ -322,7 +313,7 @@ MMatrix<std::complex<double>> MDirac::J_operator(unsigned int i) const {
 // C^\dagger = C^{-1}
 // C^T = -C
 //
-MMatrix<std::complex<double>> MDirac::C_up() const {
+DMatrix MDirac::C_up() const {
   if (BASIS == "D" || BASIS == "C") {
     return -gamma_up[2] * gamma_up[0] * zi;
   } else {
@@ -379,7 +370,7 @@ Tensor2<std::complex<double>, 4, 4> MDirac::iD_y(const double q2) const {
 //
 // Input as contravariant (upper) index 4-vector
 //
-MMatrix<std::complex<double>> MDirac::iD_F(const M4Vec &q, double m) const {
+DMatrix MDirac::iD_F(const M4Vec &q, double m) const {
   return (FSlash(q) + I4 * m) * (zi / (q.M2() - pow2(m)));
 }
 
@@ -493,19 +484,23 @@ Tensor2<std::complex<double>, 4, 4> MDirac::EpsMassiveSpin2(const M4Vec &k, int
 }
 
 // Adjoint Dirac spinor: \bar{u} = u^dagger * gamma^0
-std::vector<std::complex<double>> MDirac::Bar(
-    const std::vector<std::complex<double>> &spinor) const {
+DSpinor MDirac::Bar(const DSpinor &spinor) const {
   // First conjugate elements, then a matrix product with gamma^0 matrix
-  return gra::matoper::VecMatMultiply(gra::matoper::VecDagger(spinor), gamma_up[0]);
+  const DSpinor dagger = {std::conj(spinor[0]), std::conj(spinor[1]), std::conj(spinor[2]),
+                          std::conj(spinor[3])};
+  return dirac::VecMat(dagger, gamma_up[0]);
 }
 
 // Feynman slash matrix operator: \slash{a} = \gamma_\mu a^\mu = \gamma^\mu
 // a_\mu
 //
 // Input assumed contravariant (upper) index 4-vector
-MMatrix<std::complex<double>> MDirac::FSlash(const M4Vec &a) const {
-  MMatrix<std::complex<double>> aslash(4, 4, 0.0);  // Init with zero!
-  for (const auto &mu : LI) { aslash += gamma_up[mu] * (a % mu); }
+DMatrix MDirac::FSlash(const M4Vec &a) const {
+  DMatrix aslash;  // Init with zero
+  for (std::size_t mu = 0; mu < 4; ++mu) {
+    const double a_mu = a % mu;
+    for (std::size_t k = 0; k < 16; ++k) { aslash.d[k] += gamma_up[mu].d[k] * a_mu; }
+  }
   return aslash;
 }
 
@@ -529,11 +524,11 @@ double MDirac::TestSpinorHELimit(const M4Vec &pi, const M4Vec &pf) const {
 
   // Helicities
   for (const auto &hi : {1, 2}) {
-    const std::vector<std::complex<double>> u = uDirac(pi, hi);
+    const DSpinor u = uDirac(pi, hi);
 
     // Helicities
     for (const auto &hf : {1, 2}) {
-      const std::vector<std::complex<double>> ubar = Bar(uDirac(pf, hf));
+      const DSpinor ubar = Bar(uDirac(pf, hf));
 
       if (hi != hf) {
         std::cout << std::endl;
@@ -542,9 +537,9 @@ double MDirac::TestSpinorHELimit(const M4Vec &pi, const M4Vec &pf) const {
 
       for (const auto &mu : LI) {
         for (const auto &nu : LI) {
-          const std::vector<std::complex<double>> prod = (gamma_up[mu] * (psum % nu)) * u;
+          const DSpinor prod = (gamma_up[mu] * (psum % nu)) * u;
 
-          const std::complex<double> lhs = gra::matoper::VecVecMultiply(ubar, prod);
+          const std::complex<double> lhs = dirac::Dot(ubar, prod);
           const double               rhs = (psum % mu) * (psum % nu) * Delta(hi, hf);
 
           const double absratio = std::abs(std::real(lhs)) / std::abs(rhs);
@@ -576,12 +571,12 @@ double MDirac::TestSpinorHELimit(const M4Vec &pi, const M4Vec &pf) const {
 
 // Spinor product: s_\lambda(p1,p2)
 std::complex<double> MDirac::sProd(const M4Vec &p1, const M4Vec &p2, int helicity) const {
-  return gra::matoper::VecVecMultiply(Bar(uGauge(p1, helicity)), uGauge(p2, -helicity));
+  return dirac::Dot(Bar(uGauge(p1, helicity)), uGauge(p2, -helicity));
 }
 
 // Helicity u-spinor via massless gauge vector
 //
-std::vector<std::complex<double>> MDirac::uGauge(const M4Vec &p, int helicity) const {
+DSpinor MDirac::uGauge(const M4Vec &p, int helicity) const {
   const M4Vec l(100, 0, 0, 100);  // arbitrary "gauge vector"
   if (BASIS == "D") {             // Dirac
     return ((FSlash(p) + I4 * p.M()) / msqrt(2.0 * (p * l))) * uHelDirac(l, -helicity);
@@ -593,7 +588,7 @@ std::vector<std::complex<double>> MDirac::uGauge(const M4Vec &p, int helicity) c
 
 // Helicity u-spinor via massless gauge vector
 //
-std::vector<std::complex<double>> MDirac::vGauge(const M4Vec &p, int helicity) const {
+DSpinor MDirac::vGauge(const M4Vec &p, int helicity) const {
   const M4Vec l(100, 0, 0, 100);  // arbitrary "gauge vector"
   if (BASIS == "D") {             // Dirac
     return (-(FSlash(p) - I4 * p.M()) / msqrt(2.0 * (p * l))) * vHelDirac(l, -helicity);
@@ -604,9 +599,8 @@ std::vector<std::complex<double>> MDirac::vGauge(const M4Vec &p, int helicity) c
 }
 
 // Construct spin-1/2 helicity spinors (-1,1) [indexing with 0,1]
-std::array<std::vector<std::complex<double>>, 2> MDirac::SpinorStates(
-    const M4Vec &p, const std::string &type) const {
-  std::array<std::vector<std::complex<double>>, 2> spinor;
+std::array<DSpinor, 2> MDirac::SpinorStates(const M4Vec &p, const std::string &type) const {
+  std::array<DSpinor, 2> spinor;
 
   if (BASIS == "D") {  // Dirac
     for (const auto &m : {0, 1}) {
@@ -689,12 +683,12 @@ double MDirac::TestGammaAntiCommutation() const {
 
   for (const auto &mu : LI) {
     for (const auto &nu : LI) {
-      const MMatrix<std::complex<double>> AC_lo =
+      const DMatrix AC_lo =
           gamma_lo[mu] * gamma_lo[nu] + gamma_lo[nu] * gamma_lo[mu];
       std::cout << "gamma_lo:: mu:" << mu << " nu: " << nu << std::endl;
       AC_lo.Print();
 
-      const MMatrix<std::complex<double>> AC_up =
+      const DMatrix AC_up =
           gamma_up[mu] * gamma_up[nu] + gamma_up[nu] * gamma_up[mu];
       std::cout << "gamma_up:: mu:" << mu << " nu: " << nu << std::endl;
       AC_up.Print();
@@ -708,8 +702,8 @@ double MDirac::TestGammaAntiCommutation() const {
 // Test \slash{p}\slash{p} = p^2 I_4 (identity matrix being I4)
 //
 double MDirac::TestFSlashFSlash(const M4Vec &p) const {
-  const MMatrix<std::complex<double>> A = FSlash(p) * FSlash(p);
-  const MMatrix<std::complex<double>> B = I4 * p.M2();
+  const DMatrix A = FSlash(p) * FSlash(p);
+  const DMatrix B = I4 * p.M2();
 
   const double norm = (A - B).FrobNorm();
   std::cout << "MDirac::TestFSlashFSlash:: Frobenius norm |A-B|_F: " << norm << std::endl;
@@ -754,11 +748,11 @@ double MDirac::TestSpinorComplete(const M4Vec &p, const std::string &type,
                                   const std::string &mode) const {
   std::cout << "MDirac::TestSpinorComplete: Type: " << type << std::endl;
   // InitGammaMatrices(basis);
-  MMatrix<std::complex<double>> lhs(4, 4, 0.0);  // Init with zero!
-  const double                  SIGN = ((type == "u") ? 1.0 : -1.0);
+  DMatrix      lhs;  // Init with zero
+  const double SIGN = ((type == "u") ? 1.0 : -1.0);
 
   for (const auto &lambda : SPINORSTATE) {
-    std::vector<std::complex<double>> spinor;
+    DSpinor spinor;
 
     if (type == "u") {
       if (BASIS == "D") {
@@ -783,11 +777,11 @@ double MDirac::TestSpinorComplete(const M4Vec &p, const std::string &type,
       throw std::invalid_argument("MDirac::TestDiracSpinorComplete: Unknown type (set u or v)");
     }
     // Adjoint
-    const std::vector<std::complex<double>> spinorbar = Bar(spinor);
+    const DSpinor spinorbar = Bar(spinor);
 
     // Check normalization
     const double nlhs =
-        std::real(gra::matoper::VecVecMultiply(spinorbar, spinor));  // Take real to cast to double
+        std::real(dirac::Dot(spinorbar, spinor));  // Take real to cast to double
     const double nrhs = SIGN * 2. * p.M();
 
     printf("s = %2d : Normalization = ", lambda);
@@ -800,12 +794,12 @@ double MDirac::TestSpinorComplete(const M4Vec &p, const std::string &type,
     }
 
     // Take outerproduct, sum
-    lhs += gra::matoper::OuterProd(spinor, spinorbar);
+    lhs += dirac::Outer(spinor, spinorbar);
   }
   std::cout << std::endl;
 
   // Completeness relation
-  const MMatrix<std::complex<double>> rhs = FSlash(p) + I4 * p.M() * SIGN;
+  const DMatrix rhs = FSlash(p) + I4 * p.M() * SIGN;
 
   // Compare
   lhs.Print("sum_{s}{spinor_s(p) barspinor_s(p)}");
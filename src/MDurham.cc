@@ -76,9 +76,9 @@ MDurham::MDurham(gra::LORENTZSCALAR &lts, const std::string &modelfile) {
 // [REFERENCE: Harland-Lang, Khoze, Ryskin, Stirling, arxiv.org/abs/1005.0695]
 // [REFERENCE: Harland-Lang, Khoze, Ryskin, arxiv.org/abs/1409.4785]
 //
-double MDurham::DurhamQCD(gra::LORENTZSCALAR &lts, const std::string &process) {
+double MDurham::DurhamQCD(gra::LORENTZSCALAR &lts, DPROC process) {
   // gluon pair continuum
-  if (process == "gg") {
+  if (process == DPROC::GG) {
     // [Final state helicities/polarizations x 4 initial state helicities]
     std::vector<std::vector<std::complex<double>>> Amp(4,
                                                        std::vector<std::complex<double>>(4, 0.0));
@@ -94,7 +94,7 @@ double MDurham::DurhamQCD(gra::LORENTZSCALAR &lts, const std::string &process) {
     return DQtloop(lts, Amp);
 
     // qqbar continuum
-  } else if (process == "qqbar") {
+  } else if (process == DPROC::QQBAR) {
     // [Final state helicities/polarizations x 4 initial state helicities]
     std::vector<std::vector<std::complex<double>>> Amp(4,
                                                        std::vector<std::complex<double>>(4, 0.0));
@@ -112,7 +112,7 @@ double MDurham::DurhamQCD(gra::LORENTZSCALAR &lts, const std::string &process) {
     return DQtloop(lts, Amp);
 
     // Meson pair continuum
-  } else if (process == "MMbar") {
+  } else if (process == DPROC::MMBAR) {
     // [Final state helicities/polarizations x 4 initial state helicities]
     std::vector<std::vector<std::complex<double>>> Amp(1,
                                                        std::vector<std::complex<double>>(4, 0.0));
@@ -124,7 +124,7 @@ double MDurham::DurhamQCD(gra::LORENTZSCALAR &lts, const std::string &process) {
     return DQtloop(lts, Amp);
 
     // chic(0) resonance
-  } else if (process == "chic(0)") {
+  } else if (process == DPROC::CHIC0) {
     // [Final state helicities/polarizations x 4 initial state helicities]
     std::vector<std::vector<std::complex<double>>> Amp(1,
                                                        std::vector<std::complex<double>>(4, 0.0));
@@ -137,7 +137,7 @@ double MDurham::DurhamQCD(gra::LORENTZSCALAR &lts, const std::string &process) {
     return DQtloop(lts, Amp);
 
     // Flux with |A| = 1
-  } else if (process == "FLUX") {
+  } else if (process == DPROC::FLUX) {
     // [Final state helicities/polarizations x 4 initial state helicities]
     std::vector<std::vector<std::complex<double>>> Amp(1,
                                                        std::vector<std::complex<double>>(4, 0.0));
@@ -164,11 +164,20 @@ double MDurham::DurhamQCD(gra::LORENTZSCALAR &lts, const std::string &process) {
     //
     // ------------------------------------------------------------
   } else {
-    std::string str = "MDurham::Durham: Unknown subprocess: " + process;
-    throw std::invalid_argument(str);
+    throw std::invalid_argument("MDurham::DurhamQCD: Unknown subprocess");
   }
 }
 
+// Subprocess identifier from a string, resolved once before the event loop
+MDurham::DPROC MDurham::GetProcess(const std::string &process) {
+  if (process == "gg") { return DPROC::GG; }
+  if (process == "qqbar") { return DPROC::QQBAR; }
+  if (process == "MMbar") { return DPROC::MMBAR; }
+  if (process == "chic(0)") { return DPROC::CHIC0; }
+  if (process == "FLUX") { return DPROC::FLUX; }
+  throw std::invalid_argument("MDurham::GetProcess: Unknown subprocess: " + process);
+}
+
 // Helicity basis decomposition
 //
 // In the forward limit q1_t = - q2_t = Q_t
@@ -176,6 +185,11 @@ double MDurham::DurhamQCD(gra::LORENTZSCALAR &lts, const std::string &process) {
 //
 inline void MDurham::DHelicity(const std::vector<double> &q1, const std::vector<double> &q2,
                                std::vector<std::complex<double>> &JzP) const {
+  DHelicity(q1.data(), q2.data(), JzP);
+}
+
+inline void MDurham::DHelicity(const double *q1, const double *q2,
+                               std::vector<std::complex<double>> &JzP) const {
   const unsigned int X = 0;  // component for readability
   const unsigned int Y = 1;
 
@@ -286,34 +300,55 @@ inline void MDurham::DScaleChoise(double qt2, double q1_2, double q2_2, double &
 //               x f_g(x_1,x_1',Q_1^2,\mu_2;t_1) x
 //               f_g(x_2,x_2',Q_2^2,\mu_2;t_2)
 //
-double MDurham::DQtloop(gra::LORENTZSCALAR &                           lts,
-                        std::vector<std::vector<std::complex<double>>> Amp) {
+// Loop vectors and 2D-Simpson weights, these depend only on the parameters
+void MDurham::DInitLoopTable() {
+  WSimpson = math::Simpson38Weight2D(Param.N_qt, Param.N_phi);
+
+  loop_qtx.resize((Param.N_qt + 1) * (Param.N_phi + 1));
+  loop_qty.resize((Param.N_qt + 1) * (Param.N_phi + 1));
+
+  for (std::size_t i = 0; i < Param.N_qt + 1; ++i) {
+    const double qt = Param.qt_MIN + i * Param.qt_STEP;
+
+    for (std::size_t j = 0; j < Param.N_phi + 1; ++j) {
+      const double qphi = j * Param.phi_STEP;
+      const std::size_t k = i * (Param.N_phi + 1) + j;
+
+      loop_qtx[k] = qt * std::cos(qphi);
+      loop_qty[k] = qt * std::sin(qphi);
+    }
+  }
+}
+
+double MDurham::DQtloop(gra::LORENTZSCALAR &                                 lts,
+                        const std::vector<std::vector<std::complex<double>>> &Amp) {
   // Forward (proton) system pt-vectors
-  const std::vector<double> pt1 = {lts.pfinal[1].Px(), lts.pfinal[1].Py()};
-  const std::vector<double> pt2 = {lts.pfinal[2].Px(), lts.pfinal[2].Py()};
+  const double pt1[2] = {lts.pfinal[1].Px(), lts.pfinal[1].Py()};
+  const double pt2[2] = {lts.pfinal[2].Px(), lts.pfinal[2].Py()};
 
   // *************************************************************************
   // ** Process scale (GeV) / Sudakov suppression kt^2 integral upper bound **
   const double MU = msqrt(lts.s_hat / Param.alphas_scale);
   // *************************************************************************
 
-  // Init 2D-Simpson weight matrix (will be calculated only once, being
-  // static), C++11 handles multithreaded static initialization
-  const static MMatrix<double> WSimpson = math::Simpson38Weight2D(Param.N_qt, Param.N_phi);
-
-  // NOTE N + 1, init with zero!
-
-  // Amp.size == 4 for example for the gg -> gg process [initial states summed coherently]
-  std::vector<MMatrix<std::complex<double>>> f(
-      Amp.size(), MMatrix<std::complex<double>>(Param.N_qt + 1, Param.N_phi + 1, 0.0));
-
-  // Spin-Parity
-  std::vector<std::complex<double>> JzP(4, 0.0);
+  // Loop vectors and 2D-Simpson weight matrix (calculated only once)
+  if (loop_qtx.empty()) { DInitLoopTable(); }
 
   // 2D-loop integral
   //
   // \int d^2 \vec{qt} [...] = \int dphi \int dqt qt [...]
   //
+  // 1. Collect the loop nodes above the scale cutoff and their pdf scales,
+  // 2. evaluate the pdfs in one batch per proton (x1, x2 and MU are fixed over the loop),
+  // 3. sum the Simpson weighted integrand.
+
+  const std::size_t NPHI = Param.N_phi + 1;
+
+  loop_node.clear();
+  loop_q.clear();
+  loop_qq.clear();
+  loop_Q1.clear();
+  loop_Q2.clear();
 
   // Linearly discretized qt-loop, N+1!
   for (std::size_t i = 0; i < Param.N_qt + 1; ++i) {
@@ -321,23 +356,15 @@ double MDurham::DQtloop(gra::LORENTZSCALAR &                           lts,
     const double qt2 = pow2(qt);
 
     // Linearly discretized phi in [0,2pi), N+1!
-    for (std::size_t j = 0; j < Param.N_phi + 1; ++j) {
-      const double qphi = j * Param.phi_STEP;
-
-      // --------------------------------------------------------------------------
-      // Loop vector
-      const std::vector<double> qt_ = {qt * std::cos(qphi), qt * std::sin(qphi)};
+    for (std::size_t j = 0; j < NPHI; ++j) {
+      const std::size_t k = i * NPHI + j;
 
       // Fusing gluon pt-vectors
-      const std::vector<double> q1 = {qt_[0] - pt1[0], qt_[1] - pt1[1]};
-      const std::vector<double> q2 = {qt_[0] + pt2[0], qt_[1] + pt2[1]};
-
-      const double q1_2 = math::vpow2(q1);
-      const double q2_2 = math::vpow2(q2);
+      const double q1[2] = {loop_qtx[k] - pt1[0], loop_qty[k] - pt1[1]};
+      const double q2[2] = {loop_qtx[k] + pt2[0], loop_qty[k] + pt2[1]};
 
-      // Get fusing gluon spin-parity (J_z^P) components
-      // [q1,q2] -> [0^+,0^-,+2^+,-2^-]
-      DHelicity(q1, q2, JzP);
+      const double q1_2 = pow2(q1[0]) + pow2(q1[1]);
+      const double q2_2 = pow2(q2[0]) + pow2(q2[1]);
 
       // ** Durham scale choise **
       double Q1_2_scale = 0.0;
@@ -347,40 +374,57 @@ double MDurham::DQtloop(gra::LORENTZSCALAR &                           lts,
       // Minimum scale cutoff
       if (Q1_2_scale < Param.qt2_MIN || Q2_2_scale < Param.qt2_MIN) { continue; }
 
-      // --------------------------------------------------------------------------
-      // Get amplitude level pdfs
-      const double fg_1 = lts.GlobalSudakovPtr->fg_xQ2M(lts.x1, Q1_2_scale, MU);
-      const double fg_2 = lts.GlobalSudakovPtr->fg_xQ2M(lts.x2, Q2_2_scale, MU);
-
-      // Amplitude weight:
-      // * \pi^2 : see original KMR papers: [\alpha_s CF -> pi x f_g] for fg_1 and fg_2
-      // *    2  : factor from initial state boson-statistics, check it:!
-      // *    qt : jacobian of d^2qt -> dphi dqt qt
-      std::complex<double> weight = fg_1 * fg_2 / (qt2 * q1_2 * q2_2);
-      weight *= math::PIPI * 2.0 * qt;
+      loop_node.push_back(k);
+      loop_q.insert(loop_q.end(), {q1[0], q1[1], q2[0], q2[1]});
+      loop_qq.push_back(qt2 * q1_2 * q2_2);
+      loop_Q1.push_back(Q1_2_scale);
+      loop_Q2.push_back(Q2_2_scale);
+    }
+  }
 
-      // Loop over (outgoing) helicity combinations.
-      // Amp[h] contains initial state gluon helicity combinations --,-+,+-,++
-      // Here we sum coherently
-      for (std::size_t h = 0; h < f.size(); ++h) { f[h][i][j] = weight * DHelProj(Amp[h], JzP); }
+  // Get amplitude level pdfs
+  const std::size_t N = loop_node.size();
+  loop_fg1.resize(N);
+  loop_fg2.resize(N);
+  lts.GlobalSudakovPtr->fg_xQ2M_Batch(lts.x1, loop_Q1.data(), MU, loop_fg1.data(), N);
+  lts.GlobalSudakovPtr->fg_xQ2M_Batch(lts.x2, loop_Q2.data(), MU, loop_fg2.data(), N);
 
-    }  // phi-loop
-  }    // |q_t|-loop
+  // *****Make sure it is of right size!*****
+  lts.hamp.assign(Amp.size(), 0.0);
+
+  for (std::size_t m = 0; m < N; ++m) {
+    const std::size_t i  = loop_node[m] / NPHI;
+    const std::size_t j  = loop_node[m] % NPHI;
+    const double      qt = Param.qt_MIN + i * Param.qt_STEP;
+
+    // Get fusing gluon spin-parity (J_z^P) components
+    // [q1,q2] -> [0^+,0^-,+2^+,-2^-]
+    DHelicity(&loop_q[4 * m], &loop_q[4 * m + 2], loop_JzP);
+
+    // Amplitude weight:
+    // * \pi^2 : see original KMR papers: [\alpha_s CF -> pi x f_g] for fg_1 and fg_2
+    // *    2  : factor from initial state boson-statistics, check it:!
+    // *    qt : jacobian of d^2qt -> dphi dqt qt
+    std::complex<double> weight = loop_fg1[m] * loop_fg2[m] / loop_qq[m];
+    weight *= math::PIPI * 2.0 * qt;
+
+    // Loop over (outgoing) helicity combinations.
+    // Amp[h] contains initial state gluon helicity combinations --,-+,+-,++
+    // Here we sum coherently
+    for (std::size_t h = 0; h < Amp.size(); ++h) {
+      lts.hamp[h] += WSimpson[i][j] * (weight * DHelProj(Amp[h], loop_JzP));
+    }
+  }
 
   // Evaluate the total numerical integral for each helicity amplitude
-  std::vector<std::complex<double>> sum(f.size(), 0.0);
-  for (std::size_t h = 0; h < f.size(); ++h) {
-    sum[h] = math::Simpson38Integral2D(f[h], WSimpson, Param.qt_STEP, Param.phi_STEP);
+  // (step factors as in math::Simpson38Integral2D)
+  for (std::size_t h = 0; h < Amp.size(); ++h) {
+    lts.hamp[h] *= 9 * (Param.qt_STEP * Param.phi_STEP) / 64;
   }
 
-  // *****Make sure it is of right size!*****
-  lts.hamp.resize(f.size());
-
   // Outgoing helicity combinations
   double A2 = 0.0;
-  for (std::size_t h = 0; h < f.size(); ++h) {
-    lts.hamp[h] = sum[h];
-
+  for (std::size_t h = 0; h < Amp.size(); ++h) {
     // Apply proton form factors
     lts.hamp[h] *=
         lts.excite1 ? gra::form::S3FINEL(lts.t1, lts.pfinal[1].M2()) : gra::form::S3F(lts.t1);
@@ -401,7 +445,7 @@ double MDurham::DQtloop(gra::LORENTZSCALAR &                           lts,
   // Amplitude cutoff (hard perturbative limit)
   if (gra::math::msqrt(lts.m2) < 2.0) {
     A2       = 0.0;
-    lts.hamp = std::vector<std::complex<double>>(f.size(), 0.0);
+    lts.hamp = std::vector<std::complex<double>>(Amp.size(), 0.0);
   }
   // --------------------------------------------------------------------
 
@@ -7,15 +7,16 @@
 // C++
 #include <cmath>
 #include <fstream>
-#include <future>
 #include <iomanip>
 #include <iostream>
 #include <vector>
 
 // Own
 #include "Graniitti/MAux.h"
+#include "Graniitti/MBessel.h"
 #include "Graniitti/MEikonal.h"
 #include "Graniitti/MForm.h"
+#include "Graniitti/MGridBuilder.h"
 #include "Graniitti/MMath.h"
 #include "Graniitti/MPDG.h"
 #include "Graniitti/MTimer.h"
@@ -85,8 +86,10 @@ void MEikonal::S3Constructor(double s_in, const std::vector<gra::MParticle> &ini
       // Pointer to member function: ReturnType
       // (ClassType::*)(ParameterTypes...)
       std::complex<double> (MEikonal::*f)(double) const = &MEikonal::S3Density;
+      DensityKernel = S3DensityKernel();  // bt independent part
       S3CalculateArray(MBT, f);
-      MBT.WriteArray(filename, true);
+      DensityKernel = math::FBKernel();
+      MBT.WriteArray(filename, true, Numerics.CSV);
       ok = MBT.ReadArray(filename);
     }
   }
@@ -122,8 +125,10 @@ void MEikonal::S3Constructor(double s_in, const std::vector<gra::MParticle> &ini
       // Pointer to member function: ReturnType
       // (ClassType::*)(ParameterTypes...)
       std::complex<double> (MEikonal::*f)(double) const = &MEikonal::S3Screening;
+      ScreeningKernel = S3ScreeningKernel();  // kt independent part
       S3CalculateArray(MSA, f);
-      MSA.WriteArray(filename, true);
+      ScreeningKernel = math::FBKernel();
+      MSA.WriteArray(filename, true, Numerics.CSV);
       ok = MSA.ReadArray(filename);
     }
   }
@@ -175,12 +180,19 @@ std::complex<double> MEikonal::SingleAmpElastic(double s, double t, int type) {
 // [REFERENCE: Ewerz, Maniatis, Nachtmann, arxiv.org/abs/1309.3478]
 //
 std::complex<double> MEikonal::S3Density(double bt) const {
+  // Precomputed during array construction or calculated here
+  if (!DensityKernel.Empty()) { return DensityKernel.Integral(bt); }
+  return S3DensityKernel().Integral(bt);
+}
+
+// Integrand of S3Density (independent of bt) with integration weights
+math::FBKernel MEikonal::S3DensityKernel() const {
   // Discretization of kt
   const double kt_STEP =
       (Numerics.FBIntegralMaxKT - Numerics.FBIntegralMinKT) / Numerics.FBIntegralN;
 
-  // N + 1!
-  std::vector<std::complex<double>> f(Numerics.FBIntegralN + 1, 0.0);
+  // Simpson weights, N + 1!
+  const std::vector<double> w = gra::math::CSWeights(Numerics.FBIntegralN, kt_STEP);
 
   // Initial state configuration [NOT IMPLEMENTED = SAME FOR pp and ppbar]
   // pp
@@ -192,8 +204,16 @@ std::complex<double> MEikonal::S3Density(double bt) const {
     // TBD
   }
 
+  // [2pi from Bessel phi-integral] / [ (2pi)^2] (2D-Fourier factor) * s ]
+  const double FACTOR = 1 / (2.0 * gra::math::PI * s);
+
+  math::FBKernel K;
+  K.x.resize(w.size());
+  K.re.resize(w.size());
+  K.im.resize(w.size());
+
   // Loop over
-  for (const auto &i : indices(f)) {
+  for (const auto &i : indices(w)) {
     const double kt = Numerics.FBIntegralMinKT + i * kt_STEP;
 
     // Negative, with Mandelstam t ~= -kt^2
@@ -205,14 +225,13 @@ std::complex<double> MEikonal::S3Density(double bt) const {
     // Odderon exchange (negative signature)
     if (PARAM_SOFT::ODDERON_ON == true) { A += SingleAmpElastic(s, t, -1); }
 
-    // Value
-    f[i] = A * BESSJ0(bt * kt) * kt;
-    // f[i] = A * std::cyl_bessel_j(0, bt * kt) * kt; // c++17, slow
+    // Value without BESSJ0(bt * kt)
+    const std::complex<double> v = A * kt * w[i] * FACTOR;
+    K.x[i]                       = kt;
+    K.re[i]                      = std::real(v);
+    K.im[i]                      = std::imag(v);
   }
-  // [2pi from Bessel phi-integral] / [ (2pi)^2] (2D-Fourier factor) * s ]
-  const double FACTOR = 1 / (2.0 * gra::math::PI * s);
-
-  return gra::math::CSIntegral(f, kt_STEP) * FACTOR;
+  return K;
 }
 
 // Calculate eikonalized elastic screening amplitude: A_eik(s,t=-kt^2)
@@ -220,28 +239,44 @@ std::complex<double> MEikonal::S3Density(double bt) const {
 //
 //
 std::complex<double> MEikonal::S3Screening(double kt2) const {
+  const double kt = gra::math::msqrt(kt2);
+
+  // Precomputed during array construction or calculated here
+  if (!ScreeningKernel.Empty()) { return ScreeningKernel.Integral(kt); }
+  return S3ScreeningKernel().Integral(kt);
+}
+
+// Integrand of S3Screening (independent of kt) with integration weights
+math::FBKernel MEikonal::S3ScreeningKernel() const {
   // Local discretization
   const double STEP = (Numerics.MaxBT - Numerics.MinBT) / Numerics.FBIntegralN;
 
-  const double                      kt = gra::math::msqrt(kt2);
-  std::vector<std::complex<double>> f(Numerics.FBIntegralN + 1, 0.0);
+  // Simpson weights, N + 1!
+  const std::vector<double> w = gra::math::CSWeights(Numerics.FBIntegralN, STEP);
+
+  // Bessel phi-integral factor
+  const double FACTOR = 2.0 * gra::math::PI;
+
+  math::FBKernel K;
+  K.x.resize(w.size());
+  K.re.resize(w.size());
+  K.im.resize(w.size());
 
   // Numerical integral loop over impact parameter (b_t) space
-  for (const auto &i : indices(f)) {
+  for (const auto &i : indices(w)) {
     const double               bt    = Numerics.MinBT + i * STEP;
     const std::complex<double> Omega = MBT.Interpolate1D(bt);
 
     // I. STANDARD EIKONAL APPROXIMATION
     const std::complex<double> A = gra::math::zi * (1.0 - std::exp(gra::math::zi * Omega / 2.0));
 
-    f[i] = A * BESSJ0(bt * kt) * bt;
-    // f[i] = A * std::cyl_bessel_j(0, bt * kt) * bt; // c++17, slow
+    // Value without BESSJ0(bt * kt)
+    const std::complex<double> v = (2.0 * s) * FACTOR * A * bt * w[i];
+    K.x[i]                       = bt;
+    K.re[i]                      = std::real(v);
+    K.im[i]                      = std::imag(v);
   }
-  // Bessel phi-integral factor
-  const double FACTOR = 2.0 * gra::math::PI;
-
-  // Numerical integration
-  return (2.0 * s) * FACTOR * gra::math::CSIntegral(f, STEP);
+  return K;
 }
 
 // Calculate screened total, elastic and inelastic cross sections
@@ -377,31 +412,90 @@ void MEikonal::S3CalcXS() {
 
 // Calculate interpolation arrays
 void MEikonal::S3CalculateArray(IArray1D &arr, std::complex<double> (MEikonal::*f)(double) const) {
-  std::cout << "MEikonal::S3CalculateArray:" << std::endl;
-  std::vector<std::future<std::complex<double>>> futures;  // std::async return values
-  MTimer                                         timer(true);
+  MGridBuilder builder;
+  std::cout << "MEikonal::S3CalculateArray: <threads = " << builder.GetThreads() << ">"
+            << std::endl;
+  MTimer timer(true);
 
   // Loop over discretized variable
-  for (std::size_t i = 0; i < arr.F.size_row(); ++i) {
+  builder.Run(arr.F.size_row(), [&](std::size_t i) {
     const double a = arr.MIN + i * arr.STEP;
-    arr.F[i][X]    = a;
 
     // Transform input to linear if log stepping, for the function
     const double var = (arr.islog) ? std::exp(a) : a;
 
-    gra::aux::PrintProgress(i / static_cast<double>(arr.N + 1));
-    futures.push_back(std::async(std::launch::async, f, this, var));
-  }
-  gra::aux::ClearProgress();
+    arr.F[i][X] = a;
+    arr.F[i][Y] = (this->*f)(var);
+  });
   std::cout << std::endl;
   printf("- Time elapsed: %0.1f sec \n\n", timer.ElapsedSec());
+}
+
+// Binary cache header
+MArrayHeader IArray1D::GetHeader() const {
+  MArrayHeader h;
+  h.ndim     = 1;
+  h.hash     = gra::aux::djb2hash(GetHashString());
+  h.N[0]     = N;
+  h.islog[0] = islog;
+  h.MIN[0]   = MIN;
+  h.MAX[0]   = MAX;
+  h.sqrts    = sqrts;
+  h.ncol     = 3;
+  return h;
+}
+
+// Write the array to a binary file (and optionally to a CSV text file)
+bool IArray1D::WriteArray(const std::string &filename, bool overwrite, bool csv) const {
+  if (csv) { WriteArrayCSV(filename + ".csv", overwrite); }
+
+  // Do not write if file exists already
+  const std::string binfile = filename + ".bin";
+  if (gra::aux::FileExist(binfile) && !overwrite) { return true; }
+
+  MTimer timer(true);
+  std::cout << "IArray1D::WriteArray: ";
+
+  std::vector<double> values(3 * F.size_row(), 0.0);
+  for (std::size_t i = 0; i < F.size_row(); ++i) {
+    values[3 * i + 0] = std::real(F[i][X]);
+    values[3 * i + 1] = std::real(F[i][Y]);
+    values[3 * i + 2] = std::imag(F[i][Y]);
+  }
+  MArrayCache::Write(binfile, GetHeader(), values);
 
-  // Retrieve std::async values
-  for (const auto &i : indices(futures)) { arr.F[i][Y] = futures[i].get(); }
+  printf("Time elapsed %0.1f sec \n", timer.ElapsedSec());
+  return true;
 }
 
-// Write the array to a file
-bool IArray1D::WriteArray(const std::string &filename, bool overwrite) const {
+// Map the array from a binary file, or import it from a CSV text file
+bool IArray1D::ReadArray(const std::string &filename) {
+  const std::string binfile = filename + ".bin";
+  cache                     = MArrayCache::Map(binfile, GetHeader());
+
+  if (cache == nullptr) {
+    // Import CSV (exported or old format without extension) and convert
+    for (const auto &csvfile : {filename + ".csv", filename}) {
+      if (gra::aux::FileExist(csvfile) && ReadArrayCSV(csvfile)) {
+        WriteArray(filename, true);
+        cache = MArrayCache::Map(binfile, GetHeader());
+        break;
+      }
+    }
+    if (cache == nullptr) { return false; }
+  }
+  D = cache->data();
+
+  // Values are now read from the mapping
+  F.Clear();
+
+  std::cout << "IArray1D::ReadArray: " << rang::fg::green << "[DONE]" << rang::fg::reset
+            << std::endl;
+  return true;
+}
+
+// Write the array to a CSV text file
+bool IArray1D::WriteArrayCSV(const std::string &filename, bool overwrite) const {
   // Do not write if file exists already
   if (gra::aux::FileExist(filename) && !overwrite) {
     // std::cout << "- Found pre-calculated" << std::endl;
@@ -410,12 +504,12 @@ bool IArray1D::WriteArray(const std::string &filename, bool overwrite) const {
   std::ofstream file;
   file.open(filename);
   if (!file.is_open()) {
-    std::string str = "IArray1D::WriteArray: Fatal IO-error with: " + filename;
+    std::string str = "IArray1D::WriteArrayCSV: Fatal IO-error with: " + filename;
     throw std::invalid_argument(str);
   }
 
   MTimer timer(true);
-  std::cout << "IArray1D::WriteArray: ";
+  std::cout << "IArray1D::WriteArrayCSV: ";
   unsigned int line_number = 0;
 
   try {
@@ -426,7 +520,7 @@ bool IArray1D::WriteArray(const std::string &filename, bool overwrite) const {
       ++line_number;
     }
   } catch (...) {
-    throw std::invalid_argument("IArray1D:WriteArray: Error in file " + filename + " at line " +
+    throw std::invalid_argument("IArray1D::WriteArrayCSV: Error in file " + filename + " at line " +
                                 std::to_string(line_number));
   }
 
@@ -435,17 +529,17 @@ bool IArray1D::WriteArray(const std::string &filename, bool overwrite) const {
   return true;
 }
 
-// Read the array from a file
-bool IArray1D::ReadArray(const std::string &filename) {
+// Read the array from a CSV text file
+bool IArray1D::ReadArrayCSV(const std::string &filename) {
   std::ifstream file;
   file.open(filename);
   if (!file.is_open()) {
-    std::string str = "IArray1D::ReadArray: Fatal IO-error with: " + filename;
+    std::string str = "IArray1D::ReadArrayCSV: Fatal IO-error with: " + filename;
     return false;
   }
   std::string  line;
   unsigned int fills = 0;
-  std::cout << "IArray1D::ReadArray: ";
+  std::cout << "IArray1D::ReadArrayCSV: ";
   unsigned line_number = 0;
 
   try {
@@ -470,7 +564,7 @@ bool IArray1D::ReadArray(const std::string &filename) {
       ++line_number;
     }
   } catch (...) {
-    throw std::invalid_argument("IArray1D:ReadArray: Error in file " + filename + " at line " +
+    throw std::invalid_argument("IArray1D::ReadArrayCSV: Error in file " + filename + " at line " +
                                 std::to_string(line_number));
   }
   file.close();
@@ -507,8 +601,13 @@ std::complex<double> IArray1D::Interpolate1D(double a) const {
   if (i < 0) { i = 0; }            // Int needed for this, instead of unsigned int
   if (i >= (int)N) { i = N - 1; }  // We got N+1 elements in F
 
+  // [x, Re y, Im y] at i and i+1
+  const double *             p  = D + 3 * i;
+  const std::complex<double> y0(p[1], p[2]);
+  const std::complex<double> y1(p[4], p[5]);
+
   // y = y0 + (x - x0)*[(y1 - y0)/(x1 - x0)]
-  return F[i][Y] + (a - F[i][X]) * ((F[i + 1][Y] - F[i][Y]) / (F[i + 1][X] - F[i][X]));
+  return y0 + (a - p[0]) * ((y1 - y0) / (p[3] - p[0]));
 }
 
 // Calculate the number of cut soft Pomerons for the inelastic
@@ -0,0 +1,151 @@
+// Flat event record
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <memory>
+#include <vector>
+
+// HepMC3
+#include "HepMC3/GenCrossSection.h"
+#include "HepMC3/GenEvent.h"
+#include "HepMC3/GenParticle.h"
+#include "HepMC3/GenVertex.h"
+
+// Own
+#include "Graniitti/MEventRecord.h"
+
+namespace gra {
+
+// Vertices are added in the record order, so vertex ids are -(index + 1)
+void MEventRecord::ToGenEvent(HepMC3::GenEvent &evt) const {
+  std::vector<HepMC3::GenParticlePtr> gp(particles.size());
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    const Particle &p = particles[i];
+    gp[i] = std::make_shared<HepMC3::GenParticle>(HepMC3::FourVector(p.px, p.py, p.pz, p.e), p.pdg,
+                                                  p.status);
+    gp[i]->set_generated_mass(p.m);
+  }
+
+  std::vector<HepMC3::GenVertexPtr> gv(vertices.size());
+  for (std::size_t j = 0; j < vertices.size(); ++j) {
+    const Vertex &v = vertices[j];
+    gv[j] = std::make_shared<HepMC3::GenVertex>(HepMC3::FourVector(v.x, v.y, v.z, v.t));
+  }
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    if (particles[i].end >= 0) { gv[particles[i].end]->add_particle_in(gp[i]); }
+    if (particles[i].prod >= 0) { gv[particles[i].prod]->add_particle_out(gp[i]); }
+  }
+  for (const auto &v : gv) { evt.add_vertex(v); }
+
+  // Cross section (pb) and weights
+  std::shared_ptr<HepMC3::GenCrossSection> xsobj = std::make_shared<HepMC3::GenCrossSection>();
+  evt.add_attribute("GenCrossSection", xsobj);
+  xsobj->set_cross_section(xs, xs_err);
+
+  evt.weights() = weights;
+  evt.set_event_number(event_number);
+}
+
+// Particles and vertices in the HepMC3 id order (1,2,... and -1,-2,...),
+// the root vertex (id 0) is not a vertex of the record
+void MEventRecord::FromGenEvent(const HepMC3::GenEvent &evt) {
+  Clear();
+  for (const auto &v : evt.vertices()) {
+    const HepMC3::FourVector &pos = v->position();
+    AddVertex(M4Vec(pos.x(), pos.y(), pos.z(), pos.t()));
+  }
+  for (const auto &gp : evt.particles()) {
+    const HepMC3::FourVector &p4 = gp->momentum();
+    Particle                  p;
+    p.px     = p4.px();
+    p.py     = p4.py();
+    p.pz     = p4.pz();
+    p.e      = p4.e();
+    p.m      = gp->generated_mass();
+    p.pdg    = gp->pid();
+    p.status = gp->status();
+    particles.push_back(p);
+
+    const int i = static_cast<int>(particles.size()) - 1;
+    if (gp->production_vertex() && gp->production_vertex()->id() < 0) {
+      AddOut(-gp->production_vertex()->id() - 1, i);
+    }
+    if (gp->end_vertex() && gp->end_vertex()->id() < 0) { AddIn(-gp->end_vertex()->id() - 1, i); }
+  }
+
+  if (auto cs = evt.cross_section()) {
+    xs     = cs->xsec();
+    xs_err = cs->xsec_err();
+  }
+  weights      = evt.weights();
+  event_number = evt.event_number();
+}
+
+// Memoized depth-first search over the production vertices, each vertex is
+// resolved once. Cycles (malformed records) terminate, with partial masks.
+void MEventRecord::AncestorMask(const std::function<unsigned int(const Particle &)> &mask,
+                                std::vector<unsigned int> &ancestors,
+                                std::vector<unsigned int> &parents) const {
+  const std::size_t NP = particles.size();
+  const std::size_t NV = vertices.size();
+
+  // Incoming particles of each vertex (compressed rows)
+  std::vector<std::size_t> first(NV + 1, 0);
+  for (const auto &p : particles) {
+    if (p.end >= 0) { ++first[p.end + 1]; }
+  }
+  for (std::size_t v = 0; v < NV; ++v) { first[v + 1] += first[v]; }
+  std::vector<std::size_t> incoming(first[NV]);
+  std::vector<std::size_t> pos(first.begin(), first.end() - 1);
+  for (std::size_t i = 0; i < NP; ++i) {
+    if (particles[i].end >= 0) { incoming[pos[particles[i].end]++] = i; }
+  }
+
+  std::vector<unsigned int> own(NP);
+  for (std::size_t i = 0; i < NP; ++i) { own[i] = mask(particles[i]); }
+
+  // Vertex state: 0 = new, 1 = open, 2 = resolved
+  std::vector<unsigned int> vanc(NV, 0);  // OR over all ancestors of the outgoing particles
+  std::vector<unsigned int> vpar(NV, 0);  // OR over the incoming particles
+  std::vector<char>         state(NV, 0);
+  std::vector<int>          stack;
+
+  for (std::size_t root = 0; root < NV; ++root) {
+    if (state[root] != 0) { continue; }
+    stack.push_back(root);
+    while (!stack.empty()) {
+      const int v = stack.back();
+      if (state[v] == 0) {
+        state[v] = 1;
+        for (std::size_t k = first[v]; k < first[v + 1]; ++k) {
+          const int u = particles[incoming[k]].prod;
+          if (u >= 0 && state[u] == 0) { stack.push_back(u); }
+        }
+        continue;
+      }
+      stack.pop_back();
+      if (state[v] == 2) { continue; }  // Pushed twice
+      for (std::size_t k = first[v]; k < first[v + 1]; ++k) {
+        const std::size_t i = incoming[k];
+        const int         u = particles[i].prod;
+        vpar[v] |= own[i];
+        vanc[v] |= own[i] | ((u >= 0) ? vanc[u] : 0);
+      }
+      state[v] = 2;
+    }
+  }
+
+  ancestors.assign(NP, 0);
+  parents.assign(NP, 0);
+  for (std::size_t i = 0; i < NP; ++i) {
+    const int v = particles[i].prod;
+    if (v >= 0) {
+      ancestors[i] = vanc[v];
+      parents[i]   = vpar[v];
+    }
+  }
+}
+
+}  // namespace gra
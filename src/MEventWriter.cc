@@ -0,0 +1,419 @@
+// Event writers for the flat event record
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <charconv>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+// HepMC3
+#include "HepMC3/GenEvent.h"
+
+// Own
+#include "Graniitti/MEventWriter.h"
+
+namespace gra {
+
+namespace {
+
+// Vertex id / barcode convention
+inline int VertexID(int v) { return -(v + 1); }
+
+// Last incoming particle of vertex v
+int LastIn(const MEventRecord &evt, int v) {
+  const MEventRecord::Vertex &V = evt.vertices[v];
+  int                         n = 0;
+  int                         k = V.in1;
+  for (std::size_t i = V.in1; i < evt.particles.size(); ++i) {
+    if (evt.particles[i].end == v) {
+      k = i;
+      if (++n == V.nin) { break; }
+    }
+  }
+  return k;
+}
+
+// Stream state after a write (disk full, closed pipe, compression error)
+void CheckStream(const std::ostream &os, const std::string &where) {
+  if (os.fail()) { throw std::invalid_argument(where + ": Error writing the output stream"); }
+}
+
+}  // namespace
+
+// ----------------------------------------------------------------------
+// Text buffer
+
+void MTextBuffer::Flush(std::ostream &os) {
+  os.write(buf.data(), buf.size());
+  buf.clear();
+  CheckStream(os, "MTextBuffer::Flush");
+}
+
+void MTextBuffer::Put(const char *s) { buf.append(s, std::strlen(s)); }
+
+void MTextBuffer::Put(int x) {
+  char s[16];
+  buf.append(s, std::to_chars(s, s + sizeof(s), x).ptr - s);
+}
+void MTextBuffer::Put(long x) {
+  char s[24];
+  buf.append(s, std::to_chars(s, s + sizeof(s), x).ptr - s);
+}
+void MTextBuffer::Put(unsigned long x) {
+  char s[24];
+  buf.append(s, std::to_chars(s, s + sizeof(s), x).ptr - s);
+}
+void MTextBuffer::Put(double x) {
+  char s[32];
+  buf.append(s, std::to_chars(s, s + sizeof(s), x).ptr - s);
+}
+
+// ----------------------------------------------------------------------
+// HepMC3 ASCII
+
+MWriterHepMC3::MWriterHepMC3(std::ostream &os, std::shared_ptr<HepMC3::GenRunInfo> runinfo)
+    : out(os) {
+  tb.Put("HepMC::Version 3.02.02\n");
+  tb.Put("HepMC::Asciiv3-START_EVENT_LISTING\n");
+  if (runinfo != nullptr) {
+    for (const auto &tool : runinfo->tools()) {
+      tb.Put("T ");
+      tb.Put(tool.name);
+      tb.Put("\\|");
+      tb.Put(tool.version);
+      tb.Put("\\|");
+      tb.Put(tool.description);
+      tb.Put('\n');
+    }
+  }
+  tb.Flush(out);
+}
+
+// Particles are written in the record order, each preceded by its
+// production vertex if that is needed (several incoming particles or a
+// non-zero position), otherwise the single mother particle is the parent
+void MWriterHepMC3::Write(const MEventRecord &evt) {
+  tb.Put("E ");
+  tb.Put(evt.event_number);
+  tb.Put(' ');
+  tb.Put(evt.vertices.size());
+  tb.Put(' ');
+  tb.Put(evt.particles.size());
+  tb.Put("\nU GEV MM\n");
+
+  if (!evt.weights.empty()) {
+    tb.Put('W');
+    for (const auto &w : evt.weights) {
+      tb.Put(' ');
+      tb.Put(w);
+    }
+    tb.Put('\n');
+  }
+  tb.Put("A 0 GenCrossSection ");
+  tb.Put(evt.xs);
+  tb.Put(' ');
+  tb.Put(evt.xs_err);
+  tb.Put(" -1 -1\n");
+
+  written.assign(evt.vertices.size(), false);
+
+  for (std::size_t i = 0; i < evt.particles.size(); ++i) {
+    const MEventRecord::Particle &p = evt.particles[i];
+
+    int parent = 0;
+    if (p.prod >= 0) {
+      const MEventRecord::Vertex &v = evt.vertices[p.prod];
+      if (v.nin > 1 || !v.Zero()) {
+        parent = VertexID(p.prod);
+      } else if (v.nin == 1) {
+        parent = v.in1 + 1;
+      }
+      // Vertex line
+      if (parent < 0 && !written[p.prod]) {
+        tb.Put("V ");
+        tb.Put(parent);
+        tb.Put(" 0 [");
+        int n = 0;
+        for (std::size_t k = (v.in1 < 0) ? evt.particles.size() : v.in1;
+             k < evt.particles.size() && n < v.nin; ++k) {
+          if (evt.particles[k].end == p.prod) {
+            if (n > 0) { tb.Put(','); }
+            tb.Put(static_cast<int>(k) + 1);
+            ++n;
+          }
+        }
+        tb.Put(']');
+        if (!v.Zero()) {
+          tb.Put(" @ ");
+          tb.Put(v.x);
+          tb.Put(' ');
+          tb.Put(v.y);
+          tb.Put(' ');
+          tb.Put(v.z);
+          tb.Put(' ');
+          tb.Put(v.t);
+        }
+        tb.Put('\n');
+        written[p.prod] = true;
+      }
+    }
+    tb.Put("P ");
+    tb.Put(static_cast<int>(i) + 1);
+    tb.Put(' ');
+    tb.Put(parent);
+    tb.Put(' ');
+    tb.Put(p.pdg);
+    tb.Put(' ');
+    tb.Put(p.px);
+    tb.Put(' ');
+    tb.Put(p.py);
+    tb.Put(' ');
+    tb.Put(p.pz);
+    tb.Put(' ');
+    tb.Put(p.e);
+    tb.Put(' ');
+    tb.Put(p.m);
+    tb.Put(' ');
+    tb.Put(p.status);
+    tb.Put('\n');
+  }
+  tb.Flush(out);
+}
+
+MWriterHepMC3::~MWriterHepMC3() {
+  try {
+    Close();
+  } catch (...) {
+  }
+}
+
+void MWriterHepMC3::Close() {
+  if (closed) { return; }
+  closed = true;
+  out << "HepMC::Asciiv3-END_EVENT_LISTING\n\n";
+  out.flush();
+  CheckStream(out, "MWriterHepMC3::Close");
+}
+
+// ----------------------------------------------------------------------
+// HepMC2 ASCII
+
+MWriterHepMC2::MWriterHepMC2(std::ostream &os) : out(os) {
+  out << "HepMC::Version 2.06.09\n";
+  out << "HepMC::IO_GenEvent-START_EVENT_LISTING\n";
+}
+
+void MWriterHepMC2::WriteParticle(const MEventRecord::Particle &p) {
+  tb.Put("P ");
+  tb.Put(10001 + barcode++);
+  tb.Put(' ');
+  tb.Put(p.pdg);
+  tb.Put(' ');
+  tb.Put(p.px);
+  tb.Put(' ');
+  tb.Put(p.py);
+  tb.Put(' ');
+  tb.Put(p.pz);
+  tb.Put(' ');
+  tb.Put(p.e);
+  tb.Put(' ');
+  tb.Put(p.m);
+  tb.Put(' ');
+  tb.Put(p.status);
+  tb.Put(" 0 0 ");
+  tb.Put((p.end >= 0) ? VertexID(p.end) : 0);
+  tb.Put(" 0\n");
+}
+
+// Each vertex is followed by its orphan incoming particles (beams) and all
+// its outgoing particles, particle barcodes are 10001, 10002, ... in that order
+void MWriterHepMC2::Write(const MEventRecord &evt) {
+  // Beam barcodes
+  int beams[2] = {0, 0};
+  int nbeam    = 0;
+  int k        = 0;
+  for (std::size_t v = 0; v < evt.vertices.size(); ++v) {
+    for (const auto &p : evt.particles) {
+      if (p.end == (int)v && p.prod < 0) {
+        if (p.status == 4 && nbeam < 2) { beams[nbeam++] = 10001 + k; }
+        ++k;
+      }
+    }
+    for (const auto &p : evt.particles) {
+      if (p.prod == (int)v) {
+        if (p.status == 4 && nbeam < 2) { beams[nbeam++] = 10001 + k; }
+        ++k;
+      }
+    }
+  }
+
+  tb.Put("E ");
+  tb.Put(evt.event_number);
+  tb.Put(" -1 0 0 0 0 0 ");
+  tb.Put(evt.vertices.size());
+  tb.Put(' ');
+  tb.Put(beams[0]);
+  tb.Put(' ');
+  tb.Put(beams[1]);
+  tb.Put(" 0 ");
+  tb.Put(evt.weights.size());
+  for (const auto &w : evt.weights) {
+    tb.Put(' ');
+    tb.Put(w);
+  }
+  tb.Put("\nU GEV MM\nC ");
+  tb.Put(evt.xs);
+  tb.Put(' ');
+  tb.Put(evt.xs_err);
+  tb.Put('\n');
+
+  barcode = 0;
+  for (std::size_t v = 0; v < evt.vertices.size(); ++v) {
+    const MEventRecord::Vertex &V = evt.vertices[v];
+
+    int orphans = 0;
+    int nout    = 0;
+    for (const auto &p : evt.particles) {
+      if (p.end == (int)v && p.prod < 0) { ++orphans; }
+      if (p.prod == (int)v) { ++nout; }
+    }
+    tb.Put("V ");
+    tb.Put(VertexID(v));
+    tb.Put(" 0 ");
+    tb.Put(V.x);
+    tb.Put(' ');
+    tb.Put(V.y);
+    tb.Put(' ');
+    tb.Put(V.z);
+    tb.Put(' ');
+    tb.Put(V.t);
+    tb.Put(' ');
+    tb.Put(orphans);
+    tb.Put(' ');
+    tb.Put(nout);
+    tb.Put(" 0\n");
+
+    for (const auto &p : evt.particles) {
+      if (p.end == (int)v && p.prod < 0) { WriteParticle(p); }
+    }
+    for (const auto &p : evt.particles) {
+      if (p.prod == (int)v) { WriteParticle(p); }
+    }
+  }
+  tb.Flush(out);
+}
+
+MWriterHepMC2::~MWriterHepMC2() {
+  try {
+    Close();
+  } catch (...) {
+  }
+}
+
+void MWriterHepMC2::Close() {
+  if (closed) { return; }
+  closed = true;
+  out << "HepMC::IO_GenEvent-END_EVENT_LISTING\n\n";
+  out.flush();
+  CheckStream(out, "MWriterHepMC2::Close");
+}
+
+// ----------------------------------------------------------------------
+// Les Houches Event file
+//
+// [REFERENCE: Alwall et al., A standard format for Les Houches Event Files,
+// hep-ph/0609017]
+
+MWriterLHE::MWriterLHE(std::ostream &os, const LHEINIT &init) : out(os) {
+  tb.Put("<LesHouchesEvents version=\"3.0\">\n<header>\n<!--\n");
+  tb.Put(init.generator);
+  tb.Put("\n-->\n</header>\n<init>\n");
+  tb.Put(init.beam1);
+  tb.Put(' ');
+  tb.Put(init.beam2);
+  tb.Put(' ');
+  tb.Put(init.E1);
+  tb.Put(' ');
+  tb.Put(init.E2);
+  tb.Put(" 0 0 0 0 ");
+  tb.Put(init.weighted ? 4 : 3);  // IDWTUP
+  tb.Put(" 1\n");
+  tb.Put(init.xs);
+  tb.Put(' ');
+  tb.Put(init.xs_err);
+  tb.Put(' ');
+  tb.Put(init.maxw);
+  tb.Put(" 1\n</init>\n");
+  tb.Flush(out);
+}
+
+// Status codes: beam (4) -> -1, stable (1) -> 1, others -> 2 (intermediate),
+// mothers are the first and last incoming particles of the production vertex
+void MWriterLHE::Write(const MEventRecord &evt) {
+  tb.Put("<event>\n");
+  tb.Put(evt.particles.size());
+  tb.Put(" 1 ");
+  tb.Put(evt.weights.empty() ? 1.0 : evt.weights[0]);
+  tb.Put(" 0 0 0\n");
+
+  for (const auto &p : evt.particles) {
+    const int ISTUP = (p.status == 4) ? -1 : ((p.status == 1) ? 1 : 2);
+
+    int m1 = 0;
+    int m2 = 0;
+    if (p.prod >= 0 && evt.vertices[p.prod].nin > 0) {
+      m1 = evt.vertices[p.prod].in1 + 1;
+      m2 = LastIn(evt, p.prod) + 1;
+    }
+    tb.Put(p.pdg);
+    tb.Put(' ');
+    tb.Put(ISTUP);
+    tb.Put(' ');
+    tb.Put(m1);
+    tb.Put(' ');
+    tb.Put(m2);
+    tb.Put(" 0 0 ");
+    tb.Put(p.px);
+    tb.Put(' ');
+    tb.Put(p.py);
+    tb.Put(' ');
+    tb.Put(p.pz);
+    tb.Put(' ');
+    tb.Put(p.e);
+    tb.Put(' ');
+    tb.Put(p.m);
+    tb.Put(" 0 9\n");
+  }
+  tb.Put("</event>\n");
+  tb.Flush(out);
+}
+
+MWriterLHE::~MWriterLHE() {
+  try {
+    Close();
+  } catch (...) {
+  }
+}
+
+void MWriterLHE::Close() {
+  if (closed) { return; }
+  closed = true;
+  out << "</LesHouchesEvents>\n";
+  out.flush();
+  CheckStream(out, "MWriterLHE::Close");
+}
+
+// ----------------------------------------------------------------------
+// HepMC3 writer via GenEvent
+
+void MWriterGenEvent::Write(const MEventRecord &evt) {
+  HepMC3::GenEvent gevt(HepMC3::Units::GEV, HepMC3::Units::MM);
+  evt.ToGenEvent(gevt);
+  output->write_event(gevt);
+}
+
+}  // namespace gra
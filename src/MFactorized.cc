@@ -187,7 +187,7 @@ double MFactorized::EventWeight(const std::vector<double> &randvec, AuxIntData &
 bool MFactorized::FiducialCuts() const { return CommonCuts(); }
 
 // Record event
-bool MFactorized::EventRecord(HepMC3::GenEvent &evt) { return CommonRecord(evt); }
+bool MFactorized::EventRecord(MEventRecord &evt) { return CommonRecord(evt); }
 
 void MFactorized::PrintInit(bool silent) const {
   if (!silent) {
@@ -58,31 +58,11 @@ double ApplyDZfluxes(double amp2, gra::LORENTZSCALAR& lts) {
 // Apply Gamma-Gamma LUX-pdf (use at \mu > 10 GeV) at cross section level
 // Use with collinear kinematics
 double ApplyLUXfluxes(double amp2, gra::LORENTZSCALAR& lts) {
-  // @@ MULTITHREADING LOCK NEEDED FOR INITIALIZATION @@
-  gra::g_mutex.lock();
-
-  // Not created yet
-  if (lts.GlobalPdfPtr == nullptr) {
-    std::string pdfname = lts.LHAPDFSET;
-
-  retry:
-    try {
-      lts.GlobalPdfPtr = LHAPDF::mkPDF(pdfname, 0);
-      lts.pdf_trials   = 0;  // fine
-    } catch (...) {
-      ++lts.pdf_trials;
-      std::string str = "ApplyLUXfluxes: Problem with reading LHAPDF '" + pdfname + "'";
-      aux::AutoDownloadLHAPDF(pdfname);  // Try autodownload
-      gra::g_mutex.unlock();             // Remember before throw, otherwise deadlock
-      if (lts.pdf_trials >= 2) {         // too many failures
-        throw std::invalid_argument(str);
-      } else {
-        goto retry;
-      }
-    }
+  // Thread local PDF, created at initialization (no lock needed here)
+  if (lts.GlobalPdf.get() == nullptr) {
+    throw std::invalid_argument("ApplyLUXfluxes: LHAPDF '" + lts.LHAPDFSET +
+                                "' not initialized (post_Constructor)");
   }
-  gra::g_mutex.unlock();
-  // @@ MULTITHREADING UNLOCK @@
 
   // pdf factorization scale
   const double Q2 = lts.s_hat / 4.0;
@@ -92,8 +72,8 @@ double ApplyLUXfluxes(double amp2, gra::LORENTZSCALAR& lts) {
   double f2 = 0.0;
   try {
     // Divide x out
-    f1 = lts.GlobalPdfPtr->xfxQ2(PDG::PDG_gamma, lts.x1, Q2) / lts.x1;
-    f2 = lts.GlobalPdfPtr->xfxQ2(PDG::PDG_gamma, lts.x2, Q2) / lts.x2;
+    f1 = lts.GlobalPdf->xfxQ2(PDG::PDG_gamma, lts.x1, Q2) / lts.x1;
+    f2 = lts.GlobalPdf->xfxQ2(PDG::PDG_gamma, lts.x2, Q2) / lts.x2;
   } catch (...) { throw std::invalid_argument("ApplyLUXfluxes: Failed evaluating LHAPDF"); }
 
   const double phasespace = 1.0 / (lts.x1 * lts.x2);
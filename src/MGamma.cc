@@ -5,6 +5,7 @@
 
 // C++
 #include <complex>
+#include <mutex>
 #include <random>
 #include <vector>
 
@@ -208,10 +209,9 @@ double MGamma::yyffbar(gra::LORENTZSCALAR &lts) {
 // *************************************************************
 //
 double MGamma::yyMP(gra::LORENTZSCALAR &lts) const {
-  // Lazy printing
-  gra::g_mutex.lock();
-  PARAM_MONOPOLE::PrintParameters(lts.sqrt_s);
-  gra::g_mutex.unlock();
+  // Lazy printing, once (no lock after the first call)
+  static std::once_flag print_once;
+  std::call_once(print_once, [&lts]() { PARAM_MONOPOLE::PrintParameters(lts.sqrt_s); });
 
   // Monopolium nominal mass and width parameters
   static const double M = 2.0 * PARAM_MONOPOLE::M0 + PARAM_MONOPOLE::EnergyMP(PARAM_MONOPOLE::En);
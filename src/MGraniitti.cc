@@ -5,6 +5,7 @@
 
 // C++
 #include <algorithm>
+#include <chrono>
 #include <complex>
 #include <cstdlib>
 #include <fstream>
@@ -19,8 +20,13 @@
 #include <thread>
 #include <vector>
 
+// C file processing
+#include <dirent.h>
+
 // Own
 #include "Graniitti/MAux.h"
+#include "Graniitti/MCheckpoint.h"
+#include "Graniitti/MColumnar.h"
 #include "Graniitti/MContinuum.h"
 #include "Graniitti/MFactorized.h"
 #include "Graniitti/MGraniitti.h"
@@ -30,6 +36,7 @@
 #include "Graniitti/MParton.h"
 #include "Graniitti/MProcess.h"
 #include "Graniitti/MQuasiElastic.h"
+#include "Graniitti/MShard.h"
 #include "Graniitti/MTimer.h"
 
 // HepMC3
@@ -50,8 +57,16 @@ namespace gra {
 std::string MODELPARAM;
 
 // Multithreading
-std::mutex         g_mutex;
+MCountedMutex      g_mutex;
 std::exception_ptr globalExceptionPtr;
+unsigned int       GRIDCORES = std::max(1u, std::thread::hardware_concurrency());
+
+// Keep the first exception of the worker threads
+void SetGlobalException(std::exception_ptr e) {
+  static std::mutex           exception_mutex;
+  std::lock_guard<std::mutex> lock(exception_mutex);
+  if (!globalExceptionPtr) { globalExceptionPtr = e; }
+}
 
 // ******************************************************************
 
@@ -80,6 +95,13 @@ MGraniitti::MGraniitti() {
 
 // Destructor
 MGraniitti::~MGraniitti() {
+  // Write out all pending events (if not done by Generate)
+  try {
+    CloseFileOutput();
+  } catch (const std::exception &e) {
+    std::cerr << "MGraniitti::~MGraniitti: Event output failed: " << e.what() << std::endl;
+  }
+
   // Destroy processes
   for (std::size_t i = 0; i < pvec.size(); ++i) { delete pvec[i]; }
 
@@ -139,6 +161,210 @@ void MGraniitti::UnifyHistogramBounds() {
   }
 }
 
+// VEGAS checkpoint key: everything the integration result depends on,
+// but not the random seed, the number of threads or events, or the output
+std::string MGraniitti::GetCheckpointKey() const {
+  // Steering card without comments and without overridable or irrelevant fields
+  json card = json::parse(gra::aux::GetInputData(FULL_INPUT_STR));
+  card.erase("GENERALPARAM");
+  if (card.count("PROCESSPARAM")) {
+    for (const auto &x :
+         {"PROCESS", "ENERGY", "POMLOOP", "NSTARS", "LHAPDF", "HIST", "RNDSEED"}) {
+      card["PROCESSPARAM"].erase(x);
+    }
+  }
+
+  std::string key;
+  key += "PROCESS:     " + FULL_PROCESS_STR + "\n";
+  key += "SQRTS:       " + std::to_string(msqrt(proc->GetMandelstam_s())) + "\n";
+  key += "BEAMS:       " + std::to_string(proc->lts.beam1.pdg) + " " +
+         std::to_string(proc->lts.beam2.pdg) + "\n";
+  key += "POMLOOP:     " + std::to_string(proc->GetScreening()) + "\n";
+  key += "NSTARS:      " + std::to_string(proc->GetExcitation()) + "\n";
+  key += "LHAPDF:      " + proc->lts.LHAPDFSET + "\n";
+  key += "HIST:        " + std::to_string(proc->HIST) + "\n";
+  key += "DIMENSION:   " + std::to_string(proc->GetdLIPSDim()) + "\n";
+  key += "INTEGRATOR:  " + INTEGRATOR + "\n";
+  key += "VEGAS:       " + std::to_string(vparam.BINS) + " " + std::to_string(vparam.LAMBDA) +
+         "\n";
+  if (INTEGRATOR == "NEURO") {
+    key += "NEURO:       " + std::to_string(nparam.LAYERS) + " " +
+           std::to_string(nparam.HIDDEN) + " " + std::to_string(nparam.BATCH) + " " +
+           std::to_string(nparam.ITER) + " " + std::to_string(nparam.LR) + "\n";
+  }
+  key += "MODELPARAM:  " + gra::MODELPARAM + "\n";
+
+  // Model parameter and numerics files
+  const std::string modeldir = gra::aux::GetBasePath(2) + "/modeldata/" + gra::MODELPARAM;
+  std::vector<std::string> files;
+  if (DIR *dir = opendir(modeldir.c_str())) {
+    while (struct dirent *ent = readdir(dir)) {
+      const std::string name = ent->d_name;
+      if (name.size() > 5 && name.substr(name.size() - 5) == ".json") { files.push_back(name); }
+    }
+    closedir(dir);
+  }
+  std::sort(files.begin(), files.end());
+  for (const auto &name : files) {
+    key += "MODELFILE:   " + name + " " +
+           std::to_string(gra::aux::djb2hash(gra::aux::GetInputData(modeldir + "/" + name))) +
+           "\n";
+  }
+  const std::string numerics = gra::aux::GetBasePath(2) + "/modeldata/NUMERICS.json";
+  key += "NUMERICS:    " + std::to_string(gra::aux::djb2hash(gra::aux::GetInputData(numerics))) +
+         "\n";
+  key += "SOFT:        " + PARAM_SOFT::GetHashString() + "\n";
+
+  const MEikonalNumerics &N = proc->Eikonal.Numerics;
+  key += "LOOP:        " + std::to_string(N.NumberLoopKT) + " " + std::to_string(N.NumberLoopPHI) +
+         " " + std::to_string(N.MaxLoopKT) + " " + std::to_string(N.LoopAdaptive) + " " +
+         std::to_string(N.LoopRelTol) + " " + std::to_string(N.LoopMaxCalls) + "\n";
+  key += "CARD:        " + card.dump() + "\n";
+
+  return key;
+}
+
+std::string MGraniitti::GetCheckpointFile(const std::string &key) const {
+  return gra::aux::GetBasePath(2) + "/vegas/" + "VEGAS_" +
+         std::to_string(gra::aux::djb2hash(key)) + ".bin";
+}
+
+// Restore the VEGAS grid, integral and weight maximum, returns false if not available
+bool MGraniitti::ReadCheckpoint() {
+  const std::string key      = GetCheckpointKey();
+  const std::string filename = GetCheckpointFile(key);
+
+  MVEGASCheckpoint C;
+  if (!C.Read(filename)) { return false; }
+  if (C.key != key || C.FDIM != VD.FDIM) {
+    std::cout << "MGraniitti::ReadCheckpoint: Key mismatch in " << filename
+              << " (re-integrating)" << std::endl;
+    return false;
+  }
+
+  // Grid
+  vparam.BINS  = C.BINS;
+  vparam.NCALL = C.NCALL;
+  VD.ClearAll(vparam);
+  VD.region = C.region;
+  for (std::size_t i = 0; i < C.BINS; ++i) {
+    for (std::size_t j = 0; j < C.FDIM; ++j) { VD.xmat[i][j] = C.xmat[i * C.FDIM + j]; }
+  }
+  VD.BINS_prev = C.BINS;
+  VD.sumdata   = C.sumdata;
+  VD.sumchi2   = C.sumchi2;
+  VD.sweight   = C.sweight;
+
+  // Integral statistics
+  stat.sigma         = C.sigma;
+  stat.sigma_err     = C.sigma_err;
+  stat.sigma_err2    = pow2(C.sigma_err);
+  stat.chi2          = C.chi2;
+  stat.evaluations   = C.evaluations;
+  stat.maxf          = C.maxf;
+  stat.maxW          = C.maxW;
+  stat.amplitude_ok  = C.amplitude_ok;
+  stat.kinematics_ok = C.kinematics_ok;
+  stat.fidcuts_ok    = C.fidcuts_ok;
+  stat.vetocuts_ok   = C.vetocuts_ok;
+
+  // Phase space weight sums
+  DW_sum.SetSums(C.DW_sum[0], C.DW_sum[1], C.DW_sum[2]);
+  DW_sum_exact.SetSums(C.DW_sum_exact[0], C.DW_sum_exact[1], C.DW_sum_exact[2]);
+  proc->lts.DW_sum       = DW_sum;
+  proc->lts.DW_sum_exact = DW_sum_exact;
+
+  // Process copies: decay tree phase space weights and histogram bounds
+  for (auto &p : pvec) {
+    p->SetDecayWeights(C.decayW);
+    for (const auto &h : C.hist) {
+      if (h.dim == 1 && p->h1.count(h.name)) {
+        p->h1[h.name].ResetBounds(h.xbins, h.xmin, h.xmax);
+      }
+      if (h.dim == 2 && p->h2.count(h.name)) {
+        p->h2[h.name].ResetBounds(h.xbins, h.xmin, h.xmax, h.ybins, h.ymin, h.ymax);
+      }
+    }
+  }
+
+  time_t0 = global_tictoc.ElapsedSec();
+
+  if (!HILJAA) {
+    gra::aux::PrintBar("=");
+    std::cout << rang::style::bold;
+    printf("VEGAS integration restored from checkpoint: \n\n");
+    std::cout << rang::style::reset;
+    printf("File:                             %s \n", filename.c_str());
+    printf("Created:                          %s (version %0.3f) \n", C.created.c_str(),
+           C.generator);
+    printf("Cross section:                    [%0.3E +- %0.3E] barn \n", stat.sigma,
+           stat.sigma_err);
+    printf("MAX weight (vegas x integrand):   %0.3E \n", stat.maxf);
+    gra::aux::PrintBar("=");
+  }
+  return true;
+}
+
+// Save the VEGAS grid, integral and weight maximum
+void MGraniitti::WriteCheckpoint() const {
+  MVEGASCheckpoint C;
+  GetCheckpoint(C);
+
+  const std::string filename = GetCheckpointFile(C.key);
+  C.Write(filename);
+  if (!HILJAA) { std::cout << "MGraniitti::WriteCheckpoint: " << filename << std::endl; }
+}
+
+// Current VEGAS integration state
+void MGraniitti::GetCheckpoint(MVEGASCheckpoint &C) const {
+  C.key       = GetCheckpointKey();
+  C.hash      = gra::aux::djb2hash(C.key);
+  C.created   = gra::aux::DateTime();
+  C.generator = gra::aux::GetVersion();
+
+  C.FDIM   = VD.FDIM;
+  C.BINS   = vparam.BINS;
+  C.NCALL  = vparam.NCALL;
+  C.region = VD.region;
+  C.xmat.resize(C.BINS * C.FDIM);
+  for (std::size_t i = 0; i < C.BINS; ++i) {
+    for (std::size_t j = 0; j < C.FDIM; ++j) { C.xmat[i * C.FDIM + j] = VD.xmat[i][j]; }
+  }
+  C.sumdata = VD.sumdata;
+  C.sumchi2 = VD.sumchi2;
+  C.sweight = VD.sweight;
+
+  C.sigma         = stat.sigma;
+  C.sigma_err     = stat.sigma_err;
+  C.chi2          = stat.chi2;
+  C.maxf          = stat.maxf;
+  C.maxW          = stat.maxW;
+  C.evaluations   = stat.evaluations;
+  C.amplitude_ok  = stat.amplitude_ok;
+  C.kinematics_ok = stat.kinematics_ok;
+  C.fidcuts_ok    = stat.fidcuts_ok;
+  C.vetocuts_ok   = stat.vetocuts_ok;
+
+  proc->GetDecayWeights(C.decayW);
+  DW_sum.GetSums(C.DW_sum[0], C.DW_sum[1], C.DW_sum[2]);
+  DW_sum_exact.GetSums(C.DW_sum_exact[0], C.DW_sum_exact[1], C.DW_sum_exact[2]);
+
+  for (const auto &x : proc->h1) {
+    MCheckpointHist h;
+    h.name = x.first;
+    h.dim  = 1;
+    x.second.GetBounds(h.xbins, h.xmin, h.xmax);
+    C.hist.push_back(h);
+  }
+  for (const auto &x : proc->h2) {
+    MCheckpointHist h;
+    h.name = x.first;
+    h.dim  = 2;
+    x.second.GetBounds(h.xbins, h.xmin, h.xmax, h.ybins, h.ymin, h.ymax);
+    C.hist.push_back(h);
+  }
+}
+
 // Fuse histograms for N-fold statistics
 void MGraniitti::HistogramFusion() {
   if (hist_fusion_done == false) {
@@ -169,10 +395,77 @@ void MGraniitti::Generate() {
     // (in order not to generate unnecessary empty files
     // if file name / output type is changed)
     InitFileOutput();
+
+    // Integral before the event generation of this shard
+    GetIntegralSums(shard_base);
+
     CallIntegrator(NEVENTS);
+
+    // Finalize the output file before reporting its size, I/O errors are thrown here
+    CloseFileOutput();
+    const double outputfilesize =
+        gra::aux::GetFileSize(FULL_OUTPUT_STR) / (1024.0 * 1024.0 * 1024.0);
+    printf("Outputfile size:          %0.3f GB [%s] \n\n", outputfilesize,
+           FULL_OUTPUT_STR.c_str());
+
+    if (SHARD_COUNT > 1) { WriteShardStat(); }
+  }
+}
+
+// Write out pending events and finalize the output file (format trailer,
+// compression stream), external HepMC3 writers are closed by their owner
+void MGraniitti::CloseFileOutput() {
+  if (outputAsync != nullptr) { outputAsync->Close(); }
+  if (outputWriter != nullptr) { outputWriter->Close(); }
+  if (outputCompress != nullptr) { outputCompress->Finish(); }
+  if (outputStream != nullptr && outputStream->is_open()) {
+    outputStream->close();
+    if (outputStream->fail()) {
+      throw std::invalid_argument("MGraniitti::CloseFileOutput: Error writing " +
+                                  FULL_OUTPUT_STR);
+    }
+  }
+}
+
+// Integral sums in the form of MShardStat
+void MGraniitti::GetIntegralSums(std::array<double, 3> &sums) const {
+  if (INTEGRATOR == "VEGAS") {
+    sums = {{VD.sumdata, VD.sumchi2, VD.sweight}};
+  } else {
+    sums = {{stat.Wsum, stat.W2sum, stat.evaluations}};
   }
 }
 
+// Write the statistics sidecar of this shard, input for the merger
+void MGraniitti::WriteShardStat() const {
+  MShardStat S;
+  S.shard      = SHARD_INDEX;
+  S.shards     = SHARD_COUNT;
+  S.seed       = proc->random.GetSeed();
+  S.key        = CHECKPOINT ? gra::aux::djb2hash(GetCheckpointKey()) : 0;
+  S.process    = FULL_PROCESS_STR;
+  S.integrator = INTEGRATOR;
+  S.format     = FORMAT;
+  S.output     = FULL_OUTPUT_STR;
+  S.created    = gra::aux::DateTime();
+  S.sqrts      = msqrt(proc->GetMandelstam_s());
+  S.weighted   = WEIGHTED;
+  S.events     = stat.generated;
+  S.trials     = stat.trials;
+  S.overflow   = stat.N_overflow;
+  S.maxweight  = GetMaxweight();
+  S.sigma      = stat.sigma;
+  S.sigma_err  = stat.sigma_err;
+  S.base       = shard_base;
+  GetIntegralSums(S.sums);
+
+  const std::string filename =
+      gra::aux::GetBasePath(2) + "/output/" + OUTPUT + ShardSuffix(SHARD_INDEX, SHARD_COUNT) +
+      ".json";
+  S.Write(filename);
+  if (!HILJAA) { std::cout << "MGraniitti::WriteShardStat: " << filename << std::endl; }
+}
+
 // This is called just before event generation
 // Check against nullptr is done below, because if the output is already set
 // externally,
@@ -183,7 +476,12 @@ void MGraniitti::InitFileOutput() {
       throw std::invalid_argument("MGraniitti::InitFileOutput: OUTPUT filename not set!");
     }
 
-    FULL_OUTPUT_STR = gra::aux::GetBasePath(2) + "/output/" + OUTPUT + "." + FORMAT;
+    const std::string suffix = (SHARD_COUNT > 1) ? ShardSuffix(SHARD_INDEX, SHARD_COUNT) : "";
+    FULL_OUTPUT_STR = gra::aux::GetBasePath(2) + "/output/" + OUTPUT + suffix + "." + FORMAT;
+
+    // Compressed output, file name gets the codec suffix
+    const std::shared_ptr<MCodec> codec = MakeCodec(COMPRESS);
+    if (codec != nullptr) { FULL_OUTPUT_STR += codec->Extension(); }
 
     // --------------------------------------------------------------
     // Generator info
@@ -200,12 +498,84 @@ void MGraniitti::InitFileOutput() {
 
     // --------------------------------------------------------------
 
-    if (FORMAT == "hepmc3" && outputHepMC3 == nullptr) {
-      outputHepMC3 = std::make_shared<HepMC3::WriterAscii>(FULL_OUTPUT_STR, runinfo);
-    } else if (FORMAT == "hepmc2" && outputHepMC2 == nullptr) {
-      outputHepMC2 = std::make_shared<HepMC3::WriterAsciiHepMC2>(FULL_OUTPUT_STR, runinfo);
-    } else if (FORMAT == "hepevt" && outputHEPEVT == nullptr) {
-      outputHEPEVT = std::make_shared<HepMC3::WriterHEPEVT>(FULL_OUTPUT_STR);
+    // Output stream with a large buffer, for few large writes
+    auto OpenStream = [&]() {
+      outputBuffer.resize(4 * 1024 * 1024);
+      outputStream = std::make_shared<std::ofstream>();
+      outputStream->rdbuf()->pubsetbuf(outputBuffer.data(), outputBuffer.size());
+      outputStream->open(FULL_OUTPUT_STR, std::ios::out | std::ios::binary | std::ios::trunc);
+      if (!outputStream->is_open()) {
+        throw std::invalid_argument("MGraniitti::InitFileOutput: Cannot open " + FULL_OUTPUT_STR);
+      }
+      if (codec != nullptr) {
+        outputCompress = std::make_shared<MCompressStream>(*outputStream, codec, CORES);
+      }
+    };
+    // Stream seen by the writers
+    auto Stream = [&]() -> std::ostream & {
+      if (outputCompress != nullptr) { return *outputCompress; }
+      return *outputStream;
+    };
+
+    // Text formats are written directly from the flat event record,
+    // external (user) HepMC3 writers and HEPEVT via HepMC3::GenEvent
+    if (outputWriter == nullptr) {
+      if (FORMAT == "hepmc3") {
+        if (outputHepMC3 != nullptr) {
+          outputWriter = std::make_shared<MWriterGenEvent>(outputHepMC3);
+        } else {
+          OpenStream();
+          outputWriter = std::make_shared<MWriterHepMC3>(Stream(), runinfo);
+        }
+      } else if (FORMAT == "hepmc2") {
+        if (outputHepMC2 != nullptr) {
+          outputWriter = std::make_shared<MWriterGenEvent>(outputHepMC2);
+        } else {
+          OpenStream();
+          outputWriter = std::make_shared<MWriterHepMC2>(Stream());
+        }
+      } else if (FORMAT == "hepevt") {
+        if (outputHEPEVT == nullptr) {
+          OpenStream();
+          outputHEPEVT = std::make_shared<HepMC3::WriterHEPEVT>(Stream());
+        }
+        outputWriter = std::make_shared<MWriterGenEvent>(outputHEPEVT);
+      } else if (FORMAT == "lhe") {
+        OpenStream();
+        LHEINIT init;
+        init.beam1     = proc->lts.beam1.pdg;
+        init.beam2     = proc->lts.beam2.pdg;
+        init.E1        = proc->lts.pbeam1.E();
+        init.E2        = proc->lts.pbeam2.E();
+        init.xs        = ((xsforced > 0) ? xsforced : stat.sigma) * 1E12;  // pb
+        init.xs_err    = ((xsforced > 0) ? 0.0 : stat.sigma_err) * 1E12;
+        init.maxw      = WEIGHTED ? GetMaxweight() : 1.0;
+        init.weighted  = WEIGHTED;
+        init.generator = "GRANIITTI (" + gra::MODELPARAM + ") " +
+                         std::to_string(aux::GetVersion()).substr(0, 5) +
+                         "\nSteering card: " + FULL_INPUT_STR;
+        outputWriter = std::make_shared<MWriterLHE>(Stream(), init);
+      } else if (FORMAT == "grcol") {
+        OpenStream();
+        MColumnarHeader header;
+        if (aux::FileExist(FULL_INPUT_STR)) {
+          header.cardhash = aux::djb2hash(aux::GetInputData(FULL_INPUT_STR));
+        }
+        header.beam1     = proc->lts.beam1.pdg;
+        header.beam2     = proc->lts.beam2.pdg;
+        header.E1        = proc->lts.pbeam1.E();
+        header.E2        = proc->lts.pbeam2.E();
+        header.generator = "GRANIITTI (" + gra::MODELPARAM + ") " +
+                           std::to_string(aux::GetVersion()).substr(0, 5);
+        header.card      = FULL_INPUT_STR;
+        outputWriter     = std::make_shared<MWriterColumnar>(Stream(), header);
+      }
+    }
+
+    // --------------------------------------------------------------
+    // Asynchronous writer stage (events are written by a separate thread)
+    if (outputAsync == nullptr) {
+      outputAsync = std::make_unique<MAsyncWriter>(outputWriter, WRITEQUEUE);
     }
   }
 }
@@ -276,36 +646,50 @@ void MGraniitti::InitProcessMemory(std::string process, unsigned int seed) {
 }
 
 void MGraniitti::InitMultiMemory() {
+  // ** Init persistent worker threads (kept alive until destruction) **
+  if (pool == nullptr || pool->Size() != (unsigned int)CORES || pool->GetAffinity() != AFFINITY) {
+    pool = std::make_unique<MThreadPool>(CORES, AFFINITY);
+  }
+
   // ** Init multithreading memory by making copies of the process **
   for (std::size_t i = 0; i < pvec.size(); ++i) { delete pvec[i]; }
-  pvec.resize(CORES, nullptr);
+  pvec.assign(CORES, nullptr);
 
-  // Create new process objects for each thread
-  for (int i = 0; i < CORES; ++i) {
+  // Create new process objects for each thread, by the worker owning it
+  // (first-touch memory placement local to the worker), one at a time
+  std::mutex copy_mutex;
+  pool->Run([&](unsigned int tid) {
+    std::lock_guard<std::mutex> lock(copy_mutex);
     if (proc_Q.ProcPtr.ProcessExist(PROCESS)) {
-      pvec[i] = new MQuasiElastic(proc_Q);
+      pvec[tid] = new MQuasiElastic(proc_Q);
     } else if (proc_F.ProcPtr.ProcessExist(PROCESS)) {
-      pvec[i] = new MFactorized(proc_F);
+      pvec[tid] = new MFactorized(proc_F);
     } else if (proc_C.ProcPtr.ProcessExist(PROCESS)) {
-      pvec[i] = new MContinuum(proc_C);
+      pvec[tid] = new MContinuum(proc_C);
     } else if (proc_P.ProcPtr.ProcessExist(PROCESS)) {
-      pvec[i] = new MParton(proc_P);
+      pvec[tid] = new MParton(proc_P);
     }
-  }
+    // Resolve the amplitude routing once, not per event
+    pvec[tid]->ProcPtr.Bind(pvec[tid]->lts);
+  });
+
+  // Master seed for VEGAS chunk random substreams
+  RNDSEED_base = pvec[0]->random.GetSeed();
 
-  // RANDOM SEED PER THREAD (IMPORTANT!)
+  // RANDOM STREAM PER THREAD (IMPORTANT!)
+  // (a function of seed, shard and thread, no collisions between seeds)
   for (int i = 0; i < CORES; ++i) {
-    const unsigned int tid = i + 1;
-    // Deterministic seed
-    const unsigned int thread_seed =
-        static_cast<unsigned int>(std::max(0, (int)pvec[i]->random.GetSeed()) * tid);
-    pvec[i]->random.SetSeed(thread_seed);
+    pvec[i]->random.SetSubstream(RNDSEED_base, GenerationStream(0xFFFFFFFFULL), i);
   }
 
   // SET main control pointer to the first one
   // (needed for printing etc.)
   proc = pvec[0];
   proc->PrintInit(HILJAA);
+
+  // Phase space weight sums start from zero with the new process copies
+  DW_sum       = gra::kinematics::MCWSUM();
+  DW_sum_exact = gra::kinematics::MCWSUM();
 }
 
 // Set simple MC parameters
@@ -352,6 +736,46 @@ void MGraniitti::ReadGeneralParam(const std::string &inputfile) {
   SetIntegrator(j.at(XID).at("INTEGRATOR"));
   SetCores(j.at(XID).at("CORES"));
 
+  // This is optional, output writer queue depth
+  int writequeue = WRITEQUEUE;
+  try {
+    const int temp = j.at(XID).at("WRITEQUEUE");
+    writequeue     = temp;
+  } catch (...) {
+    // Do nothing
+  }
+  SetWriteQueue(writequeue);
+
+  // This is optional, output compression
+  std::string compress = COMPRESS;
+  try {
+    std::string temp = j.at(XID).at("COMPRESS");
+    compress         = temp;
+  } catch (...) {
+    // Do nothing
+  }
+  SetCompress(compress);
+
+  // This is optional, worker thread CPU affinity
+  std::string affinity = AFFINITY;
+  try {
+    std::string temp = j.at(XID).at("AFFINITY");
+    affinity         = temp;
+  } catch (...) {
+    // Do nothing
+  }
+  SetAffinity(affinity);
+
+  // This is optional, VEGAS integration checkpointing
+  bool checkpoint = CHECKPOINT;
+  try {
+    const bool temp = j.at(XID).at("CHECKPOINT");
+    checkpoint      = temp;
+  } catch (...) {
+    // Do nothing
+  }
+  SetCheckpoint(checkpoint);
+
   // Save for later use
   gra::MODELPARAM = j.at(XID).at("MODELPARAM");
 }
@@ -394,6 +818,7 @@ void MGraniitti::ReadProcessParam(const std::string &inputfile, const std::strin
   } else {  // commandline override
     fullstring = cmd_PROCESS;
   }
+  FULL_PROCESS_STR = fullstring;
 
   // ----------------------------------------------------------------
   // First separate possible extra arguments by @... ...
@@ -627,6 +1052,27 @@ void MGraniitti::ReadIntegralParam(const std::string &inputfile) {
   AssertRange(ND, {-10, 10}, "POMLOOP::ND", true);
   proc->Eikonal.Numerics.SetLoopDiscretization(ND);
 
+  // Adaptive loop integration: NUMERICS.json card, then @LOOP{ADAPTIVE:true,RTOL:1e-3,MAXCALLS:2000}
+  proc->Eikonal.Numerics.ReadLoopParameters();
+  for (const auto &i : indices(syntax)) {
+    if (syntax[i].id == "LOOP") {
+      for (const auto &x : syntax[i].arg) {
+        if (x.first == "ADAPTIVE" || x.first == "_SINGLET_") {
+          proc->Eikonal.Numerics.LoopAdaptive = (x.second == "true" || x.second == "1");
+        } else if (x.first == "RTOL") {
+          proc->Eikonal.Numerics.LoopRelTol = std::stod(x.second);
+        } else if (x.first == "MAXCALLS") {
+          proc->Eikonal.Numerics.LoopMaxCalls = std::stoi(x.second);
+        } else {
+          throw std::invalid_argument("@Syntax error: invalid @LOOP{} key " + x.first);
+        }
+      }
+    }
+  }
+  AssertRange(proc->Eikonal.Numerics.LoopRelTol, {1e-9, 1.0}, "LoopRelTol", true);
+  AssertRange(proc->Eikonal.Numerics.LoopMaxCalls, {(unsigned int)68, (unsigned int)1000000},
+              "LoopMaxCalls", true);
+
   // FLAT (naive) MC parameters
   MCPARAM mpam;
   mpam.PRECISION = j.at(XID).at("FLAT").at("PRECISION");
@@ -635,6 +1081,23 @@ void MGraniitti::ReadIntegralParam(const std::string &inputfile) {
   AssertRange(mpam.MIN_EVENTS, {10, (unsigned int)1e9}, "FLAT::MIN_EVENTS", true);
   SetMCParam(mpam);
 
+  // NEURO (neural importance sampler) parameters, optional
+  try {
+    const json &n = j.at(XID).at("NEURO");
+    if (n.count("LAYERS")) { nparam.LAYERS = n.at("LAYERS"); }
+    if (n.count("HIDDEN")) { nparam.HIDDEN = n.at("HIDDEN"); }
+    if (n.count("BATCH")) { nparam.BATCH = n.at("BATCH"); }
+    if (n.count("ITER")) { nparam.ITER = n.at("ITER"); }
+    if (n.count("LR")) { nparam.LR = n.at("LR"); }
+  } catch (...) {
+    // Do nothing
+  }
+  AssertRange(nparam.LAYERS, {(unsigned int)1, (unsigned int)64}, "NEURO::LAYERS", true);
+  AssertRange(nparam.HIDDEN, {(unsigned int)1, (unsigned int)1024}, "NEURO::HIDDEN", true);
+  AssertRange(nparam.BATCH, {(unsigned int)16, (unsigned int)1e7}, "NEURO::BATCH", true);
+  AssertRange(nparam.ITER, {(unsigned int)0, (unsigned int)1e6}, "NEURO::ITER", true);
+  AssertRange(nparam.LR, {0.0, 1.0}, "NEURO::LR", true);
+
   try {
     j.at(XID).at("VEGAS").at("BINS");
   } catch (...) {
@@ -1023,9 +1486,14 @@ void MGraniitti::Initialize() {
             << std::endl;
   std::cout << "Output file:            " << OUTPUT << std::endl;
   std::cout << "Output format:          " << FORMAT << std::endl;
+  std::cout << "Output compression:     " << COMPRESS << std::endl;
   std::cout << "Multithreading:         " << CORES << std::endl;
+  std::cout << "Thread affinity:        " << AFFINITY << std::endl;
   std::cout << "Integrator:             " << INTEGRATOR << std::endl;
   std::cout << "Number of events:       " << NEVENTS << std::endl;
+  if (SHARD_COUNT > 1) {
+    std::cout << "Shard:                  " << SHARD_INDEX << " / " << SHARD_COUNT << std::endl;
+  }
   std::cout << "Parameter setup:        " << gra::MODELPARAM << std::endl;
 
   std::string str = (WEIGHTED == true) ? "weighted" : "unweighted";
@@ -1057,6 +1525,9 @@ void MGraniitti::CallIntegrator(unsigned int N) {
   // Initialize global clock
   if (N == 0) { global_tictoc = MTimer(true); }
 
+  // Shared lock counters of this phase
+  gra::g_mutex.ResetCounters();
+
   // Sample the phase space
   if (INTEGRATOR == "VEGAS") {
     SampleVegas(N);
@@ -1089,6 +1560,9 @@ void MGraniitti::SampleVegas(unsigned int N) {
 
   // Pure integration mode
   if (GMODE == 0) {
+    // Restore the grid and integral from a checkpoint
+    if (CHECKPOINT && ReadCheckpoint()) { return; }
+
     const double MINTIME     = 0.1;  // Seconds
     unsigned int BURNIN_ITER = 3;    // BURN-IN iterations (default)!
 
@@ -1124,10 +1598,15 @@ void MGraniitti::SampleVegas(unsigned int N) {
         BURNIN_ITER = 2 * BURNIN_ITER;
       }
     } while (true);
+
+    if (CHECKPOINT) { WriteCheckpoint(); }
   }
 
   // Event generation mode
   if (GMODE == 1) {
+    // Generation streams start from zero, independent of the integration
+    VEGAS_stream = 0;
+
     const unsigned int init    = 2;
     const unsigned int itermin = 1E9;
     VEGAS(init, vparam.NCALL * 10, itermin, N);
@@ -1180,10 +1659,6 @@ int MGraniitti::VEGAS(unsigned int init, unsigned int calls, unsigned int itermi
   MTimer stime = MTimer(true);  // For statusprint
   atime        = MTimer(true);  // For progressbar
 
-  // -------------------------------------------------------------------
-  // Create number of calls per thread, their sum == calls
-  std::vector<unsigned int> LOCALcalls = VD.GetLocalCalls(calls, CORES);
-
   MTimer gridtic;
 
   // VEGAS grid iterations
@@ -1192,30 +1667,46 @@ int MGraniitti::VEGAS(unsigned int init, unsigned int calls, unsigned int itermi
       itertime = gridtic.ElapsedSec() / 3;  // Average over 3 iter
     }
 
-    for (std::size_t j = 0; j < VD.FDIM; ++j) {
-      for (std::size_t i = 0; i < vparam.BINS; ++i) {
-        VD.fmat[i][j]  = 0.0;
-        VD.f2mat[i][j] = 0.0;
-      }
-    }
-    // Init here outside parallel processing
-    VD.fsum  = 0.0;
-    VD.f2sum = 0.0;
+    // Init thread local accumulators here outside parallel processing
+    VL.assign(CORES, VEGASLocal());
+    VLstat.assign(CORES, Stats());
+
+    // Split calls into chunks, taken dynamically by the threads
+    VR.Init(calls, vparam, CORES, vparam.BINS, VD.FDIM);
+    const std::uint64_t stream =
+        (GMODE == 1) ? GenerationStream(VEGAS_stream++) : VEGAS_stream++;
 
     // --------------------------------------------------------------
-    // SPAWN PARALLEL PROCESSING HERE
+    // RUN PARALLEL PROCESSING HERE (persistent workers)
 
-    std::vector<std::thread> threads;
-    for (int tid = 0; tid < CORES; ++tid) {
-      threads.push_back(std::thread([=] { VEGASMultiThread(N, tid, init, LOCALcalls[tid]); }));
-    }
+    pool->Run([&](unsigned int tid) { VEGASMultiThread(N, tid, init, calls, stream); });
 
-    // Loop again to join the threads
-    for (auto &t : threads) { t.join(); }
     if (gra::globalExceptionPtr) {  // Exception handling of threads
       std::rethrow_exception(gra::globalExceptionPtr);
     }
 
+    // --------------------------------------------------------------
+    // Chunks are reduced in chunk order (reproducible), thread local
+    // statistics are counts and maxima (order independent)
+
+    VR.Reduce();
+    VD.SetSums(VR.total, vparam);
+    ReducePhaseSpaceSums();
+    for (const auto &S : VLstat) { stat.Fuse(S); }
+
+    // Got enough events generated, the last iteration is incomplete
+    // and does not enter the integral estimate
+    if (GMODE == 1 && stat.generated >= N) { goto stop; }
+
+    // Thread load imbalance: max / mean busy time - 1
+    double busy_max = 0.0;
+    double busy_sum = 0.0;
+    for (const auto &L : VL) {
+      busy_max = std::max(busy_max, L.busytime);
+      busy_sum += L.busytime;
+    }
+    stat.imbalance = (busy_sum > 0) ? busy_max / (busy_sum / VL.size()) - 1.0 : 0.0;
+
     // --------------------------------------------------------------
     // Estimates based on this iteration
 
@@ -1251,9 +1742,6 @@ int MGraniitti::VEGAS(unsigned int init, unsigned int calls, unsigned int itermi
     stat.chi2       = chi2this;
     // --------------------------------------------------------------
 
-    // Got enough events generated
-    if (GMODE == 1 && stat.generated >= N) { goto stop; }
-
     // Fatal error and convergence restart treatment
     if (GMODE == 0 && iter > 0) {
       if (std::isnan(stat.sigma) || std::isinf(stat.sigma)) {
@@ -1337,163 +1825,322 @@ stop:  // We jump here once finished (GOTO point)
   return 1;  // Return 1 for good
 }
 
-// This is called once for every VEGAS grid iteration
+// This is called once for every VEGAS grid iteration by each thread.
+// Threads take chunks dynamically until all chunks are done. Each chunk
+// draws from its own RNG substream (seed, stream, chunk) and is reduced
+// in chunk order, thus the result does not depend on which thread ran
+// which chunk.
 void MGraniitti::VEGASMultiThread(unsigned int N, unsigned int THREAD_ID, unsigned int init,
-                                  unsigned int LOCALcalls) {
+                                  unsigned int calls, std::uint64_t stream) {
   double zn = 0.0;
   double zo = 0.0;
   double ac = 0.0;
 
+  // Thread local statistics (no locking needed)
+  VEGASLocal &L  = VL[THREAD_ID];
+  Stats &     LS = VLstat[THREAD_ID];
+  MProcess *  P  = pvec[THREAD_ID];
+
+  // Phase space point vector and bin indices
+  std::vector<double>       xpoint(P->GetdLIPSDim(), 0.0);
+  std::vector<unsigned int> indvec(VD.FDIM, 0);
+
+  const auto tstart = std::chrono::steady_clock::now();
+  bool       done   = false;
+
   try {
-    for (std::size_t k = 0; k < LOCALcalls; ++k) {  // ** LOCALcalls ~= calls / CORES **
+    unsigned int chunk = 0;
+    while (!done && VR.Next(chunk)) {
+      VEGASSlot *S = VR.Acquire(chunk);
+      if (S == nullptr) { break; }
 
-      double vegasweight = 1.0;
+      // Phase space weights of this chunk only
+      P->lts.DW_sum       = gra::kinematics::MCWSUM();
+      P->lts.DW_sum_exact = gra::kinematics::MCWSUM();
 
-      // Phase space point vector
-      std::vector<double> xpoint(pvec[THREAD_ID]->GetdLIPSDim(), 0.0);
+      const std::size_t k_begin = (std::size_t)chunk * vparam.CHUNK;
+      const std::size_t k_end   = std::min((std::size_t)calls, k_begin + vparam.CHUNK);
 
-      // Loop over dimensions and construct random vector xpoint
-      std::vector<double> indvec(VD.FDIM, 0);
-      for (std::size_t j = 0; j < VD.FDIM; ++j) {
-        // Draw random number
-        zn = pvec[THREAD_ID]->random.U(0, 1) * vparam.BINS + 1.0;
-        indvec[j] =
-            std::max((unsigned int)1, std::min((unsigned int)zn, (unsigned int)vparam.BINS));
+      // Chunk random substream
+      P->random.SetSubstream(RNDSEED_base, stream, chunk);
 
-        if (indvec[j] > 1) {
-          zo = VD.xmat[indvec[j] - 1][j] - VD.xmat[indvec[j] - 2][j];
-          ac = VD.xmat[indvec[j] - 2][j] + (zn - indvec[j]) * zo;
-        } else {
-          zo = VD.xmat[indvec[j] - 1][j];
-          ac = (zn - indvec[j]) * zo;
-        }
+      for (std::size_t k = k_begin; k < k_end; ++k) {
+        double vegasweight = 1.0;
 
-        // Multidim space vector component
-        xpoint[j] = VD.region[j] + ac * VD.dxvec[j];
-        vegasweight *= zo * vparam.BINS;
+        // Loop over dimensions and construct random vector xpoint
+        for (std::size_t j = 0; j < VD.FDIM; ++j) {
+          // Draw random number
+          zn = P->random.U(0, 1) * vparam.BINS + 1.0;
+          indvec[j] =
+              std::max((unsigned int)1, std::min((unsigned int)zn, (unsigned int)vparam.BINS));
+
+          if (indvec[j] > 1) {
+            zo = VD.xmat[indvec[j] - 1][j] - VD.xmat[indvec[j] - 2][j];
+            ac = VD.xmat[indvec[j] - 2][j] + (zn - indvec[j]) * zo;
+          } else {
+            zo = VD.xmat[indvec[j] - 1][j];
+            ac = (zn - indvec[j]) * zo;
+          }
 
-      }  // VD.FDIM loop
+          // Multidim space vector component
+          xpoint[j] = VD.region[j] + ac * VD.dxvec[j];
+          vegasweight *= zo * vparam.BINS;
 
-      // *******************************************************************
-      // ****** Call the process under integration to get the weight *******
+        }  // VD.FDIM loop
 
-      gra::AuxIntData aux;
-      aux.vegasweight  = vegasweight;
-      aux.burn_in_mode = (init == 0) ? true : false;
+        // *******************************************************************
+        // ****** Call the process under integration to get the weight *******
 
-      const double W = pvec[THREAD_ID]->EventWeight(xpoint, aux);
+        gra::AuxIntData aux;
+        aux.vegasweight  = vegasweight;
+        aux.burn_in_mode = (init == 0) ? true : false;
 
-      // *******************************************************************
+        const double W = P->EventWeight(xpoint, aux);
 
-      // @@ Multithreading lock (FAST SECTION) @@
-      gra::g_mutex.lock();
+        // *******************************************************************
 
-      // Increase statistics
-      stat.Accumulate(aux);
+        // Increase statistics
+        LS.Accumulate(aux);
+        L.calls += 1;
 
-      // *** Importance weighting ***
-      const double f  = W * vegasweight;
-      const double f2 = pow2(f);
+        // *** Importance weighting ***
+        const double f  = W * vegasweight;
+        const double f2 = pow2(f);
 
-      VD.fsum += f;
-      VD.f2sum += f2;
+        S->fsum += f;
+        S->f2sum += f2;
 
-      // Loop over dimensions and add importance weighted results
-      for (std::size_t j = 0; j < VD.FDIM; ++j) {
-        VD.fmat[indvec[j] - 1][j] += f;
-        VD.f2mat[indvec[j] - 1][j] += f2;
-      }
+        // Loop over dimensions and add importance weighted results
+        for (std::size_t j = 0; j < VD.FDIM; ++j) {
+          S->fmat[indvec[j] - 1][j] += f;
+          S->f2mat[indvec[j] - 1][j] += f2;
+        }
 
-      // ----------------------------------------------------------
-      // Initialization (integration) mode
-      if (GMODE == 0) {
-        // Do not consider burn-in phase weights (unstable)
-        if (init != 0) {
-          // Maximum raw weight (for general information, not used
-          // here)
-          if (W > stat.maxW) { stat.maxW = W; }
-          // Maximum total VEGAS importance weighted
-          if (f > stat.maxf) { stat.maxf = f; }
+        // ----------------------------------------------------------
+        // Initialization (integration) mode
+        if (GMODE == 0) {
+          // Do not consider burn-in phase weights (unstable)
+          if (init != 0) {
+            // Maximum raw weight (for general information, not used
+            // here)
+            if (W > LS.maxW) { LS.maxW = W; }
+            // Maximum total VEGAS importance weighted
+            if (f > LS.maxf) { LS.maxf = f; }
+          }
         }
-      }
-      gra::g_mutex.unlock();
-      // @@ Multithreading unlock (FAST SECTION) @@
 
-      // ----------------------------------------------------------
-      // Event generation mode
-      if (GMODE == 1) {
-        // Enough events
-        if (stat.generated == (unsigned int)GetNumberOfEvents()) { break; }
+        // ----------------------------------------------------------
+        // Event generation mode
+        if (GMODE == 1) {
+          // Enough events
+          if (stat.generated == (unsigned int)GetNumberOfEvents()) {
+            done = true;
+            break;
+          }
 
-        // Event trial
-        SaveEvent(pvec[THREAD_ID], f, stat.maxf, aux);
+          // Event trial
+          SaveEvent(P, f, stat.maxf, aux);
 
-        if (THREAD_ID == 0 && atime.ElapsedSec() > 0.5) {
-          PrintStatus(stat.generated, N, local_tictoc, 10.0);
-          gra::aux::PrintProgress(stat.generated / static_cast<double>(N));
-          atime.Reset();
+          if (THREAD_ID == 0 && atime.ElapsedSec() > 0.5) {
+            PrintStatus(stat.generated, N, local_tictoc, 10.0);
+            gra::aux::PrintProgress(stat.generated / static_cast<double>(N));
+            atime.Reset();
+          }
         }
-      }
-    }  // calls loop
+      }  // calls loop
+
+      S->DW_sum       = P->lts.DW_sum;
+      S->DW_sum_exact = P->lts.DW_sum_exact;
+      VR.Release(chunk);
+      L.chunks += 1;
+    }  // chunk loop
   } catch (...) {
     // Set the global exception pointer if exception arises
     // This is because of multithreading
-    gra::globalExceptionPtr = std::current_exception();
+    gra::SetGlobalException(std::current_exception());
+    done                    = true;
   }
+  // Threads waiting for a reduction buffer stop
+  if (done) { VR.Abort(); }
+
+  L.busytime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tstart).count();
+}
+
+// Phase space weight sums over all chunks so far, in chunk order
+// (the printed phase space volume is read from the main process)
+void MGraniitti::ReducePhaseSpaceSums() {
+  DW_sum.Add(VR.total.DW_sum);
+  DW_sum_exact.Add(VR.total.DW_sum_exact);
+  proc->lts.DW_sum       = DW_sum;
+  proc->lts.DW_sum_exact = DW_sum_exact;
 }
 
 // Generate events using plain simple MC (for reference/DEBUG purposes)
 void MGraniitti::SampleFlat(unsigned int N) {
-  // Integration mode
   if (N == 0) {
-    GMODE = 0;
-    proc->PrintInit(HILJAA);
+    InitMultiMemory();
+    GMODE = 0;  // Pure integration
+  }
+  if (N > 0) {
+    GMODE = 1;  // Event generation
+  }
+
+  // Uniform points in the unit hypercube
+  auto batch = [&](unsigned int tid, std::vector<std::vector<double>> &u,
+                   std::vector<double> &jac) {
+    for (const auto &k : indices(u)) {
+      for (auto &x : u[k]) { x = pvec[tid]->random.U(0, 1); }
+      jac[k] = 1.0;
+    }
+  };
+  SamplePlain(N, batch);
+}
+
+// Neural importance sampling Monte Carlo
+void MGraniitti::SampleNeuro(unsigned int N) {
+  if (N == 0) {
+    InitMultiMemory();
+    GMODE = 0;  // Pure integration
+  }
+  if (N > 0) {
+    GMODE = 1;  // Event generation
   }
-  // Event generation mode
-  if (N > 0) { GMODE = 1; }
 
   // Get dimension of the phase space
-  const unsigned int  dim = proc->GetdLIPSDim();
-  std::vector<double> randvec(dim, 0.0);
+  const unsigned int D = proc->GetdLIPSDim();
 
+  if (N == 0) {
+    // Trained flow from an earlier run with the same key
+    const std::string key      = GetCheckpointKey();
+    const std::string filename = gra::aux::GetBasePath(2) + "/vegas/" + "NEURO_" +
+                                 std::to_string(gra::aux::djb2hash(key)) + ".bin";
+    if (CHECKPOINT && flow.Read(filename, key) && flow.Dim() == D) {
+      if (!HILJAA) { std::cout << "MGraniitti::SampleNeuro: Restored " << filename << std::endl; }
+    } else {
+      // Training draws from its own streams, so that the integration
+      // is the same with a trained or a restored flow
+      const std::uint64_t TRAIN = 1ULL << 62;
+      std::uint64_t       calls = 0;
+      MRandom             random;
+      random.SetSubstream(RNDSEED_base, TRAIN, 0);
+      flow.Init(D, nparam, random);
+
+      // Integrand batch evaluated by all threads, columns interleaved
+      std::vector<std::vector<double>> uw(CORES, std::vector<double>(D, 0.0));
+      auto integrand = [&](const Eigen::MatrixXd &U, Eigen::VectorXd &F) {
+        F = Eigen::VectorXd::Zero(U.cols());
+        const std::uint64_t stream = TRAIN + (++calls);
+
+        pool->Run([&](unsigned int tid) {
+          try {
+            pvec[tid]->random.SetSubstream(RNDSEED_base, stream, tid);
+            std::vector<double> &u = uw[tid];
+            for (std::size_t k = tid; k < (std::size_t)U.cols(); k += CORES) {
+              for (std::size_t i = 0; i < D; ++i) { u[i] = U(i, k); }
+              gra::AuxIntData aux;
+              aux.vegasweight  = 1.0;
+              aux.burn_in_mode = true;
+              const double W   = pvec[tid]->EventWeight(u, aux);
+              F[k]             = std::isfinite(W) ? W : 0.0;
+            }
+          } catch (...) {
+            gra::SetGlobalException(std::current_exception());
+          }
+        });
+        if (gra::globalExceptionPtr) {  // Exception handling of threads
+          std::rethrow_exception(gra::globalExceptionPtr);
+        }
+      };
+      flow.Train(integrand, nparam, random, HILJAA);
+
+      if (CHECKPOINT) {
+        flow.Write(filename, key);
+        if (!HILJAA) { std::cout << "MGraniitti::SampleNeuro: " << filename << std::endl; }
+      }
+    }
+  }
+
+  // -------------------------------------------------------------------
+  // Integration and event generation
+
+  // Batch of prior p(z) samples mapped through the trained flow
+  // (the flow parameters are read-only from here on)
+  // (matrices are allocated once per worker and reused over chunks)
+  struct Workspace {
+    Eigen::MatrixXd Z;
+    Eigen::MatrixXd Y;
+    Eigen::MatrixXd U;
+    Eigen::VectorXd invq;
+  };
+  std::vector<Workspace> work(CORES);
+
+  auto batch = [&](unsigned int tid, std::vector<std::vector<double>> &u,
+                   std::vector<double> &jac) {
+    Eigen::MatrixXd &Z    = work[tid].Z;
+    Eigen::MatrixXd &U    = work[tid].U;
+    Eigen::VectorXd &invq = work[tid].invq;
+    Z.resize(D, u.size());
+    for (std::size_t k = 0; k < u.size(); ++k) {
+      for (std::size_t i = 0; i < D; ++i) { Z(i, k) = pvec[tid]->random.G(0, 1); }
+    }
+    flow.Forward(Z, work[tid].Y, U, invq);
+
+    for (const auto &k : indices(u)) {
+      for (std::size_t i = 0; i < D; ++i) { u[k][i] = U(i, k); }
+      jac[k] = invq[k];
+    }
+  };
+  SamplePlain(N, batch);
+}
+
+// Multithreaded plain MC integration and event generation (FLAT, NEURO)
+void MGraniitti::SamplePlain(unsigned int N, const PointBatch &batch) {
   // Reset local timer
   local_tictoc = MTimer(true);
 
   // Progressbar
   atime = MTimer(true);
 
-  // Reservation (test)
-  // using namespace std::placeholders; // _1, _2, ... come from here
-  // std::function<double(const std::vector<double>&, int, double,
-  // std::vector<double>&,
-  // bool&)> fifth =
-  //  std::bind(&MQuasiElastic::EventWeight, &proc_Q, _1, _2, _3, _4, _5);
-
-  // Event loop
-  while (true) {
-    // ** Generate new random numbers **
-    for (const auto &i : indices(randvec)) { randvec[i] = proc->random.U(0, 1); }
-
-    // Generate event
-    // Used for in-out control of the process
-    gra::AuxIntData aux;
-    aux.vegasweight  = 1.0;
-    aux.burn_in_mode = false;
-    const double W   = proc->EventWeight(randvec, aux);
-
-    // Increase statistics
-    stat.Accumulate(aux);
-    stat.Wsum += W;
-    stat.W2sum += pow2(W);
+  // Calls per round, after each the statistics are reduced (a user
+  // parameter, the threads only share the work)
+  const unsigned int calls = vparam.NCALL;
+
+  // Generation streams start from zero, independent of the integration
+  if (GMODE == 1) { VEGAS_stream = 0; }
+
+  for (std::size_t round = 0;; ++round) {
+    VLstat.assign(CORES, Stats());
+
+    // Split calls into chunks, taken dynamically by the threads
+    VR.Init(calls, vparam, CORES, 0, 0);
+    const std::uint64_t stream =
+        (GMODE == 1) ? GenerationStream(VEGAS_stream++) : VEGAS_stream++;
+
+    pool->Run([&](unsigned int tid) { PlainMultiThread(N, tid, calls, stream, batch); });
+
+    if (gra::globalExceptionPtr) {  // Exception handling of threads
+      std::rethrow_exception(gra::globalExceptionPtr);
+    }
+
+    // Weight sums are reduced in chunk order (reproducible), thread local
+    // statistics are counts and maxima (order independent)
+    VR.Reduce();
+    stat.Wsum += VR.total.fsum;
+    stat.W2sum += VR.total.f2sum;
+    ReducePhaseSpaceSums();
+    for (const auto &S : VLstat) { stat.Fuse(S); }
 
     // Update cross section estimate
     stat.CalculateCrossSection();
 
     // Initialization
     if (GMODE == 0) {
-      stat.maxW = (W > stat.maxW) ? W : stat.maxW;  // Update maximum weight
       PrintStatus(stat.evaluations, N, local_tictoc, 10.0);
 
+      // Unify histogram boundaries after the first round across different
+      // threads (due to adaptive histogramming)
+      if (round == 0) { UnifyHistogramBounds(); }
+
       if ((stat.sigma_err / stat.sigma) < mcparam.PRECISION &&
           stat.evaluations > mcparam.MIN_EVENTS) {
         break;
@@ -1508,143 +2155,97 @@ void MGraniitti::SampleFlat(unsigned int N) {
 
     // Event generation mode
     if (GMODE == 1) {
-      SaveEvent(proc, W, stat.maxW, aux);
-      PrintStatus(stat.generated, N, local_tictoc, 10.0);
       if (stat.generated >= N) { break; }
-
-      // Progressbar
-      if (atime.ElapsedSec() > 0.1) {
-        gra::aux::PrintProgress(stat.generated / static_cast<double>(N));
-        atime.Reset();
-      }
     }
   }
   PrintStatus(stat.generated, N, local_tictoc, -1.0);
   PrintStatistics(N);
 }
 
-// Neural net Monte Carlo (small scale PROTOTYPE)
-void MGraniitti::SampleNeuro(unsigned int N) {
-  // Integration mode
-  if (N == 0) {
-    GMODE = 0;
-    proc->PrintInit(HILJAA);
-  }
-  // Event generation mode
-  if (N > 0) { GMODE = 1; }
-
-  // Get dimension of the phase space
-  const unsigned int D = proc->GetdLIPSDim();
-
-  // Reset timers
-  local_tictoc = MTimer(true);
-  atime        = MTimer(true);
-
-  // Reservation (test)
-  // using namespace std::placeholders; // _1, _2, ... come from here
-  // std::function<double(const std::vector<double>&, int, double,
-  // std::vector<double>&,
-  // bool&)> fifth =
-  // std::bind(&MQuasiElastic::EventWeight, &proc_Q, _1, _2, _3, _4, _5);
-
-  if (N == 0) {
-    // -------------------------------------------------------
-    // Bind the object and call it
-    gra::neurojac::procptr = proc;  // First set address
-    // -------------------------------------------------------
-
-    gra::neurojac::MNeuroJacobian neurojac;
-    gra::neurojac::BATCHSIZE = 100;
-
-    // Set network layer dimensions [first, ..., output]
-    gra::neurojac::par.D = D;  // Integrand dimension
-
-    gra::neurojac::par.L.push_back(gra::neurojac::Layer(2, D));  // Input
-    gra::neurojac::par.L.push_back(gra::neurojac::Layer(2, 2));
-    gra::neurojac::par.L.push_back(gra::neurojac::Layer(2, 2));
-    gra::neurojac::par.L.push_back(gra::neurojac::Layer(D, 2));  // Output
-
-    neurojac.Optimize();
-  }
-
-  // -------------------------------------------------------------------
-  // Now to the event generation
-
-  // Lambda capture
-  std::vector<double> u(D);
-
-  auto NeuroSample = [&](gra::AuxIntData &aux) {
+// This is called once for every plain MC round by each thread.
+// Threads take chunks dynamically until all chunks are done, each chunk
+// draws from its own RNG substream (seed, stream, chunk) and is reduced
+// in chunk order.
+void MGraniitti::PlainMultiThread(unsigned int N, unsigned int THREAD_ID, unsigned int calls,
+                                  std::uint64_t stream, const PointBatch &batch) {
+  Stats &   LS = VLstat[THREAD_ID];
+  MProcess *P  = pvec[THREAD_ID];
 
-    // Prior p(z) distribution sampling
-    VectorXdual z(u.size());
-    for (std::size_t i = 0; i < D; ++i) { z[i] = proc->random.G(0, 1); }
-    const double p = val(gra::neurojac::gaussprob(z, 0, 1));
+  // Batch of points in the unit hypercube and their Jacobian weights
+  std::vector<std::vector<double>> u;
+  std::vector<double>              jac;
+  bool                             done = false;
 
-    // Evaluate network map
-    VectorXdual u_ = gra::neurojac::G_net(z);
+  try {
+    unsigned int chunk = 0;
+    while (!done && VR.Next(chunk)) {
+      VEGASSlot *S = VR.Acquire(chunk);
+      if (S == nullptr) { break; }
 
-    // Evaluate the Jacobian matrix du/dz
-    MatrixXd dudz = jacobian(gra::neurojac::G_net, u_, z);
+      // Phase space weights of this chunk only
+      P->lts.DW_sum       = gra::kinematics::MCWSUM();
+      P->lts.DW_sum_exact = gra::kinematics::MCWSUM();
 
-    // Abs Jacobian determinant and inverse prior
-    const double jacweight = abs(dudz.determinant()) / p;
+      const std::size_t k_begin = (std::size_t)chunk * vparam.CHUNK;
+      const std::size_t k_end   = std::min((std::size_t)calls, k_begin + vparam.CHUNK);
 
-    for (std::size_t i = 0; i < D; ++i) { u[i] = val(u_[i]); }
+      // Chunk random substream
+      P->random.SetSubstream(RNDSEED_base, stream, chunk);
 
-    // Evaluate event weight
-    aux.vegasweight     = jacweight;
-    aux.burn_in_mode    = false;
-    const double weight = proc->EventWeight(u, aux) * jacweight;
+      // Reused over chunks (only the last chunk may be shorter)
+      if (u.size() != k_end - k_begin) {
+        u.assign(k_end - k_begin, std::vector<double>(P->GetdLIPSDim(), 0.0));
+        jac.assign(k_end - k_begin, 0.0);
+      }
+      batch(THREAD_ID, u, jac);
 
-    return weight;
-  };
+      for (const auto &k : indices(u)) {
+        // Event generation mode: enough events
+        if (GMODE == 1 && stat.generated == (unsigned int)GetNumberOfEvents()) {
+          done = true;
+          break;
+        }
 
-  // Event loop
-  while (true) {
-    // aux used for in-out control of the process
-    gra::AuxIntData aux;
-    const double    W = NeuroSample(aux);
+        // Used for in-out control of the process
+        gra::AuxIntData aux;
+        aux.vegasweight  = jac[k];
+        aux.burn_in_mode = false;
+        const double W   = P->EventWeight(u[k], aux) * jac[k];
 
-    // Increase statistics
-    stat.Accumulate(aux);
-    stat.Wsum += W;
-    stat.W2sum += pow2(W);
+        // Increase statistics
+        LS.Accumulate(aux);
+        S->fsum += W;
+        S->f2sum += pow2(W);
 
-    // Update cross section estimate
-    stat.CalculateCrossSection();
+        // Initialization (integration) mode
+        if (GMODE == 0) {
+          if (W > LS.maxW) { LS.maxW = W; }  // Update maximum weight
+        }
 
-    // Initialization
-    if (GMODE == 0) {
-      stat.maxW = (W > stat.maxW) ? W : stat.maxW;  // Update maximum weight
-      PrintStatus(stat.evaluations, N, local_tictoc, 10.0);
+        // Event generation mode
+        if (GMODE == 1) {
+          SaveEvent(P, W, stat.maxW, aux);
 
-      if ((stat.sigma_err / stat.sigma) < mcparam.PRECISION &&
-          stat.evaluations > mcparam.MIN_EVENTS) {
-        break;
+          if (THREAD_ID == 0 && atime.ElapsedSec() > 0.5) {
+            PrintStatus(stat.generated, N, local_tictoc, 10.0);
+            gra::aux::PrintProgress(stat.generated / static_cast<double>(N));
+            atime.Reset();
+          }
+        }
       }
 
-      // Progressbar
-      if (atime.ElapsedSec() > 0.1) {
-        gra::aux::PrintProgress(stat.evaluations / static_cast<double>(mcparam.MIN_EVENTS));
-        atime.Reset();
-      }
-    }
-
-    // Event generation mode
-    if (GMODE == 1) {
-      SaveEvent(proc, W, stat.maxW, aux);
-      PrintStatus(stat.generated, N, local_tictoc, 10.0);
-      if (stat.generated >= N) { break; }
-
-      // Progressbar
-      if (atime.ElapsedSec() > 0.1) {
-        gra::aux::PrintProgress(stat.generated / static_cast<double>(N));
-        atime.Reset();
-      }
+      S->DW_sum       = P->lts.DW_sum;
+      S->DW_sum_exact = P->lts.DW_sum_exact;
+      VR.Release(chunk);
     }
+  } catch (...) {
+    // Set the global exception pointer if exception arises
+    // This is because of multithreading
+    gra::SetGlobalException(std::current_exception());
+    done                    = true;
   }
-  PrintStatus(stat.generated, N, local_tictoc, -1.0);
-  PrintStatistics(N);
+  // Threads waiting for a reduction buffer stop
+  if (done) { VR.Abort(); }
 }
 
 // Save unweighted or weighted event
@@ -1653,8 +2254,8 @@ int MGraniitti::SaveEvent(MProcess *pr, double weight, double MAXWEIGHT,
   gra::g_mutex.lock();
   stat.trials += 1;  // This is one trial more
 
-  // 0. Hit-Miss
-  bool hit_in = proc->random.U(0, 1) < (weight / MAXWEIGHT);
+  // 0. Hit-Miss (with the random stream of the calling thread)
+  bool hit_in = pr->random.U(0, 1) < (weight / MAXWEIGHT);
 
   // 2. We see weight larger than maxweight
   if (!WEIGHTED && weight > MAXWEIGHT) {
@@ -1666,11 +2267,11 @@ int MGraniitti::SaveEvent(MProcess *pr, double weight, double MAXWEIGHT,
   // Three ways to accept the event. N.B. weight > 0 needed if the amplitude
   // fails numerically
   if ((hit_in && aux.Valid()) || (WEIGHTED && aux.Valid()) || aux.forced_accept) {
-    // Create HepMC3 event (do not lock yet for speed)
-    HepMC3::GenEvent evt(HepMC3::Units::GEV, HepMC3::Units::MM);
+    // Create the flat event record (do not lock yet for speed)
+    std::unique_ptr<MEventRecord> evt = std::make_unique<MEventRecord>();
 
     // Construct event record
-    if (!pr->EventRecord(evt)) {  // Event not ok!
+    if (!pr->EventRecord(*evt)) {  // Event not ok!
       // std::cout << "MGraniitti::SaveEvent: Last moment rare veto!" <<
       // std::endl;
       return 2;
@@ -1688,37 +2289,28 @@ int MGraniitti::SaveEvent(MProcess *pr, double weight, double MAXWEIGHT,
       return 1;
     }
 
-    // Save cross section information (HepMC3 format wants it event
-    // by event)
-    std::shared_ptr<HepMC3::GenCrossSection> xsobj = std::make_shared<HepMC3::GenCrossSection>();
-    evt.add_attribute("GenCrossSection", xsobj);
+    // Reserve this event
+    evt->event_number = stat.generated;
+    stat.generated += 1;  // +1 event generated
+
+    // Cross section at this point of generation
+    const double xs     = (xsforced > 0) ? xsforced : stat.sigma;
+    const double xs_err = (xsforced > 0) ? 0.0 : stat.sigma_err;
 
-    // Now add the value in picobarns [HepMC3 convention]
-    if (xsforced > 0) {
-      xsobj->set_cross_section(xsforced * 1E12, 0);  // external fixed one
-    } else {
-      xsobj->set_cross_section(stat.sigma * 1E12, stat.sigma_err * 1E12);
-    }
+    gra::g_mutex.unlock();
+    // @@ THIS IS THREAD-NON-SAFE <- LOCK IT @@
+
+    // Save cross section information event by event, in picobarns [HepMC3 convention]
+    evt->xs     = xs * 1E12;
+    evt->xs_err = xs_err * 1E12;
 
     // Save event weight (unweighted events with weight 1)
     const double HepMC3_weight = WEIGHTED ? weight : 1.0;
-    evt.weights().push_back(HepMC3_weight);  // add more weights with .push_back()
-
-    if (FORMAT == "hepmc3") {
-      outputHepMC3->write_event(evt);
-    } else if (FORMAT == "hepmc2") {
-      outputHepMC2->write_event(evt);
-    } else if (FORMAT == "hepevt") {
-      outputHEPEVT->write_event(evt);
-    } else {
-      throw std::invalid_argument("MGraniitti::SaveEvent: Unknown output FORMAT " + FORMAT);
-    }
+    evt->weights.push_back(HepMC3_weight);  // add more weights with .push_back()
 
-    // LAST STEP
-    stat.generated += 1;  // +1 event generated
-
-    gra::g_mutex.unlock();
-    // @@ THIS IS THREAD-NON-SAFE <- LOCK IT @@
+    // Hand over to the writer thread (formatting and disk I/O done there),
+    // which restores the order of the reserved event numbers
+    outputAsync->Push(std::move(evt));
     return 0;
   } else {
     return 1;
@@ -1743,9 +2335,9 @@ void MGraniitti::PrintStatus(unsigned int events, unsigned int N, MTimer &tictoc
       const double global_lap = global_tictoc.ElapsedSec();
       printf(
           "[%0.1f MB] xs: %9.3E, er: %7.5f [chi2 = %2.1f], %4.1f "
-          "min ~ %0.1E Hz \n",
+          "min ~ %0.1E Hz [imb = %0.2f] \n",
           resident_use, stat.sigma, stat.sigma_err / stat.sigma, stat.chi2, global_lap / 60.0,
-          events / global_lap);
+          events / global_lap, stat.imbalance);
     }
     if (GMODE == 1) {
       const double global_lap     = global_tictoc.ElapsedSec() - time_t0;
@@ -1753,10 +2345,10 @@ void MGraniitti::PrintStatus(unsigned int events, unsigned int N, MTimer &tictoc
 
       printf(
           "[%0.1f MB/%0.2f GB] E: %9d, xs: %9.3E, er: %7.5f, %0.1f/%0.1f min ~ "
-          "%0.1E Hz \n",
+          "%0.1E Hz [imb = %0.2f] \n",
           resident_use, outputfilesize, events, stat.sigma, stat.sigma_err / stat.sigma,
           global_lap / 60.0, (N - events) * global_lap / (double)events / 60.0,
-          events / global_lap);
+          events / global_lap, stat.imbalance);
     }
   }
 }
@@ -1871,6 +2463,27 @@ void MGraniitti::PrintStatistics(unsigned int N) {
     printf("Veto cuts passing rate:           %0.3E \n", stat.vetocuts_ok / stat.evaluations);
     printf("\n");
 
+    // Screening loop cost
+    if (proc->GetScreening()) {
+      double loop_events = 0.0;
+      double loop_calls  = 0.0;
+      for (const auto &p : pvec) {
+        loop_events += p->GetLoopEvents();
+        loop_calls += p->GetLoopCalls();
+      }
+      if (loop_events > 0) {
+        const std::string mode = proc->Eikonal.Numerics.LoopAdaptive ? "adaptive" : "fixed grid";
+        printf("Screening loop amplitude calls:   %0.1f / event (%s) \n", loop_calls / loop_events,
+               mode.c_str());
+        printf("\n");
+      }
+    }
+
+    // Amplitude and flux paths are lock-free, only the initialization locks
+    printf("Shared lock acquisitions:         %llu (contended %llu) \n",
+           static_cast<unsigned long long>(gra::g_mutex.Acquired()),
+           static_cast<unsigned long long>(gra::g_mutex.Contended()));
+
     std::cout << std::endl;
     printf(
         "** All values include phase space generation and "
@@ -1878,6 +2491,10 @@ void MGraniitti::PrintStatistics(unsigned int N) {
     gra::aux::PrintBar("=");
   }
   if (GMODE == 1) {
+    // Wait until the writer thread has written all events
+    if (outputAsync != nullptr) { outputAsync->Flush(); }
+    if (outputStream != nullptr) { outputStream->flush(); }
+
     const double lap = global_tictoc.ElapsedSec() - time_t0;
 
     gra::aux::PrintBar("=");
@@ -1900,10 +2517,18 @@ void MGraniitti::PrintStatistics(unsigned int N) {
            stat.N_overflow, stat.trials);
     printf("Generation runtime:       %0.2f sec \n", lap);
     printf("Generation frequency:     %0.2E Hz \n", N / lap);
-
-    double outputfilesize = gra::aux::GetFileSize(FULL_OUTPUT_STR) / (1024.0 * 1024.0 * 1024.0);
-
-    printf("Outputfile size:          %0.3f GB [%s] \n", outputfilesize, FULL_OUTPUT_STR.c_str());
+    printf("Shared lock acquisitions: %llu (contended %llu) \n",
+           static_cast<unsigned long long>(gra::g_mutex.Acquired()),
+           static_cast<unsigned long long>(gra::g_mutex.Contended()));
+
+    if (outputAsync != nullptr && outputAsync->GetDepth() > 0) {
+      const AsyncWriterStats ws = outputAsync->GetStats();
+      printf("Writer queue depth:       %lu (max used %0.0f) \n", outputAsync->GetDepth(),
+             ws.maxdepth);
+      printf("Writer batches:           %0.0f (%0.1f events / batch) \n", ws.batches,
+             ws.written / std::max(1.0, ws.batches));
+      printf("Writer queue full stalls: %0.0f (%0.3f sec) \n", ws.stalls, ws.stalltime);
+    }
     gra::aux::PrintBar("=");
     std::cout << std::endl;
   }
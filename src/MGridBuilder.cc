@@ -0,0 +1,70 @@
+// Bounded task-parallel construction of interpolation grids
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+
+// Own
+#include "Graniitti/MAux.h"
+#include "Graniitti/MGlobals.h"
+#include "Graniitti/MGridBuilder.h"
+#include "Graniitti/MThreadPool.h"
+
+namespace gra {
+
+MGridBuilder::MGridBuilder(unsigned int threads, std::size_t chunk) : CHUNK(chunk) {
+  THREADS = (threads > 0) ? threads : gra::GRIDCORES;
+  THREADS = std::max(1u, THREADS);
+}
+
+void MGridBuilder::Run(std::size_t N, const std::function<void(std::size_t)> &task,
+                       bool progress) {
+  RunWorkers(N, [&](std::size_t k, unsigned int) { task(k); }, progress);
+}
+
+void MGridBuilder::RunWorkers(std::size_t                                          N,
+                              const std::function<void(std::size_t, unsigned int)> &task,
+                              bool                                                 progress) {
+  if (N == 0) { return; }
+
+  // No more threads than nodes
+  const unsigned int NT = std::min((std::size_t)THREADS, N);
+
+  // Several chunks per thread for load balance, but not too small
+  const std::size_t chunk = (CHUNK > 0) ? CHUNK : std::max((std::size_t)1, N / (16 * NT));
+
+  std::atomic<std::size_t> next{0};
+  std::atomic<std::size_t> done{0};
+
+  auto worker = [&](unsigned int tid) {
+    while (true) {
+      const std::size_t k0 = next.fetch_add(chunk);
+      if (k0 >= N) { break; }
+      const std::size_t k1 = std::min(N, k0 + chunk);
+
+      try {
+        for (std::size_t k = k0; k < k1; ++k) { task(k, tid); }
+      } catch (...) {
+        next = N;  // Stop handing out new chunks
+        throw;
+      }
+      const std::size_t ndone = done.fetch_add(k1 - k0) + (k1 - k0);
+
+      if (progress && tid == 0) { gra::aux::PrintProgress(ndone / static_cast<double>(N)); }
+    }
+  };
+
+  if (NT == 1) {
+    worker(0);
+  } else {
+    MThreadPool pool(NT);
+    pool.Run(worker);  // Rethrows task exceptions
+  }
+  if (progress) { gra::aux::ClearProgress(); }
+}
+
+}  // namespace gra
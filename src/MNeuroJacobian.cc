@@ -0,0 +1,367 @@
+// NeuroJacobian neural importance sampler
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+// Own
+#include "Graniitti/MAux.h"
+#include "Graniitti/MNeuroJacobian.h"
+
+using gra::aux::BinaryGet;
+using gra::aux::BinaryGetString;
+using gra::aux::BinaryPut;
+using gra::aux::BinaryPutString;
+
+using Eigen::ArrayXXd;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+namespace gra {
+namespace neurojac {
+
+namespace {
+
+constexpr char          MAGIC[8] = {'G', 'R', 'A', 'N', 'E', 'U', 'R', 'O'};
+constexpr std::uint32_t VERSION  = 1;
+
+const double LOG2PI = std::log(2.0 * M_PI);
+
+// Conditioner network outputs of one layer for a batch
+struct Cond {
+  MatrixXd C;   // Masked input
+  MatrixXd H;   // Hidden activations
+  MatrixXd T2;  // tanh of the log-scale pre-activation
+  ArrayXXd S;   // Log-scale
+  ArrayXXd T;   // Translation
+};
+
+void Conditioner(const CouplingLayer &l, const MatrixXd &X, Cond &c) {
+  const VectorXd n = VectorXd::Ones(l.mask.size()) - l.mask;
+
+  c.C = l.mask.asDiagonal() * X;
+  c.H = ((l.W1 * c.C).colwise() + l.b1).array().tanh().matrix();
+  c.T2 = ((l.W2 * c.H).colwise() + l.b2).array().tanh().matrix();
+  c.S  = (n.asDiagonal() * (MNeuroFlow::SMAX * c.T2)).array();
+  c.T  = (n.asDiagonal() * ((l.W3 * c.H).colwise() + l.b3)).array();
+}
+
+// Standard normal log-density summed over rows
+VectorXd LogNormal(const MatrixXd &Z) {
+  return (-0.5 * Z.array().square() - 0.5 * LOG2PI).colwise().sum().transpose();
+}
+
+}  // namespace
+
+void MNeuroFlow::Init(unsigned int D_, const NEUROPARAM &param, MRandom &random) {
+  if (D_ == 0 || param.LAYERS == 0 || param.HIDDEN == 0) {
+    throw std::invalid_argument("MNeuroFlow::Init: Dimension, LAYERS and HIDDEN must be > 0");
+  }
+  D = D_;
+  H = param.HIDDEN;
+  L.clear();
+
+  // With zero output layers, each coupling is the identity and q(u) = 1
+  const double sigma = 1.0 / std::sqrt(static_cast<double>(D));
+  for (std::size_t k = 0; k < param.LAYERS; ++k) {
+    CouplingLayer l;
+    l.mask = VectorXd::Zero(D);
+    for (std::size_t i = 0; i < D; ++i) { l.mask[i] = (i + k) % 2; }
+
+    // One dimensional case: alternate identity and full affine
+    if (D == 1) { l.mask[0] = 0.0; }
+
+    l.W1 = MatrixXd(H, D);
+    l.b1 = VectorXd(H);
+    for (std::size_t i = 0; i < H; ++i) {
+      for (std::size_t j = 0; j < D; ++j) { l.W1(i, j) = random.G(0, sigma); }
+      l.b1[i] = random.G(0, 0.1);
+    }
+    l.W2 = MatrixXd::Zero(D, H);
+    l.b2 = VectorXd::Zero(D);
+    l.W3 = MatrixXd::Zero(D, H);
+    l.b3 = VectorXd::Zero(D);
+    L.push_back(l);
+  }
+}
+
+void MNeuroFlow::Forward(const MatrixXd &Z, MatrixXd &Y, MatrixXd &U, VectorXd &invq) const {
+  VectorXd logq = LogNormal(Z);
+
+  Cond     c;
+  MatrixXd A = Z;
+  for (const auto &l : L) {
+    Conditioner(l, A, c);
+    // Conditioner rows have s = t = 0, i.e. they pass through
+    A = (A.array() * c.S.exp() + c.T).matrix();
+    logq -= c.S.colwise().sum().transpose().matrix();
+  }
+  Y = A;
+
+  // Gaussian CDF to the unit hypercube
+  U = Y.unaryExpr([](double y) { return 0.5 * std::erfc(-y * M_SQRT1_2); });
+  logq -= LogNormal(Y);
+
+  invq = (-logq.array()).exp().matrix();
+}
+
+void MNeuroFlow::LogDensity(const MatrixXd &Y, VectorXd &logq) const {
+  logq = -LogNormal(Y);
+
+  Cond     c;
+  MatrixXd O = Y;
+  for (std::size_t k = L.size(); k-- > 0;) {
+    Conditioner(L[k], O, c);
+    O = ((O.array() - c.T) * (-c.S).exp()).matrix();
+    logq -= c.S.colwise().sum().transpose().matrix();
+  }
+  logq += LogNormal(O);
+}
+
+void MNeuroFlow::Gradient(const MatrixXd &Y, const VectorXd &w,
+                          std::vector<CouplingLayer> &grad) const {
+  const std::size_t NL = L.size();
+
+  // Inverse pass, with the intermediates of each layer
+  std::vector<Cond>     c(NL);
+  std::vector<ArrayXXd> A(NL);  // Layer inputs (z-side)
+  std::vector<ArrayXXd> E(NL);  // exp(-s)
+  MatrixXd              O = Y;
+  for (std::size_t k = NL; k-- > 0;) {
+    Conditioner(L[k], O, c[k]);
+    E[k] = (-c[k].S).exp();
+    A[k] = (O.array() - c[k].T) * E[k];
+    O    = A[k].matrix();
+  }
+
+  // Zero gradient
+  grad = L;
+  for (auto &g : grad) {
+    g.W1.setZero();
+    g.b1.setZero();
+    g.W2.setZero();
+    g.b2.setZero();
+    g.W3.setZero();
+    g.b3.setZero();
+  }
+
+  // Backpropagation of sum_i w_i log q_i, from the prior upwards
+  const ArrayXXd W  = w.transpose().replicate(Y.rows(), 1).array();
+  ArrayXXd       GA = -A[0] * W;
+
+  for (std::size_t k = 0; k < NL; ++k) {
+    const CouplingLayer &l = L[k];
+    CouplingLayer &      g = grad[k];
+    const ArrayXXd       m = l.mask.replicate(1, Y.cols()).array();
+    const ArrayXXd       n = 1.0 - m;
+
+    // a = (o - t) exp(-s), log q -= sum s
+    const ArrayXXd GS = (-GA * A[k] - W) * n;
+    const ArrayXXd GT = -GA * E[k] * n;
+    ArrayXXd       GO = GA * E[k];
+
+    const MatrixXd GP2 = (GS * SMAX * (1.0 - c[k].T2.array().square())).matrix();
+    const MatrixXd GP3 = GT.matrix();
+    g.W2 += GP2 * c[k].H.transpose();
+    g.b2 += GP2.rowwise().sum();
+    g.W3 += GP3 * c[k].H.transpose();
+    g.b3 += GP3.rowwise().sum();
+
+    const MatrixXd GP1 =
+        ((l.W2.transpose() * GP2 + l.W3.transpose() * GP3).array() *
+         (1.0 - c[k].H.array().square()))
+            .matrix();
+    g.W1 += GP1 * c[k].C.transpose();
+    g.b1 += GP1.rowwise().sum();
+
+    GO += m * (l.W1.transpose() * GP1).array();
+    GA = GO;
+  }
+}
+
+VectorXd MNeuroFlow::Pack(const std::vector<CouplingLayer> &layers) const {
+  std::size_t N = 0;
+  for (const auto &l : layers) {
+    N += l.W1.size() + l.b1.size() + l.W2.size() + l.b2.size() + l.W3.size() + l.b3.size();
+  }
+  VectorXd    theta(N);
+  std::size_t i   = 0;
+  auto        put = [&](const double *x, std::size_t n) {
+    theta.segment(i, n) = Eigen::Map<const VectorXd>(x, n);
+    i += n;
+  };
+  for (const auto &l : layers) {
+    put(l.W1.data(), l.W1.size());
+    put(l.b1.data(), l.b1.size());
+    put(l.W2.data(), l.W2.size());
+    put(l.b2.data(), l.b2.size());
+    put(l.W3.data(), l.W3.size());
+    put(l.b3.data(), l.b3.size());
+  }
+  return theta;
+}
+
+void MNeuroFlow::Unpack(const VectorXd &theta, std::vector<CouplingLayer> &layers) const {
+  std::size_t i   = 0;
+  auto        get = [&](double *x, std::size_t n) {
+    if (i + n > (std::size_t)theta.size()) {
+      throw std::invalid_argument("MNeuroFlow::Unpack: Parameter vector too short");
+    }
+    Eigen::Map<VectorXd>(x, n) = theta.segment(i, n);
+    i += n;
+  };
+  for (auto &l : layers) {
+    get(l.W1.data(), l.W1.size());
+    get(l.b1.data(), l.b1.size());
+    get(l.W2.data(), l.W2.size());
+    get(l.b2.data(), l.b2.size());
+    get(l.W3.data(), l.W3.size());
+    get(l.b3.data(), l.b3.size());
+  }
+}
+
+void MNeuroFlow::Train(const Integrand &f, const NEUROPARAM &param, MRandom &random,
+                       bool silent) {
+  if (!IsInitialized()) {
+    throw std::invalid_argument("MNeuroFlow::Train: Flow not initialized");
+  }
+  const unsigned int B = param.BATCH;
+
+  // Adam optimizer state
+  VectorXd         theta = Pack(L);
+  VectorXd         mom   = VectorXd::Zero(theta.size());
+  VectorXd         vel   = VectorXd::Zero(theta.size());
+  constexpr double beta1 = 0.9;
+  constexpr double beta2 = 0.999;
+  constexpr double eps   = 1e-8;
+
+  MatrixXd                   Z(D, B);
+  MatrixXd                   Y;
+  MatrixXd                   U;
+  VectorXd                   invq;
+  VectorXd                   F(B);
+  std::vector<CouplingLayer> grad;
+
+  if (!silent) {
+    std::cout << "MNeuroFlow::Train: D = " << D << ", LAYERS = " << L.size()
+              << ", HIDDEN = " << H << ", BATCH = " << B << ", ITER = " << param.ITER
+              << std::endl;
+  }
+
+  for (std::size_t it = 0; it < param.ITER; ++it) {
+    for (std::size_t j = 0; j < B; ++j) {
+      for (std::size_t i = 0; i < D; ++i) { Z(i, j) = random.G(0, 1); }
+    }
+    Forward(Z, Y, U, invq);
+    f(U, F);
+
+    // Importance weights f/q, normalized
+    const VectorXd W    = F.cwiseProduct(invq);
+    const double   sumW = W.sum();
+
+    if (!silent && (it % 10 == 0 || it == param.ITER - 1)) {
+      const double mu  = sumW / B;
+      const double var = W.squaredNorm() / B - mu * mu;
+      printf("iter = %4lu :: <f/q> = %0.4E, std(f/q)/<f/q> = %0.3f \n", it, mu,
+             (mu > 0) ? std::sqrt(std::max(0.0, var)) / mu : 0.0);
+    }
+    if (!(sumW > 0) || !std::isfinite(sumW)) { continue; }
+
+    // Ascent on sum_i w_i log q(u_i) [gradient of -KL(f||q)]
+    Gradient(Y, W / sumW, grad);
+    const VectorXd g = Pack(grad);
+    if (!g.allFinite()) { continue; }
+
+    mom = beta1 * mom + (1.0 - beta1) * g;
+    vel = beta2 * vel + (1.0 - beta2) * g.cwiseAbs2();
+    const double c1 = 1.0 - std::pow(beta1, it + 1);
+    const double c2 = 1.0 - std::pow(beta2, it + 1);
+    theta += param.LR * ((mom / c1).array() / ((vel / c2).array().sqrt() + eps)).matrix();
+    Unpack(theta, L);
+  }
+}
+
+void MNeuroFlow::Write(const std::string &filename, const std::string &key) const {
+  aux::WriteFileAtomic(filename, [&](std::ostream &f) {
+    f.write(MAGIC, sizeof(MAGIC));
+    BinaryPut(f, VERSION);
+    BinaryPutString(f, key);
+
+    BinaryPut(f, static_cast<std::uint32_t>(D));
+    BinaryPut(f, static_cast<std::uint32_t>(H));
+    BinaryPut(f, static_cast<std::uint32_t>(L.size()));
+    for (const auto &l : L) {
+      f.write(reinterpret_cast<const char *>(l.mask.data()), D * sizeof(double));
+    }
+    const VectorXd theta = Pack(L);
+    BinaryPut(f, static_cast<std::uint64_t>(theta.size()));
+    f.write(reinterpret_cast<const char *>(theta.data()), theta.size() * sizeof(double));
+  });
+}
+
+bool MNeuroFlow::Read(const std::string &filename, const std::string &key) {
+  std::ifstream f(filename, std::ios::in | std::ios::binary);
+  if (!f.is_open()) { return false; }
+
+  try {
+    char magic[8] = {0};
+    f.read(magic, sizeof(magic));
+    if (!f || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+      throw std::runtime_error("not a NEURO flow file");
+    }
+    std::uint32_t version = 0;
+    BinaryGet(f, version);
+    if (version != VERSION) {
+      throw std::runtime_error("version " + std::to_string(version) + " (expected " +
+                               std::to_string(VERSION) + ")");
+    }
+    std::string filekey;
+    BinaryGetString(f, filekey);
+    if (filekey != key) { throw std::runtime_error("key mismatch"); }
+
+    std::uint32_t D_ = 0, H_ = 0, NL = 0;
+    BinaryGet(f, D_);
+    BinaryGet(f, H_);
+    BinaryGet(f, NL);
+    if (D_ == 0 || H_ == 0 || NL == 0 || (std::uint64_t)D_ * H_ * NL > aux::BINARY_MAXLEN) {
+      throw std::runtime_error("corrupted dimensions");
+    }
+
+    // Allocate the layout and fill it
+    MRandom    dummy;
+    NEUROPARAM param;
+    param.LAYERS = NL;
+    param.HIDDEN = H_;
+    Init(D_, param, dummy);
+    for (auto &l : L) {
+      f.read(reinterpret_cast<char *>(l.mask.data()), D * sizeof(double));
+      if (!f) { throw std::runtime_error("unexpected end of file"); }
+    }
+    std::uint64_t n = 0;
+    BinaryGet(f, n);
+    if (n != (std::uint64_t)Pack(L).size()) {
+      throw std::runtime_error("parameter count does not match the layout");
+    }
+    VectorXd theta(n);
+    f.read(reinterpret_cast<char *>(theta.data()), n * sizeof(double));
+    if (!f) { throw std::runtime_error("unexpected end of file"); }
+    Unpack(theta, L);
+
+  } catch (const std::runtime_error &e) {
+    std::cout << "MNeuroFlow::Read: Invalid flow " << filename << " (" << e.what() << ")"
+              << std::endl;
+    L.clear();
+    return false;
+  }
+  return true;
+}
+
+}  // namespace neurojac
+}  // namespace gra
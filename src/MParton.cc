@@ -77,6 +77,9 @@ void MParton::post_Constructor() {
     }
   }
 
+  // Photon PDF, each process copy (thread) then loads its own
+  if (ProcPtr.ISTATE == "yy_LUX") { lts.GlobalPdf.Init(lts.LHAPDFSET); }
+
   // Set sampling boundaries
   SetTechnicalBoundaries(gcuts, EXCITATION);
 
@@ -145,7 +148,7 @@ double MParton::EventWeight(const std::vector<double> &randvec, AuxIntData &aux)
 bool MParton::FiducialCuts() const { return CommonCuts(); }
 
 // Record event
-bool MParton::EventRecord(HepMC3::GenEvent &evt) { return CommonRecord(evt); }
+bool MParton::EventRecord(MEventRecord &evt) { return CommonRecord(evt); }
 
 void MParton::PrintInit(bool silent) const {
   if (!silent) {
@@ -69,6 +69,16 @@ void MProcess::PrintSetup() const {
   std::cout << rang::style::bold << "Subprocess parameters:" << rang::style::reset << std::endl
             << std::endl;
   std::cout << "- Pomeron loop screening:  " << std::boolalpha << SCREENING << std::endl;
+  if (SCREENING) {
+    const MEikonalNumerics &num = Eikonal.Numerics;
+    if (num.LoopAdaptive) {
+      printf("- Loop integration:        adaptive (rtol = %0.1E, max calls = %u)\n", num.LoopRelTol,
+             num.LoopMaxCalls);
+    } else {
+      printf("- Loop integration:        fixed grid (%u x %u)\n", num.NumberLoopPHI,
+             num.NumberLoopKT);
+    }
+  }
 
   // All other than inclusive processes
   if (ProcPtr.ISTATE != "X") {
@@ -159,7 +169,9 @@ double MProcess::S3ScreenedAmp2() {
   if (SCREENING == false) { return ProcPtr.GetBareAmplitude2(lts); }
 
   // Elastic scattering, return directly eikonalized amplitude squared itself
-  if (ProcPtr.CHANNEL == "EL") { return abs2(Eikonal.MSA.Interpolate1D(-lts.t)); }
+  if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::EL) {
+    return abs2(Eikonal.MSA.Interpolate1D(-lts.t));
+  }
 
   // --------------------------------------------------------------------
   // First evaluate bare amplitudes to lts.hamp
@@ -172,34 +184,18 @@ double MProcess::S3ScreenedAmp2() {
   }
 
   // Save born amplitudes
-  const std::vector<std::complex<double>> hamp_0 = lts.hamp;
+  loop_hamp0 = lts.hamp;
   // --------------------------------------------------------------------
 
   // Proton pt vectors
-  const std::vector<double> p1T = {lts.pfinal[1].Px(), lts.pfinal[1].Py()};
-  const std::vector<double> p2T = {lts.pfinal[2].Px(), lts.pfinal[2].Py()};
+  loop_p1T[0] = lts.pfinal[1].Px();
+  loop_p1T[1] = lts.pfinal[1].Py();
+  loop_p2T[0] = lts.pfinal[2].Px();
+  loop_p2T[1] = lts.pfinal[2].Py();
 
   // Save old kinematics
   lts.pfinal_orig = lts.pfinal;
 
-  // @@ C++11 handles multithreaded static initialization @@
-  // Discretization steps
-  const static double StepKT =
-      (Eikonal.Numerics.MaxLoopKT - Eikonal.Numerics.MinLoopKT) / Eikonal.Numerics.NumberLoopKT;
-  const double        MinPhi  = 0.0;
-  const double        MaxPhi  = 2.0 * gra::math::PI;
-  const static double StepPhi = (MaxPhi - MinPhi) / Eikonal.Numerics.NumberLoopPHI;
-
-  // Init 2D-Simpson weight matrix (will be calculated only once, being
-  // static)
-  const static MMatrix<double> WSimpson =
-      gra::math::Simpson38Weight2D(Eikonal.Numerics.NumberLoopPHI, Eikonal.Numerics.NumberLoopKT);
-
-  // NOTE N + 1, init with zero!
-  std::vector<MMatrix<std::complex<double>>> f_hamp(
-      lts.hamp.size(), MMatrix<std::complex<double>>(Eikonal.Numerics.NumberLoopPHI + 1,
-                                                     Eikonal.Numerics.NumberLoopKT + 1, 0.0));
-
   // 2D-integral
   //
   // \int d^2kt A_eik(kt^2) A(kt1,kt2)
@@ -214,63 +210,30 @@ double MProcess::S3ScreenedAmp2() {
   //        *6
   //
 
-  for (std::size_t i = 0; i < Eikonal.Numerics.NumberLoopPHI + 1; ++i) {
-    const double phi = MinPhi + i * StepPhi;
-
-    for (std::size_t j = 0; j < Eikonal.Numerics.NumberLoopKT + 1; ++j) {
-      const double kt  = Eikonal.Numerics.MinLoopKT + j * StepKT;
-      const double kt2 = gra::math::pow2(kt);
-
-      // -------------------------------------------------------------------
-
-      // Get screening amplitude
-      // (compiler will optimize this outside the loop)
-      const std::complex<double> A_eik = Eikonal.MSA.Interpolate1D(kt2);
-
-      // 0. Construct loop 2D kT-vector
-      const std::vector<double> kt_{kt * std::cos(phi), kt * std::sin(phi)};
-
-      // 1. New proton pt vectors
-      const std::vector<double> p1p = {p1T[0] - kt_[0], p1T[1] - kt_[1]};
-      const std::vector<double> p2p = {p2T[0] + kt_[0], p2T[1] + kt_[1]};
-
-      // 2. Update kinematics
-      if (!LoopKinematics(p1p, p2p)) {
-        continue;  // not valid kinematically
-      }
-
-      // 3. Get new amplitudes to lts.hamp
-      ProcPtr.GetBareAmplitude2(lts);
-      // -------------------------------------------------------------------
-
-      // Loop over all helicity amplitudes
-      for (const auto &h : indices(lts.hamp)) {
-        f_hamp[h][i][j] = A_eik * lts.hamp[h] * kt;  // note x kt (jacobian)
-      }
-    }  // inner-loop
-  }    // outer-loop
+  if (LOOPCONTEXT) { ProcPtr.LoopBegin(lts); }
+  if (Eikonal.Numerics.LoopAdaptive) {
+    S3AdaptiveLoop();
+  } else {
+    S3FixedLoop();
+  }
+  ProcPtr.LoopEnd();
+  loop_events += 1.0;
 
   // Normalization
   const std::complex<double> norm = zi / (8.0 * gra::math::PIPI * lts.s);
-
-  // Loop over amplitudes
-  std::vector<std::complex<double>> hamp_loop(lts.hamp.size(), 0.0);
-
-  for (const auto &h : indices(lts.hamp)) {
-    hamp_loop[h] = norm * gra::math::Simpson38Integral2D(f_hamp[h], WSimpson, StepPhi, StepKT);
-  }
+  for (const auto &h : indices(loop_hamp)) { loop_hamp[h] *= norm; }
 
   // Update back to tree level kinematics
-  LoopKinematics(p1T, p2T);
+  LoopKinematics(loop_p1T, loop_p2T);
 
   // ------------------------------------------------------------
   // Final amplitude (squared)
 
   // Not Durham-QCD
-  if (ProcPtr.ISTATE != "gg") {
+  if (!ProcPtr.DURHAM) {
     // Separate (incoherent) sum
     double amp2 = 0.0;
-    for (const auto &h : indices(lts.hamp)) { amp2 += abs2(hamp_0[h] + hamp_loop[h]); }
+    for (const auto &h : indices(lts.hamp)) { amp2 += abs2(loop_hamp0[h] + loop_hamp[h]); }
 
     // Initial state helicity average, if we have all helicity amplitudes
     if (lts.hamp.size() != 1) { amp2 /= 4; }
@@ -280,7 +243,7 @@ double MProcess::S3ScreenedAmp2() {
   } else {
     // Coherent sum
     std::complex<double> A = 0.0;
-    for (const auto &h : indices(lts.hamp)) { A += hamp_0[h] + hamp_loop[h]; }
+    for (const auto &h : indices(lts.hamp)) { A += loop_hamp0[h] + loop_hamp[h]; }
     // Helicity average already taken care of
 
     return abs2(A);
@@ -288,6 +251,121 @@ double MProcess::S3ScreenedAmp2() {
 }
 
 
+// Screening loop integral over the fixed (phi,kt) grid, result to loop_hamp
+void MProcess::S3FixedLoop() {
+  // Loop kt-vectors and weights (re-build only if discretization changed)
+  if (!looptable.Match(Eikonal.Numerics)) { S3BuildLoopTable(); }
+
+  loop_hamp.assign(lts.hamp.size(), 0.0);
+
+  for (std::size_t k = 0; k < looptable.w.size(); ++k) {
+    // 1. New proton pt vectors
+    loop_p1p[0] = loop_p1T[0] - looptable.kx[k];
+    loop_p1p[1] = loop_p1T[1] - looptable.ky[k];
+    loop_p2p[0] = loop_p2T[0] + looptable.kx[k];
+    loop_p2p[1] = loop_p2T[1] + looptable.ky[k];
+
+    // 2. Update kinematics
+    if (!LoopKinematics(loop_p1p, loop_p2p)) {
+      continue;  // not valid kinematically
+    }
+
+    // 3. Get new amplitudes to lts.hamp
+    ProcPtr.GetBareAmplitude2(lts);
+    loop_calls += 1.0;
+    // -------------------------------------------------------------------
+
+    // Loop over all helicity amplitudes
+    for (const auto &h : indices(lts.hamp)) { loop_hamp[h] += looptable.w[k] * lts.hamp[h]; }
+  }
+}
+
+// Screening loop integral with adaptive cubature, result to loop_hamp
+//
+// Tolerance is relative to the loop integral itself or to the Born amplitude,
+// whichever is larger (the loop is a correction to the Born amplitude).
+void MProcess::S3AdaptiveLoop() {
+  const MEikonalNumerics &num = Eikonal.Numerics;
+  const std::size_t       NH  = loop_hamp0.size();
+
+  // Initial regions (phi, kt)
+  const unsigned int NPHI0 = 2;
+  const unsigned int NKT0  = 2;
+
+  const double norm = std::abs(zi / (8.0 * gra::math::PIPI * lts.s));
+  double       born = 0.0;
+  for (const auto &h : indices(loop_hamp0)) { born += std::abs(loop_hamp0[h]); }
+  const double abstol = num.LoopRelTol * born / norm;
+
+  // Integrand: A_eik(kt^2) x kt x A(kt1,kt2)
+  auto f = [&](double phi, double kt, std::complex<double> *out) {
+    const double kx = kt * std::cos(phi);
+    const double ky = kt * std::sin(phi);
+
+    loop_p1p[0] = loop_p1T[0] - kx;
+    loop_p1p[1] = loop_p1T[1] - ky;
+    loop_p2p[0] = loop_p2T[0] + kx;
+    loop_p2p[1] = loop_p2T[1] + ky;
+
+    if (!LoopKinematics(loop_p1p, loop_p2p)) {  // not valid kinematically
+      for (std::size_t h = 0; h < NH; ++h) { out[h] = 0.0; }
+      return;
+    }
+    ProcPtr.GetBareAmplitude2(lts);
+    loop_calls += 1.0;
+
+    const std::complex<double> w = Eikonal.MSA.Interpolate1D(pow2(kt)) * kt;
+    for (std::size_t h = 0; h < NH; ++h) { out[h] = w * lts.hamp[h]; }
+  };
+
+  double error = 0.0;
+  loop_cubature.Integrate(f, NH, 0.0, 2.0 * gra::math::PI, num.MinLoopKT, num.MaxLoopKT, NPHI0,
+                          NKT0, num.LoopRelTol, abstol, num.LoopMaxCalls, loop_hamp, error);
+}
+
+// Screening loop integration table
+//
+// The phi = 0 and phi = 2pi rows are the same loop kt-vectors,
+// their weights are merged. Zero weight points are dropped.
+void MProcess::S3BuildLoopTable() {
+  const MEikonalNumerics &num = Eikonal.Numerics;
+
+  const double StepKT  = (num.MaxLoopKT - num.MinLoopKT) / num.NumberLoopKT;
+  const double MinPhi  = 0.0;
+  const double MaxPhi  = 2.0 * gra::math::PI;
+  const double StepPhi = (MaxPhi - MinPhi) / num.NumberLoopPHI;
+
+  // 2D-Simpson weights with the step factors of Simpson38Integral2D
+  const MMatrix<double> WSimpson = gra::math::Simpson38Weight2D(num.NumberLoopPHI, num.NumberLoopKT);
+  const double          STEPW    = 9 * (StepPhi * StepKT) / 64;
+
+  looptable = MLoopTable();
+  looptable.NKT   = num.NumberLoopKT;
+  looptable.NPHI  = num.NumberLoopPHI;
+  looptable.MinKT = num.MinLoopKT;
+  looptable.MaxKT = num.MaxLoopKT;
+
+  for (std::size_t i = 0; i < num.NumberLoopPHI; ++i) {
+    const double phi = MinPhi + i * StepPhi;
+
+    for (std::size_t j = 0; j < num.NumberLoopKT + 1; ++j) {
+      const double kt = num.MinLoopKT + j * StepKT;
+
+      // Merge the periodic end point
+      double W = WSimpson[i][j];
+      if (i == 0) { W += WSimpson[num.NumberLoopPHI][j]; }
+
+      // Get screening amplitude, note x kt (jacobian)
+      const std::complex<double> w = STEPW * W * Eikonal.MSA.Interpolate1D(pow2(kt)) * kt;
+      if (w == 0.0) { continue; }
+
+      looptable.kx.push_back(kt * std::cos(phi));
+      looptable.ky.push_back(kt * std::sin(phi));
+      looptable.w.push_back(w);
+    }
+  }
+}
+
 // Set CMS energy and beam particle 4-vectors
 void MProcess::SetInitialState(const std::vector<std::string> &beam,
                                const std::vector<double> &     energy) {
@@ -1232,7 +1310,8 @@ bool MProcess::ConstructDecayKinematics(gra::MDecayBranch &branch) {
   // This leg has any daughters
   if (branch.legs.size() != 0) {
     // Generate decay product masses
-    std::vector<double> m(branch.legs.size(), 0.0);
+    std::vector<double> &m = decay_m;  // Member buffers, re-used at each level
+    m.assign(branch.legs.size(), 0.0);
     while (true) {
       for (const auto &i : indices(branch.legs)) {
         GetOffShellMass(branch.legs[i], branch.legs[i].m_offshell);
@@ -1247,8 +1326,8 @@ bool MProcess::ConstructDecayKinematics(gra::MDecayBranch &branch) {
     }
 
     // For now, keep always unweighted
-    const bool         UNWEIGHT = true;
-    std::vector<M4Vec> p;
+    const bool          UNWEIGHT = true;
+    std::vector<M4Vec> &p        = decay_p;
 
     // 2-body
     gra::kinematics::MCW w;
@@ -1283,18 +1362,47 @@ bool MProcess::ConstructDecayKinematics(gra::MDecayBranch &branch) {
 }
 
 
+// Decay tree phase space weights (used for checkpointing)
+void MProcess::GetDecayWeights(std::vector<double> &w) const {
+  w.clear();
+  for (const auto &i : indices(lts.decaytree)) { GetDecayWeights(lts.decaytree[i], w); }
+}
+
+void MProcess::GetDecayWeights(const gra::MDecayBranch &branch, std::vector<double> &w) const {
+  w.push_back(branch.W.GetW());
+  w.push_back(branch.W.GetW2());
+  w.push_back(branch.W.GetN());
+  for (const auto &i : indices(branch.legs)) { GetDecayWeights(branch.legs[i], w); }
+}
+
+void MProcess::SetDecayWeights(const std::vector<double> &w) {
+  std::size_t k = 0;
+  for (const auto &i : indices(lts.decaytree)) { SetDecayWeights(lts.decaytree[i], w, k); }
+  if (k != w.size()) {
+    throw std::invalid_argument("MProcess::SetDecayWeights: Decay tree does not match input");
+  }
+}
+
+void MProcess::SetDecayWeights(gra::MDecayBranch &branch, const std::vector<double> &w,
+                               std::size_t &k) {
+  if (k + 3 > w.size()) {
+    throw std::invalid_argument("MProcess::SetDecayWeights: Decay tree does not match input");
+  }
+  branch.W = gra::kinematics::MCW(w[k], w[k + 1], w[k + 2]);
+  k += 3;
+  for (const auto &i : indices(branch.legs)) { SetDecayWeights(branch.legs[i], w, k); }
+}
+
 // Recursively add final states to the event structure
-void MProcess::WriteDecayKinematics(const gra::MDecayBranch &     branch,
-                                    const HepMC3::GenParticlePtr &mother, HepMC3::GenEvent &evt) {
+void MProcess::WriteDecayKinematics(const gra::MDecayBranch &branch, int mother,
+                                    MEventRecord &evt) {
   // This particle has daughters
   if (branch.legs.size() > 0) {
     // Create new vertex with decay 4-position
-    HepMC3::GenVertexPtr vertex =
-        std::make_shared<HepMC3::GenVertex>(gra::aux::M4Vec2HepMC3(branch.decay_position));
-    evt.add_vertex(vertex);
+    const int vertex = evt.AddVertex(branch.decay_position);
 
     // The decaying particle
-    vertex->add_particle_in(mother);
+    evt.AddIn(vertex, mother);
 
     // Add daughters
     for (const auto &i : indices(branch.legs)) {
@@ -1303,9 +1411,8 @@ void MProcess::WriteDecayKinematics(const gra::MDecayBranch &     branch,
       // ADD HERE THE ctau > 1.0 cm definition for the status
       // code [TBD]
 
-      HepMC3::GenParticlePtr particle = std::make_shared<HepMC3::GenParticle>(
-          gra::aux::M4Vec2HepMC3(branch.legs[i].p4), branch.legs[i].p.pdg, STATE);
-      vertex->add_particle_out(particle);
+      const int particle = evt.AddParticle(branch.legs[i].p4, branch.legs[i].p.pdg, STATE);
+      evt.AddOut(vertex, particle);
 
       // ** RECURSION here **
       WriteDecayKinematics(branch.legs[i], particle, evt);
@@ -1583,15 +1690,9 @@ bool MProcess::GetLorentzScalars(unsigned int Nf) {
   return true;
 }
 
-// Event output recording (to HepMC containers)
+// Event output recording (to the flat event record)
 //
-bool MProcess::CommonRecord(HepMC3::GenEvent &evt) {
-  // Initial states (4-momentum, pdg-id, status code)
-  HepMC3::GenParticlePtr gen_p1 = std::make_shared<HepMC3::GenParticle>(
-      gra::aux::M4Vec2HepMC3(lts.pbeam1), lts.beam1.pdg, PDG::PDG_BEAM);
-  HepMC3::GenParticlePtr gen_p2 = std::make_shared<HepMC3::GenParticle>(
-      gra::aux::M4Vec2HepMC3(lts.pbeam2), lts.beam2.pdg, PDG::PDG_BEAM);
-
+bool MProcess::CommonRecord(MEventRecord &evt) {
   // Final states (protons/excited system)
   int PDG_ID1 = lts.beam1.pdg;
   int PDG_ID2 = lts.beam2.pdg;
@@ -1608,60 +1709,45 @@ bool MProcess::CommonRecord(HepMC3::GenEvent &evt) {
     PDG_status2 = PDG::PDG_INTERMEDIATE;
   }
 
-  HepMC3::GenParticlePtr gen_p1f = std::make_shared<HepMC3::GenParticle>(
-      gra::aux::M4Vec2HepMC3(lts.pfinal[1]), PDG_ID1, PDG_status1);
-  HepMC3::GenParticlePtr gen_p2f = std::make_shared<HepMC3::GenParticle>(
-      gra::aux::M4Vec2HepMC3(lts.pfinal[2]), PDG_ID2, PDG_status2);
-
-  // -------------------------------------------------------------------
-
-  // Propagator 1 and 2
-  // it is ill-posed to try classify pomeron/gamma/gluon etc. here, thus,
-  // we tag only a generic propagator ID in the record
-  HepMC3::GenParticlePtr gen_q1 = std::make_shared<HepMC3::GenParticle>(
-      gra::aux::M4Vec2HepMC3(lts.q1), PDG::PDG_propagator, PDG::PDG_INTERMEDIATE);
-  HepMC3::GenParticlePtr gen_q2 = std::make_shared<HepMC3::GenParticle>(
-      gra::aux::M4Vec2HepMC3(lts.q2), PDG::PDG_propagator, PDG::PDG_INTERMEDIATE);
-
-  // -------------------------------------------------------------------
-
-  // Central system / resonance
-  HepMC3::GenParticlePtr gen_q = std::make_shared<HepMC3::GenParticle>(
-      gra::aux::M4Vec2HepMC3(lts.pfinal[0]), PDG::PDG_system, PDG::PDG_INTERMEDIATE);
-
   // ====================================================================
-  // Construct vertices
+  // Particles (4-momentum, pdg-id, status code) and vertices
 
   // Upper proton-propagator-proton
-  HepMC3::GenVertexPtr v1 = std::make_shared<HepMC3::GenVertex>();
-  v1->add_particle_in(gen_p1);
-  v1->add_particle_out(gen_p1f);
-  v1->add_particle_out(gen_q1);
+  //
+  // Propagator 1 and 2:
+  // it is ill-posed to try classify pomeron/gamma/gluon etc. here, thus,
+  // we tag only a generic propagator ID in the record
+  const int v1      = evt.AddVertex();
+  const int gen_p1  = evt.AddParticle(lts.pbeam1, lts.beam1.pdg, PDG::PDG_BEAM);
+  const int gen_p1f = evt.AddParticle(lts.pfinal[1], PDG_ID1, PDG_status1);
+  const int gen_q1  = evt.AddParticle(lts.q1, PDG::PDG_propagator, PDG::PDG_INTERMEDIATE);
+  evt.AddIn(v1, gen_p1);
+  evt.AddOut(v1, gen_p1f);
+  evt.AddOut(v1, gen_q1);
 
   // Lower proton-propagator-proton
-  HepMC3::GenVertexPtr v2 = std::make_shared<HepMC3::GenVertex>();
-  v2->add_particle_in(gen_p2);
-  v2->add_particle_out(gen_p2f);
-  v2->add_particle_out(gen_q2);
-
-  // Propagator-Propagator-System vertex
-  HepMC3::GenVertexPtr v3 = std::make_shared<HepMC3::GenVertex>();
-  v3->add_particle_in(gen_q1);
-  v3->add_particle_in(gen_q2);
-  v3->add_particle_out(gen_q);
-
-  evt.add_vertex(v1);
-  evt.add_vertex(v2);
-  evt.add_vertex(v3);
+  const int v2      = evt.AddVertex();
+  const int gen_p2  = evt.AddParticle(lts.pbeam2, lts.beam2.pdg, PDG::PDG_BEAM);
+  const int gen_p2f = evt.AddParticle(lts.pfinal[2], PDG_ID2, PDG_status2);
+  const int gen_q2  = evt.AddParticle(lts.q2, PDG::PDG_propagator, PDG::PDG_INTERMEDIATE);
+  evt.AddIn(v2, gen_p2);
+  evt.AddOut(v2, gen_p2f);
+  evt.AddOut(v2, gen_q2);
+
+  // Propagator-Propagator-System vertex, central system / resonance
+  const int v3    = evt.AddVertex();
+  const int gen_q = evt.AddParticle(lts.pfinal[0], PDG::PDG_system, PDG::PDG_INTERMEDIATE);
+  evt.AddIn(v3, gen_q1);
+  evt.AddIn(v3, gen_q2);
+  evt.AddOut(v3, gen_q);
 
   // ====================================================================
   // System->Decay products vertex
 
-  HepMC3::GenVertexPtr v4 = std::make_shared<HepMC3::GenVertex>();
-  evt.add_vertex(v4);
+  const int v4 = evt.AddVertex();
 
   // Add resonance in
-  v4->add_particle_in(gen_q);
+  evt.AddIn(v4, gen_q);
 
   // Add direct daughters
   for (const auto &i : indices(lts.decaytree)) {
@@ -1680,9 +1766,8 @@ bool MProcess::CommonRecord(HepMC3::GenEvent &evt) {
       // ----------------------------------------------------------
     }
 
-    HepMC3::GenParticlePtr particle = std::make_shared<HepMC3::GenParticle>(
-        gra::aux::M4Vec2HepMC3(lts.decaytree[i].p4), lts.decaytree[i].p.pdg, STATE);
-    v4->add_particle_out(particle);
+    const int particle = evt.AddParticle(lts.decaytree[i].p4, lts.decaytree[i].p.pdg, STATE);
+    evt.AddOut(v4, particle);
 
     WriteDecayKinematics(lts.decaytree[i], particle, evt);
   }
@@ -1706,23 +1791,20 @@ bool MProcess::CommonRecord(HepMC3::GenEvent &evt) {
 }
 
 // Save branch to event with mother pX
-void MProcess::SaveBranch(HepMC3::GenEvent &evt, const gra::MDecayBranch &branch,
-                          const HepMC3::GenParticlePtr &pX) {
+void MProcess::SaveBranch(MEventRecord &evt, const gra::MDecayBranch &branch, int pX) {
   // Create vertex
-  HepMC3::GenVertexPtr vX = std::make_shared<HepMC3::GenVertex>();
-  evt.add_vertex(vX);
+  const int vX = evt.AddVertex();
 
   // Add mother in
-  vX->add_particle_in(pX);
+  evt.AddIn(vX, pX);
 
   // Add direct daughters
   for (const auto &i : indices(branch.legs)) {
     const int STATE = (branch.legs[i].legs.size() > 0) ? PDG::PDG_DECAY : PDG::PDG_STABLE;
     // TBD: ADD HERE THE ctau > 1.0 cm definition for the status code
 
-    HepMC3::GenParticlePtr particle = std::make_shared<HepMC3::GenParticle>(
-        gra::aux::M4Vec2HepMC3(branch.legs[i].p4), branch.legs[i].p.pdg, STATE);
-    vX->add_particle_out(particle);
+    const int particle = evt.AddParticle(branch.legs[i].p4, branch.legs[i].p.pdg, STATE);
+    evt.AddOut(vX, particle);
 
     WriteDecayKinematics(branch.legs[i], particle, evt);
   }
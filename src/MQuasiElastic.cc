@@ -64,10 +64,10 @@ MQuasiElastic::~MQuasiElastic() {}
 // Initialize cut and process spesific postsetup
 void MQuasiElastic::post_Constructor() {
   // Set phase space dimension
-  if (ProcPtr.CHANNEL == "EL") { ProcPtr.LIPSDIM = 1; };
-  if (ProcPtr.CHANNEL == "SD") { ProcPtr.LIPSDIM = 2; };
-  if (ProcPtr.CHANNEL == "DD") { ProcPtr.LIPSDIM = 3; };
-  if (ProcPtr.CHANNEL == "ND") { ProcPtr.LIPSDIM = 1; };  // Keep it 1
+  if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::EL) { ProcPtr.LIPSDIM = 1; };
+  if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::SD) { ProcPtr.LIPSDIM = 2; };
+  if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::DD) { ProcPtr.LIPSDIM = 3; };
+  if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::ND) { ProcPtr.LIPSDIM = 1; };  // Keep it 1
 
   Eikonal.Numerics.MaxLoopKT = 3.0;
 }
@@ -76,7 +76,7 @@ void MQuasiElastic::post_Constructor() {
 bool MQuasiElastic::FiducialCuts() const {
   if (fcuts.active == true) {
     // EL cuts
-    if (ProcPtr.CHANNEL == "EL") {
+    if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::EL) {
       if (fcuts.forward_t_min < std::abs(lts.t) && std::abs(lts.t) < fcuts.forward_t_max) {
         // fine
       } else {
@@ -85,7 +85,7 @@ bool MQuasiElastic::FiducialCuts() const {
     }
 
     // SD cuts
-    if (ProcPtr.CHANNEL == "SD") {
+    if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::SD) {
       if (lts.pfinal[1].M() > 1.0) {  // this one is excited system
         if (fcuts.forward_M_min < lts.pfinal[1].M() && lts.pfinal[1].M() < fcuts.forward_M_max &&
             fcuts.forward_t_min < std::abs(lts.t) && std::abs(lts.t) < fcuts.forward_t_max) {
@@ -104,7 +104,7 @@ bool MQuasiElastic::FiducialCuts() const {
     }
 
     // DD cuts
-    if (ProcPtr.CHANNEL == "DD") {
+    if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::DD) {
       if (fcuts.forward_M_min < lts.pfinal[1].M() && lts.pfinal[1].M() < fcuts.forward_M_max &&
           fcuts.forward_M_min < lts.pfinal[2].M() && lts.pfinal[2].M() < fcuts.forward_M_max &&
           fcuts.forward_t_min < std::abs(lts.t) && std::abs(lts.t) < fcuts.forward_t_max) {
@@ -160,7 +160,7 @@ bool MQuasiElastic::LoopKinematics(const std::vector<double> &p1p, const std::ve
 double MQuasiElastic::EventWeight(const std::vector<double> &randvec, AuxIntData &aux) {
   double W = 0.0;
 
-  if (ProcPtr.CHANNEL != "ND") {  // Diffractive
+  if (ProcPtr.CHANNEL_ID != MSubProc::ECHANNEL::ND) {  // Diffractive
 
     aux.kinematics_ok = B3RandomKin(randvec);
     aux.fidcuts_ok    = FiducialCuts();
@@ -208,27 +208,22 @@ double MQuasiElastic::EventWeight(const std::vector<double> &randvec, AuxIntData
   return W;
 }
 
-// Record HepMC3 event
-bool MQuasiElastic::EventRecord(HepMC3::GenEvent &evt) {
+// Record event
+bool MQuasiElastic::EventRecord(MEventRecord &evt) {
   // Non-Diffractive
-  if (ProcPtr.CHANNEL == "ND") {
-    HepMC3::GenParticlePtr gen_p1;
-    HepMC3::GenParticlePtr gen_p2;
-    HepMC3::GenParticlePtr gen_p1f;
-    HepMC3::GenParticlePtr gen_p2f;
+  if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::ND) {
+    int gen_p1  = 0;
+    int gen_p2  = 0;
+    int gen_p1f = 0;
+    int gen_p2f = 0;
 
     // Loop over multiple "cut pomerons"
     for (const auto &i : indices(etree)) {
       if (i == 0) {  // First
 
         // Initial state protons (4-momentum, pdg-id, status code)
-        gen_p1 = std::make_shared<HepMC3::GenParticle>(
-            gra::aux::M4Vec2HepMC3(etree[i].p1i), (i == 0) ? lts.beam1.pdg : PDG::PDG_fragment,
-            (i == 0) ? PDG::PDG_BEAM : PDG::PDG_INTERMEDIATE);
-
-        gen_p2 = std::make_shared<HepMC3::GenParticle>(
-            gra::aux::M4Vec2HepMC3(etree[i].p2i), (i == 0) ? lts.beam2.pdg : PDG::PDG_fragment,
-            (i == 0) ? PDG::PDG_BEAM : PDG::PDG_INTERMEDIATE);
+        gen_p1 = evt.AddParticle(etree[i].p1i, lts.beam1.pdg, PDG::PDG_BEAM);
+        gen_p2 = evt.AddParticle(etree[i].p2i, lts.beam2.pdg, PDG::PDG_BEAM);
 
       } else {  // Others recursively
 
@@ -236,61 +231,51 @@ bool MQuasiElastic::EventRecord(HepMC3::GenEvent &evt) {
         gen_p2 = gen_p2f;
       }
 
-      // Final state (or intermediate in the chain) fragments
-      gen_p1f = std::make_shared<HepMC3::GenParticle>(gra::aux::M4Vec2HepMC3(etree[i].p1f),
-                                                      PDG::PDG_fragment, PDG::PDG_INTERMEDIATE);
-
-      gen_p2f = std::make_shared<HepMC3::GenParticle>(gra::aux::M4Vec2HepMC3(etree[i].p2f),
-                                                      PDG::PDG_fragment, PDG::PDG_INTERMEDIATE);
-
-      // Exchange objects
-      HepMC3::GenParticlePtr gen_q1 = std::make_shared<HepMC3::GenParticle>(
-          gra::aux::M4Vec2HepMC3(etree[i].q1), PDG::PDG_propagator, PDG::PDG_INTERMEDIATE);
-      HepMC3::GenParticlePtr gen_q2 = std::make_shared<HepMC3::GenParticle>(
-          gra::aux::M4Vec2HepMC3(etree[i].q2), PDG::PDG_propagator, PDG::PDG_INTERMEDIATE);
-
       // Virtual state
       M4Vec system4vec(etree[i].k.Px(), etree[i].k.Py(), etree[i].k.Pz(), etree[i].k.E());
 
-      HepMC3::GenParticlePtr gen_X = std::make_shared<HepMC3::GenParticle>(
-          gra::aux::M4Vec2HepMC3(system4vec), PDG::PDG_system, PDG::PDG_INTERMEDIATE);
-
-      HepMC3::GenVertexPtr vX = std::make_shared<HepMC3::GenVertex>();
+      int gen_X = 0;
 
       if (i != etree.size() - 1) {
+        // Final state (or intermediate in the chain) fragments
+        gen_p1f = evt.AddParticle(etree[i].p1f, PDG::PDG_fragment, PDG::PDG_INTERMEDIATE);
+        gen_p2f = evt.AddParticle(etree[i].p2f, PDG::PDG_fragment, PDG::PDG_INTERMEDIATE);
+
+        // Exchange objects
+        const int gen_q1 =
+            evt.AddParticle(etree[i].q1, PDG::PDG_propagator, PDG::PDG_INTERMEDIATE);
+        const int gen_q2 =
+            evt.AddParticle(etree[i].q2, PDG::PDG_propagator, PDG::PDG_INTERMEDIATE);
+
         // Upper vertex
-        HepMC3::GenVertexPtr vXUP = std::make_shared<HepMC3::GenVertex>();
-        vXUP->add_particle_in(gen_p1);
-        vXUP->add_particle_out(gen_p1f);
-        vXUP->add_particle_out(gen_q1);
+        const int vXUP = evt.AddVertex();
+        evt.AddIn(vXUP, gen_p1);
+        evt.AddOut(vXUP, gen_p1f);
+        evt.AddOut(vXUP, gen_q1);
 
         // Lower vertex
-        HepMC3::GenVertexPtr vXDO = std::make_shared<HepMC3::GenVertex>();
-        vXDO->add_particle_in(gen_p2);
-        vXDO->add_particle_out(gen_p2f);
-        vXDO->add_particle_out(gen_q2);
-
-        // Add vertices
-        evt.add_vertex(vXUP);
-        evt.add_vertex(vXDO);
+        const int vXDO = evt.AddVertex();
+        evt.AddIn(vXDO, gen_p2);
+        evt.AddOut(vXDO, gen_p2f);
+        evt.AddOut(vXDO, gen_q2);
 
         // Pomeron-Pomeron-Virtual state vertex
-        vX->add_particle_in(gen_q1);
-        vX->add_particle_in(gen_q2);
-        vX->add_particle_out(gen_X);
+        const int vX = evt.AddVertex();
+        gen_X        = evt.AddParticle(system4vec, PDG::PDG_system, PDG::PDG_INTERMEDIATE);
+        evt.AddIn(vX, gen_q1);
+        evt.AddIn(vX, gen_q2);
+        evt.AddOut(vX, gen_X);
 
       } else {  // Last MPI, fuse remnant + remnant -> system
 
         // Proton-Proton-Virtual state vertex
-        vX = std::make_shared<HepMC3::GenVertex>();
-        vX->add_particle_in(gen_p1);
-        vX->add_particle_in(gen_p2);
-        vX->add_particle_out(gen_X);
+        const int vX = evt.AddVertex();
+        gen_X        = evt.AddParticle(system4vec, PDG::PDG_system, PDG::PDG_INTERMEDIATE);
+        evt.AddIn(vX, gen_p1);
+        evt.AddIn(vX, gen_p2);
+        evt.AddOut(vX, gen_X);
       }
 
-      // Add vertex to the event
-      evt.add_vertex(vX);
-
       // -----------------------------------------------------------------
       // Quantum numbers distributed here
       int    B        = 0;  // Baryon number
@@ -324,17 +309,6 @@ bool MQuasiElastic::EventRecord(HepMC3::GenEvent &evt) {
 
   // Diffractive processes
 
-  // Initial states (4-momentum, pdg-id, status code)
-  HepMC3::GenParticlePtr gen_p1 = std::make_shared<HepMC3::GenParticle>(
-      gra::aux::M4Vec2HepMC3(lts.pbeam1), lts.beam1.pdg, PDG::PDG_BEAM);
-  HepMC3::GenParticlePtr gen_p2 = std::make_shared<HepMC3::GenParticle>(
-      gra::aux::M4Vec2HepMC3(lts.pbeam2), lts.beam2.pdg, PDG::PDG_BEAM);
-
-  // Propagator 4-vector and generator particle
-  M4Vec                  q1(lts.pbeam1 - lts.pfinal[1]);
-  HepMC3::GenParticlePtr gen_q1 = std::make_shared<HepMC3::GenParticle>(
-      gra::aux::M4Vec2HepMC3(q1), PDG::PDG_propagator, PDG::PDG_INTERMEDIATE);
-
   // Final state protons/excited systems
   int PDG_ID1     = lts.beam1.pdg;
   int PDG_ID2     = lts.beam2.pdg;
@@ -345,7 +319,7 @@ bool MQuasiElastic::EventRecord(HepMC3::GenEvent &evt) {
   // already fine
 
   // SD
-  if (ProcPtr.CHANNEL == "SD") {
+  if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::SD) {
     if (lts.excite1) {  // proton 1 excited
       PDG_ID1     = std::abs(PDG::PDG_NSTAR) * math::sign(lts.beam1.pdg);
       PDG_status1 = PDG::PDG_INTERMEDIATE;
@@ -355,35 +329,30 @@ bool MQuasiElastic::EventRecord(HepMC3::GenEvent &evt) {
     }
   }
   // DD
-  if (ProcPtr.CHANNEL == "DD") {
+  if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::DD) {
     PDG_ID1     = std::abs(PDG::PDG_NSTAR) * math::sign(lts.beam1.pdg);
     PDG_status1 = PDG::PDG_INTERMEDIATE;
     PDG_ID2     = std::abs(PDG::PDG_NSTAR) * math::sign(lts.beam2.pdg);
     PDG_status2 = PDG::PDG_INTERMEDIATE;
   }
 
-  HepMC3::GenParticlePtr gen_p1f = std::make_shared<HepMC3::GenParticle>(
-      gra::aux::M4Vec2HepMC3(lts.pfinal[1]), PDG_ID1, PDG_status1);
-  HepMC3::GenParticlePtr gen_p2f = std::make_shared<HepMC3::GenParticle>(
-      gra::aux::M4Vec2HepMC3(lts.pfinal[2]), PDG_ID2, PDG_status2);
-
-  // Construct vertices
-
-  // Upper proton-pomeron-proton
-  HepMC3::GenVertexPtr v1 = std::make_shared<HepMC3::GenVertex>();
-  v1->add_particle_in(gen_p1);
-  v1->add_particle_out(gen_p1f);
-  v1->add_particle_out(gen_q1);
+  // Upper proton-pomeron-proton (4-momentum, pdg-id, status code)
+  const M4Vec q1(lts.pbeam1 - lts.pfinal[1]);
+  const int   v1      = evt.AddVertex();
+  const int   gen_p1  = evt.AddParticle(lts.pbeam1, lts.beam1.pdg, PDG::PDG_BEAM);
+  const int   gen_p1f = evt.AddParticle(lts.pfinal[1], PDG_ID1, PDG_status1);
+  const int   gen_q1  = evt.AddParticle(q1, PDG::PDG_propagator, PDG::PDG_INTERMEDIATE);
+  evt.AddIn(v1, gen_p1);
+  evt.AddOut(v1, gen_p1f);
+  evt.AddOut(v1, gen_q1);
 
   // Lower proton-pomeron-proton
-  HepMC3::GenVertexPtr v2 = std::make_shared<HepMC3::GenVertex>();
-  v2->add_particle_in(gen_p2);
-  v2->add_particle_out(gen_p2f);
-  v2->add_particle_in(gen_q1);
-
-  // Finally add all vertices
-  evt.add_vertex(v1);
-  evt.add_vertex(v2);
+  const int v2      = evt.AddVertex();
+  const int gen_p2  = evt.AddParticle(lts.pbeam2, lts.beam2.pdg, PDG::PDG_BEAM);
+  const int gen_p2f = evt.AddParticle(lts.pfinal[2], PDG_ID2, PDG_status2);
+  evt.AddIn(v2, gen_p2);
+  evt.AddOut(v2, gen_p2f);
+  evt.AddIn(v2, gen_q1);
 
   // Upper proton excitation
   if (lts.excite1) {
@@ -415,12 +384,12 @@ void MQuasiElastic::PrintInit(bool silent) const {
     PrintSetup();
 
     // Diffractive processes
-    if (ProcPtr.CHANNEL != "ND") {
+    if (ProcPtr.CHANNEL_ID != MSubProc::ECHANNEL::ND) {
       std::string proton1 = "-----------EL--------->";
       std::string proton2 = "-----------EL--------->";
 
-      if (ProcPtr.CHANNEL == "SD") { proton1 = "-----------F2-xxxxxxxx>"; }
-      if (ProcPtr.CHANNEL == "DD") {
+      if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::SD) { proton1 = "-----------F2-xxxxxxxx>"; }
+      if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::DD) {
         proton1 = "-----------F2-xxxxxxxx>";
         proton2 = "-----------F2-xxxxxxxx>";
       }
@@ -445,7 +414,7 @@ void MQuasiElastic::PrintInit(bool silent) const {
       std::cout << rang::style::bold << "Generation cuts:" << rang::style::reset << std::endl
                 << std::endl;
 
-      if (ProcPtr.CHANNEL != "EL") {
+      if (ProcPtr.CHANNEL_ID != MSubProc::ECHANNEL::EL) {
         printf("- Xi  [min, max]   = [%0.3E, %0.3E] (Xi == M^2/s) \n", gcuts.XI_min, gcuts.XI_max);
       }
       printf("- |t| [max]        = %0.3f GeV^2 \n", pow2(Eikonal.Numerics.MaxLoopKT));
@@ -707,7 +676,7 @@ bool MQuasiElastic::B3RandomKin(const std::vector<double> &randvec) {
   lts.excite2 = false;
 
   // Sample diffractive system masses
-  if (ProcPtr.CHANNEL == "SD") {
+  if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::SD) {
     // Log-change of variable
     const double u = log_M2_f_min + (log_M2_f_max - log_M2_f_min) * randvec[1];
     const double r = std::exp(u);
@@ -722,7 +691,7 @@ bool MQuasiElastic::B3RandomKin(const std::vector<double> &randvec) {
       lts.excite1 = false;
       lts.excite2 = true;
     }
-  } else if (ProcPtr.CHANNEL == "DD") {
+  } else if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::DD) {
     // Log-change of variable
     const double u1 = log_M2_f_min + (log_M2_f_max - log_M2_f_min) * randvec[1];
     const double r1 = std::exp(u1);
@@ -840,17 +809,17 @@ double MQuasiElastic::B3IntegralVolume() const {
   const double B     = std::abs(t_min);
   const double t_VOL = (std::log(B + ZERO_EPS) - std::log(A + ZERO_EPS)) * std::abs(lts.t);
 
-  if (ProcPtr.CHANNEL == "EL") {
+  if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::EL) {
     return t_VOL;
 
-  } else if (ProcPtr.CHANNEL == "SD") {
+  } else if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::SD) {
     // Jacobian from log-change of variable:
     // \int_a^b f(M2) dM2 = \int_{ln(a)}^{ln(b)} f(exp(u)) * exp(u) du, where u = ln(M2)
     const double J      = (lts.excite1) ? lts.ss[1][1] : lts.ss[2][2];
     const double M2_VOL = (log_M2_f_max - log_M2_f_min) * J;
     return t_VOL * M2_VOL;
 
-  } else if (ProcPtr.CHANNEL == "DD") {
+  } else if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::DD) {
     // Jacobian from log-change of variables
     const double J      = lts.ss[1][1] * lts.ss[2][2];
     const double M2_VOL = (log_M2_f_max - log_M2_f_min) * (log_DD_M2_max - log_M2_f_min) * J;
@@ -868,15 +837,15 @@ double MQuasiElastic::B3PhaseSpaceWeight() const {
   const double norm = 16.0 * gra::math::PI *
                       pow2(lts.s * gra::kinematics::beta12(lts.s, lts.beam1.mass, lts.beam2.mass));
 
-  if (ProcPtr.CHANNEL == "EL") {
+  if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::EL) {
     return 1.0 / norm;
-  } else if (ProcPtr.CHANNEL == "SD") {
+  } else if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::SD) {
     return 2.0 / norm;  // Factor of two in
                         // numerator from single
                         // diffraction left + right
-  } else if (ProcPtr.CHANNEL == "DD") {
+  } else if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::DD) {
     return 1.0 / norm;
-  } else if (ProcPtr.CHANNEL == "ND") {
+  } else if (ProcPtr.CHANNEL_ID == MSubProc::ECHANNEL::ND) {
     return 1.0;
   } else {
     return 0;
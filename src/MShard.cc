@@ -0,0 +1,180 @@
+// Event generation shards
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+// Own
+#include "Graniitti/MAux.h"
+#include "Graniitti/MShard.h"
+
+// Libraries
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+namespace gra {
+
+void MShardStat::CrossSection(const std::array<double, 3> &s) {
+  sigma     = 0.0;
+  sigma_err = 0.0;
+  if (s[2] <= 0.0) { return; }
+
+  if (integrator == "VEGAS") {
+    // Inverse variance weighted iterations
+    sigma     = s[0] / s[2];
+    sigma_err = std::sqrt(1.0 / s[2]);
+  } else {
+    // Standard error of the mean
+    sigma                 = s[0] / s[2];
+    const double variance = s[1] / s[2] - sigma * sigma;
+    sigma_err             = (variance > 0.0) ? std::sqrt(variance / s[2]) : 0.0;
+  }
+}
+
+void MShardStat::Write(const std::string &filename) const {
+  json j;
+  j["SHARD"]      = shard;
+  j["SHARDS"]     = shards;
+  j["RNDSEED"]    = seed;
+  j["KEY"]        = key;
+  j["PROCESS"]    = process;
+  j["INTEGRATOR"] = integrator;
+  j["FORMAT"]     = format;
+  j["OUTPUT"]     = output;
+  j["CREATED"]    = created;
+  j["SQRTS"]      = sqrts;
+  j["WEIGHTED"]   = weighted;
+  j["EVENTS"]     = events;
+  j["TRIALS"]     = trials;
+  j["OVERFLOW"]   = overflow;
+  j["MAXWEIGHT"]  = maxweight;
+  j["SIGMA"]      = sigma;
+  j["SIGMA_ERR"]  = sigma_err;
+  j["BASE"]       = base;
+  j["SUMS"]       = sums;
+
+  // Doubles are written round-trip exact, so the shared base compares exactly
+  aux::WriteFileAtomic(filename, [&](std::ostream &f) { f << j.dump(2) << std::endl; });
+}
+
+bool MShardStat::Read(const std::string &filename) {
+  std::ifstream f(filename);
+  if (!f.is_open()) { return false; }
+
+  try {
+    json j;
+    f >> j;
+    shard      = j.at("SHARD");
+    shards     = j.at("SHARDS");
+    seed       = j.at("RNDSEED");
+    key        = j.at("KEY");
+    process    = j.at("PROCESS").get<std::string>();
+    integrator = j.at("INTEGRATOR").get<std::string>();
+    format     = j.at("FORMAT").get<std::string>();
+    output     = j.at("OUTPUT").get<std::string>();
+    created    = j.at("CREATED").get<std::string>();
+    sqrts      = j.at("SQRTS");
+    weighted   = j.at("WEIGHTED");
+    events     = j.at("EVENTS");
+    trials     = j.at("TRIALS");
+    overflow   = j.at("OVERFLOW");
+    maxweight  = j.at("MAXWEIGHT");
+    sigma      = j.at("SIGMA");
+    sigma_err  = j.at("SIGMA_ERR");
+    base       = j.at("BASE").get<std::array<double, 3>>();
+    sums       = j.at("SUMS").get<std::array<double, 3>>();
+  } catch (...) {
+    std::cout << "MShardStat::Read: Invalid shard statistics " << filename << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void MShardStat::Print() const {
+  printf("shard %4d / %-4d  events = %9.0f  eff = %0.3E  xs = %0.4E +- %0.4E barn  [%s] \n",
+         shard, shards, events, (trials > 0) ? events / trials : 0.0, sigma, sigma_err,
+         output.c_str());
+}
+
+std::string ShardSuffix(int shard, int shards) {
+  int digits = 4;
+  for (int n = shards - 1; n >= 10000; n /= 10) { ++digits; }
+  char buff[32];
+  snprintf(buff, sizeof(buff), "_shard%0*d", digits, shard);
+  return buff;
+}
+
+MShardStat MergeShards(const std::vector<MShardStat> &input, bool &shared_base) {
+  if (input.empty()) { throw std::invalid_argument("MergeShards: No input shards"); }
+
+  const MShardStat &first = input[0];
+  for (const auto &s : input) {
+    if (s.process != first.process || s.integrator != first.integrator ||
+        s.format != first.format || s.weighted != first.weighted ||
+        std::abs(s.sqrts - first.sqrts) > 1e-9 * first.sqrts) {
+      throw std::invalid_argument("MergeShards: Shard " + std::to_string(s.shard) +
+                                  " has a different process, integrator, format, sqrt(s) or "
+                                  "weighting than shard " + std::to_string(first.shard));
+    }
+  }
+
+  // Shared base: identical integration before the generation in each shard
+  shared_base = true;
+  for (const auto &s : input) {
+    if (s.key != first.key || s.base != first.base) { shared_base = false; }
+  }
+
+  // Independent bases must come from independent integrations. The integration
+  // random streams depend only on the seed, so shards with the same seed and
+  // checkpoint key integrated concurrently (before the checkpoint existed) with
+  // the same random numbers, and cannot be combined as independent estimates.
+  if (!shared_base) {
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      for (std::size_t j = i + 1; j < input.size(); ++j) {
+        if (input[i].key == input[j].key && input[i].seed == input[j].seed) {
+          throw std::invalid_argument(
+              "MergeShards: Shards " + std::to_string(input[i].shard) + " and " +
+              std::to_string(input[j].shard) +
+              " have the same seed and checkpoint key but not a shared integral base (correlated "
+              "integrations), create the checkpoint before starting the shards or use different "
+              "seeds");
+        }
+      }
+    }
+  }
+
+  MShardStat total = first;
+  total.shard      = 0;
+  total.shards     = 1;
+  total.output     = "";
+  total.events     = 0.0;
+  total.trials     = 0.0;
+  total.overflow   = 0.0;
+  total.maxweight  = 0.0;
+  total.sums       = {{0.0, 0.0, 0.0}};
+  if (shared_base) { total.sums = first.base; }
+
+  for (const auto &s : input) {
+    total.events += s.events;
+    total.trials += s.trials;
+    total.overflow += s.overflow;
+    total.maxweight = std::max(total.maxweight, s.maxweight);
+    for (std::size_t k = 0; k < 3; ++k) {
+      total.sums[k] += shared_base ? (s.sums[k] - s.base[k]) : s.sums[k];
+    }
+  }
+  if (!shared_base) { total.base = {{0.0, 0.0, 0.0}}; }
+  total.CrossSection(total.sums);
+
+  return total;
+}
+
+}  // namespace gra
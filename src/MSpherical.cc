@@ -4,6 +4,7 @@
 // Licensed under the MIT License <http://opensource.org/licenses/MIT>.
 
 // C++
+#include <algorithm>
 #include <complex>
 #include <iostream>
 #include <vector>
@@ -26,6 +27,137 @@ using gra::math::zi;
 
 namespace gra {
 namespace spherical {
+
+// Real spherical harmonic basis, normalization as in Y_real_basis
+YLMBasis::YLMBasis(int lmax) : LMAX(lmax), NCOEF((lmax + 1) * (lmax + 1)) {
+  K.resize(NCOEF, 0.0);
+  for (int l = 0; l <= LMAX; ++l) {
+    for (int m = 0; m <= l; ++m) {
+      K[LinearInd(l, m)] = (m == 0) ? msqrt((2.0 * l + 1.0) / (4.0 * PI))
+                                    : msqrt(((2.0 * l + 1.0) * math::factorial(l - m)) /
+                                            static_cast<double>(4.0 * PI * math::factorial(l + m)));
+    }
+  }
+}
+
+// Associated Legendre recursion in l for each m, as in sf_legendre,
+// thus one sweep gives all P_l^m(costheta) and each cos(m phi), sin(m phi) once
+void YLMBasis::Eval(double costheta, double phi, double *Y) const {
+  const double sqrt2 = msqrt(2.0);
+  const double sx2   = std::sqrt((1.0 - costheta) * (1.0 + costheta));
+
+  double pmm  = 1.0;  // P_m^m
+  double fact = 1.0;
+  for (int m = 0; m <= LMAX; ++m) {
+    if (m > 0) {
+      pmm *= (-fact) * sx2;
+      fact += 2.0;
+    }
+    const double c    = std::cos(m * phi);
+    const double sn   = std::sin(m * phi);
+    const double sign = std::pow(-1, m);
+
+    double p_2 = 0.0;  // P_{l-2}^m
+    double p_1 = 0.0;  // P_{l-1}^m
+    for (int l = m; l <= LMAX; ++l) {
+      double p = 0.0;
+      if (l == m) {
+        p = pmm;
+      } else if (l == m + 1) {
+        p = costheta * (2.0 * m + 1.0) * pmm;
+      } else {
+        p = ((2.0 * l - 1.0) * costheta * p_1 - (l + m - 1.0) * p_2) / (l - m);
+      }
+      p_2 = p_1;
+      p_1 = p;
+
+      const double Klm = K[LinearInd(l, m)];
+      if (m == 0) {
+        Y[LinearInd(l, 0)] = Klm * p;
+      } else {
+        Y[LinearInd(l, m)]  = sign * sqrt2 * Klm * c * p;
+        Y[LinearInd(l, -m)] = -sqrt2 * Klm * sn * p;
+      }
+    }
+  }
+}
+
+// Mode string to index: fla = 0, fid = 1, det = 2
+int ModeIndex(const std::string &mode) {
+  if (mode == "fla") { return 0; }
+  if (mode == "fid") { return 1; }
+  if (mode == "det") { return 2; }
+  throw std::invalid_argument("spherical::ModeIndex: Unknown mode " + mode);
+}
+
+// Monte Carlo sums of all modes in one pass over the events of a hypercell.
+// The basis vector is evaluated once per event, and the sums are accumulated
+// as blocked rank-k updates G += B^T B over blocks B of event basis vectors.
+//
+// Modes:
+//   fla: Flat phase space
+//   fid: Geometric acceptance ("Fiducial phase space")
+//   det: Geometric x Efficiency ("Detector level")
+//
+std::array<SH_SUM, 3> GetSums(const std::vector<Omega> &events, const std::vector<std::size_t> &ind,
+                              int LMAX) {
+  const YLMBasis    basis(LMAX);
+  const int         NCOEF = basis.NCOEF;
+  const std::size_t BLOCK = 256;
+
+  std::array<SH_SUM, 3> S;
+  for (auto &x : S) {
+    x.G  = Eigen::MatrixXd::Zero(NCOEF, NCOEF);
+    x.G2 = Eigen::MatrixXd::Zero(NCOEF, NCOEF);
+    x.E  = Eigen::VectorXd::Zero(NCOEF);
+    x.E2 = Eigen::VectorXd::Zero(NCOEF);
+  }
+
+  // Event blocks, one row per event
+  using RowMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  std::array<RowMatrix, 3>   B;
+  std::array<std::size_t, 3> n = {0, 0, 0};
+  for (auto &x : B) { x.resize(BLOCK, NCOEF); }
+
+  auto flush = [&](std::size_t c) {
+    if (n[c] == 0) { return; }
+    const auto            Y  = B[c].topRows(n[c]);
+    const Eigen::MatrixXd Y2 = Y.array().square().matrix();
+    S[c].G.noalias() += Y.transpose() * Y;
+    S[c].G2.noalias() += Y2.transpose() * Y2;
+    S[c].E += Y.colwise().sum().transpose();
+    S[c].E2 += Y2.colwise().sum().transpose();
+    n[c] = 0;
+  };
+
+  int fiducial = 0;
+  int selected = 0;
+
+  for (const auto &k : ind) {
+    const bool fid = events[k].fiducial;
+    const bool sel = events[k].selected;
+    const bool accept[3] = {true, fid, fid && sel};
+    if (fid) { ++fiducial; }
+    if (fid && sel) { ++selected; }
+
+    basis.Eval(events[k].costheta, events[k].phi, B[0].row(n[0]).data());
+    for (std::size_t c = 1; c < 3; ++c) {
+      if (accept[c]) { B[c].row(n[c]) = B[0].row(n[0]); }
+    }
+    for (std::size_t c = 0; c < 3; ++c) {
+      if (accept[c] && ++n[c] == BLOCK) { flush(c); }
+    }
+  }
+  for (std::size_t c = 0; c < 3; ++c) { flush(c); }
+
+  for (auto &x : S) {
+    x.N        = ind.size();
+    x.fiducial = fiducial;
+    x.selected = selected;
+  }
+  return S;
+}
+
 // Monte Carlo integral I ~= V 1/N \sum_{i=1}^N f(\vec{x}_i) = V <f(x)>
 // True integral being  I = \int_\Omega f(\vec{x}) d\vec{x}
 //
@@ -35,83 +167,32 @@ namespace spherical {
 
 MMatrix<double> GetGMixing(const std::vector<Omega> &events, const std::vector<std::size_t> &ind,
                            int LMAX, const std::string &mode) {
+  const int c = ModeIndex(mode);
+  return GetGMixing(GetSums(events, ind, LMAX)[c], LMAX, mode);
+}
+
+// Mixing matrix from the hypercell sums
+MMatrix<double> GetGMixing(const SH_SUM &S, int LMAX, const std::string &mode) {
   const int NCOEF = (LMAX + 1) * (LMAX + 1);
+  ModeIndex(mode);  // Check mode
 
   std::cout << "GetGMixing: mode = " << mode << std::endl;
-  std::cout << "Generated flat MC phase space events = " << ind.size() << std::endl;
-
-  // Construct the efficiency coefficients EPSILON_LM with linear
-  // indexing
-  MMatrix<double> E(NCOEF, NCOEF, 0.0);
-  MMatrix<double> E2(NCOEF, NCOEF, 0.0);  // for the uncertainty
+  std::cout << "Generated flat MC phase space events = " << S.N << std::endl;
 
-  // Loop over GENERATED MC events and do the integral in effect via
-  // uniform MC sampling
   // We evaluate the integral:
   //
   // eta_LM = \int eta(Omega) Re Y_LM(Omega) dOmega, Omega = (costheta,phi)
-  int fiducial = 0;
-  int selected = 0;
-
-  const double VOL = 4.0 * PI;  // [costheta] x [phi] plane area
-
-  for (const auto &k : ind) {
-    const bool fid = events[k].fiducial;
-    const bool sel = events[k].selected;
+  const double VOL      = 4.0 * PI;  // [costheta] x [phi] plane area
+  const int    fiducial = S.fiducial;
+  const int    selected = S.selected;
 
-    // Flat phase space
-    if (mode == "fla") {
-      // all fine
-    }
-    // Geometric acceptance ("Fiducial phase space")
-    else if (mode == "fid") {
-      if (!fid) {
-        continue;
-      } else {
-        ++fiducial;
-      }
-    }
-    // Geometric x Efficiency ("Detector level")
-    else if (mode == "det") {
-      if (!fid) {
-        continue;
-      } else {
-        ++fiducial;
-      }
-      if (!sel) {
-        continue;
-      } else {
-        ++selected;
-      }
-    } else {
-      throw std::invalid_argument("spherical::GetELM: Unknown mode " + mode);
-    }
-
-    const double costheta = events[k].costheta;
-    const double phi      = events[k].phi;
-
-    for (int l = 0; l <= LMAX; ++l) {
-      for (int m = -l; m <= l; ++m) {
-        const int index = LinearInd(l, m);
-
-        const std::complex<double> Y   = gra::math::Y_complex_basis(costheta, phi, l, m);
-        const double               ReY = gra::math::NReY(Y, l, m);
-
-        for (int lprime = 0; lprime <= LMAX; ++lprime) {
-          for (int mprime = -lprime; mprime <= lprime; ++mprime) {
-            const int                  indexprime = LinearInd(lprime, mprime);
-            const std::complex<double> Yprime =
-                gra::math::Y_complex_basis(costheta, phi, lprime, mprime);
-            const double ReYprime = gra::math::NReY(Yprime, lprime, mprime);
-
-            // Sum to the MC integral and its squared version
-            // (for uncertainty)
-            const double f = VOL * ReY * ReYprime;  // Note volume term
-            E[index][indexprime] += f;
-            E2[index][indexprime] += f * f;
-          }
-        }
-      }
+  // Efficiency coefficients EPSILON_LM with linear indexing
+  MMatrix<double> E(NCOEF, NCOEF, 0.0);
+  MMatrix<double> E2(NCOEF, NCOEF, 0.0);  // for the uncertainty
+  for (int i = 0; i < NCOEF; ++i) {
+    for (int j = 0; j < NCOEF; ++j) {
+      E[i][j]  = VOL * S.G(i, j);  // Note volume term
+      E2[i][j] = VOL * VOL * S.G2(i, j);
     }
   }
 
@@ -119,7 +200,7 @@ MMatrix<double> GetGMixing(const std::vector<Omega> &events, const std::vector<s
     printf(
         "Fiducial flat MC phase space events = %d (acceptance %0.3f "
         "percent) \n",
-        fiducial, fiducial / static_cast<double>(ind.size()) * 100);
+        fiducial, fiducial / static_cast<double>(S.N) * 100);
   }
   if (mode == "det") {
     printf(
@@ -137,7 +218,7 @@ MMatrix<double> GetGMixing(const std::vector<Omega> &events, const std::vector<s
 
   // Do the normalization
   const double N_generated =
-      static_cast<double>(ind.size());  // Generated events within this mass interval
+      static_cast<double>(S.N);  // Generated events within this mass interval
   std::vector<double> E_error(E.size_row(), 0.0);
   std::cout << "Symmetric mixing matrix integral coefficients G_{ll'}^{mm'}:" << std::endl;
   std::vector<double> rowsum(NCOEF, 0.0);
@@ -205,79 +286,40 @@ MMatrix<double> GetGMixing(const std::vector<Omega> &events, const std::vector<s
 std::pair<std::vector<double>, std::vector<double>> GetELM(const std::vector<Omega> &      MC,
                                                            const std::vector<std::size_t> &ind,
                                                            int LMAX, const std::string &mode) {
+  const int c = ModeIndex(mode);
+  return GetELM(GetSums(MC, ind, LMAX)[c], LMAX, mode);
+}
+
+// Acceptance expansion coefficients from the hypercell sums
+std::pair<std::vector<double>, std::vector<double>> GetELM(const SH_SUM &S, int LMAX,
+                                                           const std::string &mode) {
   const int NCOEF = (LMAX + 1) * (LMAX + 1);
+  ModeIndex(mode);  // Check mode
 
   std::cout << "GetELM: mode = " << mode << std::endl;
-  std::cout << "Generated flat MC phase space events = " << ind.size() << std::endl;
+  std::cout << "Generated flat MC phase space events = " << S.N << std::endl;
 
-  // Construct the efficiency coefficients E_LM with linear indexing
-  std::vector<double> E(NCOEF, 0.0);
-  std::vector<double> E2(NCOEF, 0.0);  // for the uncertainty
-
-  // Loop over GENERATED MC events and do the integral in effect via
-  // uniform MC sampling
   // We evaluate the integral:
   //
   // E_LM = \int E(Omega) Re Y_LM(Omega) dOmega, Omega = (costheta,phi)
-
-  int          fiducial = 0;
-  int          selected = 0;
   const double V        = sqrt(4.0 * PI);  // Normalization volume
+  const int    fiducial = S.fiducial;
+  const int    selected = S.selected;
 
-  for (const auto &k : ind) {
-    bool fid = MC[k].fiducial;
-    bool sel = MC[k].selected;
-
-    // Flat flat phase space
-    if (mode == "fla") {
-      // all fine
-    }
-    // Geometric acceptance ("Fiducial phase space")
-    else if (mode == "fid") {
-      if (!fid) {
-        continue;
-      } else {
-        ++fiducial;
-      }
-    }
-    // Geometric x Efficiency ("Detector level")
-    else if (mode == "det") {
-      if (!fid) {
-        continue;
-      } else {
-        ++fiducial;
-      }
-      if (!sel) {
-        continue;
-      } else {
-        ++selected;
-      }
-    } else {
-      throw std::invalid_argument("spherical::GetELM: Unknown mode " + mode);
-    }
-
-    const double costheta = MC[k].costheta;
-    const double phi      = MC[k].phi;
-
-    for (int l = 0; l <= LMAX; ++l) {
-      for (int m = -l; m <= l; ++m) {
-        const std::complex<double> Y = gra::math::Y_complex_basis(costheta, phi, l, m);
-
-        // Sum to the MC integral and its square (for uncertainty)
-        double f = V * gra::math::NReY(Y, l, m);  // Note volume V term
-
-        const int index = LinearInd(l, m);
-        E[index] += f;
-        E2[index] += pow2(f);
-      }
-    }
+  // Efficiency coefficients E_LM with linear indexing
+  std::vector<double> E(NCOEF, 0.0);
+  std::vector<double> E2(NCOEF, 0.0);  // for the uncertainty
+  for (int i = 0; i < NCOEF; ++i) {
+    E[i]  = V * S.E(i);  // Note volume V term
+    E2[i] = V * V * S.E2(i);
   }
+
   if (mode == "fid" || mode == "det") {
     printf(
         "Fiducial flat MC phase space events = %d (geometric-kinematic "
         "acceptance "
         "%0.3f percent) \n\n",
-        fiducial, fiducial / static_cast<double>(ind.size()) * 100);
+        fiducial, fiducial / static_cast<double>(S.N) * 100);
   }
   if (mode == "det") {
     printf(
@@ -300,7 +342,7 @@ std::pair<std::vector<double>, std::vector<double>> GetELM(const std::vector<Ome
   }
 
   // Do the normalization
-  const double        N_generated = (double)ind.size();  // Generated events within this hypercell
+  const double        N_generated = (double)S.N;  // Generated events within this hypercell
   std::vector<double> E_error(E.size(), 0.0);
 
   std::cout << "Acceptance decomposition coefficients:" << std::endl;
@@ -374,30 +416,35 @@ std::vector<double> SphericalMoments(const std::vector<Omega> &      input,
   return t;
 }
 
+// Algebraic expansion coefficients with pre-calculated Y_lm values (see YLM)
+//
+std::vector<double> SphericalMoments(const MMatrix<double> &Y_lm, const std::vector<Omega> &input,
+                                     const std::vector<std::size_t> &ind, int LMAX,
+                                     const std::string &mode) {
+  const double        V     = sqrt(4.0 * PI);  // Normalization volume
+  const unsigned int  NCOEF = (LMAX + 1) * (LMAX + 1);
+  const int           c     = ModeIndex(mode);
+  std::vector<double> t(NCOEF, 0.0);
+
+  for (const auto &k : ind) {
+    if (c >= 1 && !input[k].fiducial) { continue; }
+    if (c == 2 && !input[k].selected) { continue; }
+    const double *Y = Y_lm[k];
+    for (std::size_t index = 0; index < NCOEF; ++index) { t[index] += Y[index]; }
+  }
+  for (auto &x : t) { x *= V; }  // Note volume V term
+  return t;
+}
+
 // Calculate Y_lm values for each event
 MMatrix<double> YLM(const std::vector<Omega> &events, int LMAX) {
   std::cout << "YLM:" << std::endl;
 
-  const unsigned int NCOEFF = (LMAX + 1) * (LMAX + 1);
-  MMatrix<double>    Y_lm(events.size(), NCOEFF, 0.0);
-
-  // Loop over events
-  for (const auto &k : indices(events)) {
-    // Get event (costheta, phi)
-    const double costheta = events[k].costheta;
-    const double phi      = events[k].phi;
-
-    // Loop over (l,m) coefficients
-    for (int l = 0; l <= LMAX; ++l) {
-      for (int m = -l; m <= l; ++m) {
-        const std::complex<double> Y = gra::math::Y_complex_basis(costheta, phi, l, m);
+  const YLMBasis  basis(LMAX);
+  MMatrix<double> Y_lm(events.size(), basis.NCOEF, 0.0);
 
-        // Save its value
-        const int index = LinearInd(l, m);
-        Y_lm[k][index]  = gra::math::NReY(Y, l, m);
-      }
-    }
-  }
+  // Loop over events, all (l,m) coefficients at once
+  for (const auto &k : indices(events)) { basis.Eval(events[k].costheta, events[k].phi, Y_lm[k]); }
   return Y_lm;
 }
 
@@ -448,17 +495,65 @@ std::vector<std::size_t> GetIndices(const std::vector<Omega> &events, const std:
       ind.push_back(i);
     }
   }
+  PrintHyperBin(M, Pt, Y, ind.size(), events.size());
+
+  return ind;
+}
+
+// Calculate indices for all (M,Pt,Y) hyperbins in one pass over the events.
+//
+// Bins {min,max} are in ascending order along each dimension, with the
+// same open interval acceptance as GetIndices(). Output is linearly indexed
+// as (i * Pt.size() + j) * Y.size() + k.
+//
+std::vector<std::vector<std::size_t>> GetHyperIndices(
+    const std::vector<Omega> &events, const std::vector<std::array<double, 2>> &M,
+    const std::vector<std::array<double, 2>> &Pt, const std::vector<std::array<double, 2>> &Y) {
+  // Candidate bins of x (at most two with touching edges)
+  auto find = [](double x, const std::vector<std::array<double, 2>> &bins, std::size_t out[2]) {
+    std::size_t N = 0;
+    const auto  it =
+        std::upper_bound(bins.begin(), bins.end(), x,
+                         [](double v, const std::array<double, 2> &b) { return v < b[0]; });
+    const std::size_t b = std::distance(bins.begin(), it);
+    for (std::size_t i = (b >= 2 ? b - 2 : 0); i < b; ++i) {
+      if (x > bins[i][0] && x < bins[i][1]) { out[N++] = i; }
+    }
+    return N;
+  };
+
+  std::vector<std::vector<std::size_t>> ind(M.size() * Pt.size() * Y.size());
+  std::size_t                           iM[2], iPt[2], iY[2];
+
+  for (const auto &e : indices(events)) {
+    const std::size_t nM = find(events[e].M, M, iM);
+    if (nM == 0) { continue; }
+    const std::size_t nPt = find(events[e].Pt, Pt, iPt);
+    if (nPt == 0) { continue; }
+    const std::size_t nY = find(events[e].Y, Y, iY);
+
+    for (std::size_t a = 0; a < nM; ++a) {
+      for (std::size_t b = 0; b < nPt; ++b) {
+        for (std::size_t c = 0; c < nY; ++c) {
+          ind[(iM[a] * Pt.size() + iPt[b]) * Y.size() + iY[c]].push_back(e);
+        }
+      }
+    }
+  }
+  return ind;
+}
 
+// Print hyperbin information
+void PrintHyperBin(const std::vector<double> &M, const std::vector<double> &Pt,
+                   const std::vector<double> &Y, std::size_t n, std::size_t N) {
   gra::aux::PrintBar("-");
   std::cout << rang::fg::green;
   printf(
       "MASS RANGE: [%0.3f, %0.3f] GeV, PT RANGE: [%0.3f, %0.3f] GeV, Y "
       "RANGE: [%0.3f, %0.3f] "
       ": Events in this hyperbin %lu/%lu \n\n",
-      M[0], M[1], Pt[0], Pt[1], Y[0], Y[1], ind.size(), events.size());
+      M[0], M[1], Pt[0], Pt[1], Y[0], Y[1], n, N);
   std::cout << rang::fg::reset;
-
-  return ind;
 }
 
 // TestIntegrals spherical harmonics
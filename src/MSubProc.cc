@@ -60,9 +60,40 @@ MSubProc::MSubProc(const std::vector<std::string>& istate, const std::string& mc
 void MSubProc::Initialize(const std::string& istate, const std::string& channel) {
   ISTATE  = istate;
   CHANNEL = channel;
+
+  CHANNEL_ID = ECHANNEL::OTHER;
+  if (CHANNEL == "EL") { CHANNEL_ID = ECHANNEL::EL; }
+  if (CHANNEL == "SD") { CHANNEL_ID = ECHANNEL::SD; }
+  if (CHANNEL == "DD") { CHANNEL_ID = ECHANNEL::DD; }
+  if (CHANNEL == "ND") { CHANNEL_ID = ECHANNEL::ND; }
+  DURHAM = (ISTATE == "gg");
+
   DeleteProcesses();
 }
 
+// Copy constructor
+MSubProc::MSubProc(const MSubProc& other)
+    : ISTATE(other.ISTATE),
+      CHANNEL(other.CHANNEL),
+      LIPSDIM(other.LIPSDIM),
+      CHANNEL_ID(other.CHANNEL_ID),
+      DURHAM(other.DURHAM),
+      Processes(other.Processes) {}
+
+// Copy assignment
+MSubProc& MSubProc::operator=(const MSubProc& other) {
+  if (this != &other) {
+    DeleteProcesses();
+    ISTATE     = other.ISTATE;
+    CHANNEL    = other.CHANNEL;
+    LIPSDIM    = other.LIPSDIM;
+    CHANNEL_ID = other.CHANNEL_ID;
+    DURHAM     = other.DURHAM;
+    Processes  = other.Processes;
+  }
+  return *this;
+}
+
 // Destructor
 MSubProc::~MSubProc() { DeleteProcesses(); }
 
@@ -70,6 +101,7 @@ MSubProc::~MSubProc() { DeleteProcesses(); }
 void MSubProc::DeleteProcesses() {
   for (const auto& i : aux::indices(pr)) { delete pr[i]; }
   pr.clear();  // Finally empty
+  active = nullptr;
 }
 
 void MSubProc::ConstructDescriptions(const std::string& istate, const std::string& mc) {
@@ -149,10 +181,11 @@ std::vector<std::string> MSubProc::GetProcessDescriptor(std::string str) const {
   return Processes.find(str)->second;
 }
 
-// Wrapper function
-double MSubProc::GetBareAmplitude2(gra::LORENTZSCALAR& lts) {
+// Construct the process amplitude and bind its final state routing
+void MSubProc::Bind(gra::LORENTZSCALAR& lts) {
   if (pr.size() == 0) { ActivateProcess(); }
-  return pr[0]->Amp2(lts);
+  pr[0]->Bind(lts);
+  active = pr[0];
 }
 
 }  // namespace gra
@@ -6,7 +6,6 @@
 // C++
 #include <complex>
 #include <fstream>
-#include <future>
 #include <iostream>
 #include <memory>
 #include <vector>
@@ -18,6 +17,8 @@
 
 // Own
 #include "Graniitti/MAux.h"
+#include "Graniitti/MGridBuilder.h"
+#include "Graniitti/MKinematics.h"
 #include "Graniitti/MMath.h"
 #include "Graniitti/MSudakov.h"
 #include "Graniitti/MTimer.h"
@@ -35,6 +36,13 @@ using math::msqrt;
 using math::pow2;
 using math::zi;
 
+namespace {
+
+// LHAPDF instance of the grid builder worker on this thread (nullptr for PdfPtr)
+thread_local LHAPDF::PDF *worker_pdf = nullptr;
+
+}  // namespace
+
 // Constructor
 MSudakov::MSudakov() {}
 
@@ -84,7 +92,7 @@ void MSudakov::InitArrays() {
       // (ClassType::*)(ParameterTypes...)
       std::pair<double, double> (MSudakov::*f)(double, double) = &MSudakov::Sudakov_T;
       CalculateArray(veto, f);
-      veto.WriteArray(filename, true);
+      veto.WriteArray(filename, true, Numerics.CSV);
       ok = veto.ReadArray(filename);
     }
   }
@@ -113,7 +121,7 @@ void MSudakov::InitArrays() {
       // (ClassType::*)(ParameterTypes...)
       std::pair<double, double> (MSudakov::*f)(double, double) = &MSudakov::Shuvaev_H;
       CalculateArray(spdf, f);
-      spdf.WriteArray(filename, true);
+      spdf.WriteArray(filename, true, Numerics.CSV);
       ok = spdf.ReadArray(filename);
     }
   }
@@ -129,7 +137,7 @@ void MSudakov::InitArrays() {
 double MSudakov::xg_xQ2(double x, double q2) const {
   const int pid = 21;  // gluon
   try {
-    return PdfPtr->xfxQ2(pid, x, q2);
+    return (worker_pdf != nullptr ? worker_pdf : PdfPtr)->xfxQ2(pid, x, q2);
   } catch (...) {
     std::string str =
         "MSudakov::xg_xQ2: Problem with x = " + std::to_string(x) + ", q2 = " + std::to_string(q2);
@@ -216,7 +224,7 @@ void MSudakov::TestPDF() const {
 // Access QCD coupling alpha_s(Q^2) from LHAPDF
 double MSudakov::AlphaS_Q2(double q2) const {
   try {
-    return PdfPtr->alphasQ2(q2);
+    return (worker_pdf != nullptr ? worker_pdf : PdfPtr)->alphasQ2(q2);
   } catch (...) {
     std::string str = "MSudakov::AlphaS_Q2: Problem with q2 = " + std::to_string(q2);
     throw std::invalid_argument(str);
@@ -242,24 +250,8 @@ double MSudakov::diff_xg_xQ2_wrt_Q2(double x, double q2) const {
 }
 
 // Durham flux (skewed gluon pdf)
-// ~ Shuvaev transformed gluon pdf x Sudakov suppression
-//
-// f_g(x,x',qt^2,\mu)
-// = \frac{\partial}{\partial \ln Q_t^2} [H_g(x/2,x/2,Q_t^2)\sqrt{T(Q_t^2,\mu)}]
-//
-double MSudakov::fg_xQ2M(double x, double q2, double M) const {
-  // Calculate Shuvaev transformation
-  // std::pair<double,double> out1 = Shuvaev_H(q2, x);
-  std::pair<double, double> out1 = spdf.Interpolate2D(q2, x);
-  const double              Hg   = out1.first;
-  const double              dHg  = out1.second;
-
-  // Calculate Sudakov veto
-  // std::pair<double,double> out2 = Sudakov_T(q2, M);
-  std::pair<double, double> out2 = veto.Interpolate2D(q2, M);
-  const double              Tg   = out2.first;
-  const double              dTg  = out2.second;
-
+// f_g from the interpolated Shuvaev pdf (Hg, dHg/dq^2) and Sudakov factor (Tg, dTg/dq^2)
+static inline double fg_Combine(double Hg, double dHg, double Tg, double dTg, double q2) {
   // Chain rule's: d/dln(q^2) [ ... ]
   double total = 0.0;
 
@@ -284,6 +276,44 @@ double MSudakov::fg_xQ2M(double x, double q2, double M) const {
   return total;
 }
 
+// ~ Shuvaev transformed gluon pdf x Sudakov suppression
+//
+// f_g(x,x',qt^2,\mu)
+// = \frac{\partial}{\partial \ln Q_t^2} [H_g(x/2,x/2,Q_t^2)\sqrt{T(Q_t^2,\mu)}]
+//
+double MSudakov::fg_xQ2M(double x, double q2, double M) const {
+  // Calculate Shuvaev transformation
+  // std::pair<double,double> out1 = Shuvaev_H(q2, x);
+  std::pair<double, double> out1 = spdf.Interpolate2D(q2, x);
+
+  // Calculate Sudakov veto
+  // std::pair<double,double> out2 = Sudakov_T(q2, M);
+  std::pair<double, double> out2 = veto.Interpolate2D(q2, M);
+
+  return fg_Combine(out1.first, out1.second, out2.first, out2.second, q2);
+}
+
+// Batched version over the q2 values, x and M fixed (as over the Durham qt-loop)
+void MSudakov::fg_xQ2M_Batch(double x, const double *q2, double M, double *out,
+                             std::size_t n) const {
+  // Per thread scratch buffers, grow only
+  thread_local std::vector<double> Hg;
+  thread_local std::vector<double> dHg;
+  thread_local std::vector<double> Tg;
+  thread_local std::vector<double> dTg;
+  if (Hg.size() < n) {
+    Hg.resize(n);
+    dHg.resize(n);
+    Tg.resize(n);
+    dTg.resize(n);
+  }
+
+  spdf.Interpolate2DBatch(q2, x, Hg.data(), dHg.data(), n);
+  veto.Interpolate2DBatch(q2, M, Tg.data(), dTg.data(), n);
+
+  for (std::size_t k = 0; k < n; ++k) { out[k] = fg_Combine(Hg[k], dHg[k], Tg[k], dTg[k], q2[k]); }
+}
+
 // Calculate Shuvaev integral transform
 // ----------------------------------------------------------------------
 // Identity:
@@ -441,36 +471,111 @@ double MSudakov::NumFlavor(double q2) const {
 // Constructs interpolation array values
 void MSudakov::CalculateArray(IArray2D &arr,
                               std::pair<double, double> (MSudakov::*f)(double, double)) {
-  MTimer timer;
-  for (const auto &i : indices(arr.F)) {
+  MTimer       timer;
+  MGridBuilder builder;
+
+  // Flat node index k = i * (N[1] + 1) + j
+  const std::size_t NB = arr.N[1] + 1;
+
+  // LHAPDF objects are not safe for concurrent evaluation, each worker
+  // evaluates its own instance of the set (the first one uses PdfPtr)
+  std::vector<MPDFHandle> pdfs(builder.GetThreads());
+  for (std::size_t t = 1; t < pdfs.size(); ++t) { pdfs[t].Init(PDFSETNAME); }
+
+  builder.RunWorkers((arr.N[0] + 1) * NB, [&](std::size_t k, unsigned int tid) {
+    worker_pdf = (tid > 0) ? pdfs[tid].get() : nullptr;
+
+    const std::size_t i = k / NB;
+    const std::size_t j = k % NB;
+
     const double a = arr.MIN[0] + i * arr.STEP[0];
+    const double b = arr.MIN[1] + j * arr.STEP[1];
 
     // Transform input to linear if log stepping, for the function
     const double var1 = (arr.islog[0]) ? std::exp(a) : a;
-    gra::aux::PrintProgress(i / static_cast<double>(arr.N[0] + 1));
+    const double var2 = (arr.islog[1]) ? std::exp(b) : b;
+
+    // Call function being pointed to
+    const std::pair<double, double> output = (this->*f)(var1, var2);
+
+    arr.F[i][j][0] = a;
+    arr.F[i][j][1] = b;
+    arr.F[i][j][2] = std::abs(output.first) < 1e-64 ? 0 : output.first;    // Underflow protection
+    arr.F[i][j][3] = std::abs(output.second) < 1e-64 ? 0 : output.second;  //
 
-    for (const auto &j : indices(arr.F[i])) {
-      const double b = arr.MIN[1] + j * arr.STEP[1];
+    worker_pdf = nullptr;
+  });
+  printf("MSudakov::CalculateArray: <threads = %u> Time elapsed %0.1f sec \n",
+         builder.GetThreads(), timer.ElapsedSec());
+}
 
-      // Transform input to linear if log stepping, for the function
-      const double var2 = (arr.islog[1]) ? std::exp(b) : b;
+// Binary cache header
+MArrayHeader IArray2D::GetHeader() const {
+  MArrayHeader h;
+  h.ndim  = 2;
+  h.hash  = gra::aux::djb2hash(GetHashString());
+  h.sqrts = sqrts;
+  h.ncol  = 4;
+  for (std::size_t k = 0; k < 2; ++k) {
+    h.N[k]     = N[k];
+    h.islog[k] = islog[k];
+    h.MIN[k]   = MIN[k];
+    h.MAX[k]   = MAX[k];
+  }
+  return h;
+}
 
-      // Call function being pointed to
-      const std::pair<double, double> output = (this->*f)(var1, var2);
+// Write the array to a binary file (and optionally to a CSV text file)
+bool IArray2D::WriteArray(const std::string &filename, bool overwrite, bool csv) const {
+  if (csv) { WriteArrayCSV(filename + ".csv", overwrite); }
 
-      arr.F[i][j][0] = a;
-      arr.F[i][j][1] = b;
-      arr.F[i][j][2] = std::abs(output.first) < 1e-64 ? 0 : output.first;    // Underflow protection
-      arr.F[i][j][3] = std::abs(output.second) < 1e-64 ? 0 : output.second;  //
+  // Do not write if file exists already
+  const std::string binfile = filename + ".bin";
+  if (gra::aux::FileExist(binfile) && !overwrite) { return true; }
+
+  std::cout << "IArray2D::WriteArray: ";
+
+  std::vector<double> values;
+  values.reserve(4 * (N[0] + 1) * (N[1] + 1));
+  for (const auto &i : indices(F)) {
+    for (const auto &j : indices(F[i])) {
+      values.insert(values.end(), F[i][j].begin(), F[i][j].end());
     }
   }
-  // Progressbar clearing
-  gra::aux::ClearProgress();
-  printf("MSudakov::CalculateArray: Time elapsed %0.1f sec \n", timer.ElapsedSec());
+  MArrayCache::Write(binfile, GetHeader(), values);
+
+  std::cout << rang::fg::green << "[DONE]" << rang::fg::reset << std::endl;
+  return true;
+}
+
+// Map the array from a binary file, or import it from a CSV text file
+bool IArray2D::ReadArray(const std::string &filename) {
+  const std::string binfile = filename + ".bin";
+  cache                     = MArrayCache::Map(binfile, GetHeader());
+
+  if (cache == nullptr) {
+    // Import CSV (exported or old format without extension) and convert
+    for (const auto &csvfile : {filename + ".csv", filename}) {
+      if (gra::aux::FileExist(csvfile) && ReadArrayCSV(csvfile)) {
+        WriteArray(filename, true);
+        cache = MArrayCache::Map(binfile, GetHeader());
+        break;
+      }
+    }
+    if (cache == nullptr) { return false; }
+  }
+  D = cache->data();
+
+  // Values are now read from the mapping
+  std::vector<std::vector<std::vector<double>>>().swap(F);
+
+  std::cout << "IArray2D::ReadArray: " << rang::fg::green << "[DONE]" << rang::fg::reset
+            << std::endl;
+  return true;
 }
 
-// Write the array to a file
-bool IArray2D::WriteArray(const std::string &filename, bool overwrite) const {
+// Write the array to a CSV text file
+bool IArray2D::WriteArrayCSV(const std::string &filename, bool overwrite) const {
   // Do not write if file exists already
   if (gra::aux::FileExist(filename) && !overwrite) {
     // std::cout << "- Found pre-calculated" << std::endl;
@@ -481,11 +586,11 @@ bool IArray2D::WriteArray(const std::string &filename, bool overwrite) const {
   std::ofstream file;
   file.open(filename);
   if (!file.is_open()) {
-    std::string str = "IArray2D::WriteArray: Fatal IO-error with: " + filename;
+    std::string str = "IArray2D::WriteArrayCSV: Fatal IO-error with: " + filename;
     throw std::invalid_argument(str);
   }
 
-  std::cout << "IArray2D::WriteArray: ";
+  std::cout << "IArray2D::WriteArrayCSV: ";
   unsigned int line_number = 0;
 
   try {
@@ -499,7 +604,7 @@ bool IArray2D::WriteArray(const std::string &filename, bool overwrite) const {
       }
     }
   } catch (...) {
-    throw std::invalid_argument("IArray2D:WriteArray: Error in file " + filename + " at line " +
+    throw std::invalid_argument("IArray2D::WriteArrayCSV: Error in file " + filename + " at line " +
                                 std::to_string(line_number));
   }
 
@@ -507,19 +612,19 @@ bool IArray2D::WriteArray(const std::string &filename, bool overwrite) const {
   return true;
 }
 
-// Read the array from a file
-bool IArray2D::ReadArray(const std::string &filename) {
+// Read the array from a CSV text file
+bool IArray2D::ReadArrayCSV(const std::string &filename) {
   std::ifstream file;
   file.open(filename);
   if (!file.is_open()) {
-    std::string str = "IArray2D::ReadArray: Fatal IO-error with: " + filename;
+    std::string str = "IArray2D::ReadArrayCSV: Fatal IO-error with: " + filename;
     return false;
   }
 
   std::string  line;
   unsigned int fills       = 0;
   unsigned int line_number = 0;
-  std::cout << "IArray2D::ReadArray: ";
+  std::cout << "IArray2D::ReadArrayCSV: ";
 
   try {
     for (const auto &i : indices(F)) {
@@ -543,7 +648,7 @@ bool IArray2D::ReadArray(const std::string &filename) {
     }
 
   } catch (...) {
-    throw std::invalid_argument("IArray2D:ReadArray: Error in file " + filename + " at line " +
+    throw std::invalid_argument("IArray2D::ReadArrayCSV: Error in file " + filename + " at line " +
                                 std::to_string(line_number));
   }
 
@@ -596,10 +701,17 @@ std::pair<double, double> IArray2D::Interpolate2D(double a, double b) const {
   const unsigned int X = 0;
   const unsigned int Y = 1;
 
-  const double x1 = F[i][j][X];
-  const double x2 = F[i + 1][j][X];
-  const double y1 = F[i][j][Y];
-  const double y2 = F[i][j + 1][Y];
+  // Grid points [a, b, Z, dZ], row-major with N[1]+1 columns
+  const std::size_t NCOL = 4 * (N[1] + 1);
+  const double *    P11  = D + i * NCOL + 4 * j;
+  const double *    P12  = P11 + 4;
+  const double *    P21  = P11 + NCOL;
+  const double *    P22  = P21 + 4;
+
+  const double x1 = P11[X];
+  const double x2 = P21[X];
+  const double y1 = P11[Y];
+  const double y2 = P12[Y];
 
   const double xstep = STEP[0];
   const double ystep = STEP[1];
@@ -610,10 +722,10 @@ std::pair<double, double> IArray2D::Interpolate2D(double a, double b) const {
 
   // 2 == Z, 3 == dZ
   for (std::size_t C = 2; C <= 3; ++C) {
-    const double Q11 = F[i][j][C];
-    const double Q12 = F[i][j + 1][C];
-    const double Q21 = F[i + 1][j][C];
-    const double Q22 = F[i + 1][j + 1][C];
+    const double Q11 = P11[C];
+    const double Q12 = P12[C];
+    const double Q21 = P21[C];
+    const double Q22 = P22[C];
 
     // Interpolated valued
     values[C - 2] =
@@ -624,4 +736,61 @@ std::pair<double, double> IArray2D::Interpolate2D(double a, double b) const {
   return {values[0], values[1]};
 }
 
+
+// Batched bilinear interpolation over A, with B fixed
+//
+// Same arithmetic as Interpolate2D, the B-direction index and weights are
+// computed only once.
+void IArray2D::Interpolate2DBatch(const double *A, double B, double *Z, double *dZ,
+                                  std::size_t n) const {
+  const double EPS = 1e-5;
+
+  // Fixed B-direction
+  double b = B;
+  if (b < MIN[1]) { b = MIN[1]; }
+  if (islog[1]) { b = std::log(b); }
+
+  int j = std::floor((b - MIN[1]) / STEP[1]);
+  if (j < 0) { j = 0; }
+  if (j >= (int)N[1]) { j = N[1] - 1; }
+
+  const std::size_t NCOL  = 4 * (N[1] + 1);
+  const double      ystep = STEP[1];
+  const double      y1    = D[4 * j + 1];
+  const double      y2    = D[4 * (j + 1) + 1];
+  const double      wy1   = (y2 - b) / ystep;
+  const double      wy2   = (b - y1) / ystep;
+  const double      xstep = STEP[0];
+
+  for (std::size_t k = 0; k < n; ++k) {
+    double a = A[k];
+    if (a < MIN[0]) { a = MIN[0]; }
+    if (islog[0]) { a = std::log(a); }
+
+    if (a > MAX[0] * (1 + EPS) || b > MAX[1] * (1 + EPS)) {
+      printf(
+          "Interpolate2D(%s,%s) Input out of grid domain: "
+          "%s = %0.3f [%0.3f, %0.3f], %s = %0.3f [%0.3f, %0.3f] \n",
+          name[0].c_str(), name[1].c_str(), name[0].c_str(), a, MIN[0], MAX[0], name[1].c_str(),
+          b, MIN[1], MAX[1]);
+    }
+
+    int i = std::floor((a - MIN[0]) / STEP[0]);
+    if (i < 0) { i = 0; }
+    if (i >= (int)N[0]) { i = N[0] - 1; }
+
+    const double *P11 = D + i * NCOL + 4 * j;
+    const double *P12 = P11 + 4;
+    const double *P21 = P11 + NCOL;
+    const double *P22 = P21 + 4;
+
+    const double x1  = P11[0];
+    const double x2  = P21[0];
+    const double wx1 = (x2 - a) / xstep;
+    const double wx2 = (a - x1) / xstep;
+
+    Z[k]  = wy1 * (wx1 * P11[2] + wx2 * P21[2]) + wy2 * (wx1 * P12[2] + wx2 * P22[2]);
+    dZ[k] = wy1 * (wx1 * P11[3] + wx2 * P21[3]) + wy2 * (wx1 * P12[3] + wx2 * P22[3]);
+  }
+}
 }  // namespace gra
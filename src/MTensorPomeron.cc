@@ -186,11 +186,9 @@ double MTensorPomeron::ME3(gra::LORENTZSCALAR &lts) const {
   // ------------------------------------------------------------------
 
   // Spinors (2 helicities)
-  const std::array<std::vector<std::complex<double>>, 2> u_a = SpinorStates(pa, "u");
-  const std::array<std::vector<std::complex<double>>, 2> u_b = SpinorStates(pb, "u");
-
-  const std::array<std::vector<std::complex<double>>, 2> ubar_1 = SpinorStates(p1, "ubar");
-  const std::array<std::vector<std::complex<double>>, 2> ubar_2 = SpinorStates(p2, "ubar");
+  std::array<DSpinor, 2> u_a;
+  std::array<DSpinor, 2> u_b;
+  BeamSpinors(lts, u_a, u_b);
 
   // ------------------------------------------------------------------
 
@@ -211,6 +209,7 @@ double MTensorPomeron::ME3(gra::LORENTZSCALAR &lts) const {
 
   // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
   // 2. Coherent sum of Resonances (loop over)
+  std::size_t r = 0;
   for (auto &x : lts.RESONANCES) {
     const PARAM_RES res = x.second;
 
@@ -220,6 +219,10 @@ double MTensorPomeron::ME3(gra::LORENTZSCALAR &lts) const {
     const int    J     = res.p.spinX2 / 2.0;
     const int    P     = res.p.P;
 
+    // Decay vertex of this resonance (cached in the loop context)
+    DecayVertex  local;
+    DecayVertex &dv = LoopDecayVertex(r++, p3, p4, local);
+
     // ------------------------------------------------------------------
 
     // =====================================================================
@@ -228,41 +231,45 @@ double MTensorPomeron::ME3(gra::LORENTZSCALAR &lts) const {
     //
     if (J == 0 && P == 1) {
       Tensor4<std::complex<double>, 4, 4, 4, 4> cvtx;
-      std::vector<std::complex<double>>         eps3eps4;
 
       cvtx = iG_PPS_total(lts.q1, lts.q2, M0, "scalar", res.g_Tensor);
 
       // Scalar BW-propagator
       const std::complex<double> iD = iD_MES(lts.pfinal[0], M0, Gamma);
 
-      // [PS PS]  Pseudoscalar pair decay
-      if (lts.decaytree[0].p.spinX2 == 0 && lts.decaytree[1].p.spinX2 == 0) {
-        eps3eps4.clear();
-        eps3eps4.push_back(
-            iG_f0ss(lts.decaytree[0].p4, lts.decaytree[1].p4, M0, res.hel.g_decay_tensor[0]));
-      }
+      if (!dv.valid) {
+        // [PS PS]  Pseudoscalar pair decay
+        if (lts.decaytree[0].p.spinX2 == 0 && lts.decaytree[1].p.spinX2 == 0) {
+          dv.amp.clear();
+          dv.amp.push_back(iG_f0ss(lts.decaytree[0].p4, lts.decaytree[1].p4, M0,
+                                   res.hel.g_decay_tensor[0]));
+        }
 
-      // [V   V]  Massive vector pair decay
-      else if (lts.decaytree[0].p.spinX2 == 2 && lts.decaytree[1].p.spinX2 == 2) {
-        if (res.hel.g_decay_tensor.size() != 2) {
+        // [V   V]  Massive vector pair decay
+        else if (lts.decaytree[0].p.spinX2 == 2 && lts.decaytree[1].p.spinX2 == 2) {
+          if (res.hel.g_decay_tensor.size() != 2) {
+            throw std::invalid_argument(
+                "MTensorPomeron:: S->VV Coupling array [size 2] 'hel.g_decay_tensor' not in "
+                "BRANCHING.json for resonance PDG = " +
+                std::to_string(res.p.pdg));
+          }
+          // Decay vertex with different outgoing helicity combinations
+          Tensor2<std::complex<double>, 4, 4> iGf0vv =
+              iG_f0vv(p3, p4, M0, res.hel.g_decay_tensor[0], res.hel.g_decay_tensor[1]);
+          dv.amp = MassiveSpin1PolSum(iGf0vv, p3, p4);
+
+          // Sequential decay correlations [TBD]
+          // const Tensor2<std::complex<double>, 4, 4> iGvv2psps = iG_vv2psps({},
+          // lts.decaytree[0].p.pdg);  eps3eps4.clear();  eps3eps4.push_back( iGf0vv(mu1, mu2) *
+          // iGvv2psps(mu1, mu2) );
+
+        } else {
           throw std::invalid_argument(
-              "MTensorPomeron:: S->VV Coupling array [size 2] 'hel.g_decay_tensor' not in "
-              "BRANCHING.json for resonance PDG = " +
-              std::to_string(res.p.pdg));
+              "MTensorPomeron::ME3: Unknown decay mode for scalar resonance");
         }
-        // Decay vertex with different outgoing helicity combinations
-        Tensor2<std::complex<double>, 4, 4> iGf0vv =
-            iG_f0vv(p3, p4, M0, res.hel.g_decay_tensor[0], res.hel.g_decay_tensor[1]);
-        eps3eps4 = MassiveSpin1PolSum(iGf0vv, p3, p4);
-
-        // Sequential decay correlations [TBD]
-        // const Tensor2<std::complex<double>, 4, 4> iGvv2psps = iG_vv2psps({},
-        // lts.decaytree[0].p.pdg);  eps3eps4.clear();  eps3eps4.push_back( iGf0vv(mu1, mu2) *
-        // iGvv2psps(mu1, mu2) );
-
-      } else {
-        throw std::invalid_argument("MTensorPomeron::ME3: Unknown decay mode for scalar resonance");
+        dv.valid = true;
       }
+      const std::vector<std::complex<double>> &eps3eps4 = dv.amp;
 
       // Two helicity states for incoming and outgoing protons
       std::size_t index = 0;
@@ -325,8 +332,15 @@ double MTensorPomeron::ME3(gra::LORENTZSCALAR &lts) const {
           iG_Pvv(lts.pfinal[0], lts.q2, res.g_Tensor[0], res.g_Tensor[1]);
 
       // Vector-Pseudoscalar-Pseudoscalar coupling
-      const Tensor1<std::complex<double>, 4> iGvpsps =
-          iG_vpsps(p3, p4, M0, res.hel.g_decay_tensor[0]);
+      if (!dv.valid) {
+        dv.vec   = iG_vpsps(p3, p4, M0, res.hel.g_decay_tensor[0]);
+        dv.valid = true;
+      }
+      const Tensor1<std::complex<double>, 4> &iGvpsps = dv.vec;
+
+      // Outgoing proton spinors (2 helicities)
+      const std::array<DSpinor, 2> ubar_1 = SpinorStates(p1, "ubar");
+      const std::array<DSpinor, 2> ubar_2 = SpinorStates(p2, "ubar");
 
       // Two helicity states for incoming and outgoing protons
       std::size_t index = 0;
@@ -369,7 +383,6 @@ double MTensorPomeron::ME3(gra::LORENTZSCALAR &lts) const {
       //
     } else if (J == 0 && P == -1) {
       Tensor4<std::complex<double>, 4, 4, 4, 4> cvtx;
-      std::vector<std::complex<double>>         eps3eps4;
       cvtx = iG_PPS_total(lts.q1, lts.q2, M0, "pseudoscalar", res.g_Tensor);
 
       // Scalar BW-propagator
@@ -383,8 +396,13 @@ double MTensorPomeron::ME3(gra::LORENTZSCALAR &lts) const {
       }
 
       // Decay vertex with different outgoing helicity combinations
-      Tensor2<std::complex<double>, 4, 4> iDECAY = iG_psvv(p3, p4, M0, res.hel.g_decay_tensor[0]);
-      eps3eps4                                   = MasslessSpin1PolSum(iDECAY, p3, p4);
+      if (!dv.valid) {
+        Tensor2<std::complex<double>, 4, 4> iDECAY =
+            iG_psvv(p3, p4, M0, res.hel.g_decay_tensor[0]);
+        dv.amp   = MasslessSpin1PolSum(iDECAY, p3, p4);
+        dv.valid = true;
+      }
+      const std::vector<std::complex<double>> &eps3eps4 = dv.amp;
 
       // Two helicity states for incoming and outgoing protons
       std::size_t index = 0;
@@ -425,82 +443,71 @@ double MTensorPomeron::ME3(gra::LORENTZSCALAR &lts) const {
       const Tensor4<std::complex<double>, 4, 4, 4, 4> iDf2 =
           iD_TMES(lts.pfinal[0], M0, Gamma, INDEX_UP);
 
-      // Total block
-      std::vector<Tensor2<std::complex<double>, 4, 4>> iD;
-
-      // [PS PS] Pseudoscalar pair decay
-      if (lts.decaytree[0].p.spinX2 == 0 && lts.decaytree[1].p.spinX2 == 0) {
-        const Tensor2<std::complex<double>, 4, 4> iGf2psps =
-            iG_f2psps(p3, p4, M0, res.hel.g_decay_tensor[0]);
-
-        Tensor2<std::complex<double>, 4, 4> temp;
-        temp(mu1, nu1) = iDf2(mu1, nu1, rho1, rho2) * iGf2psps(rho1, rho2);
-        iD.push_back(temp);
-
-        // [V  V] Massive vector pair decay
-      } else if (lts.decaytree[0].p.spinX2 == 2 && lts.decaytree[1].p.spinX2 == 2 &&
-                 lts.decaytree[0].p.pdg != 22 && lts.decaytree[1].p.mass != 22) {
-        if (res.hel.g_decay_tensor.size() != 2) {
-          throw std::invalid_argument(
-              "MTensorPomeron:: T->VV Coupling array [size 2] 'hel.g_decay_tensor' not in "
-              "BRANCHING.json for resonance PDG = " +
-              std::to_string(res.p.pdg));
-        }
-        const Tensor4<std::complex<double>, 4, 4, 4, 4> iGf2vv =
-            iG_f2vv(p3, p4, M0, res.hel.g_decay_tensor[0], res.hel.g_decay_tensor[1]);
-        const std::vector<Tensor2<std::complex<double>, 4, 4>> eps3eps4 =
-            MassiveSpin1PolSum(iGf2vv, p3, p4);
-
-        // Over all helicity combinations
-        Tensor2<std::complex<double>, 4, 4> temp;
-        for (const auto &ind : indices(eps3eps4)) {
-          // Contract
-          temp(mu1, nu1) = iDf2(mu1, nu1, rho1, rho2) * eps3eps4[ind](rho1, rho2);
-          iD.push_back(temp);
-        }
-
-        // Sequential spin correlated decay treatment [TBD]
-        /*
-        const Tensor2<std::complex<double>, 4,4> iGvv2psps = iG_vv2psps({}, lts.decaytree[0].p.pdg);
-
-        // Contract in two steps
-        Tensor2<std::complex<double>, 4,4> A;
-        A(alpha1, beta1) = iGf2vv(rho1, rho2, alpha1, beta1) * iGvv2psps(rho1, rho2);
-        iD(mu1, nu1) = iDf2(mu1, nu1, alpha1, beta1) * A(alpha1, beta1);
-
-        // --------------------------------------------------------------
-        // *** CONTROL CASCADE SAMPLING ***
-        lts.FORCE_FLATMASS2 = true;
-        lts.FORCE_OFFSHELL  = 3.0;
-
-        lts.decaytree[0].PS_active = true;
-        lts.decaytree[1].PS_active = true;
-        // --------------------------------------------------------------
-        */
+      // Decay vertex for each outgoing helicity combination
+      if (!dv.valid) {
+        dv.tensor.clear();
+
+        // [PS PS] Pseudoscalar pair decay
+        if (lts.decaytree[0].p.spinX2 == 0 && lts.decaytree[1].p.spinX2 == 0) {
+          dv.tensor.push_back(iG_f2psps(p3, p4, M0, res.hel.g_decay_tensor[0]));
+
+          // [V  V] Massive vector pair decay
+        } else if (lts.decaytree[0].p.spinX2 == 2 && lts.decaytree[1].p.spinX2 == 2 &&
+                   lts.decaytree[0].p.pdg != 22 && lts.decaytree[1].p.mass != 22) {
+          if (res.hel.g_decay_tensor.size() != 2) {
+            throw std::invalid_argument(
+                "MTensorPomeron:: T->VV Coupling array [size 2] 'hel.g_decay_tensor' not in "
+                "BRANCHING.json for resonance PDG = " +
+                std::to_string(res.p.pdg));
+          }
+          const Tensor4<std::complex<double>, 4, 4, 4, 4> iGf2vv =
+              iG_f2vv(p3, p4, M0, res.hel.g_decay_tensor[0], res.hel.g_decay_tensor[1]);
+          dv.tensor = MassiveSpin1PolSum(iGf2vv, p3, p4);
+
+          // Sequential spin correlated decay treatment [TBD]
+          /*
+          const Tensor2<std::complex<double>, 4,4> iGvv2psps = iG_vv2psps({}, lts.decaytree[0].p.pdg);
+
+          // Contract in two steps
+          Tensor2<std::complex<double>, 4,4> A;
+          A(alpha1, beta1) = iGf2vv(rho1, rho2, alpha1, beta1) * iGvv2psps(rho1, rho2);
+          iD(mu1, nu1) = iDf2(mu1, nu1, alpha1, beta1) * A(alpha1, beta1);
+
+          // --------------------------------------------------------------
+          // *** CONTROL CASCADE SAMPLING ***
+          lts.FORCE_FLATMASS2 = true;
+          lts.FORCE_OFFSHELL  = 3.0;
+
+          lts.decaytree[0].PS_active = true;
+          lts.decaytree[1].PS_active = true;
+          // --------------------------------------------------------------
+          */
+
+          // [y  y] Gamma pair decay
+        } else if (lts.decaytree[0].p.pdg == 22 && lts.decaytree[1].p.pdg == 22) {
+          if (res.hel.g_decay_tensor.size() != 2) {
+            throw std::invalid_argument(
+                "MTensorPomeron:: T->VV Coupling array [size 2] 'hel.g_decay_tensor' not in "
+                "BRANCHING.json for resonance PDG = " +
+                std::to_string(res.p.pdg));
+          }
+          Tensor4<std::complex<double>, 4, 4, 4, 4> iGf2yy =
+              iG_f2yy(p3, p4, M0, res.hel.g_decay_tensor[0], res.hel.g_decay_tensor[1]);
+          dv.tensor = MasslessSpin1PolSum(iGf2yy, p3, p4);
 
-        // [y  y] Gamma pair decay
-      } else if (lts.decaytree[0].p.pdg == 22 && lts.decaytree[1].p.pdg == 22) {
-        if (res.hel.g_decay_tensor.size() != 2) {
+        } else {
           throw std::invalid_argument(
-              "MTensorPomeron:: T->VV Coupling array [size 2] 'hel.g_decay_tensor' not in "
-              "BRANCHING.json for resonance PDG = " +
-              std::to_string(res.p.pdg));
-        }
-        Tensor4<std::complex<double>, 4, 4, 4, 4> iGf2yy =
-            iG_f2yy(p3, p4, M0, res.hel.g_decay_tensor[0], res.hel.g_decay_tensor[1]);
-        const std::vector<Tensor2<std::complex<double>, 4, 4>> eps3eps4 =
-            MasslessSpin1PolSum(iGf2yy, p3, p4);
-
-        // Over all helicity combinations
-        Tensor2<std::complex<double>, 4, 4> temp;
-        for (const auto &ind : indices(eps3eps4)) {
-          // Contract
-          temp(mu1, nu1) = iDf2(mu1, nu1, rho1, rho2) * eps3eps4[ind](rho1, rho2);
-          iD.push_back(temp);
+              "MTensorPomeron::ME3: Unknown decay mode for tensor resonance");
         }
+        dv.valid = true;
+      }
 
-      } else {
-        throw std::invalid_argument("MTensorPomeron::ME3: Unknown decay mode for tensor resonance");
+      // Total block, propagator contracted with the decay vertex
+      std::vector<Tensor2<std::complex<double>, 4, 4>> iD;
+      Tensor2<std::complex<double>, 4, 4>              temp2;
+      for (const auto &ind : indices(dv.tensor)) {
+        temp2(mu1, nu1) = iDf2(mu1, nu1, rho1, rho2) * dv.tensor[ind](rho1, rho2);
+        iD.push_back(temp2);
       }
 
       // Over all central helicity combinations
@@ -564,6 +571,49 @@ double MTensorPomeron::ME3(gra::LORENTZSCALAR &lts) const {
 }
 
 
+// Begin screening loop context, beams do not change over the loop kt-nodes
+void MTensorPomeron::LoopBegin(const gra::LORENTZSCALAR &lts) const {
+  loop.u_a = SpinorStates(lts.pbeam1, "u");
+  loop.u_b = SpinorStates(lts.pbeam2, "u");
+  for (auto &dv : loop.decay) { dv.valid = false; }
+  loop.active = true;
+}
+
+// Decay vertex storage of resonance r: cached within the loop context as long
+// as the decay products are (exactly) the same, otherwise the local one
+MTensorPomeron::DecayVertex &MTensorPomeron::LoopDecayVertex(std::size_t r, const M4Vec &p3,
+                                                             const M4Vec &p4,
+                                                             DecayVertex &local) const {
+  if (!loop.active) { return local; }
+  if (loop.decay.size() <= r) { loop.decay.resize(r + 1); }
+
+  DecayVertex &dv = loop.decay[r];
+  for (std::size_t mu = 0; mu < 4; ++mu) {
+    if (dv.p3[mu] != p3[mu] || dv.p4[mu] != p4[mu]) {
+      dv.valid = false;
+      break;
+    }
+  }
+  if (!dv.valid) {
+    dv.p3 = p3;
+    dv.p4 = p4;
+  }
+  return dv;
+}
+
+// Incoming proton spinors (2 helicities), cached within the loop context
+void MTensorPomeron::BeamSpinors(const gra::LORENTZSCALAR &lts, std::array<DSpinor, 2> &u_a,
+                                 std::array<DSpinor, 2> &u_b) const {
+  if (loop.active) {
+    u_a = loop.u_a;
+    u_b = loop.u_b;
+    return;
+  }
+  u_a = SpinorStates(lts.pbeam1, "u");
+  u_b = SpinorStates(lts.pbeam2, "u");
+}
+
+
 // 2 -> 4 amplitudes
 //
 // return value: matrix element squared with helicities summed over
@@ -601,12 +651,10 @@ double MTensorPomeron::ME4(gra::LORENTZSCALAR &lts) const {
 
   // ------------------------------------------------------------------
 
-  // Incoming and outgoing proton spinors (2 helicities)
-  const std::array<std::vector<std::complex<double>>, 2> u_a = SpinorStates(pa, "u");
-  const std::array<std::vector<std::complex<double>>, 2> u_b = SpinorStates(pb, "u");
-
-  const std::array<std::vector<std::complex<double>>, 2> ubar_1 = SpinorStates(p1, "ubar");
-  const std::array<std::vector<std::complex<double>>, 2> ubar_2 = SpinorStates(p2, "ubar");
+  // Incoming proton spinors (2 helicities)
+  std::array<DSpinor, 2> u_a;
+  std::array<DSpinor, 2> u_b;
+  BeamSpinors(lts, u_a, u_b);
 
 
   // t-channel Pomeron propagators
@@ -652,7 +700,15 @@ double MTensorPomeron::ME4(gra::LORENTZSCALAR &lts) const {
     throw std::invalid_argument(
         "MTensorPomeron::ME4: Invalid daughter spin (J = 0, 1/2, 1 pairs supported)");
   }
-
+  const bool PHOTONS = (SPINMODE == "2xF" && std::abs(lts.decaytree[0].p.pdg) <= 15);
+
+  // Outgoing proton spinors (2 helicities), only the photon couplings use them
+  std::array<DSpinor, 2> ubar_1;
+  std::array<DSpinor, 2> ubar_2;
+  if (PHOTONS) {
+    ubar_1 = SpinorStates(p1, "ubar");
+    ubar_2 = SpinorStates(p2, "ubar");
+  }
 
   // Two helicity states for incoming and outgoing protons
   FOR_PP_HELICITY;
@@ -663,7 +719,7 @@ double MTensorPomeron::ME4(gra::LORENTZSCALAR &lts) const {
 
   // ==============================================================
   // Lepton or quark pair via two photon fusion
-  if (SPINMODE == "2xF" && std::abs(lts.decaytree[0].p.pdg) <= 15) {
+  if (PHOTONS) {
     // Full proton-gamma-proton spinor structure (upper and lower vertex)
     const Tensor1<std::complex<double>, 4> iG_1 = iG_ypp(p1, pa, ubar_1[h1], u_a[ha]);
     const Tensor1<std::complex<double>, 4> iG_2 = iG_ypp(p2, pb, ubar_2[h2], u_b[hb]);
@@ -673,12 +729,12 @@ double MTensorPomeron::ME4(gra::LORENTZSCALAR &lts) const {
     const Tensor2<std::complex<double>, 4, 4> iD_2 = iD_y(lts.t2);
 
     // Fermion propagator
-    const MMatrix<std::complex<double>> iSF_t = iD_F(pt, M_);
-    const MMatrix<std::complex<double>> iSF_u = iD_F(pu, M_);
+    const DMatrix iSF_t = iD_F(pt, M_);
+    const DMatrix iSF_u = iD_F(pu, M_);
 
     // Central spinors (2 helicities)
-    const std::array<std::vector<std::complex<double>>, 2> v_3    = SpinorStates(p3, "v");
-    const std::array<std::vector<std::complex<double>>, 2> ubar_4 = SpinorStates(p4, "ubar");
+    const std::array<DSpinor, 2> v_3    = SpinorStates(p3, "v");
+    const std::array<DSpinor, 2> ubar_4 = SpinorStates(p4, "ubar");
 
 
     double FACTOR = 1.0;
@@ -766,12 +822,12 @@ double MTensorPomeron::ME4(gra::LORENTZSCALAR &lts) const {
   // 2 x fermion (proton-antiproton pair, lambda pair ...)
   else if (SPINMODE == "2xF") {
     // Fermion propagator
-    const MMatrix<std::complex<double>> iSF_t = iD_F(pt, M_);
-    const MMatrix<std::complex<double>> iSF_u = iD_F(pu, M_);
+    const DMatrix iSF_t = iD_F(pt, M_);
+    const DMatrix iSF_u = iD_F(pu, M_);
 
     // Central spinors (2 helicities)
-    const std::array<std::vector<std::complex<double>>, 2> v_3    = SpinorStates(p3, "v");
-    const std::array<std::vector<std::complex<double>>, 2> ubar_4 = SpinorStates(p4, "ubar");
+    const std::array<DSpinor, 2> v_3    = SpinorStates(p3, "v");
+    const std::array<DSpinor, 2> ubar_4 = SpinorStates(p4, "ubar");
 
     // Central fermion helicities
     for (const auto &h3 : indices(v_3)) {
@@ -950,11 +1006,9 @@ double MTensorPomeron::ME6(gra::LORENTZSCALAR &lts) const {
   // ------------------------------------------------------------------
 
   // Incoming and outgoing proton spinors (2 helicities)
-  const std::array<std::vector<std::complex<double>>, 2> u_a = SpinorStates(pa, "u");
-  const std::array<std::vector<std::complex<double>>, 2> u_b = SpinorStates(pb, "u");
-
-  const std::array<std::vector<std::complex<double>>, 2> ubar_1 = SpinorStates(p1, "ubar");
-  const std::array<std::vector<std::complex<double>>, 2> ubar_2 = SpinorStates(p2, "ubar");
+  std::array<DSpinor, 2> u_a;
+  std::array<DSpinor, 2> u_b;
+  BeamSpinors(lts, u_a, u_b);
 
   // ------------------------------------------------------------------
 
@@ -1320,16 +1374,16 @@ Tensor2<std::complex<double>, 4, 4> MTensorPomeron::iG_vv2psps(const std::vector
 //
 // Input as contravariant (upper index) 4-vectors
 //
-Tensor1<std::complex<double>, 4> MTensorPomeron::iG_yee(
-    const M4Vec &prime, const M4Vec &p, const std::vector<std::complex<double>> &ubar,
-    const std::vector<std::complex<double>> &u) const {
+Tensor1<std::complex<double>, 4> MTensorPomeron::iG_yee(const M4Vec &prime, const M4Vec &p,
+                                                        const DSpinor &ubar,
+                                                        const DSpinor &u) const {
   // const double q2 = (prime-p).M2();
   const double e = msqrt(qed::alpha_QED() * 4.0 * PI);  // ~ 0.3, no running
 
   Tensor1<std::complex<double>, 4> T;
   for (const auto &mu : LI) {
     // \bar{spinor} [Gamma Matrix] \spinor product
-    T(mu) = zi * e * matoper::VecMatVecMultiply(ubar, gamma_lo[mu], u);
+    T(mu) = zi * e * dirac::Sandwich(ubar, gamma_lo[mu], u);
   }
   return T;
 }
@@ -1339,23 +1393,22 @@ Tensor1<std::complex<double>, 4> MTensorPomeron::iG_yee(
 //
 // Input as contravariant (upper index) 4-vectors
 //
-Tensor1<std::complex<double>, 4> MTensorPomeron::iG_ypp(
-    const M4Vec &prime, const M4Vec &p, const std::vector<std::complex<double>> &ubar,
-    const std::vector<std::complex<double>> &u) const {
+Tensor1<std::complex<double>, 4> MTensorPomeron::iG_ypp(const M4Vec &prime, const M4Vec &p,
+                                                        const DSpinor &ubar,
+                                                        const DSpinor &u) const {
   const double t    = (prime - p).M2();
   const double e    = msqrt(qed::alpha_QED() * 4.0 * PI);  // ~ 0.3, no running
   const M4Vec  psum = prime - p;
 
+  const std::complex<double> A = F1(t);
+  const std::complex<double> B = zi / (2 * PDG::mp) * F2(t);
+
   Tensor1<std::complex<double>, 4> T;
   for (const auto &mu : LI) {
-    MMatrix<std::complex<double>> SUM(4, 4, 0.0);
-    for (const auto &nu : LI) { SUM += sigma_lo[mu][nu] * psum[nu]; }
-    const MMatrix<std::complex<double>> A = gamma_lo[mu] * F1(t);
-    const MMatrix<std::complex<double>> B = SUM * zi / (2 * PDG::mp) * F2(t);
-    const MMatrix<std::complex<double>> G = (A + B) * (-zi * e);
-
-    // \bar{spinor} [Gamma Matrix] \spinor product
-    T(mu) = matoper::VecMatVecMultiply(ubar, G, u);
+    // \bar{spinor} [Gamma Matrix] \spinor products, sum over sigma_{\mu\nu} psum^\nu
+    std::complex<double> SUM = 0.0;
+    for (const auto &nu : LI) { SUM += dirac::Sandwich(ubar, sigma_lo[mu][nu], u) * psum[nu]; }
+    T(mu) = (A * dirac::Sandwich(ubar, gamma_lo[mu], u) + B * SUM) * (-zi * e);
   }
 
   return T;
@@ -1364,19 +1417,21 @@ Tensor1<std::complex<double>, 4> MTensorPomeron::iG_ypp(
 // gamma - electron - fermion propagator - positron - gamma vertex
 // iGamma_{\mu \nu}
 //
-Tensor2<std::complex<double>, 4, 4> MTensorPomeron::iG_yeebary(
-    const std::vector<std::complex<double>> &ubar, const MMatrix<std::complex<double>> &iSF,
-    const std::vector<std::complex<double>> &v) const {
+Tensor2<std::complex<double>, 4, 4> MTensorPomeron::iG_yeebary(const DSpinor &ubar,
+                                                                const DMatrix &iSF,
+                                                                const DSpinor &v) const {
   const double               e      = msqrt(qed::alpha_QED() * 4.0 * PI);  // ~ 0.3, no running
   const std::complex<double> vertex = zi * e;
 
+  // Right hand side \gamma_\nu v
+  std::array<DSpinor, 4> rhs;
+  for (const auto &nu : LI) { rhs[nu] = gamma_lo[nu] * v; }
+
   Tensor2<std::complex<double>, 4, 4> T;
   for (const auto &mu : LI) {
-    const std::vector<std::complex<double>> lhs = matoper::VecMatMultiply(ubar, gamma_lo[mu] * iSF);
+    const DSpinor lhs = dirac::VecMat(dirac::VecMat(ubar, gamma_lo[mu]), iSF);
 
-    for (const auto &nu : LI) {
-      T(mu, nu) = vertex * matoper::VecMatVecMultiply(lhs, gamma_lo[nu], v) * vertex;
-    }
+    for (const auto &nu : LI) { T(mu, nu) = vertex * dirac::Dot(lhs, rhs[nu]) * vertex; }
   }
   return T;
 }
@@ -1405,28 +1460,27 @@ Tensor2<std::complex<double>, 4, 4> MTensorPomeron::iG_PppHE(const M4Vec &prime,
 //
 // Input as contravariant (upper index) 4-vectors
 //
-Tensor2<std::complex<double>, 4, 4> MTensorPomeron::iG_Ppp(
-    const M4Vec &prime, const M4Vec &p, const std::vector<std::complex<double>> &ubar,
-    const std::vector<std::complex<double>> &u) const {
+Tensor2<std::complex<double>, 4, 4> MTensorPomeron::iG_Ppp(const M4Vec &prime, const M4Vec &p,
+                                                            const DSpinor &ubar,
+                                                            const DSpinor &u) const {
   const double t    = (prime - p).M2();
   const M4Vec  psum = prime + p;
 
   Tensor2<std::complex<double>, 4, 4> T;
   const std::complex<double>          FACTOR = -zi * 3.0 * Param.gPNN * F1(t);
 
-  // Feynman slash
-  const MMatrix<std::complex<double>> slash = FSlash(psum);
-
-  // Aux matrix
-  MMatrix<std::complex<double>> A;
+  // The vertex matrix is linear in gamma matrices, thus
+  // \bar{spinor} [Gamma Matrix] \spinor products are needed only for
+  // \gamma_\mu (4) and the Feynman slash (1)
+  std::array<std::complex<double>, 4> J;
+  for (const auto &mu : LI) { J[mu] = dirac::Sandwich(ubar, gamma_lo[mu], u); }
+  const std::complex<double> S = dirac::Sandwich(ubar, FSlash(psum), u);
 
   for (const auto &mu : LI) {
     for (const auto &nu : LI) {
-      A = (gamma_lo[mu] * (psum % nu) + gamma_lo[nu] * (psum % mu)) * 0.5;
-      if (mu == nu) { A = A - slash * 0.25 * g[mu][nu]; }
-
-      // \bar{spinor} [Gamma Matrix] \spinor product
-      T(mu, nu) = FACTOR * gra::matoper::VecMatVecMultiply(ubar, A, u);
+      std::complex<double> A = (J[mu] * (psum % nu) + J[nu] * (psum % mu)) * 0.5;
+      if (mu == nu) { A -= S * 0.25 * g[mu][nu]; }
+      T(mu, nu) = FACTOR * A;
     }
   }
   return T;
@@ -1439,41 +1493,49 @@ Tensor2<std::complex<double>, 4, 4> MTensorPomeron::iG_Ppp(
 // iG_{\mu_2\nu_2\mu_1\nu_1}
 //
 Tensor4<std::complex<double>, 4, 4, 4, 4> MTensorPomeron::iG_PppbarP(
-    const M4Vec &prime, const std::vector<std::complex<double>> &ubar, const M4Vec &pt,
-    const MMatrix<std::complex<double>> &iSF, const std::vector<std::complex<double>> &v,
-    const M4Vec &p) const {
+    const M4Vec &prime, const DSpinor &ubar, const M4Vec &pt, const DMatrix &iSF,
+    const DSpinor &v, const M4Vec &p) const {
   const std::complex<double> lhs_FACTOR = -zi * 3.0 * Param.gPNN * F1((prime - pt).M2());
   const std::complex<double> rhs_FACTOR = -zi * 3.0 * Param.gPNN * F1((pt - p).M2());
 
   const M4Vec lhs_psum = prime + pt;
   const M4Vec rhs_psum = pt + p;
 
-  // Feynman slashes
-  const MMatrix<std::complex<double>> lhs_slash = FSlash(lhs_psum);
-  const MMatrix<std::complex<double>> rhs_slash = FSlash(rhs_psum);
+  // Both vertex matrices are linear in gamma matrices:
+  // left row spinors \bar{spinor} \gamma_\mu and \bar{spinor} \slash{lhs_psum}
+  std::array<DSpinor, 4> ubarG;
+  for (const auto &mu : LI) { ubarG[mu] = dirac::VecMat(ubar, gamma_lo[mu]); }
+  const DSpinor ubarS = dirac::VecMat(ubar, FSlash(lhs_psum));
 
-  // Aux matrices
-  MMatrix<std::complex<double>> lhs_A;
-  MMatrix<std::complex<double>> rhs_A;
+  // and right column spinors \gamma_\mu v and \slash{rhs_psum} v
+  std::array<DSpinor, 4> Gv;
+  for (const auto &mu : LI) { Gv[mu] = gamma_lo[mu] * v; }
+  const DSpinor Sv = FSlash(rhs_psum) * v;
 
   Tensor4<std::complex<double>, 4, 4, 4, 4> T;
 
   for (const auto &mu2 : LI) {
     for (const auto &nu2 : LI) {
-      lhs_A = (gamma_lo[mu2] * (lhs_psum % nu2) + gamma_lo[nu2] * (lhs_psum % mu2)) * 0.5;
-      if (mu2 == nu2) { lhs_A = lhs_A - lhs_slash * 0.25 * g[mu2][nu2]; }
+      // \bar{spinor} x left vertex
+      DSpinor ubarA;
+      for (std::size_t k = 0; k < 4; ++k) {
+        ubarA[k] = (ubarG[mu2][k] * (lhs_psum % nu2) + ubarG[nu2][k] * (lhs_psum % mu2)) * 0.5;
+        if (mu2 == nu2) { ubarA[k] -= ubarS[k] * 0.25 * g[mu2][nu2]; }
+      }
 
       // Fermion propagator applied in the middle
-      const std::vector<std::complex<double>> ubarM = matoper::VecMatMultiply(ubar, lhs_A * iSF);
+      const DSpinor ubarM = dirac::VecMat(ubarA, iSF);
+
+      std::array<std::complex<double>, 4> J;
+      for (const auto &mu1 : LI) { J[mu1] = dirac::Dot(ubarM, Gv[mu1]); }
+      const std::complex<double> S = dirac::Dot(ubarM, Sv);
 
       for (const auto &mu1 : LI) {
         for (const auto &nu1 : LI) {
-          rhs_A = (gamma_lo[mu1] * (rhs_psum % nu1) + gamma_lo[nu1] * (rhs_psum % mu1)) * 0.5;
-          if (mu1 == nu1) { rhs_A = rhs_A - rhs_slash * 0.25 * g[mu1][nu1]; }
+          std::complex<double> A = (J[mu1] * (rhs_psum % nu1) + J[nu1] * (rhs_psum % mu1)) * 0.5;
+          if (mu1 == nu1) { A -= S * 0.25 * g[mu1][nu1]; }
 
-          // \bar{spinor} [Gamma Matrix] \spinor product
-          T(mu2, nu2, mu1, nu1) =
-              lhs_FACTOR * matoper::VecMatVecMultiply(ubarM, rhs_A, v) * rhs_FACTOR;
+          T(mu2, nu2, mu1, nu1) = lhs_FACTOR * A * rhs_FACTOR;
         }
       }
     }
@@ -2291,7 +2353,7 @@ Tensor4<std::complex<double>, 4, 4, 4, 4> MTensorPomeron::iD_P(double s, double
 
   Tensor4<std::complex<double>, 4, 4, 4, 4> T;
   FOR_EACH_4(LI);
-  T(u, v, k, l) = FACTOR * (g[u][k] * g[v][l] + g[u][l] * g[v][k] - 0.5 * g[u][v] * g[k][l]);
+  T(u, v, k, l) = FACTOR * D_PT(u, v, k, l);
   FOR_EACH_4_END;
 
   return T;
@@ -2307,7 +2369,7 @@ Tensor4<std::complex<double>, 4, 4, 4, 4> MTensorPomeron::iD_2R(double s, double
 
   Tensor4<std::complex<double>, 4, 4, 4, 4> T;
   FOR_EACH_4(LI);
-  T(u, v, k, l) = FACTOR * (g[u][k] * g[v][l] + g[u][l] * g[v][k] - 0.5 * g[u][v] * g[k][l]);
+  T(u, v, k, l) = FACTOR * D_PT(u, v, k, l);
   FOR_EACH_4_END;
 
   return T;
@@ -2578,6 +2640,11 @@ void MTensorPomeron::CalcRTensor() {
   R_DDUU(a, b, c, d) = R(a, b, alfa, beta) * gT(c, alfa) * gT(d, beta);
   R_UUDD(a, b, c, d) = R(alfa, beta, c, d) * gT(a, alfa) * gT(b, beta);
 
+  // Pomeron and tensor Reggeon propagator structure
+  FOR_EACH_4(LI);
+  D_PT(u, v, k, l) = g[u][k] * g[v][l] + g[u][l] * g[v][k] - 0.5 * g[u][v] * g[k][l];
+  FOR_EACH_4_END;
+
   // -------------------------------------------------------------------
   // Pre-calculated tensor contractions for tensor resonances
 
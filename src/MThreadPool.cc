@@ -0,0 +1,168 @@
+// Persistent worker thread pool with optional CPU affinity
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Own
+#include "Graniitti/MThreadPool.h"
+
+namespace gra {
+
+namespace {
+
+// Parse Linux cpulist format, e.g. "0-7,16-23"
+std::vector<int> ParseCPUList(const std::string &str) {
+  std::vector<int>  cpus;
+  std::stringstream ss(str);
+  std::string       item;
+  while (std::getline(ss, item, ',')) {
+    if (item.empty()) { continue; }
+    const std::size_t dash = item.find('-');
+    try {
+      if (dash == std::string::npos) {
+        cpus.push_back(std::stoi(item));
+      } else {
+        const int a = std::stoi(item.substr(0, dash));
+        const int b = std::stoi(item.substr(dash + 1));
+        for (int k = a; k <= b; ++k) { cpus.push_back(k); }
+      }
+    } catch (...) {
+      // Skip malformed entry
+    }
+  }
+  return cpus;
+}
+
+// Read CPU lists per NUMA node from sysfs (empty if not available)
+std::vector<std::vector<int>> NUMANodes() {
+  std::vector<std::vector<int>> nodes;
+  for (int n = 0; n < 1024; ++n) {
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist");
+    if (!file.is_open()) { break; }
+    std::string line;
+    std::getline(file, line);
+    std::vector<int> cpus = ParseCPUList(line);
+    if (!cpus.empty()) { nodes.push_back(cpus); }
+  }
+  return nodes;
+}
+
+}  // namespace
+
+MThreadPool::MThreadPool(unsigned int N, const std::string &affinity) : AFFINITY(affinity) {
+  if (N < 1) { throw std::invalid_argument("MThreadPool: Number of threads < 1"); }
+  if (!ValidAffinity(AFFINITY)) {
+    throw std::invalid_argument("MThreadPool: Unknown affinity mode: " + AFFINITY +
+                                " (valid: none, compact, numa)");
+  }
+  CreateCPUMap(N);
+
+  workers.reserve(N);
+  for (unsigned int tid = 0; tid < N; ++tid) {
+    workers.push_back(std::thread([this, tid] { WorkerLoop(tid); }));
+  }
+}
+
+MThreadPool::~MThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    stop = true;
+  }
+  cv_task.notify_all();
+  for (auto &w : workers) {
+    if (w.joinable()) { w.join(); }
+  }
+}
+
+// Worker k -> CPU id mapping
+void MThreadPool::CreateCPUMap(unsigned int N) {
+  cpumap.clear();
+  if (AFFINITY == "none") { return; }
+
+  const unsigned int NCPU = std::max(1u, std::thread::hardware_concurrency());
+
+  if (AFFINITY == "numa") {
+    const std::vector<std::vector<int>> nodes = NUMANodes();
+    if (nodes.size() > 1) {
+      // Interleave workers over nodes: node0, node1, ..., node0, node1, ...
+      std::vector<std::size_t> next(nodes.size(), 0);
+      for (unsigned int k = 0; k < N; ++k) {
+        const std::size_t n = k % nodes.size();
+        cpumap.push_back(nodes[n][next[n] % nodes[n].size()]);
+        ++next[n];
+      }
+      return;
+    }
+    // Single node system: same as compact
+  }
+  for (unsigned int k = 0; k < N; ++k) { cpumap.push_back(k % NCPU); }
+}
+
+void MThreadPool::WorkerLoop(unsigned int tid) {
+#if defined(__linux__)
+  if (!cpumap.empty()) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpumap[tid], &cpuset);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) != 0) {
+      std::cerr << "MThreadPool: Could not set affinity of worker " << tid << " to CPU "
+                << cpumap[tid] << std::endl;
+    }
+  }
+#endif
+
+  std::uint64_t seen = 0;
+  while (true) {
+    std::function<void(unsigned int)> task;
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      cv_task.wait(lock, [&] { return stop || generation != seen; });
+      if (stop) { return; }
+      seen = generation;
+      task = task_;
+    }
+
+    // Exceptions are passed on to the caller of Run()
+    std::exception_ptr eptr = nullptr;
+    try {
+      task(tid);
+    } catch (...) { eptr = std::current_exception(); }
+
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      if (eptr && !task_exception) { task_exception = eptr; }
+      --pending;
+      if (pending == 0) { cv_done.notify_one(); }
+    }
+  }
+}
+
+void MThreadPool::Run(const std::function<void(unsigned int)> &task) {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    task_          = task;
+    task_exception = nullptr;
+    pending        = workers.size();
+    ++generation;
+  }
+  cv_task.notify_all();
+
+  std::unique_lock<std::mutex> lock(mtx);
+  cv_done.wait(lock, [&] { return pending == 0; });
+  if (task_exception) { std::rethrow_exception(task_exception); }
+}
+
+}  // namespace gra
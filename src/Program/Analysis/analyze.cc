@@ -14,6 +14,7 @@
 #include <iomanip>
 #include <iostream>
 #include <random>
+#include <thread>
 #include <vector>
 
 // ROOT
@@ -297,7 +298,7 @@ int main(int argc, char *argv[]) {
   try {
     cxxopts::Options options(argv[0], "");
     options.add_options()("i,input",
-                          "input HepMC3 file                <input1,input2,...> (without .hepmc3)",
+                          "input HepMC3 file                <in1+in2,in3,...> (without .hepmc3)",
                           cxxopts::value<std::string>())(
         "g,pdg", "central final state PDG          <input1,input2,...>",
         cxxopts::value<std::string>())("n,number",
@@ -319,7 +320,9 @@ int main(int argc, char *argv[]) {
                                   cxxopts::value<int>())(
         "S,scale", "scale plots                      <scale1,scale2,...>",
         cxxopts::value<std::string>())("R,ratio", "ratio plotting on                <true|false>",
-                                       cxxopts::value<std::string>())("H,help", "Help");
+                                       cxxopts::value<std::string>())(
+        "c,cores", "analysis threads (opt.)          <value>", cxxopts::value<int>())("H,help",
+                                                                                     "Help");
 
     auto r = options.parse(argc, argv);
 
@@ -366,6 +369,10 @@ int main(int argc, char *argv[]) {
     int MAXEVENTS = 1e9;
     if (r.count("X")) { MAXEVENTS = r["X"].as<int>(); }
 
+    // Worker threads per input
+    unsigned int THREADS = std::max(1u, std::thread::hardware_concurrency());
+    if (r.count("cores")) { THREADS = std::max(1, r["cores"].as<int>()); }
+
     std::string units      = r["units"].as<std::string>();
     double      multiplier = 0.0;
 
@@ -447,8 +454,9 @@ int main(int argc, char *argv[]) {
       std::cout << i << " :: input:" << inputfile[i] << std::endl;
 
       analysis.push_back(std::make_shared<MAnalyzer>("ID" + std::to_string(i)));
-      cross_section[i] = analysis[i]->HepMC3_OracleFill(
-          inputfile[i], (uint)multiplicity[i], finalstatePDG[i], (uint)MAXEVENTS, h1, h2, hP, i);
+      cross_section[i] =
+          analysis[i]->HepMC3_OracleFill(inputfile[i], (uint)multiplicity[i], finalstatePDG[i],
+                                         (uint)MAXEVENTS, h1, h2, hP, i, THREADS);
     }
     // Name
     std::string fullpath = gra::aux::GetBasePath(2) + "/figs/";
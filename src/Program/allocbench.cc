@@ -0,0 +1,175 @@
+// GRANIITTI - Monte Carlo event generator for high energy diffraction
+// https://github.com/mieskolainen/graniitti
+//
+// <Heap allocation micro-benchmark of the per-event kinematics and amplitude path>
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+
+// Own
+#include "Graniitti/M4Vec.h"
+#include "Graniitti/MAux.h"
+#include "Graniitti/MGraniitti.h"
+#include "Graniitti/MKinematics.h"
+#include "Graniitti/MTimer.h"
+
+using gra::aux::indices;
+using namespace gra;
+
+// ----------------------------------------------------------------------
+// Global allocation counter
+
+static std::atomic<unsigned long long> g_allocs{0};
+
+void *operator new(std::size_t n) {
+  ++g_allocs;
+  if (void *p = std::malloc(n == 0 ? 1 : n)) { return p; }
+  throw std::bad_alloc();
+}
+void *operator new[](std::size_t n) { return operator new(n); }
+void *operator new(std::size_t n, std::align_val_t al) {
+  ++g_allocs;
+  const std::size_t A = static_cast<std::size_t>(al);
+  if (void *p = std::aligned_alloc(A, ((n + A - 1) / A) * A)) { return p; }
+  throw std::bad_alloc();
+}
+void *operator new[](std::size_t n, std::align_val_t al) { return operator new(n, al); }
+void  operator delete(void *p) noexcept { std::free(p); }
+void  operator delete[](void *p) noexcept { std::free(p); }
+void  operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void  operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void  operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void  operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void  operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void  operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// ----------------------------------------------------------------------
+
+// Allocations and time per EventWeight call, after warm-up (buffers sized)
+void EventLoop(MProcess *proc, unsigned int N, const std::string &label) {
+  std::mt19937_64                        rng(12345);
+  std::uniform_real_distribution<double> flat(0.0, 1.0);
+  std::vector<double>                    randvec(proc->GetdLIPSDim(), 0.0);
+  AuxIntData                             aux;
+
+  auto run = [&](unsigned int n, unsigned int &valid) {
+    for (unsigned int k = 0; k < n; ++k) {
+      for (auto &r : randvec) { r = flat(rng); }
+      aux = AuxIntData();
+      proc->EventWeight(randvec, aux);
+      if (aux.Valid()) { ++valid; }
+    }
+  };
+
+  unsigned int valid = 0;
+  run(std::max(1u, N / 10), valid);
+
+  valid                       = 0;
+  MTimer                   tt(true);
+  const unsigned long long a0 = g_allocs;
+  run(N, valid);
+  const unsigned long long a1 = g_allocs;
+  const double             t  = tt.ElapsedSec();
+
+  printf("%-34s allocations / call = %8.3f  (valid %5.1f %%, %0.2E calls/sec) \n", label.c_str(),
+         (a1 - a0) / static_cast<double>(N), 100.0 * valid / N, N / std::max(t, 1e-9));
+}
+
+// Main
+int main(int argc, char *argv[]) {
+  aux::PrintArgv(argc, argv);
+
+  std::string  inputfile = gra::aux::GetBasePath(2) + "/input/test.json";
+  std::string  process   = "PP[CON]<C> -> pi+ pi-";
+  unsigned int N         = 10000;
+
+  if (argc >= 2) { inputfile = argv[1]; }
+  if (argc >= 3) { process = argv[2]; }
+  if (argc >= 4) { N = atoi(argv[3]); }
+  if (argc < 2) {
+    printf("Example input ./allocbench input.json \"%s\" %u \n\n", process.c_str(), N);
+  }
+
+  // ------------------------------------------------------------------
+  // 1. M4Vec algebra, boosts and rotations (scalar and SoA)
+  {
+    std::mt19937_64                        rng(12345);
+    std::uniform_real_distribution<double> flat(-1.0, 1.0);
+
+    const unsigned int   K = 8;
+    std::vector<M4Vec>   p(K);
+    kinematics::M4VecSoA soa;
+    soa.resize(K);
+    const M4Vec boost(0.1, -0.2, 3.0, 5.0);
+
+    double                   sum = 0.0;
+    const unsigned long long a0  = g_allocs;
+    for (unsigned int n = 0; n < 100000; ++n) {
+      for (const auto &i : indices(p)) {
+        p[i] = M4Vec(flat(rng), flat(rng), flat(rng), 0.0);
+        p[i].SetE(std::sqrt(p[i].P3mod2() + 0.0195));
+        M4Vec q = p[i] * 2.0 - boost;
+        q += p[i];
+        kinematics::LorentzBoost(boost, boost.M(), q, 1);
+        kinematics::Rotate(q, 0.3, 1.2);
+        sum += q.M2() + q * p[i] + q.Pt() + q.Phi();
+      }
+      soa.Load(p);
+      kinematics::LorentzBoostSoA(boost, boost.M(), soa, -1);
+      kinematics::RotateSoA(soa, 0.3, 1.2);
+      kinematics::RotateZSoA(soa, 0.7);
+      soa.Store(p);
+      sum += p[0].E();
+    }
+    const unsigned long long a1 = g_allocs;
+    printf("M4Vec algebra + boosts/rotations:  allocations = %llu  (checksum %0.6E) \n\n", a1 - a0,
+           sum);
+  }
+
+  // ------------------------------------------------------------------
+  // 2. Per-event kinematics and amplitude path
+  std::unique_ptr<MGraniitti> gen = std::make_unique<MGraniitti>();
+  try {
+    gen->ReadInput(inputfile, process);
+    gen->proc->post_Constructor();
+    gen->proc->SetHistograms(0);
+
+    // Kinematics only: BNRandomKin, BNBuildKin, decay tree, Lorentz scalars, cuts
+    gen->proc->SetScreening(false);
+    gen->proc->SetFLATAMP(1);
+    EventLoop(gen->proc, N, "Kinematics (flat amplitude):");
+
+    // Bare amplitude
+    gen->proc->SetFLATAMP(0);
+    EventLoop(gen->proc, N, "Kinematics + bare amplitude:");
+
+    // Screened amplitude (difference to the bare one is S3ScreenedAmp2)
+    gen->proc->SetScreening(true);
+    if (gen->proc->Eikonal.IsInitialized() == false) {
+      gen->proc->Eikonal.S3Constructor(gen->proc->GetMandelstam_s(), gen->proc->GetInitialState(),
+                                       false);
+    }
+    EventLoop(gen->proc, std::max(1u, N / 10), "Kinematics + screened amplitude:");
+  } catch (const std::invalid_argument &e) {
+    gra::aux::PrintGameOver();
+    std::cerr << "Exception catched: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  } catch (const std::ios_base::failure &e) {
+    std::cerr << "Exception catched: std::ios_base::failure: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  } catch (...) {
+    std::cerr << "Exception catched: Unspecified (...) (Probably JSON input)" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,156 @@
+// GRANIITTI - Monte Carlo event generator for high energy diffraction
+// https://github.com/mieskolainen/graniitti
+//
+// <Tensor Pomeron amplitude (ME3, ME4, ME6) timing and allocation benchmark>
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+
+// Own
+#include "Graniitti/MAux.h"
+#include "Graniitti/MGraniitti.h"
+
+using gra::aux::indices;
+using namespace gra;
+
+// ----------------------------------------------------------------------
+// Global allocation counter
+
+static std::atomic<unsigned long long> g_allocs{0};
+
+void *operator new(std::size_t n) {
+  ++g_allocs;
+  if (void *p = std::malloc(n == 0 ? 1 : n)) { return p; }
+  throw std::bad_alloc();
+}
+void *operator new[](std::size_t n) { return operator new(n); }
+void *operator new(std::size_t n, std::align_val_t al) {
+  ++g_allocs;
+  const std::size_t A = static_cast<std::size_t>(al);
+  if (void *p = std::aligned_alloc(A, ((n + A - 1) / A) * A)) { return p; }
+  throw std::bad_alloc();
+}
+void *operator new[](std::size_t n, std::align_val_t al) { return operator new(n, al); }
+void  operator delete(void *p) noexcept { std::free(p); }
+void  operator delete[](void *p) noexcept { std::free(p); }
+void  operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void  operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void  operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void  operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void  operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void  operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// ----------------------------------------------------------------------
+
+struct BenchResult {
+  std::string  label;
+  double       usec   = 0.0;  // Time per amplitude call
+  double       allocs = 0.0;  // Heap allocations per amplitude call
+  double       check  = 0.0;  // Checksum (mean |A|^2)
+  unsigned int N      = 0;    // Number of phase space points
+};
+
+// Time the bare amplitude only, at N phase space points passing the cuts
+BenchResult AmpLoop(MProcess *proc, unsigned int N, const std::string &label) {
+  std::mt19937_64                        rng(12345);
+  std::uniform_real_distribution<double> flat(0.0, 1.0);
+  std::vector<double>                    randvec(proc->GetdLIPSDim(), 0.0);
+  AuxIntData                             aux;
+
+  // Kinematics only here
+  proc->SetScreening(false);
+  proc->SetFLATAMP(1);
+
+  BenchResult res;
+  res.label = label;
+
+  unsigned int       valid  = 0;
+  unsigned long long trials = 0;
+  double             sec    = 0.0;
+  unsigned long long allocs = 0;
+
+  while (valid < N && trials < 1000ULL * N) {
+    ++trials;
+    for (auto &r : randvec) { r = flat(rng); }
+    aux = AuxIntData();
+    proc->EventWeight(randvec, aux);
+    if (!aux.Valid()) { continue; }
+
+    // Warm-up (first call binds the amplitude)
+    if (valid == 0) { proc->ProcPtr.GetBareAmplitude2(proc->lts); }
+
+    const auto               t0   = std::chrono::steady_clock::now();
+    const unsigned long long a0   = g_allocs;
+    const double             amp2 = proc->ProcPtr.GetBareAmplitude2(proc->lts);
+    const unsigned long long a1   = g_allocs;
+    const auto               t1   = std::chrono::steady_clock::now();
+    sec += std::chrono::duration<double>(t1 - t0).count();
+    allocs += a1 - a0;
+    res.check += amp2;
+    ++valid;
+  }
+  res.N = valid;
+  if (valid > 0) {
+    res.usec   = 1e6 * sec / valid;
+    res.allocs = allocs / static_cast<double>(valid);
+    res.check /= valid;
+  }
+  return res;
+}
+
+// Main
+int main(int argc, char *argv[]) {
+  aux::PrintArgv(argc, argv);
+
+  std::string  inputfile = gra::aux::GetBasePath(2) + "/input/test.json";
+  unsigned int N         = 1000;
+
+  if (argc >= 2) { inputfile = argv[1]; }
+  if (argc >= 3) { N = atoi(argv[2]); }
+  if (argc < 2) { printf("Example input ./ampbench input.json %u \n\n", N); }
+
+  // Processes covering ME3, ME4 (scalar, fermion and photon-fermion paths) and ME6
+  const std::vector<std::pair<std::string, std::string>> processes = {
+      {"ME3 PP[RESTENSOR] f2 > pi+pi-", "PP[RESTENSOR]<F> -> pi+ pi- @RES{f2_1270:1}"},
+      {"ME4 PP[CONTENSOR] pi+pi-", "PP[CONTENSOR]<F> -> pi+ pi-"},
+      {"ME4 PP[CONTENSOR] p pbar", "PP[CONTENSOR]<F> -> p+ p-"},
+      {"ME4 yy[QED] mu+mu-", "yy[QED]<F> -> mu+ mu-"},
+      {"ME6 PP[CONTENSOR24] rho rho",
+       "PP[CONTENSOR24]<F> -> rho(770)0 > {pi+ pi-} rho(770)0 > {pi+ pi-}"}};
+
+  std::vector<BenchResult> results;
+
+  for (const auto &i : indices(processes)) {
+    std::unique_ptr<MGraniitti> gen = std::make_unique<MGraniitti>();
+    try {
+      gen->ReadInput(inputfile, processes[i].second);
+      gen->proc->post_Constructor();
+      gen->proc->SetHistograms(0);
+      results.push_back(AmpLoop(gen->proc, N, processes[i].first));
+    } catch (const std::invalid_argument &e) {
+      std::cerr << "Exception catched: " << processes[i].second << " : " << e.what() << std::endl;
+    } catch (...) {
+      std::cerr << "Exception catched: Unspecified (...) : " << processes[i].second << std::endl;
+    }
+  }
+
+  std::cout << std::endl;
+  for (const auto &r : results) {
+    printf("%-30s N = %5u | time / call = %9.3f usec | allocs / call = %7.1f | ",
+           r.label.c_str(), r.N, r.usec, r.allocs);
+    printf("<|A|^2> = %0.6E \n", r.check);
+  }
+  std::cout << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+// GRANIITTI - Monte Carlo event generator for high energy diffraction
+// https://github.com/mieskolainen/graniitti
+//
+// <Fourier-Bessel integral micro-benchmark: scalar versus batched kernel>
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Own
+#include "Graniitti/MAux.h"
+#include "Graniitti/MBessel.h"
+#include "Graniitti/MMath.h"
+#include "Graniitti/MTimer.h"
+
+// Libraries
+#include "extmath.hpp"
+
+using gra::aux::indices;
+using namespace gra;
+
+// Toy elastic amplitude A(kt) (same shape and cost class as the eikonal input)
+std::complex<double> Amplitude(double kt) {
+  const double t = -math::pow2(kt);
+  return std::exp(5.0 * t) * std::complex<double>(0.14, 1.0) * std::pow(1e8, 1.08 + 0.25 * t);
+}
+
+// Reference: scalar integrand per call, as in the original MEikonal::S3Density
+std::complex<double> ScalarFB(double bt, unsigned int N, double MINKT, double MAXKT) {
+  const double                      STEP = (MAXKT - MINKT) / N;
+  std::vector<std::complex<double>> f(N + 1, 0.0);
+  for (const auto &i : indices(f)) {
+    const double kt = MINKT + i * STEP;
+    f[i]            = Amplitude(kt) * BESSJ0(bt * kt) * kt;
+  }
+  return math::CSIntegral(f, STEP);
+}
+
+// Main
+int main(int argc, char *argv[]) {
+  aux::PrintArgv(argc, argv);
+
+  unsigned int N      = 10000;  // Integral discretization
+  unsigned int NPOINT = 1000;   // Number of grid points (bt values)
+
+  if (argc == 3) {
+    N      = atoi(argv[1]);
+    NPOINT = atoi(argv[2]);
+  } else {
+    printf("Example input ./fbbench %u %u \n\n", N, NPOINT);
+  }
+  N += N % 2;  // Simpson needs even
+
+  const double MINKT = 1e-9;
+  const double MAXKT = 30.0;
+  const double MAXBT = 50.0;
+
+  // ------------------------------------------------------------------
+  // 1. Bessel J0 throughput and accuracy
+  {
+    std::mt19937_64                        rng(12345);
+    std::uniform_real_distribution<double> flat(0.0, 1500.0);
+    std::vector<double>                    x(1000000);
+    for (auto &v : x) { v = flat(rng); }
+    x[0] = 0.0;
+    x[1] = 8.0;
+
+    std::vector<double> y0(x.size());
+    std::vector<double> y1(x.size());
+
+    MTimer timer(true);
+    for (const auto &i : indices(x)) { y0[i] = BESSJ0(x[i]); }
+    const double t0 = timer.ElapsedSec();
+
+    timer.Reset();
+    math::BESSJ0Batch(x.data(), y1.data(), x.size());
+    const double t1 = timer.ElapsedSec();
+
+    double maxdiff = 0.0;
+    for (const auto &i : indices(x)) { maxdiff = std::max(maxdiff, std::abs(y0[i] - y1[i])); }
+
+    printf("BESSJ0 (%lu values):\n", x.size());
+    printf("  scalar:  %0.3f sec \n", t0);
+    printf("  batched: %0.3f sec  (speedup x %0.1f) \n", t1, t0 / std::max(t1, 1e-3));
+    printf("  max |J0_scalar - J0_batched| = %0.3E \n\n", maxdiff);
+  }
+
+  // ------------------------------------------------------------------
+  // 2. Fourier-Bessel integral over a grid of bt points
+  {
+    const double STEP = (MAXBT - 0.0) / NPOINT;
+
+    // Scalar reference
+    MTimer                            timer(true);
+    std::vector<std::complex<double>> I0(NPOINT + 1);
+    for (const auto &i : indices(I0)) { I0[i] = ScalarFB(i * STEP, N, MINKT, MAXKT); }
+    const double t0 = timer.ElapsedSec();
+
+    // Precomputed structure-of-arrays kernel + batched J0
+    timer.Reset();
+    const double              kt_STEP = (MAXKT - MINKT) / N;
+    const std::vector<double> w       = math::CSWeights(N, kt_STEP);
+    math::FBKernel            K;
+    K.x.resize(N + 1);
+    K.re.resize(N + 1);
+    K.im.resize(N + 1);
+    for (const auto &i : indices(w)) {
+      const double               kt = MINKT + i * kt_STEP;
+      const std::complex<double> v  = Amplitude(kt) * kt * w[i];
+      K.x[i]                        = kt;
+      K.re[i]                       = std::real(v);
+      K.im[i]                       = std::imag(v);
+    }
+    std::vector<std::complex<double>> I1(NPOINT + 1);
+    for (const auto &i : indices(I1)) { I1[i] = K.Integral(i * STEP); }
+    const double t1 = timer.ElapsedSec();
+
+    // Difference relative to the maximum (the integral crosses zero as a function of bt)
+    double maxabs  = 0.0;
+    double maxdiff = 0.0;
+    for (const auto &i : indices(I0)) {
+      maxabs  = std::max(maxabs, std::abs(I0[i]));
+      maxdiff = std::max(maxdiff, std::abs(I0[i] - I1[i]));
+    }
+
+    printf("Fourier-Bessel integral (N = %u, %u grid points):\n", N, NPOINT + 1);
+    printf("  scalar:  %0.3f sec \n", t0);
+    printf("  batched: %0.3f sec  (speedup x %0.1f) \n", t1, t0 / std::max(t1, 1e-3));
+    printf("  max |I_scalar - I_batched| / max |I_scalar| = %0.3E \n\n", maxdiff / maxabs);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -43,12 +43,18 @@ int main(int argc, char *argv[]) {
     options.add_options("GENERALPARAM")
 
         ("o,OUTPUT", "Output name            <string>", cxxopts::value<std::string>())(
-            "f,FORMAT", "Output format          <hepmc3|hepmc2|hepevt>",
+            "f,FORMAT", "Output format          <hepmc3|hepmc2|hepevt|lhe|grcol>",
             cxxopts::value<std::string>())("n,NEVENT", "Number of events       <integer32>",
                                            cxxopts::value<unsigned int>())(
             "g,INTEGRATOR", "Integrator             <VEGAS|FLAT>", cxxopts::value<std::string>())(
             "w,WEIGHTED", "Weighted events        <true|false>", cxxopts::value<std::string>())(
-            "c,CORES", "Number of CPU threads  <integer>", cxxopts::value<unsigned int>());
+            "c,CORES", "Number of CPU threads  <integer>", cxxopts::value<unsigned int>())(
+            "a,AFFINITY", "Thread CPU affinity    <none|compact|numa>",
+            cxxopts::value<std::string>())("k,CHECKPOINT", "VEGAS checkpoint       <true|false>",
+                                           cxxopts::value<std::string>())(
+            "j,SHARD", "Shard index/count      <integer>/<integer>", cxxopts::value<std::string>())(
+            "z,COMPRESS", "Output compression     <none|gzip|gzip:1-9>",
+            cxxopts::value<std::string>());
 
     options.add_options("PROCESSPARAM")("p,PROCESS", "Process                 <string>",
                                         cxxopts::value<std::string>())(
@@ -190,6 +196,19 @@ int main(int argc, char *argv[]) {
       gen->SetWeighted(val == "true");
     }
     if (r.count("c")) { gen->SetCores(r["c"].as<unsigned int>()); }
+    if (r.count("a")) { gen->SetAffinity(r["a"].as<std::string>()); }
+    if (r.count("k")) {
+      const std::string val = r["k"].as<std::string>();
+      gen->SetCheckpoint(val == "true");
+    }
+    if (r.count("j")) {
+      const std::vector<int> val = aux::SplitStr2Int(r["j"].as<std::string>(), '/');
+      if (val.size() != 2) {
+        throw std::invalid_argument("Error: Use option -j as <index>/<count>, e.g. -j 3/16");
+      }
+      gen->SetShard(val[0], val[1]);
+    }
+    if (r.count("z")) { gen->SetCompress(r["z"].as<std::string>()); }
 
     // Process parameters (adding more might be involved due to initialization
     // in
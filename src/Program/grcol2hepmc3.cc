@@ -0,0 +1,84 @@
+// GRANIITTI - Monte Carlo event generator for high energy diffraction
+// https://github.com/mieskolainen/graniitti
+//
+// <Columnar binary (.grcol) to HepMC3 format converter>
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+// HepMC3
+#include "HepMC3/GenRunInfo.h"
+
+// Own
+#include "Graniitti/MAux.h"
+#include "Graniitti/MColumnar.h"
+#include "Graniitti/MEventRecord.h"
+#include "Graniitti/MEventWriter.h"
+
+using namespace gra;
+
+int main(int argc, char *argv[]) {
+  aux::PrintArgv(argc, argv);
+
+  if (argc != 2) {
+    std::cout << std::endl;
+    std::cout << "[Columnar binary to HepMC3 converter]" << std::endl << std::endl;
+    std::cout << "Example: ./grcol2hepmc3 filename.grcol" << std::endl;
+
+    aux::CheckUpdate();
+    return EXIT_FAILURE;
+  }
+
+  const std::string inputfile(argv[1]);
+  const std::string outputfile = inputfile + ".hepmc3";
+
+  int events = 0;
+
+  try {
+    MReaderColumnar input(inputfile);
+
+    std::ofstream outputStream(outputfile, std::ios::out | std::ios::trunc);
+    if (!outputStream.is_open()) { throw std::invalid_argument("Cannot open file " + outputfile); }
+
+    // Run info from the header
+    std::shared_ptr<HepMC3::GenRunInfo> runinfo = std::make_shared<HepMC3::GenRunInfo>();
+    runinfo->tools().push_back({input.Header().generator, "", std::string("Generator")});
+    runinfo->tools().push_back({input.Header().card, "1.0", std::string("Steering card")});
+
+    MWriterHepMC3 writer(outputStream, runinfo);
+    MEventRecord  record;
+
+    while (input.ReadEvent(record)) {
+      writer.Write(record);
+      ++events;
+
+      if (events % 10000 == 0) { printf("%d events processed \n", events); }
+    }
+    writer.Close();
+  } catch (const std::invalid_argument &e) {
+    std::cerr << "Exception catched: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (events > 0) {
+    const double input_size  = aux::GetFileSize(inputfile) / 1.0e6;
+    const double output_size = aux::GetFileSize(outputfile) / 1.0e6;
+
+    printf("GRCOL:  input  (%0.1f MB, %0.5f MB/event) %s \n", input_size, input_size / events,
+           inputfile.c_str());
+    printf("HepMC3: output (%0.1f MB, %0.5f MB/event) %s \n", output_size, output_size / events,
+           outputfile.c_str());
+    printf("Total %d events converted from GRCOL to HepMC3 \n", events);
+  }
+
+  std::cout << "[grcol2hepmc3: done]" << std::endl;
+  aux::CheckUpdate();
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,102 @@
+// GRANIITTI - Monte Carlo event generator for high energy diffraction
+// https://github.com/mieskolainen/graniitti
+//
+// <HepMC3 to columnar binary (.grcol) format converter>
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+// HepMC3
+#include "HepMC3/GenEvent.h"
+#include "HepMC3/GenRunInfo.h"
+#include "HepMC3/ReaderAscii.h"
+
+// Own
+#include "Graniitti/MAux.h"
+#include "Graniitti/MColumnar.h"
+#include "Graniitti/MCompress.h"
+#include "Graniitti/MEventRecord.h"
+
+using namespace gra;
+
+int main(int argc, char *argv[]) {
+  aux::PrintArgv(argc, argv);
+
+  if (argc != 2) {
+    std::cout << std::endl;
+    std::cout << "[HepMC3 to columnar binary converter]" << std::endl << std::endl;
+    std::cout << "Example: ./hepmc3togrcol filename.hepmc3" << std::endl;
+
+    aux::CheckUpdate();
+    return EXIT_FAILURE;
+  }
+
+  const std::string inputfile(argv[1]);
+  const std::string outputfile = inputfile + ".grcol";
+
+  int events = 0;
+
+  try {
+    MInputStream stream(inputfile);
+    if (!stream.IsOpen()) { throw std::invalid_argument("Cannot open file " + inputfile); }
+    HepMC3::ReaderAscii input(stream);
+
+    std::ofstream outputStream(outputfile, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!outputStream.is_open()) { throw std::invalid_argument("Cannot open file " + outputfile); }
+
+    std::shared_ptr<MWriterColumnar> writer = nullptr;
+    HepMC3::GenEvent                 ev(HepMC3::Units::GEV, HepMC3::Units::MM);
+    MEventRecord                     record;
+
+    while (!input.failed()) {
+      input.read_event(ev);
+      if (input.failed()) { break; }
+
+      // Writer created with the run info of the first event
+      if (writer == nullptr) {
+        MColumnarHeader header;
+        if (ev.run_info() != nullptr) {
+          const auto &tools = ev.run_info()->tools();
+          if (tools.size() > 0) { header.generator = tools[0].name + " " + tools[0].version; }
+          if (tools.size() > 1) { header.card = tools[1].name; }
+        }
+        if (aux::FileExist(header.card)) {
+          header.cardhash = aux::djb2hash(aux::GetInputData(header.card));
+        }
+        writer = std::make_shared<MWriterColumnar>(outputStream, header);
+      }
+
+      record.FromGenEvent(ev);
+      writer->Write(record);
+      ++events;
+
+      if (events % 10000 == 0) { printf("%d events processed \n", events); }
+    }
+    if (writer != nullptr) { writer->Close(); }
+  } catch (const std::invalid_argument &e) {
+    std::cerr << "Exception catched: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (events > 0) {
+    const double input_size  = aux::GetFileSize(inputfile) / 1.0e6;
+    const double output_size = aux::GetFileSize(outputfile) / 1.0e6;
+
+    printf("HepMC3: input  (%0.1f MB, %0.5f MB/event) %s \n", input_size, input_size / events,
+           inputfile.c_str());
+    printf("GRCOL:  output (%0.1f MB, %0.5f MB/event) %s \n", output_size, output_size / events,
+           outputfile.c_str());
+    printf("Total %d events converted from HepMC3 to GRCOL \n", events);
+  }
+
+  std::cout << "[hepmc3togrcol: done]" << std::endl;
+  aux::CheckUpdate();
+
+  return EXIT_SUCCESS;
+}
@@ -25,6 +25,7 @@
 
 // Own
 #include "Graniitti/MAux.h"
+#include "Graniitti/MCompress.h"
 
 
 // Return filesize for statistics
@@ -57,8 +58,9 @@ int main(int argc, char *argv[]) {
   std::string inputfile(argv[1]);
   std::string outputfile = inputfile + ".lhe";
 
-  // Input and output
-  HepMC3::ReaderAscii input(inputfile);
+  // Input (gzip compressed files are decompressed transparently) and output
+  gra::MInputStream   stream(inputfile);
+  HepMC3::ReaderAscii input(stream);
   LHEF::Writer        writer(outputfile);
 
   // TODO: Check what this does actually?
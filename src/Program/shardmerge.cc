@@ -0,0 +1,206 @@
+// GRANIITTI - Monte Carlo event generator for high energy diffraction
+// https://github.com/mieskolainen/graniitti
+//
+// <Event generation shard merger>
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// C file processing
+#include <dirent.h>
+
+// HepMC3
+#include "HepMC3/GenCrossSection.h"
+#include "HepMC3/GenEvent.h"
+#include "HepMC3/ReaderAscii.h"
+#include "HepMC3/ReaderAsciiHepMC2.h"
+#include "HepMC3/ReaderHEPEVT.h"
+#include "HepMC3/WriterAscii.h"
+#include "HepMC3/WriterAsciiHepMC2.h"
+#include "HepMC3/WriterHEPEVT.h"
+
+// Own
+#include "Graniitti/MAux.h"
+#include "Graniitti/MCompress.h"
+#include "Graniitti/MShard.h"
+
+using namespace gra;
+
+// Copy all events of one shard to the merged output, with running event
+// numbers and the merged cross section
+template <typename READER>
+void Stitch(const std::string &inputfile, const MShardStat &total,
+            std::shared_ptr<HepMC3::Writer> &writer, int &events) {
+  MInputStream     stream(inputfile);  // gzip compressed shards are read transparently
+  READER           input(stream);
+  HepMC3::GenEvent ev(HepMC3::Units::GEV, HepMC3::Units::MM);
+
+  while (!input.failed()) {
+    input.read_event(ev);
+    if (input.failed()) { break; }
+
+    // Writer created with the run info of the first event
+    if (writer == nullptr) {
+      const std::string outputfile = aux::GetBasePath(2) + "/output/" + total.output;
+      if (total.format == "hepmc3") {
+        writer = std::make_shared<HepMC3::WriterAscii>(outputfile, ev.run_info());
+      } else if (total.format == "hepmc2") {
+        writer = std::make_shared<HepMC3::WriterAsciiHepMC2>(outputfile, ev.run_info());
+      } else {
+        writer = std::make_shared<HepMC3::WriterHEPEVT>(outputfile);
+      }
+    }
+
+    ev.set_event_number(events);
+    if (auto xs = ev.cross_section()) {
+      // Picobarns [HepMC3 convention]
+      xs->set_cross_section(total.sigma * 1E12, total.sigma_err * 1E12);
+    }
+    writer->write_event(ev);
+    ++events;
+  }
+  input.close();
+}
+
+// Main
+int main(int argc, char *argv[]) {
+  aux::PrintArgv(argc, argv);
+
+  if (argc < 2) {
+    std::cout << std::endl;
+    std::cout << "[Event generation shard merger]" << std::endl << std::endl;
+    std::cout << "Example: ./shardmerge OUTPUT [--stat]" << std::endl << std::endl;
+    std::cout << "  Combines output/OUTPUT_shard*.json statistics into the total cross section"
+              << std::endl;
+    std::cout << "  and concatenates the shard event files into output/OUTPUT.<FORMAT>"
+              << std::endl;
+    std::cout << "  (--stat for the cross section only)" << std::endl << std::endl;
+    std::cout << "Shards are generated with ./gr -i card.json -j <index>/<count> -r <seed>"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string name   = argv[1];
+  const bool        events = !(argc >= 3 && std::string(argv[2]) == "--stat");
+
+  try {
+    // Find shard sidecars
+    const std::string        dirname = aux::GetBasePath(2) + "/output";
+    const std::regex         pattern(std::regex_replace(name, std::regex(R"([.^$|()\[\]{}*+?\\])"),
+                                                        R"(\$&)") +
+                             R"(_shard[0-9]+\.json)");
+    std::vector<std::string> files;
+    if (DIR *dir = opendir(dirname.c_str())) {
+      while (struct dirent *ent = readdir(dir)) {
+        const std::string file = ent->d_name;
+        if (std::regex_match(file, pattern)) { files.push_back(file); }
+      }
+      closedir(dir);
+    }
+    std::sort(files.begin(), files.end());
+    if (files.empty()) {
+      throw std::invalid_argument("No shard statistics " + dirname + "/" + name +
+                                  "_shard*.json found");
+    }
+
+    std::vector<MShardStat> shards;
+    for (const auto &file : files) {
+      MShardStat S;
+      if (!S.Read(dirname + "/" + file)) {
+        throw std::invalid_argument("Could not read " + dirname + "/" + file);
+      }
+      shards.push_back(S);
+    }
+
+    // Shard coverage
+    const int        count = shards[0].shards;
+    std::vector<int> seen(count, 0);
+    for (const auto &S : shards) {
+      if (S.shards != count || S.shard < 0 || S.shard >= count) {
+        throw std::invalid_argument("Shard " + std::to_string(S.shard) + " / " +
+                                    std::to_string(S.shards) + " inconsistent with count " +
+                                    std::to_string(count));
+      }
+      if (++seen[S.shard] > 1) {
+        throw std::invalid_argument("Shard " + std::to_string(S.shard) + " found twice");
+      }
+      if (S.seed != shards[0].seed) {
+        std::cout << "shardmerge: Warning: Shard " << S.shard << " has a different seed ("
+                  << S.seed << " vs " << shards[0].seed << ")" << std::endl;
+      }
+      if (S.maxweight != shards[0].maxweight && !S.weighted) {
+        std::cout << "shardmerge: Warning: Shard " << S.shard
+                  << " has a different unweighting maximum weight" << std::endl;
+      }
+    }
+    const int missing = std::count(seen.begin(), seen.end(), 0);
+
+    // Combine statistics
+    bool       shared = false;
+    MShardStat total  = MergeShards(shards, shared);
+    total.shards      = shards.size();
+    total.output      = name + "." + total.format;
+    total.created     = aux::DateTime();
+
+    aux::PrintBar("=");
+    for (const auto &S : shards) { S.Print(); }
+    aux::PrintBar("-");
+    printf("Shards:                   %lu / %d (missing %d) \n", shards.size(), count, missing);
+    printf("Integral base:            %s \n",
+           shared ? "shared (VEGAS checkpoint, counted once)" : "independent per shard");
+    printf("Cross section:            [%0.4E +- %0.4E] barn \n", total.sigma, total.sigma_err);
+    printf("Generation efficiency:    %0.3E (%0.0f / %0.0f) \n",
+           total.events / std::max(1.0, total.trials), total.events, total.trials);
+    printf("Weight overflow:          %0.3E (%0.0f / %0.0f) \n",
+           total.overflow / std::max(1.0, total.trials), total.overflow, total.trials);
+
+    // Concatenate event files
+    if (events) {
+      std::shared_ptr<HepMC3::Writer> writer = nullptr;
+      int                             N      = 0;
+      for (const auto &S : shards) {
+        if (S.format == "hepmc3") {
+          Stitch<HepMC3::ReaderAscii>(S.output, total, writer, N);
+        } else if (S.format == "hepmc2") {
+          Stitch<HepMC3::ReaderAsciiHepMC2>(S.output, total, writer, N);
+        } else if (S.format == "hepevt") {
+          Stitch<HepMC3::ReaderHEPEVT>(S.output, total, writer, N);
+        } else {
+          throw std::invalid_argument("Unknown output format: " + S.format);
+        }
+      }
+      if (writer != nullptr) { writer->close(); }
+      if (N != total.events) {
+        std::cout << "shardmerge: Warning: Read " << N << " events, statistics have "
+                  << total.events << std::endl;
+      }
+      printf("Output:                   %s (%d events) \n", total.output.c_str(), N);
+    }
+    aux::PrintBar("=");
+
+    total.output = dirname + "/" + total.output;
+    total.Write(dirname + "/" + name + ".json");
+
+  } catch (const std::invalid_argument &e) {
+    gra::aux::PrintGameOver();
+    std::cerr << "Exception catched: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  } catch (const std::ios_base::failure &e) {
+    std::cerr << "Exception catched: std::ios_base::failure: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  } catch (...) {
+    std::cerr << "Exception catched: Unspecified (...)" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
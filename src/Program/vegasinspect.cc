@@ -0,0 +1,80 @@
+// GRANIITTI - Monte Carlo event generator for high energy diffraction
+// https://github.com/mieskolainen/graniitti
+//
+// <VEGAS checkpoint inspection>
+//
+// (c) 2017-2020 Mikael Mieskolainen
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+// C++
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// C file processing
+#include <dirent.h>
+
+// Own
+#include "Graniitti/MAux.h"
+#include "Graniitti/MCheckpoint.h"
+
+using namespace gra;
+
+// First line of the key starting with the field name
+std::string KeyField(const std::string &key, const std::string &field) {
+  const std::size_t a = key.find(field);
+  if (a == std::string::npos) { return ""; }
+  const std::size_t b = key.find('\n', a);
+  std::string       val = key.substr(a + field.size(), b - a - field.size());
+  val.erase(0, val.find_first_not_of(' '));
+  return val;
+}
+
+// Main
+int main(int argc, char *argv[]) {
+  aux::PrintArgv(argc, argv);
+
+  // Single file in detail
+  if (argc >= 2) {
+    const std::string filename = argv[1];
+    const bool        grid     = (argc >= 3 && std::string(argv[2]) == "--grid");
+
+    MVEGASCheckpoint C;
+    if (!C.Read(filename)) {
+      std::cerr << "vegasinspect: Could not read " << filename << std::endl;
+      return EXIT_FAILURE;
+    }
+    aux::PrintBar("=");
+    printf("%s \n\n", filename.c_str());
+    C.Print(grid);
+    aux::PrintBar("=");
+    return EXIT_SUCCESS;
+  }
+
+  // All checkpoints in the default directory
+  const std::string dirname = aux::GetBasePath(2) + "/vegas";
+  printf("Example input ./vegasinspect %s/VEGAS_<hash>.bin [--grid] \n\n", dirname.c_str());
+
+  std::vector<std::string> files;
+  if (DIR *dir = opendir(dirname.c_str())) {
+    while (struct dirent *ent = readdir(dir)) {
+      const std::string name = ent->d_name;
+      if (name.size() > 4 && name.substr(name.size() - 4) == ".bin") { files.push_back(name); }
+    }
+    closedir(dir);
+  }
+  std::sort(files.begin(), files.end());
+
+  printf("%lu checkpoint(s) in %s: \n\n", files.size(), dirname.c_str());
+  for (const auto &name : files) {
+    MVEGASCheckpoint C;
+    if (!C.Read(dirname + "/" + name)) { continue; }
+    printf("%-34s %s  xs = %0.3E +- %0.3E barn  maxf = %0.3E  sqrt(s) = %s  [%s] \n",
+           name.c_str(), C.created.c_str(), C.sigma, C.sigma_err, C.maxf,
+           KeyField(C.key, "SQRTS:").c_str(), KeyField(C.key, "PROCESS:").c_str());
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -1,173 +1,82 @@
 // GRANIITTI - Monte Carlo event generator for high energy diffraction
 // https://github.com/mieskolainen/graniitti
-// 
+//
 // <NeuroJacobian test>
 //
+// Neural importance sampling of a peaked 2D toy integrand versus flat sampling.
 //
-// (c) 2017-2019 Mikael Mieskolainen
+// (c) 2017-2020 Mikael Mieskolainen
 // Licensed under the MIT License <http://opensource.org/licenses/MIT>.
 
 
 // C++ includes
+#include <cmath>
 #include <iostream>
-#include <future>
 
 // Own
 #include <Graniitti/MNeuroJacobian.h>
 #include <Graniitti/MRandom.h>
-#include <Graniitti/MAux.h>
-#include <Graniitti/MH2.h>
-#include <Graniitti/MMath.h>
-#include <Graniitti/MRandom.h>
 
+using gra::MRandom;
+
+
+// Toy integrand on [0,1]^2, integral ~ 1
+double func(double x, double y) {
+	const double s = 0.05;
+	return std::exp(-(std::pow(x - 0.3, 2) + std::pow(y - 0.6, 2)) / (2 * s * s)) / (2 * M_PI * s * s);
+}
 
 // Main function
 int main() {
 
-	/*
 	MRandom random;
-	
-	gra::neurojac::MNeuroJacobian neurojac;
-	gra::neurojac::BATCHSIZE = 300;
-
-    // Set network layer dimensions [first, ..., output]
-    const int D = 2;
-	gra::neurojac::par.D = D; // Integrand dimension
-
-	gra::neurojac::par.L.push_back(gra::neurojac::Layer(3,D)); // Input
-	gra::neurojac::par.L.push_back(gra::neurojac::Layer(3,3));
-	gra::neurojac::par.L.push_back(gra::neurojac::Layer(3,3));
-	gra::neurojac::par.L.push_back(gra::neurojac::Layer(D,3)); // Output
-
-	neurojac.Optimize();
+	random.SetSeed(1);
 
-	
-	//if (ALGO == "GRAD") {
-	//FLAT_TARGET = true;
-	//NaiveGradDesc(w, 30, 1e-3);
+	const unsigned int D = 2;
+	gra::neurojac::NEUROPARAM param;
+	param.ITER = 300;
 
-	//FLAT_TARGET = false;
-	//NaiveGradDesc(w, 30, 1e-3);
-	//}
-	
+	gra::neurojac::MNeuroFlow flow;
+	flow.Init(D, param, random);
 
-    const int N_MC  = 1e5;
-    const int N_evt = 1e2;
-
-    auto NeuroSample = [&] (std::vector<double>& u)  {
-
-		// Prior p(z) distribution sampling
-		VectorXdual z(u.size());
-		for (std::size_t i = 0; i < D; ++i) {
-			z[i] = random.G(0,1);
+	auto integrand = [&](const Eigen::MatrixXd& U, Eigen::VectorXd& F) {
+		F.resize(U.cols());
+		for (std::size_t k = 0; k < (std::size_t)U.cols(); ++k) {
+			F[k] = func(U(0,k), U(1,k));
 		}
-	    const double p = val(gra::neurojac::gaussprob(z,0,1));
-	    
-		// Evaluate network map
-	    VectorXdual u_ = gra::neurojac::G_net(z);
-
-	    // Evaluate the Jacobian matrix du/dz
-	    MatrixXd dudz = jacobian(gra::neurojac::G_net, u_, z);
-	    
-	    // Abs Jacobian determinant and inverse prior
-	    const double jacweight = abs(dudz.determinant()) / p;
-	    
-	    // Total event weight
-	    for (std::size_t i = 0; i < D; ++i) {
-	    	u[i] = val(u_[i]);
-	    }
-	    const double weight = gra::neurojac::func(u) * jacweight;
-
-	    return weight;
-    };
+	};
+	flow.Train(integrand, param, random, false);
 
+	const unsigned int N = 100000;
 
+	// Neural importance sampling
 	{
-		MH2 hist(30, 0.0, 1.0, 30, 0.0, 1.0, "NEUROJAC");
-
-	    uint   samples = 0;
-	    double maxweight = 0.0;
-
-	    std::vector<double> u(D);
-
-	    // Integration
-		while (true) {
-
-			const double weight = NeuroSample(u);
-		    maxweight = weight > maxweight ? weight : maxweight;
-
-		    hist.Fill(u[0], u[1], weight);
-		    ++samples;
-
-		    if (samples == N_MC) break;
-		}
-
-		// Event generation
-		samples = 0;
-		uint trials = 0;
-		while (true) {
-
-			const double weight = NeuroSample(u);
-		    ++trials;
-
-		    // Acceptance-Rejection
-		    if (random.U(0,1) < (weight / maxweight)) {
-		    	++samples;
-		    }
-		    if (samples == N_evt) break;
+		Eigen::MatrixXd Z(D, N), Y, U;
+		Eigen::VectorXd invq, F;
+		for (std::size_t k = 0; k < N; ++k) {
+			for (std::size_t i = 0; i < D; ++i) { Z(i,k) = random.G(0,1); }
 		}
-		hist.Print();
-		printf("Event generation efficiency:: %0.3E \n ", N_evt / (double)trials);
+		flow.Forward(Z, Y, U, invq);
+		integrand(U, F);
+		const Eigen::VectorXd W = F.cwiseProduct(invq);
+		const double mu = W.mean();
+		const double sd = std::sqrt(W.squaredNorm() / N - mu * mu);
+		printf("NEURO: I = %0.5f +- %0.5f (unweighting efficiency %0.3E) \n", mu, sd / std::sqrt(N), mu / W.maxCoeff());
 	}
 
- 	{
-		MH2 hist(30, 0.0, 1.0, 30, 0.0, 1.0, "FLAT");
-	    double    sumw   = 0.0;
-	    double   sumw2   = 0.0;
-	    uint   samples   = 0;
-	    double maxweight = 0.0;
-		while (true) {
-
-			// Fully uniform sampling
-			VectorXdual z(D);
-			for (std::size_t i = 0; i < D; ++i) {
-				z[i] = random.U(0,1);
-			}
-		    std::vector<double> z_ = {val(z[0]), val(z[1])};
-		    const double weight = gra::neurojac::func(z_);
-		    maxweight = weight > maxweight ? weight : maxweight;
-
-		    sumw  += weight;
-		    sumw2 += weight*weight;
-
-		    hist.Fill(val(z[0]), val(z[1]), weight);
-		    ++samples;
-		    if (samples == N_MC) break;
-		}
-
-		samples = 0;
-		uint trials = 0;
-		while (true) {
-
-			// Fully uniform sampling
-			VectorXdual z(D);
-			for (std::size_t i = 0; i < D; ++i) {
-				z[i] = random.U(0,1);
-			}
-		    std::vector<double> z_ = {val(z[0]), val(z[1])};
-		    const double weight = gra::neurojac::func(z_);
-
-		    ++trials;
-		    if (random.U(0,1) < (weight / maxweight)){
-		    	++samples;
-		    }
-
-		    if (samples == N_MC) break;
+	// Flat sampling
+	{
+		double sumw = 0.0, sumw2 = 0.0, maxw = 0.0;
+		for (std::size_t k = 0; k < N; ++k) {
+			const double w = func(random.U(0,1), random.U(0,1));
+			sumw += w;
+			sumw2 += w * w;
+			maxw = w > maxw ? w : maxw;
 		}
-		hist.Print();
-		printf("Event generation efficiency:: %0.3E \n ", N_evt / (double)trials);
+		const double mu = sumw / N;
+		const double sd = std::sqrt(sumw2 / N - mu * mu);
+		printf("FLAT:  I = %0.5f +- %0.5f (unweighting efficiency %0.3E) \n", mu, sd / std::sqrt(N), mu / maxw);
 	}
-	*/
-	
+
 	return 0;
 }
@@ -4,14 +4,33 @@
 // Licensed under the MIT License <http://opensource.org/licenses/MIT>.
 
 #include <catch.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <map>
 #include <random>
+#include <sstream>
+#include <thread>
 
+#include "Graniitti/MAsyncWriter.h"
+#include "Graniitti/MBessel.h"
+#include "Graniitti/MColumnar.h"
+#include "Graniitti/MCompress.h"
+#include "Graniitti/MCubature.h"
+#include "Graniitti/MEventWriter.h"
 #include "Graniitti/MRandom.h"
+#include "Graniitti/MShard.h"
+#include "Graniitti/MSpherical.h"
+#include "Graniitti/MSudakov.h"
 #include "Graniitti/MMath.h"
 #include "Graniitti/MMatrix.h"
+#include "Graniitti/MNeuroJacobian.h"
 #include "Graniitti/MKinematics.h"
 #include "Graniitti/M4Vec.h"
 
+#include "extmath.hpp"
+
 using namespace gra;
 
 using gra::aux::indices;
@@ -162,6 +181,42 @@ TEST_CASE("M4Vec: Basic kinematic operations", "[M4Vec]") {
 	}
 }
 
+// Structure-of-arrays boosts and rotations against the scalar ones
+//
+//
+TEST_CASE("M4VecSoA: LorentzBoostSoA, RotateSoA, RotateZSoA versus scalar", "[M4Vec]") {
+
+	const double EPS = 1e-12;
+	const M4Vec boost(0.3, -0.2, 4.0, 6.0);
+
+	std::vector<M4Vec> p;
+	for (std::size_t i = 0; i < 7; ++i) {
+		M4Vec x(0.1*i, -0.05*i + 0.2, 1.0 - 0.3*i, 0.0);
+		x.SetE(std::sqrt(x.P3mod2() + 0.139*0.139));
+		p.push_back(x);
+	}
+	std::vector<M4Vec> ref = p;
+	for (auto& x : ref) {
+		gra::kinematics::LorentzBoost(boost, boost.M(), x, -1);
+		gra::kinematics::Rotate(x, 0.4, 2.1);
+		gra::kinematics::RotateZ(x, -0.7);
+	}
+
+	gra::kinematics::M4VecSoA soa;
+	soa.Load(p);
+	gra::kinematics::LorentzBoostSoA(boost, boost.M(), soa, -1);
+	gra::kinematics::RotateSoA(soa, 0.4, 2.1);
+	gra::kinematics::RotateZSoA(soa, -0.7);
+	soa.Store(p);
+
+	for (std::size_t i = 0; i < p.size(); ++i) {
+		for (std::size_t mu = 0; mu < 4; ++mu) {
+			REQUIRE( p[i][mu] == Approx(ref[i][mu]).margin(EPS));
+		}
+	}
+	REQUIRE( alignof(M4Vec) == 32 );
+}
+
 // Factorials
 //
 //
@@ -215,6 +270,909 @@ TEST_CASE("gra::math::Y_complex_basis: numerically", "[gra::math::Y_complex_basi
 }
 
 
+// Real spherical harmonic basis vector, one pass hypercell sums and hyperbin indices
+//
+//
+TEST_CASE("gra::spherical::YLMBasis, GetSums and GetHyperIndices versus scalar", "[gra::spherical]") {
+
+	const double EPS  = 1e-12;
+	const int    LMAX = 6;
+
+	MRandom random;
+	random.SetSeed(1234);
+
+	std::vector<spherical::Omega> events(2000);
+	for (auto& x : events) {
+		x.costheta = random.U(-1.0, 1.0);
+		x.phi      = random.U(-math::PI, math::PI);
+		x.M        = random.U(0.0, 3.0);
+		x.Pt       = random.U(0.0, 1.0);
+		x.Y        = random.U(-1.0, 1.0);
+		x.fiducial = random.U(0.0, 1.0) < 0.7;
+		x.selected = random.U(0.0, 1.0) < 0.8;
+	}
+
+	const spherical::YLMBasis basis(LMAX);
+	std::vector<double> Y(basis.NCOEF);
+
+	SECTION("Basis vector versus NReY(Y_complex_basis)") {
+		for (const auto& x : events) {
+			basis.Eval(x.costheta, x.phi, Y.data());
+			for (int l = 0; l <= LMAX; ++l) {
+			for (int m = -l; m <= l; ++m) {
+				const double ref = math::NReY(math::Y_complex_basis(x.costheta, x.phi, l, m), l, m);
+				REQUIRE( Y[spherical::LinearInd(l, m)] == Approx(ref).margin(EPS) );
+			}
+			}
+		}
+	}
+
+	SECTION("Blocked sums versus event by event") {
+		std::vector<std::size_t> ind;
+		for (std::size_t k = 0; k < events.size(); k += 3) { ind.push_back(k); }
+		const std::array<spherical::SH_SUM, 3> S = spherical::GetSums(events, ind, LMAX);
+
+		for (std::size_t c = 0; c < 3; ++c) {
+			MMatrix<double> G(basis.NCOEF, basis.NCOEF, 0.0);
+			std::vector<double> E(basis.NCOEF, 0.0);
+			for (const auto& k : ind) {
+				if (c >= 1 && !events[k].fiducial) { continue; }
+				if (c == 2 && !events[k].selected) { continue; }
+				basis.Eval(events[k].costheta, events[k].phi, Y.data());
+				for (int i = 0; i < basis.NCOEF; ++i) {
+					E[i] += Y[i];
+					for (int j = 0; j < basis.NCOEF; ++j) { G[i][j] += Y[i] * Y[j]; }
+				}
+			}
+			for (int i = 0; i < basis.NCOEF; ++i) {
+				REQUIRE( S[c].E(i) == Approx(E[i]).margin(1e-9) );
+				for (int j = 0; j < basis.NCOEF; ++j) {
+					REQUIRE( S[c].G(i, j) == Approx(G[i][j]).margin(1e-9) );
+				}
+			}
+		}
+		REQUIRE( S[0].N == ind.size() );
+	}
+
+	SECTION("One pass hyperbins versus GetIndices") {
+		std::vector<std::array<double, 2>> M, Pt, Yb;
+		for (std::size_t i = 0; i < 3; ++i) { M.push_back({i * 1.0, (i + 1) * 1.0}); }
+		for (std::size_t i = 0; i < 2; ++i) { Pt.push_back({i * 0.4, (i + 1) * 0.4}); }
+		for (std::size_t i = 0; i < 4; ++i) { Yb.push_back({-1.0 + i * 0.5, -1.0 + (i + 1) * 0.5}); }
+
+		const std::vector<std::vector<std::size_t>> bins = spherical::GetHyperIndices(events, M, Pt, Yb);
+		REQUIRE( bins.size() == M.size() * Pt.size() * Yb.size() );
+
+		for (std::size_t i = 0; i < M.size(); ++i) {
+		for (std::size_t j = 0; j < Pt.size(); ++j) {
+		for (std::size_t k = 0; k < Yb.size(); ++k) {
+			const std::vector<std::size_t> ind = spherical::GetIndices(events,
+				{M[i][0], M[i][1]}, {Pt[j][0], Pt[j][1]}, {Yb[k][0], Yb[k][1]});
+			REQUIRE( bins[(i * Pt.size() + j) * Yb.size() + k] == ind );
+		}
+		}
+		}
+	}
+}
+
+
+// Batched Bessel J0 and Fourier-Bessel kernel
+//
+//
+TEST_CASE("gra::math::BESSJ0Batch and FBKernel versus scalar", "[gra::math::BESSJ0Batch]") {
+
+	const double EPS = 1e-12;
+
+	// Both sides of the polynomial branch point |x| = 8, zero and negative values
+	std::vector<double> x = {0.0, 1e-9, 0.5, -3.0, 7.999, 8.0, 8.001, 25.0, -120.0, 1499.9};
+	std::vector<double> y(x.size());
+	gra::math::BESSJ0Batch(x.data(), y.data(), x.size());
+
+	for (std::size_t i = 0; i < x.size(); ++i) {
+		REQUIRE( y[i] == Approx(BESSJ0(x[i])).margin(EPS) );
+	}
+
+	// Simpson integral of f(x) J0(bx) against CSIntegral
+	const std::size_t   N    = 1000;
+	const double        STEP = 10.0 / N;
+	std::vector<double> w    = gra::math::CSWeights(N, STEP);
+
+	gra::math::FBKernel K;
+	for (std::size_t i = 0; i <= N; ++i) {
+		const double xi = i * STEP;
+		K.x.push_back(xi);
+		K.re.push_back(w[i] * std::exp(-xi));
+		K.im.push_back(w[i] * xi * std::exp(-xi));
+	}
+	for (const auto& b : {0.0, 0.7, 3.0, 12.0}) {
+		std::vector<std::complex<double>> f(N + 1);
+		for (std::size_t i = 0; i <= N; ++i) {
+			const double xi = i * STEP;
+			f[i] = std::complex<double>(std::exp(-xi), xi * std::exp(-xi)) * BESSJ0(b * xi);
+		}
+		const std::complex<double> ref = gra::math::CSIntegral(f, STEP);
+		REQUIRE( std::real(K.Integral(b)) == Approx(std::real(ref)).margin(EPS) );
+		REQUIRE( std::imag(K.Integral(b)) == Approx(std::imag(ref)).margin(EPS) );
+	}
+}
+
+TEST_CASE("gra::math::MCubature2D: polynomial and adaptive integrals", "[gra::math::MCubature2D]") {
+
+	gra::math::MCubature2D C;
+	std::vector<std::complex<double>> I;
+	double err = 0.0;
+
+	// Degree 7 rule is exact for polynomials of degree <= 7 (single region)
+	auto poly = [](double x, double y, std::complex<double>* out) {
+		out[0] = std::pow(x, 7) * y + x * x * std::pow(y, 5) + 3.0;
+		out[1] = std::complex<double>(0.0, x * x * y * y);
+	};
+	const unsigned int calls = C.Integrate(poly, 2, 0.0, 1.0, 0.0, 2.0, 1, 1, 1e-12, 0.0, 17, I, err);
+
+	REQUIRE( calls == gra::math::MCubature2D::NRULE );
+	REQUIRE( std::real(I[0]) == Approx(0.25 + 32.0 / 9.0 + 6.0).epsilon(1e-12) );
+	REQUIRE( std::imag(I[1]) == Approx(8.0 / 9.0).epsilon(1e-12) );
+
+	// Peaked integrand, refined until the tolerance
+	auto gauss = [](double x, double y, std::complex<double>* out) {
+		out[0] = std::exp(-50.0 * (x * x + y * y)) * std::complex<double>(1.0, x);
+	};
+	const double RTOL = 1e-6;
+	C.Integrate(gauss, 1, -1.0, 1.0, -1.0, 1.0, 2, 2, RTOL, 0.0, 1000000, I, err);
+
+	const double exact = gra::math::PI / 50.0 * std::pow(std::erf(std::sqrt(50.0)), 2);
+	REQUIRE( err <= RTOL * std::abs(I[0]) );
+	REQUIRE( std::real(I[0]) == Approx(exact).epsilon(RTOL) );
+	REQUIRE( std::imag(I[0]) == Approx(0.0).margin(RTOL * exact) );
+}
+
+TEST_CASE("IArray2D: Interpolate2DBatch versus Interpolate2D", "[IArray2D]") {
+
+	// Linear q2-axis and logarithmic x-axis as in the Shuvaev pdf array
+	IArray2D arr;
+	arr.Set(0, "q2", 0.3, 125.0, 60, false);
+	arr.Set(1, "x",  1e-5, 0.5, 40, true);
+	arr.InitArray();
+
+	for (std::size_t i = 0; i <= arr.N[0]; ++i) {
+		for (std::size_t j = 0; j <= arr.N[1]; ++j) {
+			const double a = arr.MIN[0] + i * arr.STEP[0];
+			const double b = arr.MIN[1] + j * arr.STEP[1];
+			arr.F[i][j] = {a, b, std::sin(a) * std::exp(0.1 * b), std::cos(a) + b};
+		}
+	}
+	const std::string filename = "./IArray2D_testbench";
+	REQUIRE( arr.WriteArray(filename, true) );
+	REQUIRE( arr.ReadArray(filename) );
+	std::remove((filename + ".bin").c_str());
+
+	// Also values below the grid minimum (truncated)
+	std::vector<double> q2 = {0.1, 0.3, 0.35, 1.0, 7.77, 50.0, 124.9, 125.0};
+	std::vector<double> Z(q2.size());
+	std::vector<double> dZ(q2.size());
+
+	for (const auto& x : {1e-6, 1e-5, 3.3e-4, 0.01, 0.2, 0.5}) {
+		arr.Interpolate2DBatch(q2.data(), x, Z.data(), dZ.data(), q2.size());
+
+		for (std::size_t k = 0; k < q2.size(); ++k) {
+			const std::pair<double, double> ref = arr.Interpolate2D(q2[k], x);
+			REQUIRE( Z[k]  == ref.first );
+			REQUIRE( dZ[k] == ref.second );
+		}
+	}
+}
+
+TEST_CASE("MergeShards: shared VEGAS base and independent shards", "[MShard]") {
+
+	// Integral of one VEGAS iteration as {I/var, I^2/var, 1/var}
+	auto iteration = [](double I, double err) {
+		const double w = 1.0 / (err * err);
+		return std::array<double, 3>{{I * w, I * I * w, w}};
+	};
+	const std::array<double, 3> base = iteration(2.0, 0.1);
+
+	std::vector<MShardStat> shards(3);
+	const std::vector<double> I = {1.9, 2.1, 2.05};
+	for (std::size_t i = 0; i < shards.size(); ++i) {
+		shards[i].shard      = i;
+		shards[i].shards     = shards.size();
+		shards[i].integrator = "VEGAS";
+		shards[i].events     = 100;
+		shards[i].trials     = 1000;
+		shards[i].base       = base;
+		const std::array<double, 3> it = iteration(I[i], 0.2);
+		for (std::size_t k = 0; k < 3; ++k) { shards[i].sums[k] = base[k] + it[k]; }
+	}
+
+	SECTION("Shared base counted once") {
+		bool shared = false;
+		const MShardStat total = MergeShards(shards, shared);
+		REQUIRE( shared );
+		const double w0 = 1.0 / 0.01;
+		const double w1 = 1.0 / 0.04;
+		REQUIRE( total.sigma == Approx((2.0 * w0 + (1.9 + 2.1 + 2.05) * w1) / (w0 + 3 * w1)) );
+		REQUIRE( total.sigma_err == Approx(std::sqrt(1.0 / (w0 + 3 * w1))) );
+		REQUIRE( total.events == 300 );
+		REQUIRE( total.trials == 3000 );
+	}
+
+	SECTION("Independent shards") {
+		shards[1].base[2] *= 2.0;
+		for (std::size_t i = 0; i < shards.size(); ++i) { shards[i].seed = 100 + i; }
+		bool shared = true;
+		const MShardStat total = MergeShards(shards, shared);
+		REQUIRE( !shared );
+		double wsum = 0.0;
+		for (const auto& S : shards) { wsum += S.sums[2]; }
+		REQUIRE( total.sigma_err == Approx(std::sqrt(1.0 / wsum)) );
+	}
+
+	SECTION("Correlated shards refused") {
+		// Same seed and key, integrated concurrently without the shared checkpoint
+		shards[1].base[2] *= 2.0;
+		bool shared = true;
+		REQUIRE_THROWS_AS( MergeShards(shards, shared), std::invalid_argument );
+	}
+
+	SECTION("Shard suffix") {
+		REQUIRE( ShardSuffix(3, 16) == "_shard0003" );
+		REQUIRE( ShardSuffix(12345, 20000) == "_shard12345" );
+	}
+}
+
+TEST_CASE("MEventRecord: HepMC3, HepMC2 and LHE text writers", "[MEventWriter]") {
+
+	// 2 -> 1 -> 2 record with one displaced decay vertex
+	MEventRecord evt;
+	const int v1 = evt.AddVertex();
+	const int p1 = evt.AddParticle(M4Vec(0, 0, 6500, 6500), 2212, 4);
+	const int p2 = evt.AddParticle(M4Vec(0, 0, -6500, 6500), 2212, 4);
+	const int X  = evt.AddParticle(M4Vec(0.1, -0.2, 0.3, 3.1), 90, 2);
+	evt.AddIn(v1, p1);
+	evt.AddIn(v1, p2);
+	evt.AddOut(v1, X);
+	const int v2 = evt.AddVertex(M4Vec(0.01, 0.02, 0.03, 0.04));
+	const int d1 = evt.AddParticle(M4Vec(1.0 / 3.0, 0.1, 0.2, 1.5), 211, 1);
+	const int d2 = evt.AddParticle(M4Vec(0.1 - 1.0 / 3.0, -0.3, 0.1, 1.6), -211, 1);
+	evt.AddIn(v2, X);
+	evt.AddOut(v2, d1);
+	evt.AddOut(v2, d2);
+	evt.weights      = {0.5};
+	evt.xs           = 123.0;
+	evt.event_number = 7;
+
+	auto lines = [](const std::string& str, char key) {
+		std::vector<std::string> out;
+		std::istringstream is(str);
+		std::string line;
+		while (std::getline(is, line)) {
+			if (line.size() > 1 && line[0] == key && line[1] == ' ') { out.push_back(line); }
+		}
+		return out;
+	};
+
+	SECTION("HepMC3") {
+		std::ostringstream os;
+		{
+			MWriterHepMC3 writer(os);
+			writer.Write(evt);
+		}
+		REQUIRE( lines(os.str(), 'E')[0] == "E 7 2 5" );
+		const std::vector<std::string> V = lines(os.str(), 'V');
+		REQUIRE( V.size() == 2 );
+		REQUIRE( V[0] == "V -1 0 [1,2]" );
+		REQUIRE( V[1].substr(0, 12) == "V -2 0 [3] @" );
+
+		// Parent objects and exact round-trip of the momenta
+		const std::vector<std::string> P = lines(os.str(), 'P');
+		REQUIRE( P.size() == 5 );
+		for (std::size_t i = 0; i < P.size(); ++i) {
+			std::istringstream is(P[i].substr(2));
+			int id, parent, pdg, status;
+			double px, py, pz, e, m;
+			is >> id >> parent >> pdg >> px >> py >> pz >> e >> m >> status;
+			const MEventRecord::Particle& p = evt.particles[i];
+			REQUIRE( id == (int)i + 1 );
+			REQUIRE( parent == (p.prod < 0 ? 0 : -(p.prod + 1)) );
+			REQUIRE( pdg == p.pdg );
+			REQUIRE( status == p.status );
+			REQUIRE( (px == p.px && py == p.py && pz == p.pz && e == p.e && m == p.m) );
+		}
+		REQUIRE( os.str().find("HepMC::Asciiv3-END_EVENT_LISTING") != std::string::npos );
+	}
+
+	SECTION("HepMC2") {
+		std::ostringstream os;
+		{
+			MWriterHepMC2 writer(os);
+			writer.Write(evt);
+		}
+		REQUIRE( lines(os.str(), 'E')[0] == "E 7 -1 0 0 0 0 0 2 10001 10002 0 1 0.5" );
+		REQUIRE( lines(os.str(), 'V').size() == 2 );
+		const std::vector<std::string> P = lines(os.str(), 'P');
+		REQUIRE( P.size() == 5 );
+		REQUIRE( P[2].substr(0, 10) == "P 10003 90" );
+		REQUIRE( P[2].substr(P[2].size() - 4) == "-2 0" );  // End vertex
+		REQUIRE( lines(os.str(), 'C')[0] == "C 123 0" );
+	}
+
+	SECTION("LHE") {
+		LHEINIT init;
+		std::ostringstream os;
+		{
+			MWriterLHE writer(os, init);
+			writer.Write(evt);
+		}
+		const std::string str = os.str();
+		const std::string body = str.substr(str.find("<event>\n") + 8);
+		std::istringstream is(body);
+		int NUP;
+		is >> NUP;
+		REQUIRE( NUP == 5 );
+		std::string line;
+		std::getline(is, line);
+		std::vector<std::array<int, 4>> rows;
+		for (int i = 0; i < NUP; ++i) {
+			std::array<int, 4> r;
+			is >> r[0] >> r[1] >> r[2] >> r[3];
+			std::getline(is, line);
+			rows.push_back(r);
+		}
+		REQUIRE( rows[0] == std::array<int, 4>{{2212, -1, 0, 0}} );
+		REQUIRE( rows[2] == std::array<int, 4>{{90, 2, 1, 2}} );
+		REQUIRE( rows[4] == std::array<int, 4>{{-211, 1, 3, 3}} );
+		REQUIRE( str.find("</LesHouchesEvents>") != std::string::npos );
+	}
+
+	// Second event: the pi- decays further at the origin (implicit vertex)
+	MEventRecord evt2 = evt;
+	evt2.particles[d2].status = 2;
+	const int v3 = evt2.AddVertex();
+	evt2.AddIn(v3, d2);
+	const int g1 = evt2.AddParticle(M4Vec(0.1, -0.1, 0.05, 0.8), 22, 1);
+	const int g2 = evt2.AddParticle(M4Vec(-0.3, -0.2, 0.05, 0.8 / 3.0), 22, 1);
+	evt2.AddOut(v3, g1);
+	evt2.AddOut(v3, g2);
+	evt2.weights      = {0.25, 1e-300};
+	evt2.xs_err       = 1.0 / 7.0;
+	evt2.event_number = 8;
+
+	// Incoming particles of the production vertex
+	auto parents = [](const MEventRecord& rec, std::size_t i) {
+		std::vector<int> out;
+		const int v = rec.particles[i].prod;
+		if (v < 0) { return out; }
+		for (const auto& k : indices(rec.particles)) {
+			if (rec.particles[k].end == v) { out.push_back(k); }
+		}
+		return out;
+	};
+
+	SECTION("HepMC3 round-trip") {
+		std::ostringstream os;
+		{
+			MWriterHepMC3 writer(os);
+			writer.Write(evt);
+			writer.Write(evt2);
+		}
+
+		// Read back E, W, A, V and P lines, single mother parents as implicit vertices
+		std::vector<MEventRecord> events;
+		std::map<int, int> vmap;
+		std::istringstream is(os.str());
+		std::string line;
+		while (std::getline(is, line)) {
+			if (line.size() < 2 || line[1] != ' ') { continue; }
+			std::istringstream ls(line.substr(2));
+			if (line[0] == 'E') {
+				events.emplace_back();
+				vmap.clear();
+				ls >> events.back().event_number;
+				continue;
+			}
+			if (events.empty()) { continue; }
+			MEventRecord& rec = events.back();
+
+			if (line[0] == 'W') {
+				double w;
+				while (ls >> w) { rec.weights.push_back(w); }
+			} else if (line[0] == 'A') {
+				int id;
+				std::string key;
+				ls >> id >> key;
+				if (key == "GenCrossSection") { ls >> rec.xs >> rec.xs_err; }
+			} else if (line[0] == 'V') {
+				int id, status;
+				std::string in, at;
+				ls >> id >> status >> in;
+				double x = 0, y = 0, z = 0, t = 0;
+				if (ls >> at) { ls >> x >> y >> z >> t; }
+				const int v = rec.AddVertex(M4Vec(x, y, z, t));
+				vmap[id] = v;
+				std::replace(in.begin(), in.end(), '[', ' ');
+				std::replace(in.begin(), in.end(), ']', ' ');
+				std::replace(in.begin(), in.end(), ',', ' ');
+				std::istringstream ins(in);
+				int k;
+				while (ins >> k) { rec.AddIn(v, k - 1); }
+			} else if (line[0] == 'P') {
+				int id, parent;
+				MEventRecord::Particle p;
+				ls >> id >> parent >> p.pdg >> p.px >> p.py >> p.pz >> p.e >> p.m >> p.status;
+				REQUIRE( id == (int)rec.particles.size() + 1 );
+				rec.particles.push_back(p);
+				if (parent < 0) {
+					rec.AddOut(vmap.at(parent), id - 1);
+				} else if (parent > 0) {
+					if (rec.particles[parent - 1].end < 0) { rec.AddIn(rec.AddVertex(), parent - 1); }
+					rec.AddOut(rec.particles[parent - 1].end, id - 1);
+				}
+			}
+		}
+
+		const std::vector<const MEventRecord*> orig = {&evt, &evt2};
+		REQUIRE( events.size() == orig.size() );
+		for (const auto& e : indices(orig)) {
+			const MEventRecord& a = *orig[e];
+			const MEventRecord& b = events[e];
+			REQUIRE( b.event_number == a.event_number );
+			REQUIRE( b.weights == a.weights );
+			REQUIRE( b.xs == a.xs );
+			REQUIRE( b.xs_err == a.xs_err );
+			REQUIRE( b.particles.size() == a.particles.size() );
+			REQUIRE( b.vertices.size() == a.vertices.size() );
+			for (const auto& i : indices(a.particles)) {
+				const MEventRecord::Particle& pa = a.particles[i];
+				const MEventRecord::Particle& pb = b.particles[i];
+				REQUIRE( pb.pdg == pa.pdg );
+				REQUIRE( pb.status == pa.status );
+				REQUIRE( (pb.px == pa.px && pb.py == pa.py && pb.pz == pa.pz && pb.e == pa.e && pb.m == pa.m) );
+				REQUIRE( parents(b, i) == parents(a, i) );
+				REQUIRE( (pb.end < 0) == (pa.end < 0) );
+				if (pa.prod >= 0) {
+					const MEventRecord::Vertex& va = a.vertices[pa.prod];
+					const MEventRecord::Vertex& vb = b.vertices[pb.prod];
+					REQUIRE( (vb.x == va.x && vb.y == va.y && vb.z == va.z && vb.t == va.t) );
+				}
+			}
+		}
+	}
+
+	SECTION("LHE round-trip") {
+		LHEINIT init;
+		std::ostringstream os;
+		{
+			MWriterLHE writer(os, init);
+			writer.Write(evt);
+			writer.Write(evt2);
+		}
+
+		const std::vector<const MEventRecord*> orig = {&evt, &evt2};
+		const std::string str = os.str();
+		std::size_t pos = 0;
+		for (const auto& e : indices(orig)) {
+			const MEventRecord& a = *orig[e];
+			pos = str.find("<event>\n", pos);
+			REQUIRE( pos != std::string::npos );
+			pos += 8;
+			std::istringstream is(str.substr(pos));
+
+			int NUP, IDPRUP;
+			double XWGTUP, SCALUP, AQEDUP, AQCDUP;
+			is >> NUP >> IDPRUP >> XWGTUP >> SCALUP >> AQEDUP >> AQCDUP;
+			REQUIRE( NUP == (int)a.particles.size() );
+			REQUIRE( XWGTUP == a.weights[0] );
+
+			for (const auto& i : indices(a.particles)) {
+				const MEventRecord::Particle& pa = a.particles[i];
+				int pdg, ISTUP, m1, m2, c1, c2;
+				double px, py, pz, E, m, VTIMUP, SPINUP;
+				is >> pdg >> ISTUP >> m1 >> m2 >> c1 >> c2 >> px >> py >> pz >> E >> m >> VTIMUP >> SPINUP;
+				REQUIRE( pdg == pa.pdg );
+				REQUIRE( ISTUP == ((pa.status == 4) ? -1 : ((pa.status == 1) ? 1 : 2)) );
+				const std::vector<int> P = parents(a, i);
+				REQUIRE( m1 == (P.empty() ? 0 : P.front() + 1) );
+				REQUIRE( m2 == (P.empty() ? 0 : P.back() + 1) );
+				REQUIRE( (px == pa.px && py == pa.py && pz == pa.pz && E == pa.e && m == pa.m) );
+			}
+			std::string end;
+			is >> end;
+			REQUIRE( end == "</event>" );
+		}
+	}
+
+	SECTION("Stream errors") {
+		std::ostringstream os;
+		MWriterHepMC3 writer(os);
+		os.setstate(std::ios::badbit);
+		REQUIRE_THROWS_AS( writer.Write(evt), std::invalid_argument );
+		REQUIRE_THROWS_AS( writer.Close(), std::invalid_argument );
+
+		LHEINIT init;
+		std::ostringstream os_lhe;
+		MWriterLHE writer_lhe(os_lhe, init);
+		os_lhe.setstate(std::ios::badbit);
+		REQUIRE_THROWS_AS( writer_lhe.Write(evt), std::invalid_argument );
+		REQUIRE_THROWS_AS( writer_lhe.Close(), std::invalid_argument );
+	}
+
+	SECTION("GenEvent conversion") {
+		HepMC3::GenEvent gevt(HepMC3::Units::GEV, HepMC3::Units::MM);
+		evt.ToGenEvent(gevt);
+		REQUIRE( gevt.particles().size() == 5 );
+		REQUIRE( gevt.vertices().size() == 2 );
+		REQUIRE( gevt.particles()[4]->parents().size() == 1 );
+		REQUIRE( gevt.particles()[4]->parents()[0]->pid() == 90 );
+		REQUIRE( gevt.weights()[0] == 0.5 );
+	}
+}
+
+TEST_CASE("MAsyncWriter: ordered output and writer thread errors", "[MAsyncWriter]") {
+
+	// Records the event numbers, fails at a given event
+	struct MTestWriter : public MEventWriter {
+		std::vector<int> numbers;
+		int              fail_at = -1;
+		void Write(const MEventRecord &evt) {
+			if (evt.event_number == fail_at) { throw std::runtime_error("disk full"); }
+			numbers.push_back(evt.event_number);
+		}
+	};
+	const int N = 1000;
+
+	// Event numbers pushed out of order by concurrent producers
+	const int THREADS = 4;
+	for (const std::size_t depth : {0, 16}) {
+		auto writer = std::make_shared<MTestWriter>();
+		{
+			MAsyncWriter async(writer, depth, 4);
+			std::vector<std::thread> producers;
+			for (int t = 0; t < THREADS; ++t) {
+				producers.emplace_back([&async, t] {
+					// Reversed blocks of 10 events
+					for (int b = t * 10; b < N; b += THREADS * 10) {
+						for (int i = std::min(b + 9, N - 1); i >= b; --i) {
+							auto evt = std::make_unique<MEventRecord>();
+							evt->event_number = i;
+							async.Push(std::move(evt));
+						}
+					}
+				});
+			}
+			for (auto &p : producers) { p.join(); }
+			async.Flush();
+		}
+		REQUIRE( writer->numbers.size() == (std::size_t)N );
+		for (int i = 0; i < N; ++i) { REQUIRE( writer->numbers[i] == i ); }
+	}
+
+	// Missing event numbers are skipped by Flush
+	{
+		auto writer = std::make_shared<MTestWriter>();
+		MAsyncWriter async(writer, 16, 4);
+		for (const int i : {3, 0, 5, 1}) {
+			auto evt = std::make_unique<MEventRecord>();
+			evt->event_number = i;
+			async.Push(std::move(evt));
+		}
+		async.Flush();
+		REQUIRE( writer->numbers == std::vector<int>({0, 1, 3, 5}) );
+	}
+
+	// Writer thread exception is rethrown once by Flush, later events are dropped
+	auto writer     = std::make_shared<MTestWriter>();
+	writer->fail_at = 100;
+	MAsyncWriter async(writer, 16, 4);
+	for (int i = 0; i < N; ++i) {
+		auto evt = std::make_unique<MEventRecord>();
+		evt->event_number = i;
+		async.Push(std::move(evt));
+	}
+	REQUIRE_THROWS_AS( async.Flush(), std::runtime_error );
+	REQUIRE_NOTHROW( async.Close() );
+	REQUIRE( writer->numbers.size() <= 100 );
+}
+
+TEST_CASE("MColumnar: chunked binary write and read round-trip", "[MColumnar]") {
+
+	// 2 -> 1 -> 2 record with one displaced decay vertex
+	auto event = [](int n) {
+		MEventRecord evt;
+		const int v1 = evt.AddVertex();
+		const int p1 = evt.AddParticle(M4Vec(0, 0, 6500, 6500), 2212, 4);
+		const int p2 = evt.AddParticle(M4Vec(0, 0, -6500, 6500), 2212, 4);
+		const int X  = evt.AddParticle(M4Vec(0.1 * n, -0.2, 0.3, 3.1), 90, 2);
+		evt.AddIn(v1, p1);
+		evt.AddIn(v1, p2);
+		evt.AddOut(v1, X);
+		const int v2 = evt.AddVertex(M4Vec(0.01, 0.02, 0.03, 0.04 * n));
+		const int d1 = evt.AddParticle(M4Vec(1.0 / 3.0, 0.1, 0.2, 1.5), 211, 1);
+		const int d2 = evt.AddParticle(M4Vec(0.1 * n - 1.0 / 3.0, -0.3, 0.1, 1.6), -211, 1);
+		evt.AddIn(v2, X);
+		evt.AddOut(v2, d1);
+		evt.AddOut(v2, d2);
+		evt.weights      = std::vector<double>(n % 3, 0.5 * n);
+		evt.xs           = 123.0 + n;
+		evt.xs_err       = 1.0;
+		evt.event_number = n;
+		return evt;
+	};
+
+	const int N = 25;  // Not a multiple of the chunk size
+	MColumnarHeader header;
+	header.cardhash  = 12345;
+	header.generator = "GRANIITTI";
+	header.card      = "test.json";
+
+	const std::string filename = "MColumnar_test.grcol";
+	{
+		std::ofstream os(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+		MWriterColumnar writer(os, header, 4);
+		for (int n = 0; n < N; ++n) { writer.Write(event(n)); }
+	}
+
+	SECTION("Header") {
+		MReaderColumnar reader(filename);
+		REQUIRE( reader.Header().events == (std::uint64_t) N );
+		REQUIRE( reader.Header().xs == 123.0 + (N - 1) );
+		REQUIRE( reader.Header().cardhash == 12345 );
+		REQUIRE( reader.Header().card == "test.json" );
+	}
+
+	SECTION("Events") {
+		MReaderColumnar reader(filename);
+		MEventRecord    evt;
+		int n = 0;
+		while (reader.ReadEvent(evt)) {
+			const MEventRecord ref = event(n);
+			REQUIRE( evt.event_number == n );
+			REQUIRE( evt.xs == ref.xs );
+			REQUIRE( evt.weights == ref.weights );
+			REQUIRE( evt.particles.size() == ref.particles.size() );
+			REQUIRE( evt.vertices.size() == ref.vertices.size() );
+			for (std::size_t i = 0; i < evt.particles.size(); ++i) {
+				const MEventRecord::Particle& a = evt.particles[i];
+				const MEventRecord::Particle& b = ref.particles[i];
+				REQUIRE( (a.px == b.px && a.py == b.py && a.pz == b.pz && a.e == b.e && a.m == b.m) );
+				REQUIRE( (a.pdg == b.pdg && a.status == b.status && a.prod == b.prod && a.end == b.end) );
+			}
+			for (std::size_t j = 0; j < evt.vertices.size(); ++j) {
+				REQUIRE( evt.vertices[j].t == ref.vertices[j].t );
+				REQUIRE( evt.vertices[j].nin == ref.vertices[j].nin );
+				REQUIRE( evt.vertices[j].in1 == ref.vertices[j].in1 );
+			}
+			++n;
+		}
+		REQUIRE( n == N );
+	}
+
+	SECTION("Chunk columns and mothers") {
+		MReaderColumnar reader(filename);
+		MColumnarChunk  chunk;
+		std::size_t     chunks = 0;
+		while (reader.ReadChunk(chunk)) {
+			REQUIRE( chunk.NEvents() <= 4 );
+			int m1, m2;
+			chunk.Mothers(0, 2, m1, m2);  // X <- beams
+			REQUIRE( (m1 == 0 && m2 == 1) );
+			chunk.Mothers(0, 4, m1, m2);  // pi- <- X
+			REQUIRE( (m1 == 2 && m2 == 2) );
+			chunk.Mothers(0, 0, m1, m2);  // beam
+			REQUIRE( (m1 == -1 && m2 == -1) );
+			++chunks;
+		}
+		REQUIRE( chunks == (N + 3) / 4 );
+	}
+
+	std::remove(filename.c_str());
+}
+
+TEST_CASE("MEventRecord: AncestorMask versus recursive parent search", "[MEventRecord]") {
+
+	// Random decay trees, vertex indices in scrambled order
+	std::mt19937 rng(1234);
+	for (int trial = 0; trial < 200; ++trial) {
+		const int NV = 1 + rng() % 12;
+		std::vector<int> order(NV);
+		for (int v = 0; v < NV; ++v) { order[v] = v; }
+		std::shuffle(order.begin(), order.end(), rng);
+
+		MEventRecord evt;
+		for (int v = 0; v < NV; ++v) { evt.AddVertex(); }
+		const int b1 = evt.AddParticle(M4Vec(0, 0, 1, 1), 2212, 4);
+		const int b2 = evt.AddParticle(M4Vec(0, 0, -1, 1), 2212, 4);
+		evt.AddIn(order[0], b1);
+		evt.AddIn(order[0], b2);
+		int used = 1;
+		std::vector<int> open = {order[0]};  // Vertices with incoming particles
+		for (int i = 0; i < 30; ++i) {
+			const int pdg = std::vector<int>({90, 90210, 211, 22})[rng() % 4];
+			const int p   = evt.AddParticle(M4Vec(0, 0, 0, 1), pdg, 1);
+			evt.AddOut(open[rng() % open.size()], p);
+			if (used < NV && rng() % 2) {
+				evt.AddIn(order[used], p);
+				open.push_back(order[used++]);
+			}
+		}
+
+		const auto mask = [](const MEventRecord::Particle& p) {
+			return (p.pdg == 90 ? 1U : 0U) | (p.pdg == 90210 ? 2U : 0U);
+		};
+		std::vector<unsigned int> ancestors;
+		std::vector<unsigned int> parents;
+		evt.AncestorMask(mask, ancestors, parents);
+
+		std::function<unsigned int(int)> recursive = [&](int i) {
+			unsigned int m = 0;
+			if (evt.particles[i].prod < 0) { return m; }
+			for (std::size_t j = 0; j < evt.particles.size(); ++j) {
+				if (evt.particles[j].end == evt.particles[i].prod) {
+					m |= mask(evt.particles[j]) | recursive(j);
+				}
+			}
+			return m;
+		};
+		for (std::size_t i = 0; i < evt.particles.size(); ++i) {
+			unsigned int direct = 0;
+			for (std::size_t j = 0; j < evt.particles.size(); ++j) {
+				if (evt.particles[i].prod >= 0 && evt.particles[j].end == evt.particles[i].prod) {
+					direct |= mask(evt.particles[j]);
+				}
+			}
+			REQUIRE( ancestors[i] == recursive(i) );
+			REQUIRE( parents[i] == direct );
+		}
+	}
+}
+
+TEST_CASE("MCompress: parallel block gzip output and transparent input", "[MCompress]") {
+
+	std::string text;
+	for (int i = 0; i < 20000; ++i) {
+		text += "P " + std::to_string(i) + " 211 " + std::to_string(std::sin(i)) + "\n";
+	}
+	auto readall = [](const std::string& filename) {
+		MInputStream in(filename);
+		REQUIRE( in.IsOpen() );
+		std::ostringstream os;
+		os << in.rdbuf();
+		return std::make_pair(in.Compressed(), os.str());
+	};
+
+	const std::string filename = "MCompress_test.gz";
+	for (const unsigned int threads : {0, 1, 3}) {
+		{
+			std::ofstream file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+			MCompressBuf  buf(file, MakeCodec("gzip:1"), threads, 4096);  // Many small blocks
+			std::ostream  os(&buf);
+			for (std::size_t k = 0; k < text.size(); k += 1000) { os << text.substr(k, 1000); }
+			buf.Finish();
+		}
+		const auto result = readall(filename);
+		REQUIRE( result.first == true );
+		REQUIRE( result.second == text );
+	}
+
+	// Uncompressed file is read as it is
+	{
+		std::ofstream file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+		file << text;
+	}
+	const auto result = readall(filename);
+	REQUIRE( result.first == false );
+	REQUIRE( result.second == text );
+
+	REQUIRE( MakeCodec("none") == nullptr );
+	REQUIRE_THROWS( MakeCodec("gzip:0") );
+	REQUIRE_THROWS( MakeCodec("bzip2") );
+
+	std::remove(filename.c_str());
+}
+
+TEST_CASE("MNeuroFlow: analytic density and gradient", "[MNeuroJacobian]") {
+
+	using Eigen::MatrixXd;
+	using Eigen::VectorXd;
+
+	MRandom random;
+	random.SetSeed(12345);
+
+	// Flow with non-trivial couplings
+	const unsigned int D = 3;
+	gra::neurojac::NEUROPARAM param;
+	param.LAYERS = 4;
+	param.HIDDEN = 5;
+	gra::neurojac::MNeuroFlow flow;
+	flow.Init(D, param, random);
+	VectorXd theta = flow.Pack(flow.L);
+	for (std::size_t i = 0; i < (std::size_t)theta.size(); ++i) { theta[i] = random.G(0, 0.3); }
+	flow.Unpack(theta, flow.L);
+
+	const unsigned int B = 8;
+	MatrixXd Z(D, B);
+	for (std::size_t j = 0; j < B; ++j) {
+		for (std::size_t i = 0; i < D; ++i) { Z(i, j) = random.G(0, 1); }
+	}
+	MatrixXd Y, U;
+	VectorXd invq;
+	flow.Forward(Z, Y, U, invq);
+
+	SECTION("Inverse pass density equals forward pass density") {
+		VectorXd logq;
+		flow.LogDensity(Y, logq);
+		for (std::size_t j = 0; j < B; ++j) {
+			REQUIRE( logq[j] == Approx(-std::log(invq[j])).epsilon(1e-9) );
+		}
+	}
+
+	SECTION("1/q(u) equals |du/dz| / p(z) by finite differences") {
+		const double h = 1e-6;
+		for (std::size_t j = 0; j < B; ++j) {
+			MatrixXd J(D, D);
+			for (std::size_t i = 0; i < D; ++i) {
+				MatrixXd Zp = Z.col(j), Zm = Z.col(j);
+				Zp(i, 0) += h;
+				Zm(i, 0) -= h;
+				MatrixXd Yp, Up, Ym, Um;
+				VectorXd dummy;
+				flow.Forward(Zp, Yp, Up, dummy);
+				flow.Forward(Zm, Ym, Um, dummy);
+				J.col(i) = (Up - Um) / (2 * h);
+			}
+			double logp = 0.0;
+			for (std::size_t i = 0; i < D; ++i) { logp += -0.5 * Z(i, j) * Z(i, j) - 0.5 * std::log(2 * M_PI); }
+			REQUIRE( invq[j] == Approx(std::abs(J.determinant()) / std::exp(logp)).epsilon(1e-5) );
+		}
+	}
+
+	SECTION("File round-trip and corrupted parameter count") {
+		const std::string filename = "MNeuroFlow_test.bin";
+		const std::string key      = "test";
+		flow.Write(filename, key);
+
+		gra::neurojac::MNeuroFlow other;
+		REQUIRE( other.Read(filename, key) );
+		REQUIRE( other.Pack(other.L) == theta );
+		REQUIRE_FALSE( other.Read(filename, "other key") );
+
+		// Parameter count after the header, key, dimensions and masks
+		const std::size_t offset = 8 + 4 + 8 + key.size() + 3 * 4 + param.LAYERS * D * 8;
+		{
+			std::fstream f(filename, std::ios::in | std::ios::out | std::ios::binary);
+			f.seekp(offset);
+			const std::uint64_t n = 1ULL << 60;
+			f.write(reinterpret_cast<const char*>(&n), sizeof(n));
+		}
+		REQUIRE_FALSE( other.Read(filename, key) );
+		std::remove(filename.c_str());
+	}
+
+	SECTION("Gradient versus numerical derivative") {
+		VectorXd w(B);
+		for (std::size_t j = 0; j < B; ++j) { w[j] = random.U(0, 1); }
+
+		auto J = [&](const VectorXd& th) {
+			gra::neurojac::MNeuroFlow f = flow;
+			f.Unpack(th, f.L);
+			VectorXd logq;
+			f.LogDensity(Y, logq);
+			return w.dot(logq);
+		};
+		std::vector<gra::neurojac::CouplingLayer> grad;
+		flow.Gradient(Y, w, grad);
+		const VectorXd g = flow.Pack(grad);
+
+		const double h = 1e-6;
+		for (std::size_t i = 0; i < (std::size_t)theta.size(); ++i) {
+			VectorXd tp = theta, tm = theta;
+			tp[i] += h;
+			tm[i] -= h;
+			const double num = (J(tp) - J(tm)) / (2 * h);
+			REQUIRE( g[i] == Approx(num).margin(1e-6).epsilon(1e-5) );
+		}
+	}
+}
+
 // Matrix initialization
 //
 //
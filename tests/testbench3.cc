@@ -4,6 +4,7 @@
 // Licensed under the MIT License <http://opensource.org/licenses/MIT>.
 
 #include <catch.hpp>
+#include <cstdio>
 #include <random>
 
 #include "Graniitti/MRandom.h"
@@ -18,6 +19,9 @@
 #include "Graniitti/MDurham.h"
 #include "Graniitti/MGamma.h"
 #include "Graniitti/MQED.h"
+#include "Graniitti/MGraniitti.h"
+#include "Graniitti/Amplitude/AMP_MG5_gg_gg.h"
+#include "Graniitti/Amplitude/AMP_MG5_yy_ll.h"
 
 
 using namespace gra;
@@ -36,6 +40,175 @@ TEST_CASE("MTensorPomeron", "[gra::MTensorPomeron]") {
 	MTensorPomeron a(lts, modelfile);
 }
 
+// Test screening loop context: cached beam spinors give identical amplitudes
+// while the beams stay fixed and the rest of the kinematics changes
+//
+TEST_CASE("MTensorPomeron: screening loop context", "[gra::MTensorPomeron]") {
+
+	const std::string inputfile = gra::aux::GetBasePath(2) + "/input/test.json";
+	const std::vector<std::string> processes = {"PP[CONTENSOR]<F> -> pi+ pi-",
+	                                            "PP[CONTENSOR]<F> -> p+ p-"};
+
+	for (const auto& process : processes) {
+		MGraniitti gen;
+		gen.ReadInput(inputfile, process);
+		gen.proc->post_Constructor();
+		gen.proc->SetScreening(false);
+		gen.proc->SetFLATAMP(1); // Kinematics only from EventWeight
+
+		std::mt19937_64 rng(12345);
+		std::uniform_real_distribution<double> flat(0.0, 1.0);
+		std::vector<double> randvec(gen.proc->GetdLIPSDim(), 0.0);
+
+		unsigned int valid  = 0;
+		unsigned int trials = 0;
+		while (valid < 20 && trials < 100000) {
+			++trials;
+			for (auto& r : randvec) { r = flat(rng); }
+			AuxIntData aux;
+			gen.proc->EventWeight(randvec, aux);
+			if (!aux.Valid()) { continue; }
+
+			// Context is begun at the previous phase space point, as with the loop nodes
+			if (valid == 0) { gen.proc->ProcPtr.LoopBegin(gen.proc->lts); }
+			const double A2_loop = gen.proc->ProcPtr.GetBareAmplitude2(gen.proc->lts);
+			const std::vector<std::complex<double>> hamp_loop = gen.proc->lts.hamp;
+
+			gen.proc->ProcPtr.LoopEnd();
+			const double A2 = gen.proc->ProcPtr.GetBareAmplitude2(gen.proc->lts);
+			gen.proc->ProcPtr.LoopBegin(gen.proc->lts);
+
+			REQUIRE( A2 > 0.0 );
+			REQUIRE( A2_loop == A2 );
+			REQUIRE( hamp_loop.size() == gen.proc->lts.hamp.size() );
+			for (const auto& h : indices(hamp_loop)) {
+				REQUIRE( hamp_loop[h] == gen.proc->lts.hamp[h] );
+			}
+			++valid;
+		}
+		gen.proc->ProcPtr.LoopEnd();
+		REQUIRE( valid == 20 );
+	}
+}
+
+// Test screening loop context: the screened amplitude with the loop invariant
+// blocks (beam spinors, resonance decay vertices) cached equals the one without
+//
+TEST_CASE("MTensorPomeron: screened amplitude with loop context", "[gra::MTensorPomeron]") {
+
+	const std::string inputfile = gra::aux::GetBasePath(2) + "/input/test.json";
+	const std::vector<std::string> processes = {"PP[RESTENSOR]<F> -> pi+ pi-",
+	                                            "PP[CONTENSOR]<F> -> pi+ pi-"};
+
+	for (const auto& process : processes) {
+		MGraniitti gen;
+		gen.ReadInput(inputfile, process);
+		gen.proc->post_Constructor();
+		gen.proc->SetScreening(true);
+		gen.proc->Eikonal.S3Constructor(gen.proc->GetMandelstam_s(),
+		                                gen.proc->GetInitialState(), false);
+
+		std::mt19937_64 rng(12345);
+		std::uniform_real_distribution<double> flat(0.0, 1.0);
+		std::vector<double> randvec(gen.proc->GetdLIPSDim(), 0.0);
+
+		unsigned int valid  = 0;
+		unsigned int trials = 0;
+		while (valid < 5 && trials < 100000) {
+			++trials;
+			for (auto& r : randvec) { r = flat(rng); }
+
+			// Same substream for both, the decay angles are drawn within EventWeight
+			AuxIntData aux_loop;
+			gen.proc->SetLoopContext(true);
+			gen.proc->random.SetSubstream(12345, 0, trials);
+			const double W_loop = gen.proc->EventWeight(randvec, aux_loop);
+			if (!aux_loop.Valid() || !(W_loop > 0.0)) { continue; }
+
+			AuxIntData aux;
+			gen.proc->SetLoopContext(false);
+			gen.proc->random.SetSubstream(12345, 0, trials);
+			const double W = gen.proc->EventWeight(randvec, aux);
+
+			REQUIRE( aux.Valid() );
+			REQUIRE( W_loop == Approx(W).epsilon(1e-10) );
+			++valid;
+		}
+		REQUIRE( valid == 5 );
+	}
+}
+
+// Test MadGraph helicity filtering: vanishing helicity combinations are learned
+// and skipped without changing the amplitudes
+//
+TEST_CASE("MG5 amplitudes: helicity filtering", "[gra::MG5]") {
+
+	MRandom random;
+	random.SetSeed(4321);
+
+	// Massless initial states, two body final state at random angles
+	auto kinematics = [&](gra::LORENTZSCALAR& lts, double sqrts, double m) {
+		const double E = sqrts / 2.0;
+		lts.q1.Set(0, 0,  E, E);
+		lts.q2.Set(0, 0, -E, E);
+		const double costheta = random.U(-0.95, 0.95);
+		const double phi      = random.U(-math::PI, math::PI);
+		const double p        = msqrt(E * E - m * m);
+		const double sintheta = msqrt(1.0 - costheta * costheta);
+		lts.decaytree.resize(2);
+		lts.decaytree[0].p4.Set( p * sintheta * std::cos(phi),  p * sintheta * std::sin(phi),  p * costheta, E);
+		lts.decaytree[1].p4.Set(-p * sintheta * std::cos(phi), -p * sintheta * std::sin(phi), -p * costheta, E);
+	};
+
+	auto compare = [&](auto& filtered, auto& full, double sqrts, double m, double alphas) {
+		gra::LORENTZSCALAR lts;
+		for (std::size_t n = 0; n < 100; ++n) {
+			kinematics(lts, sqrts, m);
+			const double A2_full = full.CalcAmp2(lts, alphas);
+			const std::vector<std::complex<double>> hamp_full = lts.hamp;
+			const double A2 = filtered.CalcAmp2(lts, alphas);
+
+			REQUIRE( A2 == Approx(A2_full).epsilon(1e-12) );
+			REQUIRE( lts.hamp.size() == hamp_full.size() );
+			for (const auto& h : indices(hamp_full)) {
+				if (lts.hamp[h] != 0.0) { REQUIRE( lts.hamp[h] == hamp_full[h] ); }
+			}
+		}
+		REQUIRE( filtered.getHelicityFilter().Learned() );
+		return filtered.getHelicityFilter().NGood();
+	};
+
+	SECTION("gg -> gg: MHV zeros skipped") {
+		AMP_MG5_gg_gg filtered;
+		AMP_MG5_gg_gg full;
+		full.setHelicityFilter(false);
+		REQUIRE( compare(filtered, full, 100.0, 0.0, 0.1) < 16 );
+	}
+
+	SECTION("yy -> mu+ mu-: mass suppressed helicities kept") {
+		AMP_MG5_yy_ll filtered;
+		AMP_MG5_yy_ll full;
+		full.setHelicityFilter(false);
+		REQUIRE( compare(filtered, full, 20.0, 0.105658, 0.0) == 16 );
+	}
+
+	SECTION("Vanishing points do not count to the warm-up") {
+		MG5_sm::HelicityFilter filter;
+		const std::vector<std::complex<double>> zero(4, 0.0);
+		for (std::size_t n = 0; n < 2 * MG5_sm::HelicityFilter::NWARMUP; ++n) { filter.Update(zero); }
+		REQUIRE_FALSE( filter.Learned() );
+		REQUIRE( filter.Evaluate(0) );
+
+		std::vector<std::complex<double>> hamp(4, 0.0);
+		hamp[2] = 1.0;
+		for (std::size_t n = 0; n < MG5_sm::HelicityFilter::NWARMUP; ++n) { filter.Update(hamp); }
+		REQUIRE( filter.Learned() );
+		REQUIRE( filter.NGood() == 1 );
+		REQUIRE( filter.Evaluate(2) );
+		REQUIRE_FALSE( filter.Evaluate(0) );
+	}
+}
+
 // Test initializing Regge amplitudes
 //
 TEST_CASE("MRegge", "[gra::MRegge]") {
@@ -339,3 +512,115 @@ TEST_CASE("gra::kinematics::GJframe", "[Lorentz Frames]") {
 	} while ((++repeat) < N);
 }
 
+
+// Test multithreaded VEGAS integration reproducibility: the same integration
+// gives bit-exact results run to run and independent of the number of threads
+//
+TEST_CASE("MGraniitti: multithreaded VEGAS reproducibility", "[MGraniitti]") {
+
+	const std::string inputfile = gra::aux::GetBasePath(2) + "/input/test.json";
+
+	auto integrate = [&](int cores) {
+		MGraniitti gen;
+		gen.ReadInput(inputfile);
+		gen.SetIntegrator("VEGAS");
+		gen.SetCores(cores);
+		gen.SetNumberOfEvents(0);
+		gen.Initialize();
+
+		double xs     = 0.0;
+		double xs_err = 0.0;
+		gen.GetXS(xs, xs_err);
+		return std::make_pair(xs, xs_err);
+	};
+
+	const auto a = integrate(3);
+	const auto b = integrate(3);
+	const auto c = integrate(2);
+
+	REQUIRE( a.first > 0.0 );
+	REQUIRE( a.first  == b.first );
+	REQUIRE( a.second == b.second );
+	REQUIRE( a.first  == c.first );
+	REQUIRE( a.second == c.second );
+}
+
+// Test VEGAS checkpoint: a run restored from the checkpoint has the same grid,
+// integral and phase space weight sums as the uninterrupted run which wrote it
+//
+TEST_CASE("MGraniitti: VEGAS checkpoint restore", "[MGraniitti]") {
+
+	const std::string inputfile = gra::aux::GetBasePath(2) + "/input/test.json";
+
+	auto integrate = [&](MVEGASCheckpoint& C, bool checkpoint) {
+		MGraniitti gen;
+		gen.ReadInput(inputfile);
+		gen.SetIntegrator("VEGAS");
+		gen.SetCheckpoint(checkpoint);
+		gen.SetNumberOfEvents(0);
+		gen.Initialize();
+		gen.GetCheckpoint(C);
+		return gen.GetCheckpointFile(C.key);
+	};
+
+	// Uninterrupted run, its state saved as the checkpoint
+	MVEGASCheckpoint A;
+	const std::string filename = integrate(A, false);
+	A.Write(filename);
+
+	// Restored run
+	MVEGASCheckpoint B;
+	integrate(B, true);
+	std::remove(filename.c_str());
+
+	REQUIRE( A.sigma > 0.0 );
+	REQUIRE( A.DW_sum[0] > 0.0 );
+	REQUIRE( B.BINS == A.BINS );
+	REQUIRE( B.NCALL == A.NCALL );
+	REQUIRE( B.region == A.region );
+	REQUIRE( B.xmat == A.xmat );
+	REQUIRE( (B.sumdata == A.sumdata && B.sumchi2 == A.sumchi2 && B.sweight == A.sweight) );
+	REQUIRE( (B.sigma == A.sigma && B.sigma_err == A.sigma_err && B.maxf == A.maxf) );
+	REQUIRE( B.decayW == A.decayW );
+	for (std::size_t i = 0; i < 3; ++i) {
+		REQUIRE( B.DW_sum[i] == A.DW_sum[i] );
+		REQUIRE( B.DW_sum_exact[i] == A.DW_sum_exact[i] );
+	}
+}
+
+// Test multithreaded plain MC integration reproducibility: the same integration
+// gives bit-exact results run to run and independent of the number of threads
+//
+TEST_CASE("MGraniitti: multithreaded FLAT reproducibility", "[MGraniitti]") {
+
+	const std::string inputfile = gra::aux::GetBasePath(2) + "/input/test.json";
+
+	auto integrate = [&](int cores) {
+		MGraniitti gen;
+		gen.ReadInput(inputfile);
+		gen.SetIntegrator("FLAT");
+		gen.SetCores(cores);
+		gen.SetNumberOfEvents(0);
+
+		MCPARAM mcparam;
+		mcparam.PRECISION  = 1.0;
+		mcparam.MIN_EVENTS = 50000;
+		gen.SetMCParam(mcparam);
+		gen.Initialize();
+
+		double xs     = 0.0;
+		double xs_err = 0.0;
+		gen.GetXS(xs, xs_err);
+		return std::make_pair(xs, xs_err);
+	};
+
+	const auto a = integrate(3);
+	const auto b = integrate(3);
+	const auto c = integrate(2);
+
+	REQUIRE( a.first > 0.0 );
+	REQUIRE( a.first  == b.first );
+	REQUIRE( a.second == b.second );
+	REQUIRE( a.first  == c.first );
+	REQUIRE( a.second == c.second );
+}